@@ -70,6 +70,7 @@ main_sources(STM32F7_SRC
     drivers/bus_i2c_hal.c
     drivers/dma_stm32f7xx.c
     drivers/bus_spi_hal_ll.c
+    drivers/crc_hw_hal.c
     drivers/timer.c
     drivers/timer_impl_hal.c
     drivers/timer_stm32f7xx.c
@@ -149,6 +149,7 @@ main_sources(STM32H7_SRC
     drivers/bus_i2c_hal.c
     drivers/dma_stm32h7xx.c
     drivers/bus_spi_hal_ll.c
+    drivers/crc_hw_hal.c
     drivers/bus_quadspi.c
     drivers/bus_quadspi_hal.c
     drivers/memprot.h
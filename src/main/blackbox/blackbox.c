@@ -412,7 +412,9 @@ static const blackboxConditionalFieldDefinition_t blackboxGpsGFields[] = {
     {"GPS_epv",           -1, UNSIGNED, PREDICT(0),          ENCODING(UNSIGNED_VB), CONDITION(ALWAYS)},
     {"GPS_velned",         0, SIGNED,   PREDICT(0),          ENCODING(SIGNED_VB),   CONDITION(ALWAYS)},
     {"GPS_velned",         1, SIGNED,   PREDICT(0),          ENCODING(SIGNED_VB),   CONDITION(ALWAYS)},
-    {"GPS_velned",         2, SIGNED,   PREDICT(0),          ENCODING(SIGNED_VB),   CONDITION(ALWAYS)}
+    {"GPS_velned",         2, SIGNED,   PREDICT(0),          ENCODING(SIGNED_VB),   CONDITION(ALWAYS)},
+    {"GPS_latency",       -1, UNSIGNED, PREDICT(0),          ENCODING(UNSIGNED_VB), CONDITION(ALWAYS)},
+    {"navHistDepth",      -1, UNSIGNED, PREDICT(0),          ENCODING(UNSIGNED_VB), CONDITION(ALWAYS)}
 };
 
 // GPS home frame
@@ -1631,6 +1633,8 @@ static void writeGPSFrame(timeUs_t currentTimeUs)
     blackboxWriteUnsignedVB(gpsSol.eph);
     blackboxWriteUnsignedVB(gpsSol.epv);
     blackboxWriteSigned16VBArray(gpsSol.velNED, XYZ_AXIS_COUNT);
+    blackboxWriteUnsignedVB(navGpsLatency);
+    blackboxWriteUnsignedVB(navPosHistoryDepth);
 
     gpsHistory.GPS_numSat = gpsSol.numSat;
     gpsHistory.GPS_coord[0] = gpsSol.llh.lat;
@@ -1710,9 +1714,9 @@ static void loadMainState(timeUs_t currentTimeUs)
         blackboxCurrent->rcCommand[i] = rcCommand[i];
     }
 
-    blackboxCurrent->attitude[0] = attitude.values.roll;
-    blackboxCurrent->attitude[1] = attitude.values.pitch;
-    blackboxCurrent->attitude[2] = attitude.values.yaw;
+    blackboxCurrent->attitude[0] = imuGetAttitude()->values.roll;
+    blackboxCurrent->attitude[1] = imuGetAttitude()->values.pitch;
+    blackboxCurrent->attitude[2] = imuGetAttitude()->values.yaw;
 
     for (int i = 0; i < DEBUG32_VALUE_COUNT; i++) {
         blackboxCurrent->debug[i] = debug[i];
@@ -79,6 +79,9 @@ typedef enum {
     DEBUG_GPS,
     DEBUG_LULU,
     DEBUG_SBUS2,
+    DEBUG_MSP_DISPLAYPORT,
+    DEBUG_POS_EST_STATS,
+    DEBUG_RX_LATENCY,
     DEBUG_COUNT // also update debugModeNames in cli.c
 } debugType_e;
 
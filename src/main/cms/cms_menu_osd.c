@@ -80,6 +80,7 @@ static long cmsx_osdElementOnChange(displayPort_t *displayPort, const void *ptr)
     if (osdCurrentElementVisible) {
         *pos |= OSD_VISIBLE_FLAG;
     }
+    osdStartFullRedraw();
     cmsYieldDisplay(displayPort, 500);
     return 0;
 }
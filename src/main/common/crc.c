@@ -16,85 +16,391 @@
  */
 
 #include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
 
 #include "crc.h"
 #include "streambuf.h"
 
+#ifdef USE_CRC_HW
+#include "drivers/crc_hw.h"
+
+// Set by crcInit() once the CRC unit reproduced the software results
+static bool crcHwVerified = false;
+#endif
+
+/*
+ * MSB-first CRC lookup tables. Slice k holds the CRC of a single byte followed
+ * by k zero bytes, which lets the bulk functions consume four bytes per step.
+ */
+#ifdef USE_CRC_SLICE_BY_4
+#define CRC_TABLE_SLICES 4
+#else
+#define CRC_TABLE_SLICES 1
+#endif
+
+static const uint16_t crc16_ccitt_table[CRC_TABLE_SLICES][256] = {
+    {
+        0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+        0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+        0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+        0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+        0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+        0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+        0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+        0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+        0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+        0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+        0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+        0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+        0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+        0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+        0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+        0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+        0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+        0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+        0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+        0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+        0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+        0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+        0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+        0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+        0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+        0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+        0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+        0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+        0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+        0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+        0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+        0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0,
+    },
+#ifdef USE_CRC_SLICE_BY_4
+    {
+        0x0000, 0x3331, 0x6662, 0x5553, 0xCCC4, 0xFFF5, 0xAAA6, 0x9997,
+        0x89A9, 0xBA98, 0xEFCB, 0xDCFA, 0x456D, 0x765C, 0x230F, 0x103E,
+        0x0373, 0x3042, 0x6511, 0x5620, 0xCFB7, 0xFC86, 0xA9D5, 0x9AE4,
+        0x8ADA, 0xB9EB, 0xECB8, 0xDF89, 0x461E, 0x752F, 0x207C, 0x134D,
+        0x06E6, 0x35D7, 0x6084, 0x53B5, 0xCA22, 0xF913, 0xAC40, 0x9F71,
+        0x8F4F, 0xBC7E, 0xE92D, 0xDA1C, 0x438B, 0x70BA, 0x25E9, 0x16D8,
+        0x0595, 0x36A4, 0x63F7, 0x50C6, 0xC951, 0xFA60, 0xAF33, 0x9C02,
+        0x8C3C, 0xBF0D, 0xEA5E, 0xD96F, 0x40F8, 0x73C9, 0x269A, 0x15AB,
+        0x0DCC, 0x3EFD, 0x6BAE, 0x589F, 0xC108, 0xF239, 0xA76A, 0x945B,
+        0x8465, 0xB754, 0xE207, 0xD136, 0x48A1, 0x7B90, 0x2EC3, 0x1DF2,
+        0x0EBF, 0x3D8E, 0x68DD, 0x5BEC, 0xC27B, 0xF14A, 0xA419, 0x9728,
+        0x8716, 0xB427, 0xE174, 0xD245, 0x4BD2, 0x78E3, 0x2DB0, 0x1E81,
+        0x0B2A, 0x381B, 0x6D48, 0x5E79, 0xC7EE, 0xF4DF, 0xA18C, 0x92BD,
+        0x8283, 0xB1B2, 0xE4E1, 0xD7D0, 0x4E47, 0x7D76, 0x2825, 0x1B14,
+        0x0859, 0x3B68, 0x6E3B, 0x5D0A, 0xC49D, 0xF7AC, 0xA2FF, 0x91CE,
+        0x81F0, 0xB2C1, 0xE792, 0xD4A3, 0x4D34, 0x7E05, 0x2B56, 0x1867,
+        0x1B98, 0x28A9, 0x7DFA, 0x4ECB, 0xD75C, 0xE46D, 0xB13E, 0x820F,
+        0x9231, 0xA100, 0xF453, 0xC762, 0x5EF5, 0x6DC4, 0x3897, 0x0BA6,
+        0x18EB, 0x2BDA, 0x7E89, 0x4DB8, 0xD42F, 0xE71E, 0xB24D, 0x817C,
+        0x9142, 0xA273, 0xF720, 0xC411, 0x5D86, 0x6EB7, 0x3BE4, 0x08D5,
+        0x1D7E, 0x2E4F, 0x7B1C, 0x482D, 0xD1BA, 0xE28B, 0xB7D8, 0x84E9,
+        0x94D7, 0xA7E6, 0xF2B5, 0xC184, 0x5813, 0x6B22, 0x3E71, 0x0D40,
+        0x1E0D, 0x2D3C, 0x786F, 0x4B5E, 0xD2C9, 0xE1F8, 0xB4AB, 0x879A,
+        0x97A4, 0xA495, 0xF1C6, 0xC2F7, 0x5B60, 0x6851, 0x3D02, 0x0E33,
+        0x1654, 0x2565, 0x7036, 0x4307, 0xDA90, 0xE9A1, 0xBCF2, 0x8FC3,
+        0x9FFD, 0xACCC, 0xF99F, 0xCAAE, 0x5339, 0x6008, 0x355B, 0x066A,
+        0x1527, 0x2616, 0x7345, 0x4074, 0xD9E3, 0xEAD2, 0xBF81, 0x8CB0,
+        0x9C8E, 0xAFBF, 0xFAEC, 0xC9DD, 0x504A, 0x637B, 0x3628, 0x0519,
+        0x10B2, 0x2383, 0x76D0, 0x45E1, 0xDC76, 0xEF47, 0xBA14, 0x8925,
+        0x991B, 0xAA2A, 0xFF79, 0xCC48, 0x55DF, 0x66EE, 0x33BD, 0x008C,
+        0x13C1, 0x20F0, 0x75A3, 0x4692, 0xDF05, 0xEC34, 0xB967, 0x8A56,
+        0x9A68, 0xA959, 0xFC0A, 0xCF3B, 0x56AC, 0x659D, 0x30CE, 0x03FF,
+    },
+    {
+        0x0000, 0x3730, 0x6E60, 0x5950, 0xDCC0, 0xEBF0, 0xB2A0, 0x8590,
+        0xA9A1, 0x9E91, 0xC7C1, 0xF0F1, 0x7561, 0x4251, 0x1B01, 0x2C31,
+        0x4363, 0x7453, 0x2D03, 0x1A33, 0x9FA3, 0xA893, 0xF1C3, 0xC6F3,
+        0xEAC2, 0xDDF2, 0x84A2, 0xB392, 0x3602, 0x0132, 0x5862, 0x6F52,
+        0x86C6, 0xB1F6, 0xE8A6, 0xDF96, 0x5A06, 0x6D36, 0x3466, 0x0356,
+        0x2F67, 0x1857, 0x4107, 0x7637, 0xF3A7, 0xC497, 0x9DC7, 0xAAF7,
+        0xC5A5, 0xF295, 0xABC5, 0x9CF5, 0x1965, 0x2E55, 0x7705, 0x4035,
+        0x6C04, 0x5B34, 0x0264, 0x3554, 0xB0C4, 0x87F4, 0xDEA4, 0xE994,
+        0x1DAD, 0x2A9D, 0x73CD, 0x44FD, 0xC16D, 0xF65D, 0xAF0D, 0x983D,
+        0xB40C, 0x833C, 0xDA6C, 0xED5C, 0x68CC, 0x5FFC, 0x06AC, 0x319C,
+        0x5ECE, 0x69FE, 0x30AE, 0x079E, 0x820E, 0xB53E, 0xEC6E, 0xDB5E,
+        0xF76F, 0xC05F, 0x990F, 0xAE3F, 0x2BAF, 0x1C9F, 0x45CF, 0x72FF,
+        0x9B6B, 0xAC5B, 0xF50B, 0xC23B, 0x47AB, 0x709B, 0x29CB, 0x1EFB,
+        0x32CA, 0x05FA, 0x5CAA, 0x6B9A, 0xEE0A, 0xD93A, 0x806A, 0xB75A,
+        0xD808, 0xEF38, 0xB668, 0x8158, 0x04C8, 0x33F8, 0x6AA8, 0x5D98,
+        0x71A9, 0x4699, 0x1FC9, 0x28F9, 0xAD69, 0x9A59, 0xC309, 0xF439,
+        0x3B5A, 0x0C6A, 0x553A, 0x620A, 0xE79A, 0xD0AA, 0x89FA, 0xBECA,
+        0x92FB, 0xA5CB, 0xFC9B, 0xCBAB, 0x4E3B, 0x790B, 0x205B, 0x176B,
+        0x7839, 0x4F09, 0x1659, 0x2169, 0xA4F9, 0x93C9, 0xCA99, 0xFDA9,
+        0xD198, 0xE6A8, 0xBFF8, 0x88C8, 0x0D58, 0x3A68, 0x6338, 0x5408,
+        0xBD9C, 0x8AAC, 0xD3FC, 0xE4CC, 0x615C, 0x566C, 0x0F3C, 0x380C,
+        0x143D, 0x230D, 0x7A5D, 0x4D6D, 0xC8FD, 0xFFCD, 0xA69D, 0x91AD,
+        0xFEFF, 0xC9CF, 0x909F, 0xA7AF, 0x223F, 0x150F, 0x4C5F, 0x7B6F,
+        0x575E, 0x606E, 0x393E, 0x0E0E, 0x8B9E, 0xBCAE, 0xE5FE, 0xD2CE,
+        0x26F7, 0x11C7, 0x4897, 0x7FA7, 0xFA37, 0xCD07, 0x9457, 0xA367,
+        0x8F56, 0xB866, 0xE136, 0xD606, 0x5396, 0x64A6, 0x3DF6, 0x0AC6,
+        0x6594, 0x52A4, 0x0BF4, 0x3CC4, 0xB954, 0x8E64, 0xD734, 0xE004,
+        0xCC35, 0xFB05, 0xA255, 0x9565, 0x10F5, 0x27C5, 0x7E95, 0x49A5,
+        0xA031, 0x9701, 0xCE51, 0xF961, 0x7CF1, 0x4BC1, 0x1291, 0x25A1,
+        0x0990, 0x3EA0, 0x67F0, 0x50C0, 0xD550, 0xE260, 0xBB30, 0x8C00,
+        0xE352, 0xD462, 0x8D32, 0xBA02, 0x3F92, 0x08A2, 0x51F2, 0x66C2,
+        0x4AF3, 0x7DC3, 0x2493, 0x13A3, 0x9633, 0xA103, 0xF853, 0xCF63,
+    },
+    {
+        0x0000, 0x76B4, 0xED68, 0x9BDC, 0xCAF1, 0xBC45, 0x2799, 0x512D,
+        0x85C3, 0xF377, 0x68AB, 0x1E1F, 0x4F32, 0x3986, 0xA25A, 0xD4EE,
+        0x1BA7, 0x6D13, 0xF6CF, 0x807B, 0xD156, 0xA7E2, 0x3C3E, 0x4A8A,
+        0x9E64, 0xE8D0, 0x730C, 0x05B8, 0x5495, 0x2221, 0xB9FD, 0xCF49,
+        0x374E, 0x41FA, 0xDA26, 0xAC92, 0xFDBF, 0x8B0B, 0x10D7, 0x6663,
+        0xB28D, 0xC439, 0x5FE5, 0x2951, 0x787C, 0x0EC8, 0x9514, 0xE3A0,
+        0x2CE9, 0x5A5D, 0xC181, 0xB735, 0xE618, 0x90AC, 0x0B70, 0x7DC4,
+        0xA92A, 0xDF9E, 0x4442, 0x32F6, 0x63DB, 0x156F, 0x8EB3, 0xF807,
+        0x6E9C, 0x1828, 0x83F4, 0xF540, 0xA46D, 0xD2D9, 0x4905, 0x3FB1,
+        0xEB5F, 0x9DEB, 0x0637, 0x7083, 0x21AE, 0x571A, 0xCCC6, 0xBA72,
+        0x753B, 0x038F, 0x9853, 0xEEE7, 0xBFCA, 0xC97E, 0x52A2, 0x2416,
+        0xF0F8, 0x864C, 0x1D90, 0x6B24, 0x3A09, 0x4CBD, 0xD761, 0xA1D5,
+        0x59D2, 0x2F66, 0xB4BA, 0xC20E, 0x9323, 0xE597, 0x7E4B, 0x08FF,
+        0xDC11, 0xAAA5, 0x3179, 0x47CD, 0x16E0, 0x6054, 0xFB88, 0x8D3C,
+        0x4275, 0x34C1, 0xAF1D, 0xD9A9, 0x8884, 0xFE30, 0x65EC, 0x1358,
+        0xC7B6, 0xB102, 0x2ADE, 0x5C6A, 0x0D47, 0x7BF3, 0xE02F, 0x969B,
+        0xDD38, 0xAB8C, 0x3050, 0x46E4, 0x17C9, 0x617D, 0xFAA1, 0x8C15,
+        0x58FB, 0x2E4F, 0xB593, 0xC327, 0x920A, 0xE4BE, 0x7F62, 0x09D6,
+        0xC69F, 0xB02B, 0x2BF7, 0x5D43, 0x0C6E, 0x7ADA, 0xE106, 0x97B2,
+        0x435C, 0x35E8, 0xAE34, 0xD880, 0x89AD, 0xFF19, 0x64C5, 0x1271,
+        0xEA76, 0x9CC2, 0x071E, 0x71AA, 0x2087, 0x5633, 0xCDEF, 0xBB5B,
+        0x6FB5, 0x1901, 0x82DD, 0xF469, 0xA544, 0xD3F0, 0x482C, 0x3E98,
+        0xF1D1, 0x8765, 0x1CB9, 0x6A0D, 0x3B20, 0x4D94, 0xD648, 0xA0FC,
+        0x7412, 0x02A6, 0x997A, 0xEFCE, 0xBEE3, 0xC857, 0x538B, 0x253F,
+        0xB3A4, 0xC510, 0x5ECC, 0x2878, 0x7955, 0x0FE1, 0x943D, 0xE289,
+        0x3667, 0x40D3, 0xDB0F, 0xADBB, 0xFC96, 0x8A22, 0x11FE, 0x674A,
+        0xA803, 0xDEB7, 0x456B, 0x33DF, 0x62F2, 0x1446, 0x8F9A, 0xF92E,
+        0x2DC0, 0x5B74, 0xC0A8, 0xB61C, 0xE731, 0x9185, 0x0A59, 0x7CED,
+        0x84EA, 0xF25E, 0x6982, 0x1F36, 0x4E1B, 0x38AF, 0xA373, 0xD5C7,
+        0x0129, 0x779D, 0xEC41, 0x9AF5, 0xCBD8, 0xBD6C, 0x26B0, 0x5004,
+        0x9F4D, 0xE9F9, 0x7225, 0x0491, 0x55BC, 0x2308, 0xB8D4, 0xCE60,
+        0x1A8E, 0x6C3A, 0xF7E6, 0x8152, 0xD07F, 0xA6CB, 0x3D17, 0x4BA3,
+    },
+#endif
+};
+
+static const uint8_t crc8_dvb_s2_table[CRC_TABLE_SLICES][256] = {
+    {
+        0x00, 0xD5, 0x7F, 0xAA, 0xFE, 0x2B, 0x81, 0x54, 0x29, 0xFC, 0x56, 0x83,
+        0xD7, 0x02, 0xA8, 0x7D, 0x52, 0x87, 0x2D, 0xF8, 0xAC, 0x79, 0xD3, 0x06,
+        0x7B, 0xAE, 0x04, 0xD1, 0x85, 0x50, 0xFA, 0x2F, 0xA4, 0x71, 0xDB, 0x0E,
+        0x5A, 0x8F, 0x25, 0xF0, 0x8D, 0x58, 0xF2, 0x27, 0x73, 0xA6, 0x0C, 0xD9,
+        0xF6, 0x23, 0x89, 0x5C, 0x08, 0xDD, 0x77, 0xA2, 0xDF, 0x0A, 0xA0, 0x75,
+        0x21, 0xF4, 0x5E, 0x8B, 0x9D, 0x48, 0xE2, 0x37, 0x63, 0xB6, 0x1C, 0xC9,
+        0xB4, 0x61, 0xCB, 0x1E, 0x4A, 0x9F, 0x35, 0xE0, 0xCF, 0x1A, 0xB0, 0x65,
+        0x31, 0xE4, 0x4E, 0x9B, 0xE6, 0x33, 0x99, 0x4C, 0x18, 0xCD, 0x67, 0xB2,
+        0x39, 0xEC, 0x46, 0x93, 0xC7, 0x12, 0xB8, 0x6D, 0x10, 0xC5, 0x6F, 0xBA,
+        0xEE, 0x3B, 0x91, 0x44, 0x6B, 0xBE, 0x14, 0xC1, 0x95, 0x40, 0xEA, 0x3F,
+        0x42, 0x97, 0x3D, 0xE8, 0xBC, 0x69, 0xC3, 0x16, 0xEF, 0x3A, 0x90, 0x45,
+        0x11, 0xC4, 0x6E, 0xBB, 0xC6, 0x13, 0xB9, 0x6C, 0x38, 0xED, 0x47, 0x92,
+        0xBD, 0x68, 0xC2, 0x17, 0x43, 0x96, 0x3C, 0xE9, 0x94, 0x41, 0xEB, 0x3E,
+        0x6A, 0xBF, 0x15, 0xC0, 0x4B, 0x9E, 0x34, 0xE1, 0xB5, 0x60, 0xCA, 0x1F,
+        0x62, 0xB7, 0x1D, 0xC8, 0x9C, 0x49, 0xE3, 0x36, 0x19, 0xCC, 0x66, 0xB3,
+        0xE7, 0x32, 0x98, 0x4D, 0x30, 0xE5, 0x4F, 0x9A, 0xCE, 0x1B, 0xB1, 0x64,
+        0x72, 0xA7, 0x0D, 0xD8, 0x8C, 0x59, 0xF3, 0x26, 0x5B, 0x8E, 0x24, 0xF1,
+        0xA5, 0x70, 0xDA, 0x0F, 0x20, 0xF5, 0x5F, 0x8A, 0xDE, 0x0B, 0xA1, 0x74,
+        0x09, 0xDC, 0x76, 0xA3, 0xF7, 0x22, 0x88, 0x5D, 0xD6, 0x03, 0xA9, 0x7C,
+        0x28, 0xFD, 0x57, 0x82, 0xFF, 0x2A, 0x80, 0x55, 0x01, 0xD4, 0x7E, 0xAB,
+        0x84, 0x51, 0xFB, 0x2E, 0x7A, 0xAF, 0x05, 0xD0, 0xAD, 0x78, 0xD2, 0x07,
+        0x53, 0x86, 0x2C, 0xF9,
+    },
+#ifdef USE_CRC_SLICE_BY_4
+    {
+        0x00, 0x0B, 0x16, 0x1D, 0x2C, 0x27, 0x3A, 0x31, 0x58, 0x53, 0x4E, 0x45,
+        0x74, 0x7F, 0x62, 0x69, 0xB0, 0xBB, 0xA6, 0xAD, 0x9C, 0x97, 0x8A, 0x81,
+        0xE8, 0xE3, 0xFE, 0xF5, 0xC4, 0xCF, 0xD2, 0xD9, 0xB5, 0xBE, 0xA3, 0xA8,
+        0x99, 0x92, 0x8F, 0x84, 0xED, 0xE6, 0xFB, 0xF0, 0xC1, 0xCA, 0xD7, 0xDC,
+        0x05, 0x0E, 0x13, 0x18, 0x29, 0x22, 0x3F, 0x34, 0x5D, 0x56, 0x4B, 0x40,
+        0x71, 0x7A, 0x67, 0x6C, 0xBF, 0xB4, 0xA9, 0xA2, 0x93, 0x98, 0x85, 0x8E,
+        0xE7, 0xEC, 0xF1, 0xFA, 0xCB, 0xC0, 0xDD, 0xD6, 0x0F, 0x04, 0x19, 0x12,
+        0x23, 0x28, 0x35, 0x3E, 0x57, 0x5C, 0x41, 0x4A, 0x7B, 0x70, 0x6D, 0x66,
+        0x0A, 0x01, 0x1C, 0x17, 0x26, 0x2D, 0x30, 0x3B, 0x52, 0x59, 0x44, 0x4F,
+        0x7E, 0x75, 0x68, 0x63, 0xBA, 0xB1, 0xAC, 0xA7, 0x96, 0x9D, 0x80, 0x8B,
+        0xE2, 0xE9, 0xF4, 0xFF, 0xCE, 0xC5, 0xD8, 0xD3, 0xAB, 0xA0, 0xBD, 0xB6,
+        0x87, 0x8C, 0x91, 0x9A, 0xF3, 0xF8, 0xE5, 0xEE, 0xDF, 0xD4, 0xC9, 0xC2,
+        0x1B, 0x10, 0x0D, 0x06, 0x37, 0x3C, 0x21, 0x2A, 0x43, 0x48, 0x55, 0x5E,
+        0x6F, 0x64, 0x79, 0x72, 0x1E, 0x15, 0x08, 0x03, 0x32, 0x39, 0x24, 0x2F,
+        0x46, 0x4D, 0x50, 0x5B, 0x6A, 0x61, 0x7C, 0x77, 0xAE, 0xA5, 0xB8, 0xB3,
+        0x82, 0x89, 0x94, 0x9F, 0xF6, 0xFD, 0xE0, 0xEB, 0xDA, 0xD1, 0xCC, 0xC7,
+        0x14, 0x1F, 0x02, 0x09, 0x38, 0x33, 0x2E, 0x25, 0x4C, 0x47, 0x5A, 0x51,
+        0x60, 0x6B, 0x76, 0x7D, 0xA4, 0xAF, 0xB2, 0xB9, 0x88, 0x83, 0x9E, 0x95,
+        0xFC, 0xF7, 0xEA, 0xE1, 0xD0, 0xDB, 0xC6, 0xCD, 0xA1, 0xAA, 0xB7, 0xBC,
+        0x8D, 0x86, 0x9B, 0x90, 0xF9, 0xF2, 0xEF, 0xE4, 0xD5, 0xDE, 0xC3, 0xC8,
+        0x11, 0x1A, 0x07, 0x0C, 0x3D, 0x36, 0x2B, 0x20, 0x49, 0x42, 0x5F, 0x54,
+        0x65, 0x6E, 0x73, 0x78,
+    },
+    {
+        0x00, 0x83, 0xD3, 0x50, 0x73, 0xF0, 0xA0, 0x23, 0xE6, 0x65, 0x35, 0xB6,
+        0x95, 0x16, 0x46, 0xC5, 0x19, 0x9A, 0xCA, 0x49, 0x6A, 0xE9, 0xB9, 0x3A,
+        0xFF, 0x7C, 0x2C, 0xAF, 0x8C, 0x0F, 0x5F, 0xDC, 0x32, 0xB1, 0xE1, 0x62,
+        0x41, 0xC2, 0x92, 0x11, 0xD4, 0x57, 0x07, 0x84, 0xA7, 0x24, 0x74, 0xF7,
+        0x2B, 0xA8, 0xF8, 0x7B, 0x58, 0xDB, 0x8B, 0x08, 0xCD, 0x4E, 0x1E, 0x9D,
+        0xBE, 0x3D, 0x6D, 0xEE, 0x64, 0xE7, 0xB7, 0x34, 0x17, 0x94, 0xC4, 0x47,
+        0x82, 0x01, 0x51, 0xD2, 0xF1, 0x72, 0x22, 0xA1, 0x7D, 0xFE, 0xAE, 0x2D,
+        0x0E, 0x8D, 0xDD, 0x5E, 0x9B, 0x18, 0x48, 0xCB, 0xE8, 0x6B, 0x3B, 0xB8,
+        0x56, 0xD5, 0x85, 0x06, 0x25, 0xA6, 0xF6, 0x75, 0xB0, 0x33, 0x63, 0xE0,
+        0xC3, 0x40, 0x10, 0x93, 0x4F, 0xCC, 0x9C, 0x1F, 0x3C, 0xBF, 0xEF, 0x6C,
+        0xA9, 0x2A, 0x7A, 0xF9, 0xDA, 0x59, 0x09, 0x8A, 0xC8, 0x4B, 0x1B, 0x98,
+        0xBB, 0x38, 0x68, 0xEB, 0x2E, 0xAD, 0xFD, 0x7E, 0x5D, 0xDE, 0x8E, 0x0D,
+        0xD1, 0x52, 0x02, 0x81, 0xA2, 0x21, 0x71, 0xF2, 0x37, 0xB4, 0xE4, 0x67,
+        0x44, 0xC7, 0x97, 0x14, 0xFA, 0x79, 0x29, 0xAA, 0x89, 0x0A, 0x5A, 0xD9,
+        0x1C, 0x9F, 0xCF, 0x4C, 0x6F, 0xEC, 0xBC, 0x3F, 0xE3, 0x60, 0x30, 0xB3,
+        0x90, 0x13, 0x43, 0xC0, 0x05, 0x86, 0xD6, 0x55, 0x76, 0xF5, 0xA5, 0x26,
+        0xAC, 0x2F, 0x7F, 0xFC, 0xDF, 0x5C, 0x0C, 0x8F, 0x4A, 0xC9, 0x99, 0x1A,
+        0x39, 0xBA, 0xEA, 0x69, 0xB5, 0x36, 0x66, 0xE5, 0xC6, 0x45, 0x15, 0x96,
+        0x53, 0xD0, 0x80, 0x03, 0x20, 0xA3, 0xF3, 0x70, 0x9E, 0x1D, 0x4D, 0xCE,
+        0xED, 0x6E, 0x3E, 0xBD, 0x78, 0xFB, 0xAB, 0x28, 0x0B, 0x88, 0xD8, 0x5B,
+        0x87, 0x04, 0x54, 0xD7, 0xF4, 0x77, 0x27, 0xA4, 0x61, 0xE2, 0xB2, 0x31,
+        0x12, 0x91, 0xC1, 0x42,
+    },
+    {
+        0x00, 0x45, 0x8A, 0xCF, 0xC1, 0x84, 0x4B, 0x0E, 0x57, 0x12, 0xDD, 0x98,
+        0x96, 0xD3, 0x1C, 0x59, 0xAE, 0xEB, 0x24, 0x61, 0x6F, 0x2A, 0xE5, 0xA0,
+        0xF9, 0xBC, 0x73, 0x36, 0x38, 0x7D, 0xB2, 0xF7, 0x89, 0xCC, 0x03, 0x46,
+        0x48, 0x0D, 0xC2, 0x87, 0xDE, 0x9B, 0x54, 0x11, 0x1F, 0x5A, 0x95, 0xD0,
+        0x27, 0x62, 0xAD, 0xE8, 0xE6, 0xA3, 0x6C, 0x29, 0x70, 0x35, 0xFA, 0xBF,
+        0xB1, 0xF4, 0x3B, 0x7E, 0xC7, 0x82, 0x4D, 0x08, 0x06, 0x43, 0x8C, 0xC9,
+        0x90, 0xD5, 0x1A, 0x5F, 0x51, 0x14, 0xDB, 0x9E, 0x69, 0x2C, 0xE3, 0xA6,
+        0xA8, 0xED, 0x22, 0x67, 0x3E, 0x7B, 0xB4, 0xF1, 0xFF, 0xBA, 0x75, 0x30,
+        0x4E, 0x0B, 0xC4, 0x81, 0x8F, 0xCA, 0x05, 0x40, 0x19, 0x5C, 0x93, 0xD6,
+        0xD8, 0x9D, 0x52, 0x17, 0xE0, 0xA5, 0x6A, 0x2F, 0x21, 0x64, 0xAB, 0xEE,
+        0xB7, 0xF2, 0x3D, 0x78, 0x76, 0x33, 0xFC, 0xB9, 0x5B, 0x1E, 0xD1, 0x94,
+        0x9A, 0xDF, 0x10, 0x55, 0x0C, 0x49, 0x86, 0xC3, 0xCD, 0x88, 0x47, 0x02,
+        0xF5, 0xB0, 0x7F, 0x3A, 0x34, 0x71, 0xBE, 0xFB, 0xA2, 0xE7, 0x28, 0x6D,
+        0x63, 0x26, 0xE9, 0xAC, 0xD2, 0x97, 0x58, 0x1D, 0x13, 0x56, 0x99, 0xDC,
+        0x85, 0xC0, 0x0F, 0x4A, 0x44, 0x01, 0xCE, 0x8B, 0x7C, 0x39, 0xF6, 0xB3,
+        0xBD, 0xF8, 0x37, 0x72, 0x2B, 0x6E, 0xA1, 0xE4, 0xEA, 0xAF, 0x60, 0x25,
+        0x9C, 0xD9, 0x16, 0x53, 0x5D, 0x18, 0xD7, 0x92, 0xCB, 0x8E, 0x41, 0x04,
+        0x0A, 0x4F, 0x80, 0xC5, 0x32, 0x77, 0xB8, 0xFD, 0xF3, 0xB6, 0x79, 0x3C,
+        0x65, 0x20, 0xEF, 0xAA, 0xA4, 0xE1, 0x2E, 0x6B, 0x15, 0x50, 0x9F, 0xDA,
+        0xD4, 0x91, 0x5E, 0x1B, 0x42, 0x07, 0xC8, 0x8D, 0x83, 0xC6, 0x09, 0x4C,
+        0xBB, 0xFE, 0x31, 0x74, 0x7A, 0x3F, 0xF0, 0xB5, 0xEC, 0xA9, 0x66, 0x23,
+        0x2D, 0x68, 0xA7, 0xE2,
+    },
+#endif
+};
+
+static const uint8_t crc8_table[256] = {
+    0x00, 0x07, 0x0E, 0x09, 0x1C, 0x1B, 0x12, 0x15, 0x38, 0x3F, 0x36, 0x31,
+    0x24, 0x23, 0x2A, 0x2D, 0x70, 0x77, 0x7E, 0x79, 0x6C, 0x6B, 0x62, 0x65,
+    0x48, 0x4F, 0x46, 0x41, 0x54, 0x53, 0x5A, 0x5D, 0xE0, 0xE7, 0xEE, 0xE9,
+    0xFC, 0xFB, 0xF2, 0xF5, 0xD8, 0xDF, 0xD6, 0xD1, 0xC4, 0xC3, 0xCA, 0xCD,
+    0x90, 0x97, 0x9E, 0x99, 0x8C, 0x8B, 0x82, 0x85, 0xA8, 0xAF, 0xA6, 0xA1,
+    0xB4, 0xB3, 0xBA, 0xBD, 0xC7, 0xC0, 0xC9, 0xCE, 0xDB, 0xDC, 0xD5, 0xD2,
+    0xFF, 0xF8, 0xF1, 0xF6, 0xE3, 0xE4, 0xED, 0xEA, 0xB7, 0xB0, 0xB9, 0xBE,
+    0xAB, 0xAC, 0xA5, 0xA2, 0x8F, 0x88, 0x81, 0x86, 0x93, 0x94, 0x9D, 0x9A,
+    0x27, 0x20, 0x29, 0x2E, 0x3B, 0x3C, 0x35, 0x32, 0x1F, 0x18, 0x11, 0x16,
+    0x03, 0x04, 0x0D, 0x0A, 0x57, 0x50, 0x59, 0x5E, 0x4B, 0x4C, 0x45, 0x42,
+    0x6F, 0x68, 0x61, 0x66, 0x73, 0x74, 0x7D, 0x7A, 0x89, 0x8E, 0x87, 0x80,
+    0x95, 0x92, 0x9B, 0x9C, 0xB1, 0xB6, 0xBF, 0xB8, 0xAD, 0xAA, 0xA3, 0xA4,
+    0xF9, 0xFE, 0xF7, 0xF0, 0xE5, 0xE2, 0xEB, 0xEC, 0xC1, 0xC6, 0xCF, 0xC8,
+    0xDD, 0xDA, 0xD3, 0xD4, 0x69, 0x6E, 0x67, 0x60, 0x75, 0x72, 0x7B, 0x7C,
+    0x51, 0x56, 0x5F, 0x58, 0x4D, 0x4A, 0x43, 0x44, 0x19, 0x1E, 0x17, 0x10,
+    0x05, 0x02, 0x0B, 0x0C, 0x21, 0x26, 0x2F, 0x28, 0x3D, 0x3A, 0x33, 0x34,
+    0x4E, 0x49, 0x40, 0x47, 0x52, 0x55, 0x5C, 0x5B, 0x76, 0x71, 0x78, 0x7F,
+    0x6A, 0x6D, 0x64, 0x63, 0x3E, 0x39, 0x30, 0x37, 0x22, 0x25, 0x2C, 0x2B,
+    0x06, 0x01, 0x08, 0x0F, 0x1A, 0x1D, 0x14, 0x13, 0xAE, 0xA9, 0xA0, 0xA7,
+    0xB2, 0xB5, 0xBC, 0xBB, 0x96, 0x91, 0x98, 0x9F, 0x8A, 0x8D, 0x84, 0x83,
+    0xDE, 0xD9, 0xD0, 0xD7, 0xC2, 0xC5, 0xCC, 0xCB, 0xE6, 0xE1, 0xE8, 0xEF,
+    0xFA, 0xFD, 0xF4, 0xF3,
+};
 
 uint16_t crc16_ccitt(uint16_t crc, unsigned char a)
 {
-    crc ^= (uint16_t)a << 8;
-    for (int ii = 0; ii < 8; ++ii) {
-        if (crc & 0x8000) {
-            crc = (crc << 1) ^ 0x1021;
-        } else {
-            crc = crc << 1;
-        }
-    }
-    return crc;
+    return (crc << 8) ^ crc16_ccitt_table[0][(crc >> 8) ^ a];
 }
 
-uint16_t crc16_ccitt_update(uint16_t crc, const void *data, uint32_t length)
+static uint16_t crc16_ccitt_update_sw(uint16_t crc, const uint8_t *p, uint32_t length)
 {
-    const uint8_t *p = (const uint8_t *)data;
-    const uint8_t *pend = p + length;
+#ifdef USE_CRC_SLICE_BY_4
+    for (; length >= 4; length -= 4, p += 4) {
+        crc = crc16_ccitt_table[3][(crc >> 8) ^ p[0]] ^
+              crc16_ccitt_table[2][(crc & 0xFF) ^ p[1]] ^
+              crc16_ccitt_table[1][p[2]] ^
+              crc16_ccitt_table[0][p[3]];
+    }
+#endif
 
-    for (; p != pend; p++) {
+    for (; length > 0; length--, p++) {
         crc = crc16_ccitt(crc, *p);
     }
     return crc;
 }
 
-void crc16_ccitt_sbuf_append(sbuf_t *dst, uint8_t *start)
+uint16_t crc16_ccitt_update(uint16_t crc, const void *data, uint32_t length)
 {
-    uint16_t crc = 0;
-    const uint8_t * const end = sbufPtr(dst);
-    for (const uint8_t *ptr = start; ptr < end; ++ptr) {
-        crc = crc16_ccitt(crc, *ptr);
+#ifdef USE_CRC_HW
+    if (crcHwVerified && length >= CRC_HW_MIN_LENGTH && crcHwCrc16Ccitt(&crc, data, length)) {
+        return crc;
     }
+#endif
+
+    return crc16_ccitt_update_sw(crc, data, length);
+}
+
+void crc16_ccitt_sbuf_append(sbuf_t *dst, uint8_t *start)
+{
+    const uint16_t crc = crc16_ccitt_update(0, start, sbufPtr(dst) - start);
     sbufWriteU16(dst, crc);
 }
 
 uint8_t crc8_dvb_s2(uint8_t crc, unsigned char a)
 {
-    crc ^= a;
-    for (int ii = 0; ii < 8; ++ii) {
-        if (crc & 0x80) {
-            crc = (crc << 1) ^ 0xD5;
-        } else {
-            crc = crc << 1;
-        }
-    }
-    return crc;
+    return crc8_dvb_s2_table[0][crc ^ a];
 }
 
-uint8_t crc8_dvb_s2_update(uint8_t crc, const void *data, uint32_t length)
+static uint8_t crc8_dvb_s2_update_sw(uint8_t crc, const uint8_t *p, uint32_t length)
 {
-    const uint8_t *p = (const uint8_t *)data;
-    const uint8_t *pend = p + length;
+#ifdef USE_CRC_SLICE_BY_4
+    for (; length >= 4; length -= 4, p += 4) {
+        crc = crc8_dvb_s2_table[3][crc ^ p[0]] ^
+              crc8_dvb_s2_table[2][p[1]] ^
+              crc8_dvb_s2_table[1][p[2]] ^
+              crc8_dvb_s2_table[0][p[3]];
+    }
+#endif
 
-    for (; p != pend; p++) {
+    for (; length > 0; length--, p++) {
         crc = crc8_dvb_s2(crc, *p);
     }
     return crc;
 }
 
-void crc8_dvb_s2_sbuf_append(sbuf_t *dst, uint8_t *start)
+uint8_t crc8_dvb_s2_update(uint8_t crc, const void *data, uint32_t length)
 {
-    uint8_t crc = 0;
-    const uint8_t * const end = dst->ptr;
-    for (const uint8_t *ptr = start; ptr < end; ++ptr) {
-        crc = crc8_dvb_s2(crc, *ptr);
+#ifdef USE_CRC_HW
+    if (crcHwVerified && length >= CRC_HW_MIN_LENGTH && crcHwCrc8DvbS2(&crc, data, length)) {
+        return crc;
     }
+#endif
+
+    return crc8_dvb_s2_update_sw(crc, data, length);
+}
+
+void crc8_dvb_s2_sbuf_append(sbuf_t *dst, uint8_t *start)
+{
+    const uint8_t crc = crc8_dvb_s2_update(0, start, dst->ptr - start);
     sbufWriteU8(dst, crc);
 }
 
 uint8_t crc8_xor_update(uint8_t crc, const void *data, uint32_t length)
 {
     const uint8_t *p = (const uint8_t *)data;
-    const uint8_t *pend = p + length;
+    uint32_t acc = 0;
 
-    for (; p != pend; p++) {
+    // XOR is position independent, fold a word at a time and reduce at the end
+    for (; length >= 4; length -= 4, p += 4) {
+        uint32_t word;
+        memcpy(&word, p, sizeof(word));
+        acc ^= word;
+    }
+    acc ^= acc >> 16;
+    acc ^= acc >> 8;
+    crc ^= (uint8_t)acc;
+
+    for (; length > 0; length--, p++) {
         crc ^= *p;
     }
     return crc;
@@ -102,24 +408,13 @@ uint8_t crc8_xor_update(uint8_t crc, const void *data, uint32_t length)
 
 void crc8_xor_sbuf_append(sbuf_t *dst, uint8_t *start)
 {
-    uint8_t crc = 0;
-    const uint8_t *end = dst->ptr;
-    for (uint8_t *ptr = start; ptr < end; ++ptr) {
-        crc ^= *ptr;
-    }
+    const uint8_t crc = crc8_xor_update(0, start, dst->ptr - start);
     sbufWriteU8(dst, crc);
 }
 
 uint8_t crc8(uint8_t crc, uint8_t a)
 {
-    uint8_t crc_u = a;
-    crc_u ^= crc;
-
-    for (int i=0; i<8; i++) {
-        crc_u = ( crc_u & 0x80 ) ? 0x7 ^ ( crc_u << 1 ) : ( crc_u << 1 );
-    }
-
-    return crc_u;
+    return crc8_table[crc ^ a];
 }
 
 uint8_t crc8_update(uint8_t crc, const void *data, uint32_t length)
@@ -142,4 +437,24 @@ uint8_t crc8_sum_update(uint8_t crc, const void *data, uint32_t length)
         crc += *p;
     }
     return crc;
-}
\ No newline at end of file
+}
+
+/*
+ * Run once at boot, before the config is read. The CRC unit is only used if
+ * it matches the software implementation on a buffer with an odd length and
+ * non-zero initial value, otherwise everything stays in software.
+ */
+void crcInit(void)
+{
+#ifdef USE_CRC_HW
+    uint8_t pattern[CRC_HW_MIN_LENGTH + 3];
+    for (unsigned i = 0; i < sizeof(pattern); i++) {
+        pattern[i] = i * 37 + 11;
+    }
+
+    uint16_t crc16 = 0x1D0F;
+    uint8_t crc8 = 0x5A;
+    crcHwVerified = crcHwCrc16Ccitt(&crc16, pattern, sizeof(pattern)) && crc16 == crc16_ccitt_update_sw(0x1D0F, pattern, sizeof(pattern)) &&
+                    crcHwCrc8DvbS2(&crc8, pattern, sizeof(pattern)) && crc8 == crc8_dvb_s2_update_sw(0x5A, pattern, sizeof(pattern));
+#endif
+}
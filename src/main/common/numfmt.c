@@ -0,0 +1,138 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "common/numfmt.h"
+
+// Writes the digits of value backwards, ending right before end. Returns the number of digits.
+static int writeDigitsBackwards(char *end, uint32_t value)
+{
+    char *ptr = end;
+    do {
+        *--ptr = '0' + (value % 10);
+        value /= 10;
+    } while (value);
+    return end - ptr;
+}
+
+static int formatMagnitude(char *buf, uint32_t magnitude, bool negative, uint8_t width, char pad)
+{
+    char digits[10];
+    const int digitCount = writeDigitsBackwards(digits + sizeof(digits), magnitude);
+    const int length = digitCount + (negative ? 1 : 0);
+    int padding = width > length ? width - length : 0;
+    char *ptr = buf;
+
+    if (pad == '0') {
+        // Zero padding goes between the sign and the digits
+        if (negative) {
+            *ptr++ = '-';
+        }
+        memset(ptr, '0', padding);
+        ptr += padding;
+    } else {
+        memset(ptr, pad, padding);
+        ptr += padding;
+        if (negative) {
+            *ptr++ = '-';
+        }
+    }
+
+    memcpy(ptr, digits + sizeof(digits) - digitCount, digitCount);
+    ptr += digitCount;
+    *ptr = '\0';
+
+    return ptr - buf;
+}
+
+int numfmtUnsigned(char *buf, uint32_t value, uint8_t width, char pad)
+{
+    return formatMagnitude(buf, value, false, width, pad);
+}
+
+int numfmtSigned(char *buf, int32_t value, uint8_t width, char pad)
+{
+    // Negate in unsigned arithmetic so INT32_MIN is handled
+    const uint32_t magnitude = value < 0 ? 0U - (uint32_t)value : (uint32_t)value;
+    return formatMagnitude(buf, magnitude, value < 0, width, pad);
+}
+
+int numfmtFixed(char *buf, int32_t value, uint8_t decimals, uint8_t width)
+{
+    if (decimals == 0) {
+        return numfmtSigned(buf, value, width, ' ');
+    }
+    if (decimals > NUMFMT_MAX_DECIMALS) {
+        decimals = NUMFMT_MAX_DECIMALS;
+    }
+
+    char digits[NUMFMT_MAX_DECIMALS + 1];
+    const bool negative = value < 0;
+    const uint32_t magnitude = negative ? 0U - (uint32_t)value : (uint32_t)value;
+    int digitCount = writeDigitsBackwards(digits + sizeof(digits), magnitude);
+
+    // Always have at least one integer digit: 5 with 2 decimals is "0.05"
+    while (digitCount <= decimals) {
+        digits[sizeof(digits) - ++digitCount] = '0';
+    }
+
+    const int integerDigits = digitCount - decimals;
+    const int length = digitCount + 1 + (negative ? 1 : 0);
+    int padding = width > length ? width - length : 0;
+    const char *src = digits + sizeof(digits) - digitCount;
+    char *ptr = buf;
+
+    memset(ptr, ' ', padding);
+    ptr += padding;
+    if (negative) {
+        *ptr++ = '-';
+    }
+    memcpy(ptr, src, integerDigits);
+    ptr += integerDigits;
+    *ptr++ = '.';
+    memcpy(ptr, src + integerDigits, decimals);
+    ptr += decimals;
+    *ptr = '\0';
+
+    return ptr - buf;
+}
+
+int numfmtCentered(char *buf, const char *str, uint8_t width)
+{
+    const int length = strlen(str);
+    if (length >= width) {
+        memcpy(buf, str, length + 1);
+        return length;
+    }
+
+    const int left = (width - length) / 2;
+    memset(buf, ' ', width);
+    memcpy(buf + left, str, length);
+    buf[width] = '\0';
+
+    return width;
+}
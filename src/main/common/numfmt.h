@@ -0,0 +1,47 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Typed integer to ASCII conversion for display and CLI output. These
+ * replace runtime format string parsing on hot paths. All functions write
+ * straight into buf, null terminate it and return the number of characters
+ * written (excluding the terminator). A value wider than the requested
+ * width is never truncated, like printf() does.
+ */
+
+#define NUMFMT_INT32_MAX_CHARS 11 // "-2147483648"
+#define NUMFMT_MAX_DECIMALS 10
+
+// Equivalent of "%<width>u" (pad = ' ') or "%0<width>u" (pad = '0')
+int numfmtUnsigned(char *buf, uint32_t value, uint8_t width, char pad);
+// Equivalent of "%<width>d" (pad = ' ') or "%0<width>d" (pad = '0')
+int numfmtSigned(char *buf, int32_t value, uint8_t width, char pad);
+// Fixed point value with the given number of decimals, e.g. (1234, 2) -> "12.34", right aligned to width
+int numfmtFixed(char *buf, int32_t value, uint8_t decimals, uint8_t width);
+// Copies str into a field of width characters, centered and padded with spaces
+int numfmtCentered(char *buf, const char *str, uint8_t width);
@@ -25,6 +25,7 @@
 #include "build/build_config.h"
 
 #include "common/crc.h"
+#include "common/maths.h"
 #include "common/utils.h"
 
 #include "config/config_eeprom.h"
@@ -33,6 +34,7 @@
 
 #include "drivers/system.h"
 #include "drivers/flash.h"
+#include "drivers/time.h"
 
 #include "fc/config.h"
 
@@ -40,6 +42,12 @@
     void config_streamer_impl_unlock(void);
 #endif
 
+#ifdef UNIT_TEST
+// Provided by target/common_post.h, which the unit test platform does not include
+extern uint8_t __config_start;
+extern uint8_t __config_end;
+#endif
+
 static uint16_t eepromConfigSize;
 
 typedef enum {
@@ -340,3 +348,215 @@ void writeConfigToEEPROM(void)
     // Flash write failed - just die now
     failureMode(FAILURE_FLASH_WRITE_FAILED);
 }
+
+const uint8_t *configSnapshotData(void)
+{
+    return &__config_start;
+}
+
+// Snapshot import. The incoming stream has the same layout as the one produced by
+// writeSettingsToEEPROM(); it is parsed incrementally as chunks arrive and every record
+// is staged into the PG copy area. Live config is only touched once the footer and
+// checksum have been verified, so an aborted or corrupted transfer leaves it intact.
+// CLI dump/diff use the same copy area and are refused while an import is active; an
+// import the client abandoned releases it after a timeout.
+#define CONFIG_SNAPSHOT_IMPORT_TIMEOUT_MS   5000
+
+typedef enum {
+    SNAPSHOT_STATE_HEADER = 0,
+    SNAPSHOT_STATE_RECORD_HEADER,
+    SNAPSHOT_STATE_RECORD_DATA,
+    SNAPSHOT_STATE_CHECKSUM,
+    SNAPSHOT_STATE_DONE,
+    SNAPSHOT_STATE_FAILED,
+} configSnapshotState_e;
+
+static struct {
+    configSnapshotState_e state;
+    configSnapshotStatus_e error;
+    uint32_t offset;
+    uint16_t crc;
+    uint8_t buf[sizeof(configRecord_t)];    // partially received record header or checksum
+    uint8_t bufLen;
+    uint8_t *stage;                         // destination of current record payload, NULL to skip it
+    uint16_t remaining;                     // payload bytes left in current record
+    uint16_t failedPgn;
+    bool active;                            // staged config occupies the PG copy area
+    timeMs_t lastChunkMs;
+} snapshotImport;
+
+static void configSnapshotFail(configSnapshotStatus_e error, pgn_t pgn)
+{
+    snapshotImport.state = SNAPSHOT_STATE_FAILED;
+    snapshotImport.error = error;
+    snapshotImport.failedPgn = pgn;
+    snapshotImport.active = false;
+}
+
+bool configSnapshotImportActive(void)
+{
+    if (snapshotImport.active && millis() - snapshotImport.lastChunkMs > CONFIG_SNAPSHOT_IMPORT_TIMEOUT_MS) {
+        configSnapshotFail(CONFIG_SNAPSHOT_ERROR_TIMEOUT, 0);
+    }
+    return snapshotImport.active;
+}
+
+static void configSnapshotBeginRecord(const configRecord_t *record)
+{
+    const pgRegistry_t *reg = pgFind(record->pgn);
+    const configRecordFlags_e classification = record->flags & CR_CLASSIFICATION_MASK;
+
+    snapshotImport.remaining = record->size - sizeof(configRecord_t);
+    snapshotImport.stage = NULL;
+
+    if (!reg) {
+        // PG not compiled into this build, loadEEPROM() would ignore it as well
+        return;
+    }
+
+    if (record->version != pgVersion(reg) || snapshotImport.remaining != pgSize(reg)) {
+        configSnapshotFail(CONFIG_SNAPSHOT_ERROR_PG_VERSION, record->pgn);
+        return;
+    }
+
+    if (pgIsSystem(reg)) {
+        if (classification != CR_CLASSICATION_SYSTEM) {
+            configSnapshotFail(CONFIG_SNAPSHOT_ERROR_FORMAT, record->pgn);
+            return;
+        }
+        snapshotImport.stage = reg->copy;
+    } else {
+        if (classification == CR_CLASSICATION_SYSTEM) {
+            configSnapshotFail(CONFIG_SNAPSHOT_ERROR_FORMAT, record->pgn);
+            return;
+        }
+        snapshotImport.stage = reg->copy + pgSize(reg) * (classification - CR_CLASSICATION_PROFILE1);
+    }
+}
+
+static void configSnapshotCommit(void)
+{
+    PG_FOREACH(reg) {
+        const uint16_t instances = pgIsSystem(reg) ? 1 : MAX_PROFILE_COUNT;
+        memcpy(reg->address, reg->copy, pgSize(reg) * instances);
+    }
+}
+
+void configSnapshotImportStart(void)
+{
+    memset(&snapshotImport, 0, sizeof(snapshotImport));
+    snapshotImport.active = true;
+    snapshotImport.lastChunkMs = millis();
+
+    // PGs or profiles missing from the snapshot end up at defaults, same as loadEEPROM()
+    PG_FOREACH(reg) {
+        const uint16_t instances = pgIsSystem(reg) ? 1 : MAX_PROFILE_COUNT;
+        for (uint16_t i = 0; i < instances; i++) {
+            pgResetCopy(reg->copy + pgSize(reg) * i, pgN(reg));
+        }
+    }
+}
+
+configSnapshotStatus_e configSnapshotImportWrite(uint32_t offset, const uint8_t *data, uint16_t len)
+{
+    if (!configSnapshotImportActive() && snapshotImport.state != SNAPSHOT_STATE_DONE) {
+        return snapshotImport.state == SNAPSHOT_STATE_FAILED ? snapshotImport.error : CONFIG_SNAPSHOT_ERROR_OFFSET;
+    }
+
+    if (offset != snapshotImport.offset) {
+        return CONFIG_SNAPSHOT_ERROR_OFFSET;
+    }
+
+    snapshotImport.lastChunkMs = millis();
+
+    while (len > 0 && snapshotImport.state < SNAPSHOT_STATE_DONE) {
+        if (snapshotImport.state == SNAPSHOT_STATE_RECORD_DATA) {
+            const uint16_t take = MIN(len, snapshotImport.remaining);
+            if (snapshotImport.stage) {
+                memcpy(snapshotImport.stage, data, take);
+                snapshotImport.stage += take;
+            }
+            snapshotImport.crc = crc16_ccitt_update(snapshotImport.crc, data, take);
+            snapshotImport.remaining -= take;
+            snapshotImport.offset += take;
+            data += take;
+            len -= take;
+            if (snapshotImport.remaining == 0) {
+                snapshotImport.state = SNAPSHOT_STATE_RECORD_HEADER;
+            }
+            continue;
+        }
+
+        const uint8_t c = *data++;
+        len--;
+        snapshotImport.offset++;
+        snapshotImport.buf[snapshotImport.bufLen++] = c;
+
+        switch (snapshotImport.state) {
+        case SNAPSHOT_STATE_HEADER:
+            if (c != EEPROM_CONF_VERSION) {
+                configSnapshotFail(CONFIG_SNAPSHOT_ERROR_FORMAT, 0);
+                break;
+            }
+            snapshotImport.crc = crc16_ccitt(snapshotImport.crc, c);
+            snapshotImport.bufLen = 0;
+            snapshotImport.state = SNAPSHOT_STATE_RECORD_HEADER;
+            break;
+
+        case SNAPSHOT_STATE_RECORD_HEADER:
+            snapshotImport.crc = crc16_ccitt(snapshotImport.crc, c);
+            if (snapshotImport.bufLen == sizeof(configFooter_t)) {
+                const uint16_t size = snapshotImport.buf[0] | (snapshotImport.buf[1] << 8);
+                if (size == 0) {
+                    // footer terminator, checksum follows
+                    snapshotImport.bufLen = 0;
+                    snapshotImport.state = SNAPSHOT_STATE_CHECKSUM;
+                } else if (size < sizeof(configRecord_t)) {
+                    configSnapshotFail(CONFIG_SNAPSHOT_ERROR_FORMAT, 0);
+                }
+            } else if (snapshotImport.bufLen == sizeof(configRecord_t)) {
+                configRecord_t record;
+                memcpy(&record, snapshotImport.buf, sizeof(record));
+                snapshotImport.bufLen = 0;
+                snapshotImport.state = SNAPSHOT_STATE_RECORD_DATA;
+                configSnapshotBeginRecord(&record);
+                if (snapshotImport.state == SNAPSHOT_STATE_RECORD_DATA && snapshotImport.remaining == 0) {
+                    snapshotImport.state = SNAPSHOT_STATE_RECORD_HEADER;
+                }
+            }
+            break;
+
+        case SNAPSHOT_STATE_CHECKSUM:
+            if (snapshotImport.bufLen == sizeof(uint16_t)) {
+                const uint16_t checkSum = snapshotImport.buf[0] | (snapshotImport.buf[1] << 8);
+                if (checkSum != snapshotImport.crc) {
+                    configSnapshotFail(CONFIG_SNAPSHOT_ERROR_CRC, 0);
+                    break;
+                }
+                configSnapshotCommit();
+                snapshotImport.state = SNAPSHOT_STATE_DONE;
+                snapshotImport.active = false;
+            }
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    if (snapshotImport.state == SNAPSHOT_STATE_FAILED) {
+        return snapshotImport.error;
+    }
+
+    return snapshotImport.state == SNAPSHOT_STATE_DONE ? CONFIG_SNAPSHOT_COMPLETE : CONFIG_SNAPSHOT_IN_PROGRESS;
+}
+
+uint32_t configSnapshotImportOffset(void)
+{
+    return snapshotImport.offset;
+}
+
+uint16_t configSnapshotImportFailedPgn(void)
+{
+    return snapshotImport.failedPgn;
+}
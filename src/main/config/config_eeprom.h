@@ -27,3 +27,22 @@ bool isEEPROMContentValid(void);
 bool loadEEPROM(void);
 void writeConfigToEEPROM(void);
 uint16_t getEEPROMConfigSize(void);
+
+typedef enum {
+    CONFIG_SNAPSHOT_IN_PROGRESS = 0,    // chunk accepted, more data expected
+    CONFIG_SNAPSHOT_COMPLETE,           // footer and checksum verified, staged config committed
+    CONFIG_SNAPSHOT_ERROR_OFFSET,       // chunk does not continue the stream, resend from expected offset
+    CONFIG_SNAPSHOT_ERROR_FORMAT,       // header format, record layout or classification invalid
+    CONFIG_SNAPSHOT_ERROR_PG_VERSION,   // known PG with different version or size
+    CONFIG_SNAPSHOT_ERROR_CRC,          // stream checksum mismatch
+    CONFIG_SNAPSHOT_ERROR_TIMEOUT,      // no chunk received for too long, import abandoned
+} configSnapshotStatus_e;
+
+// Saved config stream (header, PG records, footer and checksum) as written by writeConfigToEEPROM()
+const uint8_t *configSnapshotData(void);
+
+void configSnapshotImportStart(void);
+bool configSnapshotImportActive(void);
+configSnapshotStatus_e configSnapshotImportWrite(uint32_t offset, const uint8_t *data, uint16_t len);
+uint32_t configSnapshotImportOffset(void);
+uint16_t configSnapshotImportFailedPgn(void);
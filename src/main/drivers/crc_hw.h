@@ -0,0 +1,39 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Below this length table driven software CRC is faster than setting up the peripheral
+#define CRC_HW_MIN_LENGTH   64
+
+/*
+ * CRC calculation on the MCU CRC unit, for MCUs with programmable polynomial.
+ * Return false if the unit is busy (e.g. used by an interrupted context),
+ * the caller is expected to fall back to software calculation.
+ */
+bool crcHwCrc16Ccitt(uint16_t *crc, const uint8_t *data, uint32_t length);
+bool crcHwCrc8DvbS2(uint8_t *crc, const uint8_t *data, uint32_t length);
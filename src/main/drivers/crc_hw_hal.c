@@ -0,0 +1,129 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_CRC_HW
+
+#include "build/atomic.h"
+
+#include "drivers/crc_hw.h"
+#include "drivers/nvic.h"
+#include "drivers/rcc.h"
+
+#if defined(STM32H7)
+#include "stm32h7xx_ll_crc.h"
+#define CRC_HW_RCC  RCC_AHB4(CRC)
+#elif defined(STM32F7)
+#include "stm32f7xx_ll_crc.h"
+#define CRC_HW_RCC  RCC_AHB1(CRC)
+#else
+#error "CRC unit with programmable polynomial is not available on this MCU"
+#endif
+
+static bool crcHwInitialized = false;
+static volatile bool crcHwBusy = false;
+
+static bool crcHwAcquire(void)
+{
+    bool acquired = false;
+
+    ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+        if (!crcHwBusy) {
+            crcHwBusy = true;
+            acquired = true;
+        }
+    }
+
+    if (acquired && !crcHwInitialized) {
+        RCC_ClockCmd(CRC_HW_RCC, ENABLE);
+        crcHwInitialized = true;
+    }
+
+    return acquired;
+}
+
+static void crcHwRelease(void)
+{
+    crcHwBusy = false;
+}
+
+static void crcHwSetup(uint32_t polySize, uint32_t poly, uint32_t init)
+{
+    // Non-reflected, no final XOR - matches the software MSB-first implementations
+    LL_CRC_SetPolynomialSize(CRC, polySize);
+    LL_CRC_SetPolynomialCoef(CRC, poly);
+    LL_CRC_SetInputDataReverseMode(CRC, LL_CRC_INDATA_REVERSE_NONE);
+    LL_CRC_SetOutputDataReverseMode(CRC, LL_CRC_OUTDATA_REVERSE_NONE);
+    LL_CRC_SetInitialData(CRC, init);
+    LL_CRC_ResetCRCCalculationUnit(CRC);
+}
+
+static void crcHwFeed(const uint8_t *data, uint32_t length)
+{
+    // Unit consumes 32-bit writes MSB first, byte swap so memory order is preserved
+    for (; length >= 4; length -= 4, data += 4) {
+        uint32_t word;
+        memcpy(&word, data, sizeof(word));
+        LL_CRC_FeedData32(CRC, __REV(word));
+    }
+
+    for (; length > 0; length--, data++) {
+        LL_CRC_FeedData8(CRC, *data);
+    }
+}
+
+bool crcHwCrc16Ccitt(uint16_t *crc, const uint8_t *data, uint32_t length)
+{
+    if (!crcHwAcquire()) {
+        return false;
+    }
+
+    crcHwSetup(LL_CRC_POLYLENGTH_16B, 0x1021, *crc);
+    crcHwFeed(data, length);
+    *crc = LL_CRC_ReadData16(CRC);
+
+    crcHwRelease();
+    return true;
+}
+
+bool crcHwCrc8DvbS2(uint8_t *crc, const uint8_t *data, uint32_t length)
+{
+    if (!crcHwAcquire()) {
+        return false;
+    }
+
+    crcHwSetup(LL_CRC_POLYLENGTH_8B, 0xD5, *crc);
+    crcHwFeed(data, length);
+    *crc = LL_CRC_ReadData8(CRC);
+
+    crcHwRelease();
+    return true;
+}
+
+#endif
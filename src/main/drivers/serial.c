@@ -71,6 +71,20 @@ uint8_t serialRead(serialPort_t *instance)
     return instance->vTable->serialRead(instance);
 }
 
+uint32_t serialReadBuf(serialPort_t *instance, uint8_t *data, uint32_t maxLength)
+{
+    uint32_t count = serialRxBytesWaiting(instance);
+    if (count > maxLength) {
+        count = maxLength;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        data[i] = serialRead(instance);
+    }
+
+    return count;
+}
+
 void serialSetBaudRate(serialPort_t *instance, uint32_t baudRate)
 {
     instance->vTable->serialSetBaudRate(instance, baudRate);
@@ -124,3 +138,29 @@ bool serialIsIdle(serialPort_t *instance)
     else
         return false;
 }
+
+bool serialSetRxFrameCallback(serialPort_t *instance, serialReceiveFrameCallbackPtr callback)
+{
+    if (instance->vTable->setRxFrameCallback)
+        return instance->vTable->setRxFrameCallback(instance, callback);
+    else
+        return false;
+}
+
+void serialFrameReceiveByte(serialPort_t *instance, uint8_t ch)
+{
+    instance->rxBuffer[instance->rxBufferHead++] = ch;
+
+    // Buffer full without seeing line idle, hand over what we have
+    if (instance->rxBufferHead >= instance->rxBufferSize) {
+        serialFrameReceiveIdle(instance);
+    }
+}
+
+void serialFrameReceiveIdle(serialPort_t *instance)
+{
+    if (instance->rxBufferHead > 0) {
+        instance->rxFrameCallback((const uint8_t *)instance->rxBuffer, instance->rxBufferHead, instance->rxCallbackData);
+        instance->rxBufferHead = 0;
+    }
+}
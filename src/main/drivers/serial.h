@@ -56,6 +56,8 @@ typedef enum portOptions_t {
 } portOptions_t;
 
 typedef void (*serialReceiveCallbackPtr)(uint16_t data, void *rxCallbackData);   // used by serial drivers to return frames to app
+// Used by serial drivers to return a complete burst of bytes, delimited by line idle, to the app
+typedef void (*serialReceiveFrameCallbackPtr)(const uint8_t *data, uint16_t length, void *rxCallbackData);
 
 typedef struct serialPort_s {
 
@@ -77,6 +79,8 @@ typedef struct serialPort_s {
     uint32_t txBufferTail;
 
     serialReceiveCallbackPtr rxCallback;
+    // When set, RX bytes are collected linearly in rxBuffer and handed over on line idle
+    serialReceiveFrameCallbackPtr rxFrameCallback;
     void *rxCallbackData;
 } serialPort_t;
 
@@ -106,6 +110,9 @@ struct serialPortVTable {
     // Optional functions used to buffer large writes.
     void (*beginWrite)(serialPort_t *instance);
     void (*endWrite)(serialPort_t *instance);
+
+    // Optional frame level RX delivery, returns false if the port can not detect line idle.
+    bool (*setRxFrameCallback)(serialPort_t *instance, serialReceiveFrameCallbackPtr callback);
 };
 
 void serialWrite(serialPort_t *instance, uint8_t ch);
@@ -113,6 +120,7 @@ uint32_t serialRxBytesWaiting(const serialPort_t *instance);
 uint32_t serialTxBytesFree(const serialPort_t *instance);
 void serialWriteBuf(serialPort_t *instance, const uint8_t *data, int count);
 uint8_t serialRead(serialPort_t *instance);
+uint32_t serialReadBuf(serialPort_t *instance, uint8_t *data, uint32_t maxLength);
 void serialSetBaudRate(serialPort_t *instance, uint32_t baudRate);
 void serialSetMode(serialPort_t *instance, portMode_t mode);
 void serialSetOptions(serialPort_t *instance, portOptions_t options);
@@ -121,6 +129,11 @@ void serialPrint(serialPort_t *instance, const char *str);
 uint32_t serialGetBaudRate(serialPort_t *instance);
 bool serialIsConnected(const serialPort_t *instance);
 bool serialIsIdle(serialPort_t *instance);
+bool serialSetRxFrameCallback(serialPort_t *instance, serialReceiveFrameCallbackPtr callback);
+
+// Helpers for drivers implementing frame level RX delivery
+void serialFrameReceiveByte(serialPort_t *instance, uint8_t ch);
+void serialFrameReceiveIdle(serialPort_t *instance);
 
 // A shim that adapts the bufWriter API to the serialWriteBuf() API.
 void serialWriteBufShim(void *instance, const uint8_t *data, int count);
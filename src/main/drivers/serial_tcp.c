@@ -39,6 +39,7 @@
 #include <errno.h>
 #include <netinet/tcp.h>
 
+#include "common/maths.h"
 #include "common/utils.h"
 
 #include "drivers/serial.h"
@@ -120,6 +121,17 @@ static tcpPort_t *tcpReConfigure(tcpPort_t *port, uint32_t id)
 }
 
 void tcpReceiveBytes( tcpPort_t *port, const uint8_t* buffer, ssize_t recvSize ) {
+    // Each recv() chunk stands in for a burst of bytes ended by line idle
+    if (port->serialPort.rxFrameCallback) {
+        while (recvSize > 0) {
+            const uint16_t chunk = MIN(recvSize, (ssize_t)port->serialPort.rxBufferSize);
+            port->serialPort.rxFrameCallback(buffer, chunk, port->serialPort.rxCallbackData);
+            buffer += chunk;
+            recvSize -= chunk;
+        }
+        return;
+    }
+
     for (ssize_t i = 0; i < recvSize; i++) {
         if (port->serialPort.rxCallback) {
             port->serialPort.rxCallback((uint16_t)buffer[i], port->serialPort.rxCallbackData);
@@ -207,6 +219,7 @@ serialPort_t *tcpOpen(USART_TypeDef *USARTx, serialReceiveCallbackPtr callback,
 
     port->serialPort.vTable = tcpVTable;
     port->serialPort.rxCallback = callback;
+    port->serialPort.rxFrameCallback = NULL;
     port->serialPort.rxCallbackData = rxCallbackData;
     port->serialPort.rxBufferHead = port->serialPort.rxBufferTail = 0;
     port->serialPort.rxBufferSize = TCP_BUFFER_SIZE;
@@ -323,6 +336,12 @@ void tcpSetOptions(serialPort_t *instance, portOptions_t options)
     UNUSED(options);
 }
 
+static bool tcpSetRxFrameCallback(serialPort_t *instance, serialReceiveFrameCallbackPtr callback)
+{
+    instance->rxFrameCallback = callback;
+    return true;
+}
+
 static const struct serialPortVTable tcpVTable[] = {
     {
         .serialWrite = tcpWrite,
@@ -338,6 +357,7 @@ static const struct serialPortVTable tcpVTable[] = {
         .beginWrite = NULL,
         .endWrite = NULL,
         .isIdle = NULL,
+        .setRxFrameCallback = tcpSetRxFrameCallback,
     }
 };
 
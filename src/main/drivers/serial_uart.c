@@ -140,6 +140,7 @@ serialPort_t *uartOpen(USART_TypeDef *USARTx, serialReceiveCallbackPtr rxCallbac
     s->port.txBufferHead = s->port.txBufferTail = 0;
     // callback works for IRQ-based RX ONLY
     s->port.rxCallback = rxCallback;
+    s->port.rxFrameCallback = NULL;
     s->port.rxCallbackData = rxCallbackData;
     s->port.mode = mode;
     s->port.baudRate = baudRate;
@@ -253,6 +254,22 @@ bool isUartIdle(serialPort_t *instance)
     }
 }
 
+static bool uartSetRxFrameCallback(serialPort_t *instance, serialReceiveFrameCallbackPtr callback)
+{
+    uartPort_t *s = (uartPort_t *)instance;
+
+    USART_ITConfig(s->USARTx, USART_IT_IDLE, DISABLE);
+    s->port.rxBufferHead = s->port.rxBufferTail = 0;
+    s->port.rxFrameCallback = callback;
+
+    if (callback && (s->port.mode & MODE_RX)) {
+        uartClearIdleFlag(s);
+        USART_ITConfig(s->USARTx, USART_IT_IDLE, ENABLE);
+    }
+
+    return true;
+}
+
 const struct serialPortVTable uartVTable[] = {
     {
         .serialWrite = uartWrite,
@@ -268,5 +285,6 @@ const struct serialPortVTable uartVTable[] = {
         .beginWrite = NULL,
         .endWrite = NULL,
         .isIdle = isUartIdle,
+        .setRxFrameCallback = uartSetRxFrameCallback,
     }
 };
@@ -360,7 +360,9 @@ static uartDevice_t* uartHardwareMap[] = {
 void uartIrqHandler(uartPort_t *s)
 {
     if (usart_flag_get(s->USARTx, USART_RDBF_FLAG) == SET) {
-        if (s->port.rxCallback) {
+        if (s->port.rxFrameCallback) {
+            serialFrameReceiveByte(&s->port, s->USARTx->dt);
+        } else if (s->port.rxCallback) {
             s->port.rxCallback(s->USARTx->dt, s->port.rxCallbackData);
         } else {
             s->port.rxBuffer[s->port.rxBufferHead] = s->USARTx->dt;
@@ -368,6 +370,11 @@ void uartIrqHandler(uartPort_t *s)
         }
     }
 
+    if (s->port.rxFrameCallback && usart_flag_get(s->USARTx, USART_IDLEF_FLAG) == SET) {
+        uartClearIdleFlag(s);
+        serialFrameReceiveIdle(&s->port);
+    }
+
     if (usart_flag_get(s->USARTx, USART_TDBE_FLAG) == SET) {
         if (s->port.txBufferTail != s->port.txBufferHead) {
             usart_data_transmit(s->USARTx, s->port.txBuffer[s->port.txBufferTail]);
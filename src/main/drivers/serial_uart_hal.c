@@ -104,6 +104,11 @@ static void uartReconfigure(uartPort_t *uartPort)
 
         /* Enable the UART Data Register not empty Interrupt */
         SET_BIT(uartPort->USARTx->CR1, USART_CR1_RXNEIE);
+
+        /* Enable the UART Idle Line Interrupt for frame level delivery */
+        if (uartPort->port.rxFrameCallback) {
+            SET_BIT(uartPort->USARTx->CR1, USART_CR1_IDLEIE);
+        }
     }
 
     // Transmit IRQ
@@ -161,6 +166,7 @@ serialPort_t *uartOpen(USART_TypeDef *USARTx, serialReceiveCallbackPtr callback,
     s->port.txBufferHead = s->port.txBufferTail = 0;
     // callback works for IRQ-based RX ONLY
     s->port.rxCallback = callback;
+    s->port.rxFrameCallback = NULL;
     s->port.rxCallbackData = rxCallbackData;
     s->port.mode = mode;
     s->port.baudRate = baudRate;
@@ -264,6 +270,22 @@ bool isUartIdle(serialPort_t *instance)
     }
 }
 
+static bool uartSetRxFrameCallback(serialPort_t *instance, serialReceiveFrameCallbackPtr callback)
+{
+    uartPort_t *s = (uartPort_t *)instance;
+
+    CLEAR_BIT(s->USARTx->CR1, USART_CR1_IDLEIE);
+    s->port.rxBufferHead = s->port.rxBufferTail = 0;
+    s->port.rxFrameCallback = callback;
+
+    if (callback && (s->port.mode & MODE_RX)) {
+        __HAL_UART_CLEAR_IDLEFLAG(&s->Handle);
+        SET_BIT(s->USARTx->CR1, USART_CR1_IDLEIE);
+    }
+
+    return true;
+}
+
 const struct serialPortVTable uartVTable[] = {
     {
         .serialWrite = uartWrite,
@@ -279,5 +301,6 @@ const struct serialPortVTable uartVTable[] = {
         .beginWrite = NULL,
         .endWrite = NULL,
         .isIdle = isUartIdle,
+        .setRxFrameCallback = uartSetRxFrameCallback,
     }
 };
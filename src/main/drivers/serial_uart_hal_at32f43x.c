@@ -143,6 +143,7 @@ serialPort_t *uartOpen(usart_type *USARTx, serialReceiveCallbackPtr rxCallback,
     s->port.txBufferHead = s->port.txBufferTail = 0;
     // callback works for IRQ-based RX ONLY
     s->port.rxCallback = rxCallback;
+    s->port.rxFrameCallback = NULL;
     s->port.rxCallbackData = rxCallbackData;
     s->port.mode = mode;
     s->port.baudRate = baudRate;
@@ -259,6 +260,22 @@ bool isUartIdle(serialPort_t *instance)
     }
 }
 
+static bool uartSetRxFrameCallback(serialPort_t *instance, serialReceiveFrameCallbackPtr callback)
+{
+    uartPort_t *s = (uartPort_t *)instance;
+
+    usart_interrupt_enable(s->USARTx, USART_IDLE_INT, FALSE);
+    s->port.rxBufferHead = s->port.rxBufferTail = 0;
+    s->port.rxFrameCallback = callback;
+
+    if (callback && (s->port.mode & MODE_RX)) {
+        uartClearIdleFlag(s);
+        usart_interrupt_enable(s->USARTx, USART_IDLE_INT, TRUE);
+    }
+
+    return true;
+}
+
 const struct serialPortVTable uartVTable[] = {
     {
         .serialWrite = uartWrite,
@@ -274,5 +291,6 @@ const struct serialPortVTable uartVTable[] = {
         .beginWrite = NULL,
         .endWrite = NULL,
         .isIdle = isUartIdle,
+        .setRxFrameCallback = uartSetRxFrameCallback,
     }
 };
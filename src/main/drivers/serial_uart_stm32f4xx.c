@@ -216,7 +216,9 @@ static uartDevice_t* uartHardwareMap[] = {
 void uartIrqHandler(uartPort_t *s)
 {
     if (USART_GetITStatus(s->USARTx, USART_IT_RXNE) == SET) {
-        if (s->port.rxCallback) {
+        if (s->port.rxFrameCallback) {
+            serialFrameReceiveByte(&s->port, s->USARTx->DR);
+        } else if (s->port.rxCallback) {
             s->port.rxCallback(s->USARTx->DR, s->port.rxCallbackData);
         } else {
             s->port.rxBuffer[s->port.rxBufferHead] = s->USARTx->DR;
@@ -224,6 +226,11 @@ void uartIrqHandler(uartPort_t *s)
         }
     }
 
+    if (USART_GetITStatus(s->USARTx, USART_IT_IDLE) == SET) {
+        uartClearIdleFlag(s);
+        serialFrameReceiveIdle(&s->port);
+    }
+
     if (USART_GetITStatus(s->USARTx, USART_IT_TXE) == SET) {
         if (s->port.txBufferTail != s->port.txBufferHead) {
             USART_SendData(s->USARTx, s->port.txBuffer[s->port.txBufferTail]);
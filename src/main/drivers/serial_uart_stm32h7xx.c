@@ -255,7 +255,9 @@ void uartIrqHandler(uartPort_t *s)
     if ((__HAL_UART_GET_IT(huart, UART_IT_RXNE) != RESET)) {
         uint8_t rbyte = (uint8_t)(huart->Instance->RDR & (uint8_t) 0xff);
 
-        if (s->port.rxCallback) {
+        if (s->port.rxFrameCallback) {
+            serialFrameReceiveByte(&s->port, rbyte);
+        } else if (s->port.rxCallback) {
             s->port.rxCallback(rbyte, s->port.rxCallbackData);
         } else {
             s->port.rxBuffer[s->port.rxBufferHead] = rbyte;
@@ -269,6 +271,12 @@ void uartIrqHandler(uartPort_t *s)
         __HAL_UART_SEND_REQ(huart, UART_RXDATA_FLUSH_REQUEST);
     }
 
+    /* UART idle line interrupt occurred ----------------------------------------*/
+    if (s->port.rxFrameCallback && (__HAL_UART_GET_IT(huart, UART_IT_IDLE) != RESET)) {
+        __HAL_UART_CLEAR_IDLEFLAG(huart);
+        serialFrameReceiveIdle(&s->port);
+    }
+
     /* UART parity error interrupt occurred -------------------------------------*/
     if ((__HAL_UART_GET_IT(huart, UART_IT_PE) != RESET)) {
         __HAL_UART_CLEAR_IT(huart, UART_CLEAR_PEF);
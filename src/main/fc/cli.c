@@ -36,6 +36,7 @@ bool cliMode = false;
 #include "common/axis.h"
 #include "common/color.h"
 #include "common/maths.h"
+#include "common/numfmt.h"
 #include "common/printf.h"
 #include "common/string_light.h"
 #include "common/memory.h"
@@ -214,7 +215,10 @@ static const char *debugModeNames[DEBUG_COUNT] = {
     "HEADTRACKER",
     "GPS",
     "LULU",
-    "SBUS2"
+    "SBUS2",
+    "MSP_DISPLAYPORT",
+    "POS_EST_STATS",
+    "RX_LATENCY"
 };
 
 /* Sensor names (used in lookup tables for *_hardware settings and in status
@@ -466,12 +470,18 @@ static void printValuePointer(const setting_t *var, const void *valuePointer, ui
     switch (SETTING_MODE(var)) {
     case MODE_DIRECT:
         if (SETTING_TYPE(var) == VAR_UINT32)
-            cliPrintf("%u", value);
+            numfmtUnsigned(buf, value, 0, ' ');
         else
-            cliPrintf("%d", value);
+            numfmtSigned(buf, value, 0, ' ');
+        cliPrint(buf);
         if (full) {
             if (SETTING_MODE(var) == MODE_DIRECT) {
-                cliPrintf(" %d %u", settingGetMin(var), settingGetMax(var));
+                cliWrite(' ');
+                numfmtSigned(buf, settingGetMin(var), 0, ' ');
+                cliPrint(buf);
+                cliWrite(' ');
+                numfmtUnsigned(buf, settingGetMax(var), 0, ' ');
+                cliPrint(buf);
             }
         }
         break;
@@ -479,7 +489,7 @@ static void printValuePointer(const setting_t *var, const void *valuePointer, ui
     {
         const char *name = settingLookupValueName(var, value);
         if (name) {
-            cliPrintf(name);
+            cliPrint(name);
         } else {
             settingGetName(var, buf);
             cliPrintErrorLinef("VALUE %d OUT OF RANGE FOR %s", (int)value, buf);
@@ -524,7 +534,7 @@ static bool valuePtrEqualsDefault(const setting_t *value, const void *ptr, const
     return result;
 }
 
-static void dumpPgValue(const setting_t *value, uint8_t dumpMask)
+static void dumpPgValue(const setting_t *value, const pgRegistry_t *pg, uint8_t dumpMask)
 {
     char name[SETTING_MAX_NAME_LENGTH];
     const char *format = "set %s = ";
@@ -534,8 +544,8 @@ static void dumpPgValue(const setting_t *value, uint8_t dumpMask)
     // defaults. This means that settingGetValuePointer() will
     // return the default value while settingGetCopyValuePointer()
     // will return the actual value.
-    const void *valuePointer = settingGetCopyValuePointer(value);
-    const void *defaultValuePointer = settingGetValuePointer(value);
+    const void *valuePointer = settingGetPgCopyValuePointer(value, pg);
+    const void *defaultValuePointer = settingGetPgValuePointer(value, pg);
     const bool equalsDefault = valuePtrEqualsDefault(value, valuePointer, defaultValuePointer);
     if (((dumpMask & DO_DIFF) == 0) || !equalsDefault) {
         settingGetName(value, name);
@@ -557,11 +567,25 @@ static void dumpPgValue(const setting_t *value, uint8_t dumpMask)
 
 static void dumpAllValues(uint16_t valueSection, uint8_t dumpMask)
 {
-    for (unsigned i = 0; i < SETTINGS_TABLE_COUNT; i++) {
-        const setting_t *value = settingGet(i);
-        bufWriterFlush(cliWriter);
-        if (SETTING_SECTION(value) == valueSection) {
-            dumpPgValue(value, dumpMask);
+    unsigned settingIndex = 0;
+    for (unsigned groupIndex = 0; groupIndex < SETTINGS_PGN_COUNT; groupIndex++) {
+        const pgRegistry_t *pg = settingsGroupRegistry(groupIndex);
+        const unsigned groupEnd = settingIndex + settingsGroupSize(groupIndex);
+        const setting_t *first = settingGet(settingIndex);
+
+        // When diffing, skip groups whose backed up values are identical
+        // to the defaults, since none of their settings would be printed.
+        if ((dumpMask & DO_DIFF) && SETTING_SECTION(first) == valueSection && settingsGroupInstanceEqualsCopy(first, pg)) {
+            settingIndex = groupEnd;
+            continue;
+        }
+
+        for (; settingIndex < groupEnd; settingIndex++) {
+            const setting_t *value = settingGet(settingIndex);
+            if (SETTING_SECTION(value) == valueSection) {
+                bufWriterFlush(cliWriter);
+                dumpPgValue(value, pg, dumpMask);
+            }
         }
     }
 }
@@ -2454,6 +2478,7 @@ static void processCliLogic(char *cmdline, int16_t lcIndex) {
         }
     } else if (sl_strncasecmp(cmdline, "reset", 5) == 0) {
         pgResetCopy(logicConditionsMutable(0), PG_LOGIC_CONDITIONS);
+        logicConditionInvalidateProgram();
     } else {
         enum {
             INDEX = 0,
@@ -2499,6 +2524,7 @@ static void processCliLogic(char *cmdline, int16_t lcIndex) {
             logicConditionsMutable(i)->operandB.type = args[OPERAND_B_TYPE];
             logicConditionsMutable(i)->operandB.value = args[OPERAND_B_VALUE];
             logicConditionsMutable(i)->flags = args[FLAGS];
+            logicConditionInvalidateProgram();
 
             processCliLogic("", i);
         } else {
@@ -3127,6 +3153,7 @@ static void cliOsdLayout(char *cmdline)
         case 5:
             // Layout, item, pos and visibility. Set the item.
             osdLayoutsConfigMutable()->item_pos[layout][item] = OSD_POS(col, row) | (visible ? OSD_VISIBLE_FLAG : 0);
+            osdStartFullRedraw();
             break;
         default:
             // Unhandled
@@ -4263,6 +4290,7 @@ static void cliStatus(char *cmdline)
         cliPrintLinef("  HDOP: %f", (double)(gpsSol.hdop / (float)HDOP_SCALE));
         cliPrintLinef("  EPH : %f m", (double)(gpsSol.eph / 100.0f));
         cliPrintLinef("  EPV : %f m", (double)(gpsSol.epv / 100.0f));
+        cliPrintLinef("  Fix interval: %d us, jitter avg/max: %d/%d us", (int)gpsStats.fixIntervalUs, (int)gpsStats.fixJitterUs, (int)gpsStats.fixJitterMaxUs);
         //cliPrintLinef("  GNSS Capabilities: %d", gpsUbloxCapLastUpdate());
         cliPrintLinef("  GNSS Capabilities:");
         cliPrintLine("    GNSS Provider active/default");
@@ -4387,6 +4415,12 @@ static void restoreConfigs(void)
 
 static void printConfig(const char *cmdline, bool doDiff)
 {
+    if (configSnapshotImportActive()) {
+        // The PG copy area holds the config staged by an MSP snapshot import
+        cliPrintErrorLine("Config import in progress");
+        return;
+    }
+
     uint8_t dumpMask = DUMP_MASTER;
     const char *options;
     if ((options = checkCommand(cmdline, "master"))) {
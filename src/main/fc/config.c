@@ -77,6 +77,8 @@
 
 #include "navigation/navigation.h"
 
+#include "programming/logic_condition.h"
+
 #ifndef DEFAULT_FEATURES
 #define DEFAULT_FEATURES 0
 #endif
@@ -339,6 +341,8 @@ static void activateConfig(void)
     pidInit();
 
     navigationUsePIDs();
+
+    logicConditionInvalidateProgram();
 }
 
 void readEEPROM(void)
@@ -425,7 +425,7 @@ static void processPilotAndFailSafeActions(float dT)
         failsafeUpdateRcCommandValues();
 
         if (FLIGHT_MODE(HEADFREE_MODE)) {
-            const float radDiff = degreesToRadians(DECIDEGREES_TO_DEGREES(attitude.values.yaw) - headFreeModeHold);
+            const float radDiff = degreesToRadians(DECIDEGREES_TO_DEGREES(imuGetAttitude()->values.yaw) - headFreeModeHold);
             const float cosDiff = cos_approx(radDiff);
             const float sinDiff = sin_approx(radDiff);
             const int16_t rcCommand_PITCH = rcCommand[PITCH] * cosDiff + rcCommand[ROLL] * sinDiff;
@@ -587,9 +587,9 @@ void tryArm(void)
 #endif
         }
 
-        headFreeModeHold = DECIDEGREES_TO_DEGREES(attitude.values.yaw);
+        headFreeModeHold = DECIDEGREES_TO_DEGREES(imuGetAttitude()->values.yaw);
 
-        resetHeadingHoldTarget(DECIDEGREES_TO_DEGREES(attitude.values.yaw));
+        resetHeadingHoldTarget(DECIDEGREES_TO_DEGREES(imuGetAttitude()->values.yaw));
 
 #ifdef USE_BLACKBOX
         if (feature(FEATURE_BLACKBOX)) {
@@ -721,7 +721,7 @@ void processRx(timeUs_t currentTimeUs)
     if (sensors(SENSOR_ACC)) {
         if (IS_RC_MODE_ACTIVE(BOXHEADINGHOLD)) {
             if (!FLIGHT_MODE(HEADING_MODE)) {
-                resetHeadingHoldTarget(DECIDEGREES_TO_DEGREES(attitude.values.yaw));
+                resetHeadingHoldTarget(DECIDEGREES_TO_DEGREES(imuGetAttitude()->values.yaw));
                 ENABLE_FLIGHT_MODE(HEADING_MODE);
             }
         } else {
@@ -737,7 +737,7 @@ void processRx(timeUs_t currentTimeUs)
             DISABLE_FLIGHT_MODE(HEADFREE_MODE);
         }
         if (IS_RC_MODE_ACTIVE(BOXHEADADJ) && STATE(MULTIROTOR)) {
-            headFreeModeHold = DECIDEGREES_TO_DEGREES(attitude.values.yaw); // acquire new heading
+            headFreeModeHold = DECIDEGREES_TO_DEGREES(imuGetAttitude()->values.yaw); // acquire new heading
         }
     }
 #endif
@@ -841,6 +841,9 @@ void processRx(timeUs_t currentTimeUs)
 #endif
     // Sound a beeper if the flight mode state has changed
     updateFlightModeChangeBeeper();
+
+    // React to new RC data and flight mode changes without waiting for the programming task
+    logicConditionProcessPending();
 }
 
 // Function for loop trigger
@@ -931,6 +934,7 @@ void taskMainPidLoop(timeUs_t currentTimeUs)
     }
 
     if (isRXDataNew) {
+        rxFrameConsumed(currentTimeUs);
         updateWaypointsAndNavigationMode();
     }
     isRXDataNew = false;
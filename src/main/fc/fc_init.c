@@ -31,6 +31,7 @@
 
 #include "common/axis.h"
 #include "common/color.h"
+#include "common/crc.h"
 #include "common/log.h"
 #include "common/maths.h"
 #include "common/memory.h"
@@ -234,6 +235,7 @@ void init(void)
     serialProxyInit();
 #endif
 
+    crcInit();
     initEEPROM();
     ensureEEPROMContainsValidData();
     suspendRxSignal();
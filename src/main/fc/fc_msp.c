@@ -625,9 +625,9 @@ static bool mspFcProcessOutCommand(uint16_t cmdMSP, sbuf_t *dst, mspPostProcessF
         break;
 
     case MSP_ATTITUDE:
-        sbufWriteU16(dst, attitude.values.roll);
-        sbufWriteU16(dst, attitude.values.pitch);
-        sbufWriteU16(dst, DECIDEGREES_TO_DEGREES(attitude.values.yaw));
+        sbufWriteU16(dst, imuGetAttitude()->values.roll);
+        sbufWriteU16(dst, imuGetAttitude()->values.pitch);
+        sbufWriteU16(dst, DECIDEGREES_TO_DEGREES(imuGetAttitude()->values.yaw));
         break;
 
     case MSP_ALTITUDE:
@@ -876,6 +876,17 @@ static bool mspFcProcessOutCommand(uint16_t cmdMSP, sbuf_t *dst, mspPostProcessF
 
         break;
 
+    case MSP2_INAV_RX_LATENCY:
+        {
+            // RX frame arrival to first PID iteration using it, microseconds
+            const rxFrameLatency_t *latency = rxGetFrameLatency();
+            sbufWriteU16(dst, constrain(latency->lastUs, 0, UINT16_MAX));
+            sbufWriteU16(dst, constrain(latency->averageUs, 0, UINT16_MAX));
+            sbufWriteU16(dst, constrain(latency->maxUs, 0, UINT16_MAX));
+            sbufWriteU8(dst, rxConfig()->frameTrigger);
+        }
+        break;
+
     case MSP2_INAV_BATTERY_CONFIG:
 #ifdef USE_ADC
         sbufWriteU16(dst, batteryMetersConfig()->voltage.scale);
@@ -2306,6 +2317,7 @@ static mspResult_e mspFcProcessInCommand(uint16_t cmdMSP, sbuf_t *src)
             logicConditionsMutable(tmp_u8)->operandB.type = sbufReadU8(src);
             logicConditionsMutable(tmp_u8)->operandB.value = sbufReadU32(src);
             logicConditionsMutable(tmp_u8)->flags = sbufReadU8(src);
+            logicConditionInvalidateProgram();
         } else
             return MSP_RESULT_ERROR;
         break;
@@ -3803,6 +3815,71 @@ static bool mspParameterGroupsCommand(sbuf_t *dst, sbuf_t *src)
     return true;
 }
 
+static bool mspConfigSnapshotCommand(sbuf_t *dst, sbuf_t *src)
+{
+    // Request payload:
+    //  uint32_t    - offset into the saved config stream
+    //  uint16_t    - max size of block to read (optional)
+    uint32_t offset;
+    uint16_t readLength;
+
+    if (!sbufReadU32Safe(&offset, src)) {
+        return false;
+    }
+    if (!sbufReadU16Safe(&readLength, src)) {
+        readLength = 128;
+    }
+
+    const uint32_t totalSize = getEEPROMConfigSize();
+    if (offset > totalSize) {
+        return false;
+    }
+
+    const int replyHeaderSize = 2 * sizeof(uint32_t);
+    if (sbufBytesRemaining(dst) < replyHeaderSize) {
+        return false;
+    }
+
+    readLength = MIN(readLength, totalSize - offset);
+    readLength = MIN(readLength, sbufBytesRemaining(dst) - replyHeaderSize);
+
+    // Stream ends with its own CRC16, so the client can verify the reassembled copy
+    sbufWriteU32(dst, totalSize);
+    sbufWriteU32(dst, offset);
+    sbufWriteData(dst, configSnapshotData() + offset, readLength);
+    return true;
+}
+
+static bool mspSetConfigSnapshotCommand(sbuf_t *dst, sbuf_t *src)
+{
+    // Request payload:
+    //  uint32_t    - offset of this chunk, 0 restarts the import
+    //  uint8_t[]   - chunk of the config stream
+    uint32_t offset;
+
+    if (ARMING_FLAG(ARMED) || !sbufReadU32Safe(&offset, src)) {
+        return false;
+    }
+
+    if (offset == 0) {
+        configSnapshotImportStart();
+    }
+
+    const configSnapshotStatus_e status = configSnapshotImportWrite(offset, sbufPtr(src), sbufBytesRemaining(src));
+    if (status == CONFIG_SNAPSHOT_COMPLETE) {
+        suspendRxSignal();
+        writeEEPROM();
+        readEEPROM();
+        resumeRxSignal();
+    }
+
+    // Reply with the offset the next chunk must start at, so a lost chunk can be resent
+    sbufWriteU8(dst, status);
+    sbufWriteU32(dst, configSnapshotImportOffset());
+    sbufWriteU16(dst, configSnapshotImportFailedPgn());
+    return true;
+}
+
 #ifdef USE_SIMULATOR
 bool isOSDTypeSupportedBySimulator(void)
 {
@@ -3986,6 +4063,14 @@ bool mspFCProcessInOutCommand(uint16_t cmdMSP, sbuf_t *dst, sbuf_t *src, mspResu
         *ret = mspParameterGroupsCommand(dst, src) ? MSP_RESULT_ACK : MSP_RESULT_ERROR;
         break;
 
+    case MSP2_INAV_CONFIG_SNAPSHOT:
+        *ret = mspConfigSnapshotCommand(dst, src) ? MSP_RESULT_ACK : MSP_RESULT_ERROR;
+        break;
+
+    case MSP2_INAV_SET_CONFIG_SNAPSHOT:
+        *ret = mspSetConfigSnapshotCommand(dst, src) ? MSP_RESULT_ACK : MSP_RESULT_ERROR;
+        break;
+
 #if defined(USE_OSD)
     case MSP2_INAV_OSD_LAYOUTS:
         if (sbufBytesRemaining(src) >= 1) {
@@ -4150,9 +4235,10 @@ bool mspFCProcessInOutCommand(uint16_t cmdMSP, sbuf_t *dst, sbuf_t *src, mspResu
                 }
 
                 if (!SIMULATOR_HAS_OPTION(HITL_USE_IMU)) {
-                    attitude.values.roll = (int16_t)sbufReadU16(src);
-                    attitude.values.pitch = (int16_t)sbufReadU16(src);
-                    attitude.values.yaw = (int16_t)sbufReadU16(src);
+                    const int16_t roll = (int16_t)sbufReadU16(src);
+                    const int16_t pitch = (int16_t)sbufReadU16(src);
+                    const int16_t yaw = (int16_t)sbufReadU16(src);
+                    imuSetAttitudeRPY(roll, pitch, yaw);
                 } else {
                     sbufAdvance(src, sizeof(uint16_t) * XYZ_AXIS_COUNT);
                 }
@@ -4226,9 +4312,9 @@ bool mspFCProcessInOutCommand(uint16_t cmdMSP, sbuf_t *dst, sbuf_t *src, mspResu
         sbufWriteU8(dst, tmp_u8);
         sbufWriteU32(dst, debug[simulatorData.debugIndex]);
 
-        sbufWriteU16(dst, attitude.values.roll);
-        sbufWriteU16(dst, attitude.values.pitch);
-        sbufWriteU16(dst, attitude.values.yaw);
+        sbufWriteU16(dst, imuGetAttitude()->values.roll);
+        sbufWriteU16(dst, imuGetAttitude()->values.pitch);
+        sbufWriteU16(dst, imuGetAttitude()->values.yaw);
 
         mspWriteSimulatorOSD(dst);
 
@@ -160,6 +160,19 @@ void taskUpdateTemperature(timeUs_t currentTimeUs)
 }
 
 #ifdef USE_GPS
+bool taskProcessGPSCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTimeUs)
+{
+    UNUSED(currentTimeUs);
+
+    // Run as soon as a complete message is buffered so navigation gets each fix in phase,
+    // poll at the task rate for timeouts, configuration and driver based providers
+    if (currentDeltaTimeUs >= TASK_PERIOD_HZ(50)) {
+        return true;
+    }
+
+    return feature(FEATURE_GPS) && gpsHasPendingFrame();
+}
+
 void taskProcessGPS(timeUs_t currentTimeUs)
 {
     // if GPS feature is enabled, gpsThread() will be called at some intervals to check for stuck
@@ -191,8 +204,8 @@ void taskUpdateCompass(timeUs_t currentTimeUs)
 #ifdef USE_ADSB
 void taskAdsb(timeUs_t currentTimeUs)
 {
-    UNUSED(currentTimeUs);
     adsbTtlClean(currentTimeUs);
+    adsbUpdateVehicles();
 }
 #endif
 
@@ -541,8 +554,9 @@ cfTask_t cfTasks[TASK_COUNT] = {
 #ifdef USE_GPS
     [TASK_GPS] = {
         .taskName = "GPS",
+        .checkFunc = taskProcessGPSCheck,
         .taskFunc = taskProcessGPS,
-        .desiredPeriod = TASK_PERIOD_HZ(50),      // GPS usually don't go raster than 10Hz
+        .desiredPeriod = TASK_PERIOD_HZ(50),      // Event driven on complete messages, polled at this rate otherwise
         .staticPriority = TASK_PRIORITY_MEDIUM,
     },
 #endif
@@ -560,7 +574,7 @@ cfTask_t cfTasks[TASK_COUNT] = {
         [TASK_ADSB] = {
         .taskName = "ADSB",
         .taskFunc = taskAdsb,
-        .desiredPeriod = TASK_PERIOD_HZ(1),      // ADSB is updated at 1 Hz
+        .desiredPeriod = TASK_PERIOD_HZ(5),      // Distances and conflicts are refreshed at 5 Hz, TTL still counts down at 1 Hz
         .staticPriority = TASK_PRIORITY_IDLE,
     },
 #endif
@@ -247,18 +247,26 @@ static uint16_t getValueOffset(const setting_t *value)
     return 0;
 }
 
-void *settingGetValuePointer(const setting_t *val)
+void *settingGetPgValuePointer(const setting_t *val, const pgRegistry_t *pg)
 {
-    const pgRegistry_t *pg = pgFind(settingGetPgn(val));
     return pg->address + getValueOffset(val);
 }
 
-const void * settingGetCopyValuePointer(const setting_t *val)
+const void * settingGetPgCopyValuePointer(const setting_t *val, const pgRegistry_t *pg)
 {
-    const pgRegistry_t *pg = pgFind(settingGetPgn(val));
     return pg->copy + getValueOffset(val);
 }
 
+void *settingGetValuePointer(const setting_t *val)
+{
+    return settingGetPgValuePointer(val, pgFind(settingGetPgn(val)));
+}
+
+const void * settingGetCopyValuePointer(const setting_t *val)
+{
+    return settingGetPgCopyValuePointer(val, pgFind(settingGetPgn(val)));
+}
+
 setting_min_t settingGetMin(const setting_t *val)
 {
 	if (SETTING_MODE(val) == MODE_LOOKUP) {
@@ -348,3 +356,19 @@ bool settingsGetParameterGroupIndexes(pgn_t pg, uint16_t *start, uint16_t *end)
 	}
 	return false;
 }
+
+uint8_t settingsGroupSize(unsigned groupIndex)
+{
+	return settingsPgnCounts[groupIndex];
+}
+
+const pgRegistry_t * settingsGroupRegistry(unsigned groupIndex)
+{
+	return pgFind(settingsPgn[groupIndex]);
+}
+
+bool settingsGroupInstanceEqualsCopy(const setting_t *val, const pgRegistry_t *pg)
+{
+	const uint16_t instanceOffset = getValueOffset(val) - val->offset;
+	return memcmp(pg->address + instanceOffset, pg->copy + instanceOffset, pgSize(pg)) == 0;
+}
@@ -100,6 +100,10 @@ void * settingGetValuePointer(const setting_t *val);
 // group for the value has been manually performed. Currently, this
 // is only used by cli.c during config dumps.
 const void * settingGetCopyValuePointer(const setting_t *val);
+// Same as settingGetValuePointer() and settingGetCopyValuePointer(), but
+// using an already resolved parameter group for the setting.
+void * settingGetPgValuePointer(const setting_t *val, const pgRegistry_t *pg);
+const void * settingGetPgCopyValuePointer(const setting_t *val, const pgRegistry_t *pg);
 // Returns the minimum valid value for the given setting_t. setting_min_t
 // depends on the target and build options, but will always be a signed
 // integer (e.g. intxx_t,)
@@ -132,3 +136,13 @@ setting_max_t settingGetStringMaxLength(const setting_t *val);
 // Retrieve the setting indexes for the given PG. If the PG is not
 // found, these function returns false.
 bool settingsGetParameterGroupIndexes(pgn_t pg, uint16_t *start, uint16_t *end);
+
+// The settings table is sorted by parameter group. These allow walking
+// it one group at a time: groupIndex goes from 0 to SETTINGS_PGN_COUNT - 1
+// and each group holds settingsGroupSize() consecutive settings.
+uint8_t settingsGroupSize(unsigned groupIndex);
+const pgRegistry_t * settingsGroupRegistry(unsigned groupIndex);
+// Returns true if the instance of pg addressed by val (the active profile
+// for profile settings) is identical in the live and backed up copy regions,
+// meaning no setting of that section in the group can differ.
+bool settingsGroupInstanceEqualsCopy(const setting_t *val, const pgRegistry_t *pg);
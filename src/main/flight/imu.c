@@ -92,9 +92,15 @@ STATIC_FASTRAM float smallAngleCosZ;
 STATIC_FASTRAM bool isAccelUpdatedAtLeastOnce;
 STATIC_FASTRAM fpVector3_t vCorrectedMagNorth;             // Magnetic North vector in EF (true North rotated by declination)
 
-FASTRAM fpQuaternion_t orientation;
-FASTRAM attitudeEulerAngles_t attitude;             // absolute angle inclination in multiple of 0.1 degree    180 deg = 1800
-FASTRAM float rMat[3][3];
+/*
+ * Orientation quaternion is the only attitude state updated every IMU cycle.
+ * Euler angles are derived from it on first access after each change, tracked
+ * by a generation counter.
+ */
+STATIC_FASTRAM fpQuaternion_t orientation;
+STATIC_FASTRAM uint32_t orientationGeneration;
+STATIC_FASTRAM attitudeEulerAngles_t attitude;      // absolute angle inclination in multiple of 0.1 degree    180 deg = 1800
+STATIC_FASTRAM uint32_t attitudeGeneration;
 
 STATIC_FASTRAM imuRuntimeConfig_t imuRuntimeConfig;
 
@@ -114,6 +120,9 @@ STATIC_FASTRAM pt1Filter_t GPS3DspeedFilter;
 FASTRAM bool gpsHeadingInitialized;
 
 FASTRAM bool imuUpdated = false;
+#if defined(SITL_BUILD) || defined (USE_SIMULATOR)
+STATIC_FASTRAM attitudeEulerAngles_t simulatorAttitude;
+#endif
 
 static float imuCalculateAccelerometerWeightNearness(fpVector3_t* accBF);
 
@@ -132,30 +141,49 @@ PG_RESET_TEMPLATE(imuConfig_t, imuConfig,
     .gps_yaw_weight = SETTING_AHRS_GPS_YAW_WEIGHT_DEFAULT
 );
 
-STATIC_UNIT_TESTED void imuComputeRotationMatrix(void)
+static void imuOrientationUpdated(void)
+{
+    orientationGeneration++;
+}
+
+/*
+ * Only the first column and last row of the rotation matrix are needed for
+ * Euler angles - take them straight from the quaternion
+ */
+static void imuComputeEulerAngles(void)
 {
-    float q1q1 = orientation.q1 * orientation.q1;
-    float q2q2 = orientation.q2 * orientation.q2;
-    float q3q3 = orientation.q3 * orientation.q3;
+    const float r00 = 1.0f - 2.0f * (sq(orientation.q2) + sq(orientation.q3));
+    const float r10 = 2.0f * (orientation.q1 * orientation.q2 + orientation.q0 * orientation.q3);
+    const float r20 = 2.0f * (orientation.q1 * orientation.q3 - orientation.q0 * orientation.q2);
+    const float r21 = 2.0f * (orientation.q2 * orientation.q3 + orientation.q0 * orientation.q1);
+    const float r22 = 1.0f - 2.0f * (sq(orientation.q1) + sq(orientation.q2));
 
-    float q0q1 = orientation.q0 * orientation.q1;
-    float q0q2 = orientation.q0 * orientation.q2;
-    float q0q3 = orientation.q0 * orientation.q3;
-    float q1q2 = orientation.q1 * orientation.q2;
-    float q1q3 = orientation.q1 * orientation.q3;
-    float q2q3 = orientation.q2 * orientation.q3;
+    attitude.values.roll = RADIANS_TO_DECIDEGREES(atan2_approx(r21, r22));
+    attitude.values.pitch = RADIANS_TO_DECIDEGREES((0.5f * M_PIf) - acos_approx(-r20));
+    attitude.values.yaw = RADIANS_TO_DECIDEGREES(-atan2_approx(r10, r00));
+
+    if (attitude.values.yaw < 0)
+        attitude.values.yaw += 3600;
+}
 
-    rMat[0][0] = 1.0f - 2.0f * q2q2 - 2.0f * q3q3;
-    rMat[0][1] = 2.0f * (q1q2 + -q0q3);
-    rMat[0][2] = 2.0f * (q1q3 - -q0q2);
+const attitudeEulerAngles_t * imuGetAttitude(void)
+{
+    if (attitudeGeneration != orientationGeneration) {
+        imuComputeEulerAngles();
+        attitudeGeneration = orientationGeneration;
+    }
 
-    rMat[1][0] = 2.0f * (q1q2 - -q0q3);
-    rMat[1][1] = 1.0f - 2.0f * q1q1 - 2.0f * q3q3;
-    rMat[1][2] = 2.0f * (q2q3 + -q0q1);
+    return &attitude;
+}
 
-    rMat[2][0] = 2.0f * (q1q3 + -q0q2);
-    rMat[2][1] = 2.0f * (q2q3 - -q0q1);
-    rMat[2][2] = 1.0f - 2.0f * q1q1 - 2.0f * q2q2;
+/*
+ * Body X axis (nose direction) in earth frame, first column of the rotation matrix
+ */
+void imuGetHeadingVectorEF(fpVector3_t * v)
+{
+    v->x = 1.0f - 2.0f * (sq(orientation.q2) + sq(orientation.q3));
+    v->y = 2.0f * (orientation.q1 * orientation.q2 + orientation.q0 * orientation.q3);
+    v->z = 2.0f * (orientation.q1 * orientation.q3 - orientation.q0 * orientation.q2);
 }
 
 void imuConfigure(void)
@@ -190,7 +218,7 @@ void imuInit(void)
     imuSetMagneticDeclination(deg + min / 60.0f);
 
     quaternionInitUnit(&orientation);
-    imuComputeRotationMatrix();
+    imuOrientationUpdated();
 
     // Initialize rotation rate filter
     pt1FilterReset(&rotRateFilterX, 0);
@@ -251,7 +279,7 @@ STATIC_UNIT_TESTED void imuComputeQuaternionFromRPY(int16_t initialRoll, int16_t
     orientation.q2 = cosRoll * sinPitch * cosYaw + sinRoll * cosPitch * sinYaw;
     orientation.q3 = cosRoll * cosPitch * sinYaw - sinRoll * sinPitch * cosYaw;
 
-    imuComputeRotationMatrix();
+    imuOrientationUpdated();
 }
 #endif
 
@@ -548,28 +576,23 @@ static void imuMahonyAHRSupdate(float dt, const fpVector3_t * gyroBF, const fpVe
     // Check for invalid quaternion and reset to previous known good one
     imuCheckAndResetOrientationQuaternion(&prevOrientation, accBF);
 
-    // Pre-compute rotation matrix from quaternion
-    imuComputeRotationMatrix();
+    // Invalidate derived attitude
+    imuOrientationUpdated();
 }
 
-STATIC_UNIT_TESTED void imuUpdateEulerAngles(void)
+static void imuUpdateAttitudeState(void)
 {
 #ifdef USE_SIMULATOR
 	if ((ARMING_FLAG(SIMULATOR_MODE_HITL) && !SIMULATOR_HAS_OPTION(HITL_USE_IMU)) || (ARMING_FLAG(SIMULATOR_MODE_SITL) && imuUpdated)) {
-		imuComputeQuaternionFromRPY(attitude.values.roll, attitude.values.pitch, attitude.values.yaw);
-		imuComputeRotationMatrix();
+		imuComputeQuaternionFromRPY(simulatorAttitude.values.roll, simulatorAttitude.values.pitch, simulatorAttitude.values.yaw);
+
+		// Keep Euler angles exactly as the simulator reported them
+		attitude = simulatorAttitude;
+		if (attitude.values.yaw < 0)
+			attitude.values.yaw += 3600;
+		attitudeGeneration = orientationGeneration;
 	}
-	else
 #endif
-	{
-		/* Compute pitch/roll angles */
-		attitude.values.roll = RADIANS_TO_DECIDEGREES(atan2_approx(rMat[2][1], rMat[2][2]));
-		attitude.values.pitch = RADIANS_TO_DECIDEGREES((0.5f * M_PIf) - acos_approx(-rMat[2][0]));
-		attitude.values.yaw = RADIANS_TO_DECIDEGREES(-atan2_approx(rMat[1][0], rMat[0][0]));
-	}
-
-    if (attitude.values.yaw < 0)
-        attitude.values.yaw += 3600;
 
     /* Update small angle state */
     if (calculateCosTiltAngle() > smallAngleCosZ) {
@@ -637,9 +660,11 @@ static void imuCalculateFilters(float dT)
     imuMeasuredRotationBFFiltered.x = pt1FilterApply4(&rotRateFilterX, imuMeasuredRotationBF.x, IMU_ROTATION_LPF, dT);
     imuMeasuredRotationBFFiltered.y = pt1FilterApply4(&rotRateFilterY, imuMeasuredRotationBF.y, IMU_ROTATION_LPF, dT);
     imuMeasuredRotationBFFiltered.z = pt1FilterApply4(&rotRateFilterZ, imuMeasuredRotationBF.z, IMU_ROTATION_LPF, dT);
-    HeadVecEFFiltered.x = pt1FilterApply4(&HeadVecEFFilterX, rMat[0][0], IMU_ROTATION_LPF, dT);
-    HeadVecEFFiltered.y = pt1FilterApply4(&HeadVecEFFilterY, rMat[1][0], IMU_ROTATION_LPF, dT);
-    HeadVecEFFiltered.z = pt1FilterApply4(&HeadVecEFFilterZ, rMat[2][0], IMU_ROTATION_LPF, dT);
+    fpVector3_t headVecEF;
+    imuGetHeadingVectorEF(&headVecEF);
+    HeadVecEFFiltered.x = pt1FilterApply4(&HeadVecEFFilterX, headVecEF.x, IMU_ROTATION_LPF, dT);
+    HeadVecEFFiltered.y = pt1FilterApply4(&HeadVecEFFilterY, headVecEF.y, IMU_ROTATION_LPF, dT);
+    HeadVecEFFiltered.z = pt1FilterApply4(&HeadVecEFFilterZ, headVecEF.z, IMU_ROTATION_LPF, dT);
 
     //anti aliasing
     float GPS3Dspeed = calc_length_pythagorean_3D(gpsSol.velNED[X],gpsSol.velNED[Y],gpsSol.velNED[Z]);
@@ -727,6 +752,7 @@ void imuUpdateTailSitter(void)
     if (((bool)STATE(TAILSITTER)) != lastTailSitter){
         fpQuaternion_t* rotation_for_tailsitter= getTailSitterQuaternion(STATE(TAILSITTER));
         quaternionMultiply(&orientation, &orientation, rotation_for_tailsitter);
+        imuOrientationUpdated();
     }
     lastTailSitter = STATE(TAILSITTER);
 }
@@ -758,11 +784,11 @@ static void imuCalculateEstimatedAttitude(float dT)
         }
         else if (!canUseMAG) {
             // Re-initialize quaternion from known Roll, Pitch and GPS heading
-            imuComputeQuaternionFromRPY(attitude.values.roll, attitude.values.pitch, gpsSol.groundCourse);
+            imuComputeQuaternionFromRPY(imuGetAttitude()->values.roll, imuGetAttitude()->values.pitch, gpsSol.groundCourse);
             gpsHeadingInitialized = true;
 
             // Force reset of heading hold target
-            resetHeadingHoldTarget(DECIDEGREES_TO_DEGREES(attitude.values.yaw));
+            resetHeadingHoldTarget(DECIDEGREES_TO_DEGREES(imuGetAttitude()->values.yaw));
         }
     } else if (!ARMING_FLAG(ARMED)) {
         gpsHeadingInitialized = false;
@@ -828,7 +854,7 @@ static void imuCalculateEstimatedAttitude(float dT)
                             accWeight,
                             magWeight);
     imuUpdateTailSitter();
-    imuUpdateEulerAngles();
+    imuUpdateAttitudeState();
 }
 
 void imuUpdateAccelerometer(void)
@@ -892,9 +918,9 @@ float calculateCosTiltAngle(void)
 
 void imuSetAttitudeRPY(int16_t roll, int16_t pitch, int16_t yaw)
 {
-    attitude.values.roll = roll;
-    attitude.values.pitch = pitch;
-    attitude.values.yaw = yaw;
+    simulatorAttitude.values.roll = roll;
+    simulatorAttitude.values.pitch = pitch;
+    simulatorAttitude.values.yaw = yaw;
     imuUpdated = true;
 }
 #endif
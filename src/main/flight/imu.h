@@ -40,10 +40,6 @@ typedef union {
     } values;
 } attitudeEulerAngles_t;
 
-extern fpQuaternion_t orientation;
-extern attitudeEulerAngles_t attitude;
-extern float rMat[3][3];
-
 typedef struct imuConfig_s {
     uint16_t dcm_kp_acc;                    // DCM filter proportional gain ( x 10000) for accelerometer
     uint16_t dcm_ki_acc;                    // DCM filter integral gain ( x 10000) for accelerometer
@@ -86,8 +82,11 @@ bool isImuHeadingValid(void);
 void imuTransformVectorBodyToEarth(fpVector3_t * v);
 void imuTransformVectorEarthToBody(fpVector3_t * v);
 
+void imuGetHeadingVectorEF(fpVector3_t * v);
+const attitudeEulerAngles_t * imuGetAttitude(void);
+
 void imuInit(void);
 
-#if defined(SITL_BUILD)
+#if defined(SITL_BUILD) || defined (USE_SIMULATOR)
 void imuSetAttitudeRPY(int16_t roll, int16_t pitch, int16_t yaw);
 #endif
@@ -586,7 +586,7 @@ static float calcHorizonRateMagnitude(void)
 /* ANGLE freefloat deadband (degs).Angle error only starts to increase if atttiude outside deadband. */
 int16_t angleFreefloatDeadband(int16_t deadband, flight_dynamics_index_t axis)
 {
-    int16_t levelDatum = axis == FD_PITCH ? attitude.raw[axis] + DEGREES_TO_DECIDEGREES(fixedWingLevelTrim) : attitude.raw[axis];
+    int16_t levelDatum = axis == FD_PITCH ? imuGetAttitude()->raw[axis] + DEGREES_TO_DECIDEGREES(fixedWingLevelTrim) : imuGetAttitude()->raw[axis];
     if (ABS(levelDatum) > deadband) {
         return levelDatum > 0 ? deadband - levelDatum : -(levelDatum + deadband);
     } else {
@@ -635,7 +635,7 @@ static float computePidLevelTarget(flight_dynamics_index_t axis) {
 
 static void pidLevel(const float angleTarget, pidState_t *pidState, flight_dynamics_index_t axis, float horizonRateMagnitude, float dT)
 {
-    float angleErrorDeg = DECIDEGREES_TO_DEGREES(angleTarget - attitude.raw[axis]);
+    float angleErrorDeg = DECIDEGREES_TO_DEGREES(angleTarget - imuGetAttitude()->raw[axis]);
 
     // Soaring mode deadband inactive if pitch/roll stick not centered to allow RC stick adjustment
     if (FLIGHT_MODE(SOARING_MODE) && axis == FD_PITCH && calculateRollPitchCenterStatus() == CENTERED) {
@@ -958,7 +958,7 @@ float pidHeadingHold(float dT)
     float headingHoldRate;
 
     /* Convert absolute error into relative to current heading */
-    int16_t error = DECIDEGREES_TO_DEGREES(attitude.values.yaw) - headingHoldTarget;
+    int16_t error = DECIDEGREES_TO_DEGREES(imuGetAttitude()->values.yaw) - headingHoldTarget;
 
     /* Convert absolute error into relative to current heading */
     if (error > 180) {
@@ -1099,7 +1099,7 @@ void checkItermFreezingActive(pidState_t *pidState, flight_dynamics_index_t axis
 {
     if (usedPidControllerType == PID_TYPE_PIFF && pidProfile()->fixedWingYawItermBankFreeze != 0 && axis == FD_YAW) {
         // Do not allow yaw I-term to grow when bank angle is too large
-        float bankAngle = DECIDEGREES_TO_DEGREES(attitude.values.roll);
+        float bankAngle = DECIDEGREES_TO_DEGREES(imuGetAttitude()->values.roll);
         if (fabsf(bankAngle) > pidProfile()->fixedWingYawItermBankFreeze && !(FLIGHT_MODE(AUTO_TUNE) || FLIGHT_MODE(TURN_ASSISTANT))) {
             pidState->itermFreezeActive = true;
         } else
@@ -1135,8 +1135,8 @@ void updateAngleHold(float *angleTarget, uint8_t axis)
         static int16_t angleHoldTarget[2];
 
         if (restartAngleHoldMode) {      // set target attitude to current attitude on activation
-            angleHoldTarget[FD_ROLL] = attitude.raw[FD_ROLL];
-            angleHoldTarget[FD_PITCH] = attitude.raw[FD_PITCH] + DEGREES_TO_DECIDEGREES(fixedWingLevelTrim);
+            angleHoldTarget[FD_ROLL] = imuGetAttitude()->raw[FD_ROLL];
+            angleHoldTarget[FD_PITCH] = imuGetAttitude()->raw[FD_PITCH] + DEGREES_TO_DECIDEGREES(fixedWingLevelTrim);
             restartAngleHoldMode = false;
         }
 
@@ -1161,8 +1161,8 @@ void updateAngleHold(float *angleTarget, uint8_t axis)
             angleHoldTarget[axis] = ABS(angleHoldTarget[axis]) < 30 ? 0 : angleHoldTarget[axis];   // snap to level when within 3 degs of level
             *angleTarget = constrain(angleHoldTarget[axis] - levelTrim, -bankLimit, bankLimit);
         } else {
-            *angleTarget = constrain(attitude.raw[axis] + *angleTarget + levelTrim, -bankLimit, bankLimit);
-            angleHoldTarget[axis] = attitude.raw[axis] + levelTrim;
+            *angleTarget = constrain(imuGetAttitude()->raw[axis] + *angleTarget + levelTrim, -bankLimit, bankLimit);
+            angleHoldTarget[axis] = imuGetAttitude()->raw[axis] + levelTrim;
         }
     }
 }
@@ -1185,7 +1185,7 @@ void FAST_CODE pidController(float dT)
     }
 
     if (headingHoldState == HEADING_HOLD_UPDATE_HEADING) {
-        updateHeadingHoldTarget(DECIDEGREES_TO_DEGREES(attitude.values.yaw));
+        updateHeadingHoldTarget(DECIDEGREES_TO_DEGREES(imuGetAttitude()->values.yaw));
     }
 
     for (int axis = 0; axis < 3; axis++) {
@@ -313,8 +313,8 @@ void servoMixer(float dT)
 #endif
 
     if (IS_RC_MODE_ACTIVE(BOXCAMSTAB)) {
-        input[INPUT_GIMBAL_PITCH] = scaleRange(attitude.values.pitch, -900, 900, -500, +500);
-        input[INPUT_GIMBAL_ROLL] = scaleRange(attitude.values.roll, -1800, 1800, -500, +500);
+        input[INPUT_GIMBAL_PITCH] = scaleRange(imuGetAttitude()->values.pitch, -900, 900, -500, +500);
+        input[INPUT_GIMBAL_ROLL] = scaleRange(imuGetAttitude()->values.roll, -1800, 1800, -500, +500);
     } else {
         input[INPUT_GIMBAL_PITCH] = 0;
         input[INPUT_GIMBAL_ROLL] = 0;
@@ -595,8 +595,8 @@ void processContinuousServoAutotrim(const float dT)
             const bool planeIsFlyingStraight = rotRateMagnitudeFiltered <= DEGREES_TO_RADIANS(servoConfig()->servo_autotrim_rotation_limit);
             const bool noRotationCommanded = targetRateMagnitudeFiltered <= servoConfig()->servo_autotrim_rotation_limit;
             const bool sticksAreCentered = !areSticksDeflected();
-            const bool planeIsFlyingLevel = ABS(attitude.values.pitch + DEGREES_TO_DECIDEGREES(getFixedWingLevelTrim())) <= SERVO_AUTOTRIM_ATTITUDE_LIMIT
-                                            && ABS(attitude.values.roll) <= SERVO_AUTOTRIM_ATTITUDE_LIMIT;
+            const bool planeIsFlyingLevel = ABS(imuGetAttitude()->values.pitch + DEGREES_TO_DECIDEGREES(getFixedWingLevelTrim())) <= SERVO_AUTOTRIM_ATTITUDE_LIMIT
+                                            && ABS(imuGetAttitude()->values.roll) <= SERVO_AUTOTRIM_ATTITUDE_LIMIT;
             if (
                 planeIsFlyingStraight &&
                 noRotationCommanded &&
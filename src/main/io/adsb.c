@@ -18,13 +18,18 @@
 
 #include <string.h>
 
+#include "platform.h"
 
 #include "adsb.h"
 
 #include "navigation/navigation.h"
 #include "navigation/navigation_private.h"
 
+#include "build/build_config.h"
+
 #include "common/maths.h"
+#include "common/utils.h"
+#include "common/vector.h"
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-function"
 #include "common/mavlink.h"
@@ -36,24 +41,102 @@
 
 #ifdef USE_ADSB
 
+/*
+ * ICAO -> list index lookup, open addressing with linear probing.
+ * Table is kept at least twice the size of the vehicle list so probe chains stay short.
+ */
+#define ADSB_ICAO_HASH_BITS     6
+#define ADSB_ICAO_HASH_SIZE     (1 << ADSB_ICAO_HASH_BITS)
+#define ADSB_ICAO_HASH_MASK     (ADSB_ICAO_HASH_SIZE - 1)
+#define ADSB_ICAO_HASH_EMPTY    0xFF
+
+STATIC_ASSERT(ADSB_ICAO_HASH_SIZE >= 2 * MAX_ADSB_VEHICLES, adsb_icao_hash_too_small);
+STATIC_ASSERT(MAX_ADSB_VEHICLES < ADSB_ICAO_HASH_EMPTY, adsb_vehicle_list_too_large);
+
 adsbVehicle_t adsbVehiclesList[MAX_ADSB_VEHICLES];
 adsbVehicleStatus_t adsbVehiclesStatus;
 
 adsbVehicleValues_t vehicleValues;
 
+static uint8_t adsbIcaoHash[ADSB_ICAO_HASH_SIZE];
+static bool adsbIcaoHashInitialized = false;
+
+// Vehicle list indexes of predicted conflicts, sorted by time to conflict
+static uint8_t adsbThreatList[MAX_ADSB_VEHICLES];
+static uint8_t adsbThreatCount = 0;
+static uint8_t adsbClosestIndex = ADSB_ICAO_HASH_EMPTY;
 
 adsbVehicleValues_t* getVehicleForFill(void){
     return &vehicleValues;
 }
 
-// use bsearch function
-adsbVehicle_t *findVehicleByIcao(uint32_t avicao) {
-    for (uint8_t i = 0; i < MAX_ADSB_VEHICLES; i++) {
-        if (avicao == adsbVehiclesList[i].vehicleValues.icao) {
-            return &adsbVehiclesList[i];
+static uint8_t adsbIcaoHashSlot(uint32_t icao)
+{
+    // Fibonacci hashing, ICAO addresses are allocated in blocks per country so low bits alone cluster
+    return (icao * 2654435761u) >> (32 - ADSB_ICAO_HASH_BITS);
+}
+
+static void adsbIcaoHashInit(void)
+{
+    memset(adsbIcaoHash, ADSB_ICAO_HASH_EMPTY, sizeof(adsbIcaoHash));
+    adsbIcaoHashInitialized = true;
+}
+
+static int adsbIcaoHashFind(uint32_t icao)
+{
+    if (!adsbIcaoHashInitialized) {
+        return -1;
+    }
+
+    for (uint8_t slot = adsbIcaoHashSlot(icao), n = 0; n < ADSB_ICAO_HASH_SIZE; slot = (slot + 1) & ADSB_ICAO_HASH_MASK, n++) {
+        if (adsbIcaoHash[slot] == ADSB_ICAO_HASH_EMPTY) {
+            return -1;
+        }
+        if (adsbVehiclesList[adsbIcaoHash[slot]].vehicleValues.icao == icao) {
+            return slot;
         }
     }
-    return NULL;
+
+    return -1;
+}
+
+static void adsbIcaoHashInsert(uint8_t index)
+{
+    if (!adsbIcaoHashInitialized) {
+        adsbIcaoHashInit();
+    }
+
+    uint8_t slot = adsbIcaoHashSlot(adsbVehiclesList[index].vehicleValues.icao);
+    while (adsbIcaoHash[slot] != ADSB_ICAO_HASH_EMPTY) {
+        slot = (slot + 1) & ADSB_ICAO_HASH_MASK;
+    }
+    adsbIcaoHash[slot] = index;
+}
+
+// Backward shift deletion, keeps probe chains intact without tombstones
+static void adsbIcaoHashRemove(uint32_t icao)
+{
+    int found = adsbIcaoHashFind(icao);
+    if (found < 0) {
+        return;
+    }
+
+    uint8_t hole = found;
+    for (uint8_t slot = (hole + 1) & ADSB_ICAO_HASH_MASK; adsbIcaoHash[slot] != ADSB_ICAO_HASH_EMPTY; slot = (slot + 1) & ADSB_ICAO_HASH_MASK) {
+        const uint8_t home = adsbIcaoHashSlot(adsbVehiclesList[adsbIcaoHash[slot]].vehicleValues.icao);
+        // Entry can move into the hole only if its home slot is not cyclically within (hole, slot]
+        const bool canMove = (slot > hole) ? (home <= hole || home > slot) : (home <= hole && home > slot);
+        if (canMove) {
+            adsbIcaoHash[hole] = adsbIcaoHash[slot];
+            hole = slot;
+        }
+    }
+    adsbIcaoHash[hole] = ADSB_ICAO_HASH_EMPTY;
+}
+
+adsbVehicle_t *findVehicleByIcao(uint32_t avicao) {
+    int slot = adsbIcaoHashFind(avicao);
+    return slot < 0 ? NULL : &adsbVehiclesList[adsbIcaoHash[slot]];
 }
 
 adsbVehicle_t *findVehicleFarthest(void) {
@@ -76,16 +159,48 @@ uint8_t getActiveVehiclesCount(void) {
     return total;
 }
 
+static bool isVehicleActiveAndCalculated(const adsbVehicle_t *vehicle)
+{
+    return vehicle->ttl > 0 && vehicle->calculatedVehicleValues.valid;
+}
+
 adsbVehicle_t *findVehicleClosest(void) {
+    // Closest vehicle is tracked by adsbUpdateVehicles(), only rescan if it went stale in between
+    if (adsbClosestIndex < MAX_ADSB_VEHICLES && isVehicleActiveAndCalculated(&adsbVehiclesList[adsbClosestIndex])) {
+        return &adsbVehiclesList[adsbClosestIndex];
+    }
+
     adsbVehicle_t *adsbLocal = NULL;
     for (uint8_t i = 0; i < MAX_ADSB_VEHICLES; i++) {
-        if (adsbVehiclesList[i].ttl > 0 && adsbVehiclesList[i].calculatedVehicleValues.valid && (adsbLocal == NULL || adsbLocal->calculatedVehicleValues.dist > adsbVehiclesList[i].calculatedVehicleValues.dist)) {
+        if (isVehicleActiveAndCalculated(&adsbVehiclesList[i]) && (adsbLocal == NULL || adsbLocal->calculatedVehicleValues.dist > adsbVehiclesList[i].calculatedVehicleValues.dist)) {
             adsbLocal = &adsbVehiclesList[i];
         }
     }
+
+    adsbClosestIndex = adsbLocal ? (uint8_t)(adsbLocal - adsbVehiclesList) : ADSB_ICAO_HASH_EMPTY;
     return adsbLocal;
 }
 
+adsbVehicle_t *findVehicleByThreatRank(uint8_t rank) {
+    while (rank < adsbThreatCount) {
+        adsbVehicle_t *vehicle = &adsbVehiclesList[adsbThreatList[rank]];
+        if (isVehicleActiveAndCalculated(vehicle) && vehicle->calculatedVehicleValues.threatLevel != ADSB_THREAT_NONE) {
+            return vehicle;
+        }
+        rank++;
+    }
+
+    return NULL;
+}
+
+adsbVehicle_t *findVehicleMostThreatening(void) {
+    return findVehicleByThreatRank(0);
+}
+
+uint8_t getThreatVehiclesCount(void) {
+    return adsbThreatCount;
+}
+
 adsbVehicle_t *findFreeSpaceInList(void) {
     //find expired first
     for (uint8_t i = 0; i < MAX_ADSB_VEHICLES; i++) {
@@ -131,11 +246,160 @@ void gpsDistanceCmBearing(int32_t currentLat1, int32_t currentLon1, int32_t dest
     *bearing = wrap_36000(*bearing);
 };
 
+/*
+ * Closest point of approach and time to conflict for straight line motion.
+ * relPos and relVel are vehicle relative to FC, NEU frame, cm and cm/s.
+ */
+STATIC_UNIT_TESTED void adsbCalculateConflict(const fpVector3_t *relPos, const fpVector3_t *relVel, adsbVehicleCalculatedValues_t *calc)
+{
+    const float distSq = sq(relPos->x) + sq(relPos->y);
+    const float velSq = sq(relVel->x) + sq(relVel->y);
+    const float posDotVel = relPos->x * relVel->x + relPos->y * relVel->y;
+    const float dist = fast_fsqrtf(distSq);
+
+    calc->closingRate = dist > 1.0f ? constrainf(-posDotVel / dist, INT16_MIN, INT16_MAX) : 0;
+
+    float cpaTime = 0.0f;
+    if (velSq > 1.0f && posDotVel < 0.0f) {
+        cpaTime = MIN(-posDotVel / velSq, ADSB_CONFLICT_HORIZON_DS / 10.0f);
+    }
+
+    calc->cpaTime = lrintf(cpaTime * 10.0f);
+    calc->cpaDist = fast_fsqrtf(sq(relPos->x + relVel->x * cpaTime) + sq(relPos->y + relVel->y * cpaTime));
+    calc->cpaVerticalDistance = relPos->z + relVel->z * cpaTime;
+
+    // Entry into the protected cylinder: smallest t >= 0 with |relPos + relVel * t| = radius
+    float conflictTime = -1.0f;
+    const float c = distSq - sq((float)ADSB_CONFLICT_RADIUS_CM);
+    if (c <= 0.0f) {
+        conflictTime = 0.0f;
+    } else if (velSq > 1.0f && posDotVel < 0.0f) {
+        const float disc = sq(posDotVel) - velSq * c;
+        if (disc >= 0.0f) {
+            conflictTime = (-posDotVel - fast_fsqrtf(disc)) / velSq;
+        }
+    }
+
+    calc->conflictTime = ADSB_NO_CONFLICT;
+    calc->threatLevel = ADSB_THREAT_NONE;
+
+    if (conflictTime < 0.0f || conflictTime * 10.0f > ADSB_CONFLICT_HORIZON_DS) {
+        return;
+    }
+
+    // Vertical separation must also be lost, either on entry or at closest approach
+    const float entryVerticalDistance = relPos->z + relVel->z * conflictTime;
+    if (fabsf(entryVerticalDistance) > ADSB_CONFLICT_HEIGHT_CM && ABS(calc->cpaVerticalDistance) > ADSB_CONFLICT_HEIGHT_CM) {
+        return;
+    }
+
+    calc->conflictTime = lrintf(conflictTime * 10.0f);
+    calc->threatLevel = calc->conflictTime < ADSB_CONFLICT_HIGH_DS ? ADSB_THREAT_HIGH : ADSB_THREAT_LOW;
+}
+
+typedef struct {
+    int32_t lat;
+    int32_t lon;
+    float scaleLonDown;
+    float alt;
+    fpVector3_t vel;
+} adsbOwnState_t;
+
+static void adsbGetOwnState(adsbOwnState_t *own)
+{
+    own->lat = gpsSol.llh.lat;
+    own->lon = gpsSol.llh.lon;
+    own->scaleLonDown = cos_approx((fabsf((float) gpsSol.llh.lat) / 10000000.0f) * 0.0174532925f);
+    own->alt = getEstimatedActualPosition(Z) + GPS_home.alt;
+    own->vel.x = getEstimatedActualVelocity(X);
+    own->vel.y = getEstimatedActualVelocity(Y);
+    own->vel.z = getEstimatedActualVelocity(Z);
+}
+
+static void adsbCalculateVehicle(adsbVehicle_t *vehicle, const adsbOwnState_t *own)
+{
+    adsbVehicleCalculatedValues_t *calc = &vehicle->calculatedVehicleValues;
+    const adsbVehicleValues_t *values = &vehicle->vehicleValues;
+
+    // Longitude difference overflows int32 and must be wrapped across the antimeridian
+    int64_t dLon = (int64_t)values->lon - own->lon;
+    if (dLon > 1800000000LL) {
+        dLon -= 3600000000LL;
+    } else if (dLon < -1800000000LL) {
+        dLon += 3600000000LL;
+    }
+
+    const fpVector3_t relPos = { .v = {
+        (values->lat - own->lat) * DISTANCE_BETWEEN_TWO_LONGITUDE_POINTS_AT_EQUATOR,
+        dLon * own->scaleLonDown * DISTANCE_BETWEEN_TWO_LONGITUDE_POINTS_AT_EQUATOR,
+        values->alt - own->alt
+    }};
+
+    calc->dist = calc_length_pythagorean_2D(relPos.x, relPos.y);
+    if (calc->dist > ADSB_LIMIT_CM) {
+        vehicle->ttl = 0;
+        return;
+    }
+
+    calc->dir = wrap_36000(RADIANS_TO_CENTIDEGREES(atan2_approx(relPos.y, relPos.x)));
+    calc->verticalDistance = relPos.z;
+
+    fpVector3_t relVel = { .v = { -own->vel.x, -own->vel.y, -own->vel.z } };
+    if (values->flags & ADSB_FLAGS_VALID_VELOCITY) {
+        const float course = CENTIDEGREES_TO_RADIANS(values->heading);
+        relVel.x += values->horVelocity * cos_approx(course);
+        relVel.y += values->horVelocity * sin_approx(course);
+    }
+    if (values->flags & ADSB_FLAGS_VERTICAL_VELOCITY_VALID) {
+        relVel.z += values->verVelocity;
+    }
+
+    adsbCalculateConflict(&relPos, &relVel, calc);
+    calc->valid = true;
+}
+
+static void adsbSortThreats(void)
+{
+    adsbThreatCount = 0;
+
+    for (uint8_t i = 0; i < MAX_ADSB_VEHICLES; i++) {
+        const adsbVehicle_t *vehicle = &adsbVehiclesList[i];
+        if (!isVehicleActiveAndCalculated(vehicle) || vehicle->calculatedVehicleValues.threatLevel == ADSB_THREAT_NONE) {
+            continue;
+        }
+
+        // Insertion sort by time to conflict, ties broken by closest approach
+        uint8_t pos = adsbThreatCount++;
+        while (pos > 0) {
+            const adsbVehicleCalculatedValues_t *prev = &adsbVehiclesList[adsbThreatList[pos - 1]].calculatedVehicleValues;
+            if (prev->conflictTime < vehicle->calculatedVehicleValues.conflictTime ||
+                (prev->conflictTime == vehicle->calculatedVehicleValues.conflictTime && prev->cpaDist <= vehicle->calculatedVehicleValues.cpaDist)) {
+                break;
+            }
+            adsbThreatList[pos] = adsbThreatList[pos - 1];
+            pos--;
+        }
+        adsbThreatList[pos] = i;
+    }
+}
+
 bool adsbHeartbeat(void){
     adsbVehiclesStatus.heartbeatMessagesTotal++;
     return true;
 }
 
+static void adsbStoreVehicle(adsbVehicle_t *vehicle, const adsbVehicleValues_t* vehicleValuesLocal)
+{
+    if (vehicle->vehicleValues.icao != vehicleValuesLocal->icao) {
+        // Slot is reused for another plane, move it in the ICAO index
+        adsbIcaoHashRemove(vehicle->vehicleValues.icao);
+        memcpy(&(vehicle->vehicleValues), vehicleValuesLocal, sizeof(vehicle->vehicleValues));
+        adsbIcaoHashInsert(vehicle - adsbVehiclesList);
+    } else {
+        memcpy(&(vehicle->vehicleValues), vehicleValuesLocal, sizeof(vehicle->vehicleValues));
+    }
+}
+
 void adsbNewVehicle(adsbVehicleValues_t* vehicleValuesLocal) {
 
     // no valid lat lon or altitude
@@ -161,7 +425,7 @@ void adsbNewVehicle(adsbVehicleValues_t* vehicleValuesLocal) {
         }
 
         if (vehicle != NULL) {
-            memcpy(&(vehicle->vehicleValues), vehicleValuesLocal, sizeof(vehicle->vehicleValues));
+            adsbStoreVehicle(vehicle, vehicleValuesLocal);
             vehicle->ttl = ADSB_MAX_SECONDS_KEEP_INACTIVE_PLANE_IN_LIST;
             vehicle->calculatedVehicleValues.valid = false;
             return;
@@ -183,7 +447,7 @@ void adsbNewVehicle(adsbVehicleValues_t* vehicleValuesLocal) {
         }
 
         if (vehicle != NULL) {
-            memcpy(&(vehicle->vehicleValues), vehicleValuesLocal, sizeof(vehicle->vehicleValues));
+            adsbStoreVehicle(vehicle, vehicleValuesLocal);
             recalculateVehicle(vehicle);
             vehicle->ttl = ADSB_MAX_SECONDS_KEEP_INACTIVE_PLANE_IN_LIST;
             return;
@@ -192,15 +456,41 @@ void adsbNewVehicle(adsbVehicleValues_t* vehicleValuesLocal) {
 };
 
 void recalculateVehicle(adsbVehicle_t* vehicle){
-    gpsDistanceCmBearing(gpsSol.llh.lat, gpsSol.llh.lon, vehicle->vehicleValues.lat, vehicle->vehicleValues.lon, &(vehicle->calculatedVehicleValues.dist), &(vehicle->calculatedVehicleValues.dir));
+    adsbOwnState_t own;
+    adsbGetOwnState(&own);
+    adsbCalculateVehicle(vehicle, &own);
+}
 
-    if (vehicle != NULL && vehicle->calculatedVehicleValues.dist > ADSB_LIMIT_CM) {
-        vehicle->ttl = 0;
+/*
+ * Refresh distance, bearing and conflict prediction of all tracked planes
+ * against a single snapshot of FC position and velocity
+ */
+void adsbUpdateVehicles(void)
+{
+    if (!enviromentOkForCalculatingDistaceBearing()) {
+        adsbThreatCount = 0;
         return;
     }
 
-    vehicle->calculatedVehicleValues.verticalDistance = vehicle->vehicleValues.alt - (int32_t)getEstimatedActualPosition(Z) - GPS_home.alt;
-    vehicle->calculatedVehicleValues.valid = true;
+    adsbOwnState_t own;
+    adsbGetOwnState(&own);
+
+    adsbVehicle_t *closest = NULL;
+    for (uint8_t i = 0; i < MAX_ADSB_VEHICLES; i++) {
+        adsbVehicle_t *vehicle = &adsbVehiclesList[i];
+        if (vehicle->ttl == 0) {
+            continue;
+        }
+
+        adsbCalculateVehicle(vehicle, &own);
+
+        if (isVehicleActiveAndCalculated(vehicle) && (closest == NULL || closest->calculatedVehicleValues.dist > vehicle->calculatedVehicleValues.dist)) {
+            closest = vehicle;
+        }
+    }
+
+    adsbClosestIndex = closest ? (uint8_t)(closest - adsbVehiclesList) : ADSB_ICAO_HASH_EMPTY;
+    adsbSortThreats();
 }
 
 void adsbTtlClean(timeUs_t currentTimeUs) {
@@ -226,4 +516,3 @@ bool enviromentOkForCalculatingDistaceBearing(void){
 }
 
 #endif
-
@@ -24,11 +24,29 @@
 #define ADSB_CALL_SIGN_MAX_LENGTH 9
 #define ADSB_MAX_SECONDS_KEEP_INACTIVE_PLANE_IN_LIST 10
 
+#define ADSB_CONFLICT_HORIZON_DS        600     // 0.1s, look ahead for predicted conflicts
+#define ADSB_CONFLICT_HIGH_DS           200     // 0.1s, conflicts closer than this are high threat
+#define ADSB_CONFLICT_RADIUS_CM         50000   // CM, horizontal protected radius around the FC
+#define ADSB_CONFLICT_HEIGHT_CM         15000   // CM, vertical protected distance around the FC
+#define ADSB_NO_CONFLICT                UINT16_MAX
+
+typedef enum {
+    ADSB_THREAT_NONE = 0,
+    ADSB_THREAT_LOW,
+    ADSB_THREAT_HIGH,
+} adsbThreatLevel_e;
+
 typedef struct {
     bool valid;
     int32_t dir;   // centidegrees direction to plane, pivot is inav FC
     uint32_t dist;  // CM distance to plane, pivot is inav FC
     int32_t verticalDistance; // CM, vertical distance to plane, pivot is inav FC
+    int16_t closingRate; // CM/s, positive when horizontal distance is decreasing
+    uint16_t cpaTime; // 0.1s, time to closest point of approach
+    uint32_t cpaDist; // CM, horizontal distance at closest point of approach
+    int32_t cpaVerticalDistance; // CM, vertical distance at closest point of approach
+    uint16_t conflictTime; // 0.1s, time until protected volume is entered, ADSB_NO_CONFLICT if none predicted
+    uint8_t threatLevel; // adsbThreatLevel_e
 } adsbVehicleCalculatedValues_t;
 
 typedef struct {
@@ -37,6 +55,8 @@ typedef struct {
     int32_t lon; // Longitude, expressed as degrees * 1E7
     int32_t alt;  // Barometric/Geometric Altitude (ASL), in cm
     uint16_t heading; // Course over ground in centidegrees
+    uint16_t horVelocity; // The horizontal velocity in cm/s
+    int16_t verVelocity; // The vertical velocity in cm/s, positive is up
     uint16_t flags; // Flags to indicate various statuses including valid data fields
     uint8_t altitudeType; // Type from ADSB_ALTITUDE_TYPE enum
     char callsign[ADSB_CALL_SIGN_MAX_LENGTH]; // The callsign, 8 chars + NULL
@@ -60,10 +80,14 @@ typedef struct {
 void adsbNewVehicle(adsbVehicleValues_t* vehicleValuesLocal);
 bool adsbHeartbeat(void);
 adsbVehicle_t * findVehicleClosest(void);
+adsbVehicle_t * findVehicleMostThreatening(void);
+adsbVehicle_t * findVehicleByThreatRank(uint8_t rank);
+uint8_t getThreatVehiclesCount(void);
 adsbVehicle_t * findVehicle(uint8_t index);
 uint8_t getActiveVehiclesCount(void);
 void adsbTtlClean(timeUs_t currentTimeUs);
 adsbVehicleStatus_t* getAdsbStatus(void);
 adsbVehicleValues_t* getVehicleForFill(void);
 bool enviromentOkForCalculatingDistaceBearing(void);
-void recalculateVehicle(adsbVehicle_t* vehicle);
\ No newline at end of file
+void recalculateVehicle(adsbVehicle_t* vehicle);
+void adsbUpdateVehicles(void);
\ No newline at end of file
@@ -58,6 +58,7 @@
 #include "scheduler/scheduler.h"
 #include "fc/config.h"
 #include "common/maths.h"
+#include "build/debug.h"
 
 #define FONT_VERSION 3
 
@@ -70,6 +71,11 @@ typedef enum {          // defines are from hdzero code
 } resolutionType_e;
 
 #define DRAW_FREQ_DENOM 4 // 60Hz
+#define MSP_V1_FRAME_OVERHEAD 6 // '$', 'M', '>', size, cmd, crc
+#define MSP_DP_BATCH_MAX_PAYLOAD 254 // Keep batched frames below the MSPv1 JUMBO frame limit
+#define MSP_DP_BATCH_RUN_HEADER_SIZE 4 // row, col, attr, len
+#define MSP_DP_COALESCE_GAP (MSP_V1_FRAME_OVERHEAD + 3) // Bridging fewer clean chars is cheaper than a new frame
+#define MSP_DP_BATCH_COALESCE_GAP (MSP_DP_BATCH_RUN_HEADER_SIZE - 1) // ... or than a new run inside a batch
 #define TX_BUFFER_SIZE 1024
 #define VTX_TIMEOUT 1000 // 1 second timer
 
@@ -103,6 +109,14 @@ static timeMs_t sendSubFrameMs = 0;
 // set screen size
 #define SCREENSIZE (ROWS*COLS)
 
+typedef struct mspDpRun_s {
+    uint8_t row;
+    uint8_t col;
+    uint8_t attributes;
+    uint8_t len;
+    uint8_t data[COLS];
+} mspDpRun_t;
+
 static uint8_t currentOsdMode;               // HDZero screen mode can change across layouts
 
 static uint8_t screen[SCREENSIZE];
@@ -268,12 +282,75 @@ static int writeString(displayPort_t *displayPort, uint8_t col, uint8_t row, con
     return 0;
 }
 
+/**
+ * Collect the run of dirty characters starting at pos into run. A run ends at the
+ * end of the visible line or when the font page or blink attribute changes. Up to
+ * maxGap clean characters are bridged when more dirty ones follow, since resending
+ * them costs less than the header of another run. Returns the position following
+ * the last character included in the run.
+ */
+static int collectRun(int pos, mspDpRun_t *run, int maxGap)
+{
+    const uint8_t row = pos / COLS;
+    const int endOfLine = row * COLS + screenCols;
+    const uint8_t page = getAttrPage(attrs[pos]);
+    const uint8_t blink = getAttrBlink(attrs[pos]);
+    const bool djiCompat = isDJICompatibleVideoSystem(osdConfig());
+
+    run->row = row;
+    run->col = pos % COLS;
+    run->attributes = 0;
+    run->len = 0;
+
+    int last = pos;
+    for (int i = pos + 1; i < endOfLine && getAttrPage(attrs[i]) == page && getAttrBlink(attrs[i]) == blink; i++) {
+        if (bitArrayGet(dirty, i)) {
+            last = i;
+        } else if (i - last > maxGap) {
+            break;
+        }
+    }
+
+    for (int i = pos; i <= last; i++) {
+        run->data[run->len++] = djiCompat ? getDJICharacter(screen[i], page) : screen[i];
+    }
+
+    if (!djiCompat) {
+        run->attributes |= (page << DISPLAYPORT_MSP_ATTR_FONTPAGE);
+    }
+
+    if (blink) {
+        run->attributes |= (1 << DISPLAYPORT_MSP_ATTR_BLINK);
+    }
+
+    return last + 1;
+}
+
+static void clearRun(const mspDpRun_t *run)
+{
+    const int pos = run->row * COLS + run->col;
+    for (int i = 0; i < run->len; i++) {
+        bitArrayClr(dirty, pos + i);
+    }
+}
+
+/**
+ * Largest MSP_DISPLAYPORT payload that still fits into the TX buffer,
+ * keeping room for the DRAW_SCREEN frame that ends the update.
+ */
+static int batchBudget(void)
+{
+    const int txFree = (int)mspSerialTxBytesFree(mspPort.port) - MSP_V1_FRAME_OVERHEAD - (MSP_V1_FRAME_OVERHEAD + 1);
+    return constrain(txFree, 0, MSP_DP_BATCH_MAX_PAYLOAD);
+}
+
 /**
  * Write only changed characters to the VTX
  */
 static int drawScreen(displayPort_t *displayPort) // 250Hz
 {
     static uint8_t counter = 0;
+    static uint16_t deferredDraws = 0;
 
     if ((!cmsInMenu && IS_RC_MODE_ACTIVE(BOXOSD)) || (counter++ % DRAW_FREQ_DENOM)) { // 62.5Hz
         return 0;
@@ -295,46 +372,60 @@ static int drawScreen(displayPort_t *displayPort) // 250Hz
         sendSubFrameMs = (osdConfig()->msp_displayport_fullframe_interval > 0) ? (millis() + DS2MS(osdConfig()->msp_displayport_fullframe_interval)) : 0;
     }
 
-    uint8_t subcmd[COLS + 4];
+    const bool batched = osdConfig()->msp_displayport_batch;
+    uint8_t subcmd[MSP_DP_BATCH_MAX_PAYLOAD];
+    int subcmdLen = 0;
+    int sentBytes = 0;
+    uint8_t frameCount = 0;
     uint8_t updateCount = 0;
-    subcmd[0] = MSP_DP_WRITE_STRING;
+    mspDpRun_t run;
 
     int next = BITARRAY_FIND_FIRST_SET(dirty, 0);
     while (next >= 0) {
-        // Look for sequential dirty characters on the same line for the same font page
-        int pos = next;
-        uint8_t row = pos / COLS;
-        uint8_t col = pos % COLS;
-        uint8_t attributes = 0;
-        int endOfLine = row * COLS + screenCols;
-        uint8_t page = getAttrPage(attrs[pos]);
-        uint8_t blink = getAttrBlink(attrs[pos]);
-
-        uint8_t len = 4;
-        do {
-            bitArrayClr(dirty, pos);
-            subcmd[len] = isDJICompatibleVideoSystem(osdConfig()) ? getDJICharacter(screen[pos++], page): screen[pos++];
-            len++;
-
-            if (bitArrayGet(dirty, pos)) {
-                next = pos;
+        const int endOfRun = collectRun(next, &run, batched ? MSP_DP_BATCH_COALESCE_GAP : MSP_DP_COALESCE_GAP);
+
+        if (batched) {
+            // Flush the pending batch when this run would not fit, then stop if the port has no room left
+            if (MAX(subcmdLen, 1) + MSP_DP_BATCH_RUN_HEADER_SIZE + run.len > batchBudget()) {
+                if (subcmdLen > 0) {
+                    sentBytes += output(displayPort, MSP_DISPLAYPORT, subcmd, subcmdLen);
+                    frameCount++;
+                    subcmdLen = 0;
+                }
+                if (1 + MSP_DP_BATCH_RUN_HEADER_SIZE + run.len > batchBudget()) {
+                    // Port is full, leave the rest dirty for the next draw
+                    deferredDraws++;
+                    break;
+                }
             }
-        } while (next == pos && next < endOfLine && getAttrPage(attrs[next]) == page && getAttrBlink(attrs[next]) == blink);
-
-        if (!isDJICompatibleVideoSystem(osdConfig())) {
-            attributes |= (page << DISPLAYPORT_MSP_ATTR_FONTPAGE);
-        }
 
-        if (blink) {
-            attributes |= (1 << DISPLAYPORT_MSP_ATTR_BLINK);
+            if (subcmdLen == 0) {
+                subcmd[subcmdLen++] = MSP_DP_WRITE_STRINGS;
+            }
+            subcmd[subcmdLen++] = run.row;
+            subcmd[subcmdLen++] = run.col;
+            subcmd[subcmdLen++] = run.attributes;
+            subcmd[subcmdLen++] = run.len;
+            memcpy(&subcmd[subcmdLen], run.data, run.len);
+            subcmdLen += run.len;
+        } else {
+            subcmd[0] = MSP_DP_WRITE_STRING;
+            subcmd[1] = run.row;
+            subcmd[2] = run.col;
+            subcmd[3] = run.attributes;
+            memcpy(&subcmd[4], run.data, run.len);
+            sentBytes += output(displayPort, MSP_DISPLAYPORT, subcmd, run.len + 4);
+            frameCount++;
         }
 
-        subcmd[1] = row;
-        subcmd[2] = col;
-        subcmd[3] = attributes;
-        output(displayPort, MSP_DISPLAYPORT, subcmd, len);
+        clearRun(&run);
         updateCount++;
-        next = BITARRAY_FIND_FIRST_SET(dirty, pos);
+        next = BITARRAY_FIND_FIRST_SET(dirty, endOfRun);
+    }
+
+    if (subcmdLen > 0) {
+        sentBytes += output(displayPort, MSP_DISPLAYPORT, subcmd, subcmdLen);
+        frameCount++;
     }
 
     if (updateCount > 0 || screenCleared) {
@@ -343,9 +434,15 @@ static int drawScreen(displayPort_t *displayPort) // 250Hz
         }
 
         subcmd[0] = MSP_DP_DRAW_SCREEN;
-        output(displayPort, MSP_DISPLAYPORT, subcmd, 1);
+        sentBytes += output(displayPort, MSP_DISPLAYPORT, subcmd, 1);
+        frameCount++;
     }
 
+    DEBUG_SET(DEBUG_MSP_DISPLAYPORT, 0, sentBytes);
+    DEBUG_SET(DEBUG_MSP_DISPLAYPORT, 1, frameCount);
+    DEBUG_SET(DEBUG_MSP_DISPLAYPORT, 2, updateCount);
+    DEBUG_SET(DEBUG_MSP_DISPLAYPORT, 3, deferredDraws);
+
     if (vtxReset) {
         clearScreen(displayPort);
         vtxReset = false;
@@ -73,11 +73,14 @@
 
 #include "programming/logic_condition.h"
 
+#define GPS_FIX_JITTER_MAX_DECAY    64      // Peak loses 1/64 (at least 1us) per solution, a single spike fades within seconds
+
 typedef struct {
     bool                isDriverBased;
     portMode_t          portMode;           // Port mode RX/TX (only for serial based)
     void                (*restart)(void);   // Restart protocol driver thread
     void                (*protocol)(void);  // Process protocol driver thread
+    bool                (*check)(void);     // Optional, true when buffered data can complete a message
 } gpsProviderDescriptor_t;
 
 // GPS public data
@@ -97,22 +100,22 @@ baudRate_e gpsToSerialBaudRate[GPS_BAUDRATE_COUNT] = { BAUD_115200, BAUD_57600,
 static gpsProviderDescriptor_t gpsProviders[GPS_PROVIDER_COUNT] = {
     /* UBLOX binary */
 #ifdef USE_GPS_PROTO_UBLOX
-    { false, MODE_RXTX, &gpsRestartUBLOX, &gpsHandleUBLOX },
+    { false, MODE_RXTX, &gpsRestartUBLOX, &gpsHandleUBLOX, &gpsCheckUBLOX },
 #else
-    { false, 0, NULL, NULL },
+    { false, 0, NULL, NULL, NULL },
 #endif
 
     /* MSP GPS */
 #ifdef USE_GPS_PROTO_MSP
-    { true, 0, &gpsRestartMSP, &gpsHandleMSP },
+    { true, 0, &gpsRestartMSP, &gpsHandleMSP, NULL },
 #else
-    { false, 0, NULL, NULL },
+    { false, 0, NULL, NULL, NULL },
 #endif
 
 #ifdef USE_GPS_FAKE
-    {true, 0, &gpsFakeRestart, &gpsFakeHandle},
+    {true, 0, &gpsFakeRestart, &gpsFakeHandle, NULL},
 #else
-    { false, 0, NULL, NULL },
+    { false, 0, NULL, NULL, NULL },
 #endif
 
 };
@@ -200,6 +203,33 @@ void gpsSetState(gpsState_e state)
     gpsState.lastStateSwitchMs = millis();
 }
 
+static void gpsUpdateFixIntervalStats(void)
+{
+    static timeUs_t lastFixUs;
+    const timeUs_t currentTimeUs = micros();
+    const timeDelta_t intervalUs = currentTimeUs - lastFixUs;
+
+    lastFixUs = currentTimeUs;
+
+    // Skip the first solution after start or a gap
+    if (intervalUs > (timeDelta_t)MS2US(GPS_TIMEOUT)) {
+        return;
+    }
+
+    if (gpsStats.fixIntervalUs == 0) {
+        gpsStats.fixIntervalUs = intervalUs;
+        return;
+    }
+
+    const uint32_t jitterUs = ABS(intervalUs - (timeDelta_t)gpsStats.fixIntervalUs);
+
+    // 1/8 exponential averages, integer only
+    gpsStats.fixIntervalUs = (int32_t)gpsStats.fixIntervalUs + (intervalUs - (int32_t)gpsStats.fixIntervalUs) / 8;
+    gpsStats.fixJitterUs = (int32_t)gpsStats.fixJitterUs + ((int32_t)jitterUs - (int32_t)gpsStats.fixJitterUs) / 8;
+    const uint32_t jitterMaxDecayUs = MAX(gpsStats.fixJitterMaxUs / GPS_FIX_JITTER_MAX_DECAY, 1u);
+    gpsStats.fixJitterMaxUs = MAX(gpsStats.fixJitterMaxUs > jitterMaxDecayUs ? gpsStats.fixJitterMaxUs - jitterMaxDecayUs : 0, jitterUs);
+}
+
 static void gpsUpdateTime(void)
 {
     if (!rtcHasTime() && gpsSol.flags.validTime && gpsSol.time.year != 0) {
@@ -303,8 +333,11 @@ void updateEstimatedGPSFix(void)
     }
 #endif
 
-    float velX = rMat[0][0] * speed;
-    float velY = -rMat[1][0] * speed;
+    fpVector3_t headVecEF;
+    imuGetHeadingVectorEF(&headVecEF);
+
+    float velX = headVecEF.x * speed;
+    float velY = -headVecEF.y * speed;
     // here (velX, velY) is estimated horizontal speed without wind influence = airspeed, cm/sec in NEU frame
 
     if (isEstimatedWindSpeedValid()) {
@@ -398,6 +431,7 @@ void gpsProcessNewSolutionData(bool timeout)
 
         // Update statistics
         gpsStats.lastMessageDt = gpsState.lastMessageMs - gpsState.lastLastMessageMs;
+        gpsUpdateFixIntervalStats();
     }
     gpsSol.flags.hasNewData = true;
 
@@ -450,6 +484,9 @@ void gpsInit(void)
 
     gpsStats.errors = 0;
     gpsStats.timeouts = 0;
+    gpsStats.fixIntervalUs = 0;
+    gpsStats.fixJitterUs = 0;
+    gpsStats.fixJitterMaxUs = 0;
 
     // Reset solution, timeout and prepare to start
     gpsResetSolution(&gpsSolDRV);
@@ -511,6 +548,24 @@ uint16_t gpsConstrainHDOP(uint32_t hdop)
     return (hdop > 9999) ? 9999 : hdop; // max 99.99m error
 }
 
+bool gpsHasPendingFrame(void)
+{
+    const gpsProviderDescriptor_t *provider = &gpsProviders[gpsState.gpsConfig->provider];
+
+    if (gpsState.state != GPS_RUNNING || !provider->check) {
+        return false;
+    }
+
+#ifdef USE_SIMULATOR
+    // Solution comes from the simulator, the port is not being read
+    if (ARMING_FLAG(SIMULATOR_MODE_HITL)) {
+        return false;
+    }
+#endif
+
+    return provider->check();
+}
+
 bool gpsUpdate(void)
 {
     // Sanity check
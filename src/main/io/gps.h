@@ -154,6 +154,9 @@ typedef struct {
     uint32_t    errors;                // gps error counter - crc error/lost of data/sync etc..
     uint32_t    timeouts;
     uint32_t    packetCount;
+    uint32_t    fixIntervalUs;         // average interval between new solutions
+    uint32_t    fixJitterUs;           // average deviation of the interval from its average
+    uint32_t    fixJitterMaxUs;        // peak deviation, decays so old spikes don't stick
 } gpsStatistics_t;
 
 extern gpsSolutionData_t gpsSol;
@@ -165,6 +168,8 @@ void gpsInit(void);
 // Called periodically from GPS task. Returns true iff the GPS
 // information was updated.
 bool gpsUpdate(void);
+// True when the receiver has buffered enough data to complete a message
+bool gpsHasPendingFrame(void);
 void updateGpsIndicator(timeUs_t currentTimeUs);
 bool isGPSHealthy(void);
 bool isGPSHeadingValid(void);
@@ -83,6 +83,7 @@ void gpsSetProtocolTimeout(timeMs_t timeoutMs);
 
 extern void gpsRestartUBLOX(void);
 extern void gpsHandleUBLOX(void);
+extern bool gpsCheckUBLOX(void);
 
 extern void gpsRestartMSP(void);
 extern void gpsHandleMSP(void);
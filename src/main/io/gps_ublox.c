@@ -52,6 +52,7 @@
 #include "scheduler/protothreads.h"
 
 #include "gps_ublox.h"
+#include "gps_ublox_parser.h"
 #include "gps_ublox_utils.h"
 
 
@@ -87,19 +88,7 @@ static const char * baudInitDataNMEA[GPS_BAUDRATE_COUNT] = {
 
 static ubx_nav_sig_info satelites[UBLOX_MAX_SIGNALS] = {};
 
-// Packet checksum accumulators
-static uint8_t _ck_a;
-static uint8_t _ck_b;
-
-// State machine state
-static bool _skip_packet;
-static uint8_t _step;
-static uint8_t _msg_id;
-static uint16_t _payload_length;
-static uint16_t _payload_counter;
-
 static uint8_t next_fix_type;
-static uint8_t _class;
 static uint8_t _ack_state;
 static uint8_t _ack_waiting_msg;
 
@@ -136,21 +125,16 @@ static union send_buffer_t {
     uint8_t bytes[58];
 } send_buffer;
 
-// Receive buffer
-static union {
-    ubx_nav_posllh posllh;
-    ubx_nav_status status;
-    ubx_nav_solution solution;
-    ubx_nav_velned velned;
-    ubx_nav_pvt pvt;
-    ubx_nav_svinfo svinfo;
-    ubx_mon_ver ver;
-    ubx_nav_timeutc timeutc;
-    ubx_ack_ack ack;
-    ubx_mon_gnss gnss;
-    ubx_nav_sig navsig;
-    uint8_t bytes[UBLOX_BUFFER_SIZE];
-} _buffer;
+// Receive side, parser assembles messages split across reads in an aligned buffer
+static ubxParser_t ubloxParser;
+static uint32_t ubloxParserBuffer[(UBLOX_BUFFER_SIZE + 3) / 4];
+// Reads land 2 bytes into the chunk, so a frame at the start of a read has its payload
+// (after the 6 byte header) 4 byte aligned and a whole NAV-PVT is dispatched in place
+#define UBLOX_RX_CHUNK_OFFSET       2
+#define UBLOX_RX_CHUNK_SIZE         (UBLOX_RX_CHUNK_OFFSET + sizeof(ubx_nav_pvt) + 8)
+static uint8_t ubloxRxChunk[UBLOX_RX_CHUNK_SIZE] __attribute__((aligned(4)));
+static uint8_t ubloxRxChunkLength;
+static uint8_t ubloxRxChunkPosition;
 
 bool gpsUbloxHasGalileo(void)
 {
@@ -591,305 +575,302 @@ static uint32_t gpsDecodeHardwareVersion(const char * szBuf, unsigned nBufSize)
     return UBX_HW_VERSION_UNKNOWN;
 }
 
-static bool gpsParseFrameUBLOX(void)
+static bool ubloxSolutionReady(void)
 {
-    switch (_msg_id) {
-    case MSG_POSLLH:
-        gpsSolDRV.llh.lon = _buffer.posllh.longitude;
-        gpsSolDRV.llh.lat = _buffer.posllh.latitude;
-        gpsSolDRV.llh.alt = _buffer.posllh.altitude_msl / 10;  //alt in cm
-        gpsSolDRV.eph = gpsConstrainEPE(_buffer.posllh.horizontal_accuracy / 10);
-        gpsSolDRV.epv = gpsConstrainEPE(_buffer.posllh.vertical_accuracy / 10);
-        gpsSolDRV.flags.validEPE = true;
-        if (next_fix_type != GPS_NO_FIX)
-            gpsSolDRV.fixType = next_fix_type;
-        _new_position = true;
-        break;
-    case MSG_STATUS:
-        next_fix_type = gpsMapFixType(_buffer.status.fix_status & NAV_STATUS_FIX_VALID, _buffer.status.fix_type);
-        if (next_fix_type == GPS_NO_FIX)
-            gpsSolDRV.fixType = GPS_NO_FIX;
-        break;
-    case MSG_SOL:
-        next_fix_type = gpsMapFixType(_buffer.solution.fix_status & NAV_STATUS_FIX_VALID, _buffer.solution.fix_type);
-        if (next_fix_type == GPS_NO_FIX)
-            gpsSolDRV.fixType = GPS_NO_FIX;
-        gpsSolDRV.numSat = _buffer.solution.satellites;
-        gpsSolDRV.hdop = gpsConstrainHDOP(_buffer.solution.position_DOP);
-        break;
-    case MSG_VELNED:
-        gpsSolDRV.groundSpeed = _buffer.velned.speed_2d;    // cm/s
-        gpsSolDRV.groundCourse = (uint16_t) (_buffer.velned.heading_2d / 10000);     // Heading 2D deg * 100000 rescaled to deg * 10
-        gpsSolDRV.velNED[X] = _buffer.velned.ned_north;
-        gpsSolDRV.velNED[Y] = _buffer.velned.ned_east;
-        gpsSolDRV.velNED[Z] = _buffer.velned.ned_down;
-        gpsSolDRV.flags.validVelNE = true;
-        gpsSolDRV.flags.validVelD = true;
-        _new_speed = true;
-        break;
-    case MSG_TIMEUTC:
-        if (UBX_VALID_GPS_DATE_TIME(_buffer.timeutc.valid)) {
-            gpsSolDRV.time.year = _buffer.timeutc.year;
-            gpsSolDRV.time.month = _buffer.timeutc.month;
-            gpsSolDRV.time.day = _buffer.timeutc.day;
-            gpsSolDRV.time.hours = _buffer.timeutc.hour;
-            gpsSolDRV.time.minutes = _buffer.timeutc.min;
-            gpsSolDRV.time.seconds = _buffer.timeutc.sec;
-            gpsSolDRV.time.millis = _buffer.timeutc.nano / (1000*1000);
-
-            gpsSolDRV.flags.validTime = true;
-        } else {
-            gpsSolDRV.flags.validTime = false;
-        }
-        break;
-    case MSG_PVT:
-        {
-            static int pvtCount = 0;
-            DEBUG_SET(DEBUG_GPS, 0, pvtCount++);
-        }
+    DEBUG_SET(DEBUG_GPS, 5, gpsState.flags.pvt);
+    DEBUG_SET(DEBUG_GPS, 6, gpsState.flags.sat);
+    DEBUG_SET(DEBUG_GPS, 7, gpsState.flags.sig);
+
+    // we only return true when we get new position and speed data
+    // this ensures we don't use stale data
+    if (_new_position && _new_speed) {
+        _new_speed = _new_position = false;
+        return true;
+    }
 
-        gpsState.flags.pvt = 1;
-        next_fix_type = gpsMapFixType(_buffer.pvt.fix_status & NAV_STATUS_FIX_VALID, _buffer.pvt.fix_type);
+    return false;
+}
+
+static bool ubloxHandleNavPosllh(const void *payload, uint16_t length)
+{
+    const ubx_nav_posllh *posllh = payload;
+    UNUSED(length);
+
+    gpsSolDRV.llh.lon = posllh->longitude;
+    gpsSolDRV.llh.lat = posllh->latitude;
+    gpsSolDRV.llh.alt = posllh->altitude_msl / 10;  //alt in cm
+    gpsSolDRV.eph = gpsConstrainEPE(posllh->horizontal_accuracy / 10);
+    gpsSolDRV.epv = gpsConstrainEPE(posllh->vertical_accuracy / 10);
+    gpsSolDRV.flags.validEPE = true;
+    if (next_fix_type != GPS_NO_FIX)
         gpsSolDRV.fixType = next_fix_type;
-        gpsSolDRV.llh.lon = _buffer.pvt.longitude;
-        gpsSolDRV.llh.lat = _buffer.pvt.latitude;
-        gpsSolDRV.llh.alt = _buffer.pvt.altitude_msl / 10;  //alt in cm
-        gpsSolDRV.velNED[X]=_buffer.pvt.ned_north / 10;  // to cm/s
-        gpsSolDRV.velNED[Y]=_buffer.pvt.ned_east / 10;   // to cm/s
-        gpsSolDRV.velNED[Z]=_buffer.pvt.ned_down / 10;   // to cm/s
-        gpsSolDRV.groundSpeed = _buffer.pvt.speed_2d / 10;    // to cm/s
-        gpsSolDRV.groundCourse = (uint16_t) (_buffer.pvt.heading_2d / 10000);     // Heading 2D deg * 100000 rescaled to deg * 10
-        gpsSolDRV.numSat = _buffer.pvt.satellites;
-        gpsSolDRV.eph = gpsConstrainEPE(_buffer.pvt.horizontal_accuracy / 10);
-        gpsSolDRV.epv = gpsConstrainEPE(_buffer.pvt.vertical_accuracy / 10);
-        gpsSolDRV.hdop = gpsConstrainHDOP(_buffer.pvt.position_DOP);
-        gpsSolDRV.flags.validVelNE = true;
-        gpsSolDRV.flags.validVelD = true;
-        gpsSolDRV.flags.validEPE = true;
-
-        if (UBX_VALID_GPS_DATE_TIME(_buffer.pvt.valid)) {
-            gpsSolDRV.time.year = _buffer.pvt.year;
-            gpsSolDRV.time.month = _buffer.pvt.month;
-            gpsSolDRV.time.day = _buffer.pvt.day;
-            gpsSolDRV.time.hours = _buffer.pvt.hour;
-            gpsSolDRV.time.minutes = _buffer.pvt.min;
-            gpsSolDRV.time.seconds = _buffer.pvt.sec;
-            gpsSolDRV.time.millis = _buffer.pvt.nano / (1000*1000);
-
-            gpsSolDRV.flags.validTime = true;
-        } else {
-            gpsSolDRV.flags.validTime = false;
-        }
+    _new_position = true;
 
-        _new_position = true;
-        _new_speed = true;
-        break;
-    case MSG_VER:
-        if (_class == CLASS_MON) {
-            gpsState.hwVersion = gpsDecodeHardwareVersion(_buffer.ver.hwVersion, sizeof(_buffer.ver.hwVersion));
-            if (gpsState.hwVersion >= UBX_HW_VERSION_UBLOX8) {
-                if (_buffer.ver.swVersion[9] > '2' || true) {
-                    // check extensions;
-                    // after hw + sw vers; each is 30 bytes
-                    bool found = false;
-                    for (int j = 40; j < _payload_length && !found; j += 30)
-                    {
-                        // Example content: GPS;GAL;BDS;GLO
-                        if (strnstr((const char *)(_buffer.bytes + j), "GAL", 30))
-                        {
-                            ubx_capabilities.supported |= UBX_MON_GNSS_GALILEO_MASK;
-                            found = true;
-                        }
-                        if (strnstr((const char *)(_buffer.bytes + j), "BDS", 30))
-                        {
-                            ubx_capabilities.supported |= UBX_MON_GNSS_BEIDOU_MASK;
-                            found = true;
-                        }
-                        if (strnstr((const char *)(_buffer.bytes + j), "GLO", 30))
-                        {
-                            ubx_capabilities.supported |= UBX_MON_GNSS_GLONASS_MASK;
-                            found = true;
-                        }
-                    }
-                }
-                for(int j = 40; j < _payload_length; j += 30) {
-                    if (strnstr((const char *)(_buffer.bytes + j), "PROTVER", 30)) {
-                        gpsDecodeProtocolVersion((const char *)(_buffer.bytes + j), 30);
-                        break;
-                    }
-                }
-            }
-        }
-        break;
-    case MSG_MON_GNSS:
-        if(_class == CLASS_MON) {
-            if (_buffer.gnss.version == 0) {
-                ubx_capabilities.supported = _buffer.gnss.supported;
-                ubx_capabilities.defaultGnss = _buffer.gnss.defaultGnss;
-                ubx_capabilities.enabledGnss = _buffer.gnss.enabled;
-                ubx_capabilities.capMaxGnss = _buffer.gnss.maxConcurrent;
-                gpsState.lastCapaUpdMs = millis();
-            }
-        }
-        break;
-    case MSG_NAV_SAT:
-        if (_class == CLASS_NAV) {
-            static int satInfoCount = 0;
-            gpsState.flags.sat = 1;
-            DEBUG_SET(DEBUG_GPS, 1, satInfoCount++);
-            DEBUG_SET(DEBUG_GPS, 3, _buffer.svinfo.numSvs);
-            if (!gpsState.flags.pvt) { // PVT is the prefered source
-                gpsSolDRV.numSat = _buffer.svinfo.numSvs;
-            }
+    return ubloxSolutionReady();
+}
 
-            for(int i = 0; i < MIN(_buffer.svinfo.numSvs, UBLOX_MAX_SIGNALS); ++i) {
-                ubloxNavSat2NavSig(&_buffer.svinfo.channel[i], &satelites[i]);
-            }
-            for(int i =_buffer.svinfo.numSvs; i < UBLOX_MAX_SIGNALS; ++i) {
-                satelites->gnssId = 0xFF;
-                satelites->svId = 0xFF;
-            }
-        }
-        break;
-    case MSG_NAV_SIG:
-        if (_class == CLASS_NAV && _buffer.navsig.version == 0) {
-            static int sigInfoCount = 0;
-            DEBUG_SET(DEBUG_GPS, 2, sigInfoCount++);
-            DEBUG_SET(DEBUG_GPS, 4, _buffer.navsig.numSigs);
-            gpsState.flags.sig = 1;
-
-            if(_buffer.navsig.numSigs > 0) 
+static bool ubloxHandleNavStatus(const void *payload, uint16_t length)
+{
+    const ubx_nav_status *status = payload;
+    UNUSED(length);
+
+    next_fix_type = gpsMapFixType(status->fix_status & NAV_STATUS_FIX_VALID, status->fix_type);
+    if (next_fix_type == GPS_NO_FIX)
+        gpsSolDRV.fixType = GPS_NO_FIX;
+
+    return ubloxSolutionReady();
+}
+
+static bool ubloxHandleNavSol(const void *payload, uint16_t length)
+{
+    const ubx_nav_solution *solution = payload;
+    UNUSED(length);
+
+    next_fix_type = gpsMapFixType(solution->fix_status & NAV_STATUS_FIX_VALID, solution->fix_type);
+    if (next_fix_type == GPS_NO_FIX)
+        gpsSolDRV.fixType = GPS_NO_FIX;
+    gpsSolDRV.numSat = solution->satellites;
+    gpsSolDRV.hdop = gpsConstrainHDOP(solution->position_DOP);
+
+    return ubloxSolutionReady();
+}
+
+static bool ubloxHandleNavVelned(const void *payload, uint16_t length)
+{
+    const ubx_nav_velned *velned = payload;
+    UNUSED(length);
+
+    gpsSolDRV.groundSpeed = velned->speed_2d;    // cm/s
+    gpsSolDRV.groundCourse = (uint16_t) (velned->heading_2d / 10000);     // Heading 2D deg * 100000 rescaled to deg * 10
+    gpsSolDRV.velNED[X] = velned->ned_north;
+    gpsSolDRV.velNED[Y] = velned->ned_east;
+    gpsSolDRV.velNED[Z] = velned->ned_down;
+    gpsSolDRV.flags.validVelNE = true;
+    gpsSolDRV.flags.validVelD = true;
+    _new_speed = true;
+
+    return ubloxSolutionReady();
+}
+
+static bool ubloxHandleNavTimeutc(const void *payload, uint16_t length)
+{
+    const ubx_nav_timeutc *timeutc = payload;
+    UNUSED(length);
+
+    if (UBX_VALID_GPS_DATE_TIME(timeutc->valid)) {
+        gpsSolDRV.time.year = timeutc->year;
+        gpsSolDRV.time.month = timeutc->month;
+        gpsSolDRV.time.day = timeutc->day;
+        gpsSolDRV.time.hours = timeutc->hour;
+        gpsSolDRV.time.minutes = timeutc->min;
+        gpsSolDRV.time.seconds = timeutc->sec;
+        gpsSolDRV.time.millis = timeutc->nano / (1000*1000);
+
+        gpsSolDRV.flags.validTime = true;
+    } else {
+        gpsSolDRV.flags.validTime = false;
+    }
+
+    return ubloxSolutionReady();
+}
+
+static bool ubloxHandleNavPvt(const void *payload, uint16_t length)
+{
+    const ubx_nav_pvt *pvt = payload;
+    UNUSED(length);
+
+    {
+        static int pvtCount = 0;
+        DEBUG_SET(DEBUG_GPS, 0, pvtCount++);
+    }
+
+    gpsState.flags.pvt = 1;
+    next_fix_type = gpsMapFixType(pvt->fix_status & NAV_STATUS_FIX_VALID, pvt->fix_type);
+    gpsSolDRV.fixType = next_fix_type;
+    gpsSolDRV.llh.lon = pvt->longitude;
+    gpsSolDRV.llh.lat = pvt->latitude;
+    gpsSolDRV.llh.alt = pvt->altitude_msl / 10;  //alt in cm
+    gpsSolDRV.velNED[X]=pvt->ned_north / 10;  // to cm/s
+    gpsSolDRV.velNED[Y]=pvt->ned_east / 10;   // to cm/s
+    gpsSolDRV.velNED[Z]=pvt->ned_down / 10;   // to cm/s
+    gpsSolDRV.groundSpeed = pvt->speed_2d / 10;    // to cm/s
+    gpsSolDRV.groundCourse = (uint16_t) (pvt->heading_2d / 10000);     // Heading 2D deg * 100000 rescaled to deg * 10
+    gpsSolDRV.numSat = pvt->satellites;
+    gpsSolDRV.eph = gpsConstrainEPE(pvt->horizontal_accuracy / 10);
+    gpsSolDRV.epv = gpsConstrainEPE(pvt->vertical_accuracy / 10);
+    gpsSolDRV.hdop = gpsConstrainHDOP(pvt->position_DOP);
+    gpsSolDRV.flags.validVelNE = true;
+    gpsSolDRV.flags.validVelD = true;
+    gpsSolDRV.flags.validEPE = true;
+
+    if (UBX_VALID_GPS_DATE_TIME(pvt->valid)) {
+        gpsSolDRV.time.year = pvt->year;
+        gpsSolDRV.time.month = pvt->month;
+        gpsSolDRV.time.day = pvt->day;
+        gpsSolDRV.time.hours = pvt->hour;
+        gpsSolDRV.time.minutes = pvt->min;
+        gpsSolDRV.time.seconds = pvt->sec;
+        gpsSolDRV.time.millis = pvt->nano / (1000*1000);
+
+        gpsSolDRV.flags.validTime = true;
+    } else {
+        gpsSolDRV.flags.validTime = false;
+    }
+
+    _new_position = true;
+    _new_speed = true;
+
+    return ubloxSolutionReady();
+}
+
+static bool ubloxHandleMonVer(const void *payload, uint16_t length)
+{
+    const ubx_mon_ver *ver = payload;
+    const char *bytes = payload;
+
+    gpsState.hwVersion = gpsDecodeHardwareVersion(ver->hwVersion, sizeof(ver->hwVersion));
+    if (gpsState.hwVersion >= UBX_HW_VERSION_UBLOX8) {
+        if (ver->swVersion[9] > '2' || true) {
+            // check extensions;
+            // after hw + sw vers; each is 30 bytes
+            bool found = false;
+            for (int j = 40; j + 30 <= length && !found; j += 30)
             {
-                for(int i=0; i < MIN(UBLOX_MAX_SIGNALS, _buffer.navsig.numSigs); ++i)
+                // Example content: GPS;GAL;BDS;GLO
+                if (strnstr(bytes + j, "GAL", 30))
+                {
+                    ubx_capabilities.supported |= UBX_MON_GNSS_GALILEO_MASK;
+                    found = true;
+                }
+                if (strnstr(bytes + j, "BDS", 30))
                 {
-                    memcpy(&satelites[i], &_buffer.navsig.sig[i], sizeof(ubx_nav_sig_info));
+                    ubx_capabilities.supported |= UBX_MON_GNSS_BEIDOU_MASK;
+                    found = true;
                 }
-                for(int i = _buffer.navsig.numSigs; i < UBLOX_MAX_SIGNALS; ++i)
+                if (strnstr(bytes + j, "GLO", 30))
                 {
-                    satelites[i].svId = 0xFF; // no used
-                    satelites[i].gnssId = 0xFF;
+                    ubx_capabilities.supported |= UBX_MON_GNSS_GLONASS_MASK;
+                    found = true;
                 }
             }
         }
-        break;
-    case MSG_ACK_ACK:
-        if ((_ack_state == UBX_ACK_WAITING) && (_buffer.ack.msg == _ack_waiting_msg)) {
-            _ack_state = UBX_ACK_GOT_ACK;
-        }
-        break;
-    case MSG_ACK_NACK:
-        if ((_ack_state == UBX_ACK_WAITING) && (_buffer.ack.msg == _ack_waiting_msg)) {
-            _ack_state = UBX_ACK_GOT_NAK;
+        for(int j = 40; j + 30 <= length; j += 30) {
+            if (strnstr(bytes + j, "PROTVER", 30)) {
+                gpsDecodeProtocolVersion(bytes + j, 30);
+                break;
+            }
         }
-        break;
-    default:
-        return false;
     }
 
-    DEBUG_SET(DEBUG_GPS, 5, gpsState.flags.pvt);
-    DEBUG_SET(DEBUG_GPS, 6, gpsState.flags.sat);
-    DEBUG_SET(DEBUG_GPS, 7, gpsState.flags.sig);
+    return ubloxSolutionReady();
+}
 
-    // we only return true when we get new position and speed data
-    // this ensures we don't use stale data
-    if (_new_position && _new_speed) {
-        _new_speed = _new_position = false;
-        return true;
+static bool ubloxHandleMonGnss(const void *payload, uint16_t length)
+{
+    const ubx_mon_gnss *gnss = payload;
+    UNUSED(length);
+
+    if (gnss->version == 0) {
+        ubx_capabilities.supported = gnss->supported;
+        ubx_capabilities.defaultGnss = gnss->defaultGnss;
+        ubx_capabilities.enabledGnss = gnss->enabled;
+        ubx_capabilities.capMaxGnss = gnss->maxConcurrent;
+        gpsState.lastCapaUpdMs = millis();
     }
 
-    return false;
+    return ubloxSolutionReady();
 }
 
-static bool gpsNewFrameUBLOX(uint8_t data)
+static bool ubloxHandleNavSat(const void *payload, uint16_t length)
 {
-    bool parsed = false;
+    const ubx_nav_svinfo *svinfo = payload;
+    static int satInfoCount = 0;
+
+    gpsState.flags.sat = 1;
+    DEBUG_SET(DEBUG_GPS, 1, satInfoCount++);
+    DEBUG_SET(DEBUG_GPS, 3, svinfo->numSvs);
+    if (!gpsState.flags.pvt) { // PVT is the prefered source
+        gpsSolDRV.numSat = svinfo->numSvs;
+    }
 
-    switch (_step) {
-        case 0: // Sync char 1 (0xB5)
-            if (PREAMBLE1 == data) {
-                _skip_packet = false;
-                _step++;
-            }
-            break;
-        case 1: // Sync char 2 (0x62)
-            if (PREAMBLE2 != data) {
-                _step = 0;
-                break;
-            }
-            _step++;
-            break;
-        case 2: // Class
-            _step++;
-            _class = data;
-            _ck_b = _ck_a = data;   // reset the checksum accumulators
-            break;
-        case 3: // Id
-            _step++;
-            _ck_b += (_ck_a += data);       // checksum byte
-            _msg_id = data;
-            break;
-        case 4: // Payload length (part 1)
-            _step++;
-            _ck_b += (_ck_a += data);       // checksum byte
-            _payload_length = data; // payload length low byte
-            break;
-        case 5: // Payload length (part 2)
-            _step++;
-            _ck_b += (_ck_a += data);       // checksum byte
-            _payload_length |= (uint16_t)(data << 8);
-            if (_payload_length > MAX_UBLOX_PAYLOAD_SIZE ) {
-                // we can't receive the whole packet, just log the error and start searching for the next packet.
-                gpsStats.errors++;
-                _step = 0;
-                break;
-            }
-            // prepare to receive payload
-            _payload_counter = 0;
-            if (_payload_length == 0) {
-                _step = 7;
-            }
-            break;
-        case 6:
-            _ck_b += (_ck_a += data);       // checksum byte
-            if (_payload_counter < MAX_UBLOX_PAYLOAD_SIZE) {
-                _buffer.bytes[_payload_counter] = data;
-            }
-            // NOTE: check counter BEFORE increasing so that a payload_size of 65535 is correctly handled.  This can happen if garbage data is received.
-            if (_payload_counter ==  _payload_length - 1) {
-                _step++;
-            }
-            _payload_counter++;
-            break;
-        case 7:
-            _step++;
-            if (_ck_a != data) {
-                _skip_packet = true;          // bad checksum
-                gpsStats.errors++;
-                _step = 0;
-            }
-            break;
-        case 8:
-            _step = 0;
+    // Only trust the channels actually present in the payload
+    const int numSvs = MIN(MIN((int)svinfo->numSvs, (int)((length - 8) / sizeof(ubx_nav_svinfo_channel))), UBLOX_MAX_SIGNALS);
+    for(int i = 0; i < numSvs; ++i) {
+        ubloxNavSat2NavSig(&svinfo->channel[i], &satelites[i]);
+    }
+    for(int i = numSvs; i < UBLOX_MAX_SIGNALS; ++i) {
+        satelites[i].gnssId = 0xFF;
+        satelites[i].svId = 0xFF;
+    }
 
-            if (_ck_b != data) {
-                gpsStats.errors++;
-                break;              // bad checksum
-            }
+    return ubloxSolutionReady();
+}
 
-            gpsStats.packetCount++;
+static bool ubloxHandleNavSig(const void *payload, uint16_t length)
+{
+    const ubx_nav_sig *navsig = payload;
 
-            if (_skip_packet) {
-                break;
-            }
+    if (navsig->version == 0) {
+        static int sigInfoCount = 0;
+        DEBUG_SET(DEBUG_GPS, 2, sigInfoCount++);
+        DEBUG_SET(DEBUG_GPS, 4, navsig->numSigs);
+        gpsState.flags.sig = 1;
 
-            if (gpsParseFrameUBLOX()) {
-                parsed = true;
+        const int numSigs = MIN(MIN((int)navsig->numSigs, (int)((length - 8) / sizeof(ubx_nav_sig_info))), UBLOX_MAX_SIGNALS);
+        if (numSigs > 0)
+        {
+            memcpy(satelites, navsig->sig, numSigs * sizeof(ubx_nav_sig_info));
+            for(int i = numSigs; i < UBLOX_MAX_SIGNALS; ++i)
+            {
+                satelites[i].svId = 0xFF; // no used
+                satelites[i].gnssId = 0xFF;
             }
+        }
+    }
+
+    return ubloxSolutionReady();
+}
+
+static bool ubloxHandleAckAck(const void *payload, uint16_t length)
+{
+    const ubx_ack_ack *ack = payload;
+    UNUSED(length);
+
+    if ((_ack_state == UBX_ACK_WAITING) && (ack->msg == _ack_waiting_msg)) {
+        _ack_state = UBX_ACK_GOT_ACK;
+    }
+
+    return ubloxSolutionReady();
+}
+
+static bool ubloxHandleAckNack(const void *payload, uint16_t length)
+{
+    const ubx_ack_ack *ack = payload;
+    UNUSED(length);
+
+    if ((_ack_state == UBX_ACK_WAITING) && (ack->msg == _ack_waiting_msg)) {
+        _ack_state = UBX_ACK_GOT_NAK;
     }
 
-    return parsed;
+    return ubloxSolutionReady();
 }
 
+// Messages we decode, everything else is checksummed and skipped without copying
+static const ubxMessageHandler_t ubloxMessageHandlers[] = {
+    { CLASS_NAV, MSG_PVT,       sizeof(ubx_nav_pvt),        ubloxHandleNavPvt },
+    { CLASS_NAV, MSG_NAV_SIG,   8,                          ubloxHandleNavSig },
+    { CLASS_NAV, MSG_NAV_SAT,   8,                          ubloxHandleNavSat },
+    { CLASS_NAV, MSG_POSLLH,    sizeof(ubx_nav_posllh),     ubloxHandleNavPosllh },
+    { CLASS_NAV, MSG_STATUS,    sizeof(ubx_nav_status),     ubloxHandleNavStatus },
+    { CLASS_NAV, MSG_SOL,       sizeof(ubx_nav_solution),   ubloxHandleNavSol },
+    { CLASS_NAV, MSG_VELNED,    sizeof(ubx_nav_velned),     ubloxHandleNavVelned },
+    { CLASS_NAV, MSG_TIMEUTC,   sizeof(ubx_nav_timeutc),    ubloxHandleNavTimeutc },
+    { CLASS_ACK, MSG_ACK_ACK,   sizeof(ubx_ack_ack),        ubloxHandleAckAck },
+    { CLASS_ACK, MSG_ACK_NACK,  sizeof(ubx_ack_ack),        ubloxHandleAckNack },
+    { CLASS_MON, MSG_VER,       sizeof(ubx_mon_ver),        ubloxHandleMonVer },
+    { CLASS_MON, MSG_MON_GNSS,  sizeof(ubx_mon_gnss),       ubloxHandleMonGnss },
+};
+
 static uint16_t hz2rate(uint8_t hz)
 {
     return 1000 / hz;
@@ -1130,13 +1111,26 @@ STATIC_PROTOTHREAD(gpsProtocolReceiverThread)
     ptBegin(gpsProtocolReceiverThread);
 
     while (1) {
-        // Wait until there are bytes to consume
-        ptWait(serialRxBytesWaiting(gpsState.gpsPort));
+        // Wait until there are bytes to consume, leftovers of the last chunk go first
+        ptWait(ubloxRxChunkPosition < ubloxRxChunkLength || serialRxBytesWaiting(gpsState.gpsPort));
+
+        // Consume chunks until buffer empty of until we have full message received
+        while (ubloxRxChunkPosition < ubloxRxChunkLength || serialRxBytesWaiting(gpsState.gpsPort)) {
+            if (ubloxRxChunkPosition >= ubloxRxChunkLength) {
+                ubloxRxChunkLength = UBLOX_RX_CHUNK_OFFSET + serialReadBuf(gpsState.gpsPort, ubloxRxChunk + UBLOX_RX_CHUNK_OFFSET, sizeof(ubloxRxChunk) - UBLOX_RX_CHUNK_OFFSET);
+                ubloxRxChunkPosition = UBLOX_RX_CHUNK_OFFSET;
+            }
 
-        // Consume bytes until buffer empty of until we have full message received
-        while (serialRxBytesWaiting(gpsState.gpsPort)) {
-            uint8_t newChar = serialRead(gpsState.gpsPort);
-            if (gpsNewFrameUBLOX(newChar)) {
+            const uint32_t packetCount = ubloxParser.packetCount;
+            const uint32_t errorCount = ubloxParser.errorCount;
+            bool newSolution;
+
+            ubloxRxChunkPosition += ubxParserFeed(&ubloxParser, ubloxRxChunk + ubloxRxChunkPosition, ubloxRxChunkLength - ubloxRxChunkPosition, &newSolution);
+
+            gpsStats.packetCount += ubloxParser.packetCount - packetCount;
+            gpsStats.errors += ubloxParser.errorCount - errorCount;
+
+            if (newSolution) {
                 gpsProcessNewDriverData();
                 ptSemaphoreSignal(semNewDataReady);
                 break;
@@ -1252,11 +1246,20 @@ void gpsRestartUBLOX(void)
 		satelites[i].gnssId = 0xFF;
 	}
 
+    ubxParserInit(&ubloxParser, ubloxMessageHandlers, ARRAYLEN(ubloxMessageHandlers), ubloxParserBuffer, MAX_UBLOX_PAYLOAD_SIZE);
+    ubloxRxChunkLength = ubloxRxChunkPosition = 0;
+
     ptSemaphoreInit(semNewDataReady);
     ptRestart(ptGetHandle(gpsProtocolReceiverThread));
     ptRestart(ptGetHandle(gpsProtocolStateThread));
 }
 
+bool gpsCheckUBLOX(void)
+{
+    const uint32_t buffered = (ubloxRxChunkLength - ubloxRxChunkPosition) + serialRxBytesWaiting(gpsState.gpsPort);
+    return buffered >= ubxParserBytesToCompletion(&ubloxParser);
+}
+
 void gpsHandleUBLOX(void)
 {
     // Run the protocol threads
@@ -0,0 +1,261 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "common/maths.h"
+
+#include "io/gps_ublox_parser.h"
+
+#define UBX_PREAMBLE1       0xB5
+#define UBX_PREAMBLE2       0x62
+
+void ubxParserInit(ubxParser_t *parser, const ubxMessageHandler_t *handlers, uint8_t handlerCount, uint32_t *buffer, uint16_t bufferSize)
+{
+    memset(parser, 0, sizeof(*parser));
+    parser->handlers = handlers;
+    parser->handlerCount = handlerCount;
+    parser->buffer = buffer;
+    parser->bufferSize = bufferSize;
+    parser->maxPayloadLength = bufferSize;
+}
+
+void ubxParserReset(ubxParser_t *parser)
+{
+    parser->step = UBX_PARSER_SYNC1;
+    parser->handler = NULL;
+}
+
+// 8-bit Fletcher over a run, in 32 bit accumulators so the loop carries no truncation
+void ubxChecksumUpdate(uint8_t *ckA, uint8_t *ckB, const uint8_t *data, uint32_t length)
+{
+    uint32_t a = *ckA;
+    uint32_t b = *ckB;
+
+    while (length >= 4) {
+        a += data[0]; b += a;
+        a += data[1]; b += a;
+        a += data[2]; b += a;
+        a += data[3]; b += a;
+        data += 4;
+        length -= 4;
+    }
+
+    while (length--) {
+        a += *data++;
+        b += a;
+    }
+
+    *ckA = a;
+    *ckB = b;
+}
+
+uint32_t ubxParserBytesToCompletion(const ubxParser_t *parser)
+{
+    switch (parser->step) {
+        case UBX_PARSER_PAYLOAD:
+            return parser->payloadLength - parser->payloadCounter + 2;
+        case UBX_PARSER_CK_A:
+            return 2;
+        case UBX_PARSER_CK_B:
+            return 1;
+        default:
+            // Header bytes left plus the checksum of an empty message
+            return UBX_PARSER_PAYLOAD - parser->step + 2;
+    }
+}
+
+static const ubxMessageHandler_t *ubxFindHandler(const ubxParser_t *parser, uint8_t msgClass, uint8_t msgId)
+{
+    for (unsigned i = 0; i < parser->handlerCount; i++) {
+        const ubxMessageHandler_t *handler = &parser->handlers[i];
+        if (handler->msgClass == msgClass && handler->msgId == msgId) {
+            return handler;
+        }
+    }
+
+    return NULL;
+}
+
+static bool ubxDispatch(ubxParser_t *parser, const uint8_t *payload)
+{
+    parser->packetCount++;
+
+    const ubxMessageHandler_t *handler = parser->handler;
+    parser->handler = NULL;
+
+    if (!handler || parser->payloadLength < handler->minLength) {
+        return false;
+    }
+
+    // Handlers cast the payload to protocol structures, hand out an aligned view
+    if (((uintptr_t)payload & 3) != 0) {
+        memcpy(parser->buffer, payload, parser->payloadLength);
+        payload = (const uint8_t *)parser->buffer;
+    }
+
+    return handler->fn(payload, parser->payloadLength);
+}
+
+static void ubxHeaderComplete(ubxParser_t *parser)
+{
+    if (parser->payloadLength > parser->maxPayloadLength) {
+        // Can't be a valid message, resync
+        parser->errorCount++;
+        parser->step = UBX_PARSER_SYNC1;
+        return;
+    }
+
+    parser->handler = ubxFindHandler(parser, parser->msgClass, parser->msgId);
+    parser->payloadCounter = 0;
+    parser->step = parser->payloadLength ? UBX_PARSER_PAYLOAD : UBX_PARSER_CK_A;
+}
+
+uint32_t ubxParserFeed(ubxParser_t *parser, const uint8_t *data, uint32_t length, bool *newSolution)
+{
+    uint32_t pos = 0;
+    uint32_t resync = 0;            // Just past the sync byte of the current frame, or the chunk start if it came earlier
+
+    *newSolution = false;
+
+    while (pos < length) {
+        switch (parser->step) {
+            case UBX_PARSER_SYNC1:
+                {
+                    const uint8_t *sync = memchr(data + pos, UBX_PREAMBLE1, length - pos);
+                    if (!sync) {
+                        return length;
+                    }
+                    pos = sync - data + 1;
+                    resync = pos;
+                    parser->step = UBX_PARSER_SYNC2;
+                }
+                break;
+
+            case UBX_PARSER_SYNC2:
+                if (data[pos] == UBX_PREAMBLE2) {
+                    pos++;
+                    parser->step = UBX_PARSER_CLASS;
+                } else {
+                    // Don't consume, it may be the first sync byte
+                    parser->step = UBX_PARSER_SYNC1;
+                }
+                break;
+
+            case UBX_PARSER_CLASS:
+                parser->msgClass = data[pos++];
+                parser->ckA = parser->ckB = 0;
+                ubxChecksumUpdate(&parser->ckA, &parser->ckB, &parser->msgClass, 1);
+                parser->step = UBX_PARSER_ID;
+                break;
+
+            case UBX_PARSER_ID:
+                parser->msgId = data[pos];
+                ubxChecksumUpdate(&parser->ckA, &parser->ckB, &data[pos++], 1);
+                parser->step = UBX_PARSER_LENGTH1;
+                break;
+
+            case UBX_PARSER_LENGTH1:
+                parser->payloadLength = data[pos];
+                ubxChecksumUpdate(&parser->ckA, &parser->ckB, &data[pos++], 1);
+                parser->step = UBX_PARSER_LENGTH2;
+                break;
+
+            case UBX_PARSER_LENGTH2:
+                parser->payloadLength |= (uint16_t)data[pos] << 8;
+                ubxChecksumUpdate(&parser->ckA, &parser->ckB, &data[pos++], 1);
+                ubxHeaderComplete(parser);
+
+                if (parser->step == UBX_PARSER_SYNC1) {
+                    pos = resync;
+                    break;
+                }
+
+                // Whole message in this chunk, validate and dispatch in place
+                if (parser->step == UBX_PARSER_PAYLOAD && length - pos >= (uint32_t)parser->payloadLength + 2) {
+                    const uint8_t *payload = data + pos;
+                    ubxChecksumUpdate(&parser->ckA, &parser->ckB, payload, parser->payloadLength);
+                    pos += parser->payloadLength;
+                    parser->step = UBX_PARSER_SYNC1;
+
+                    if (data[pos] != parser->ckA || data[pos + 1] != parser->ckB) {
+                        // The sync bytes may have been payload data, rescan right after them
+                        parser->errorCount++;
+                        parser->handler = NULL;
+                        pos = resync;
+                        break;
+                    }
+
+                    pos += 2;
+                    if (ubxDispatch(parser, payload)) {
+                        *newSolution = true;
+                        return pos;
+                    }
+                }
+                break;
+
+            case UBX_PARSER_PAYLOAD:
+                {
+                    const uint32_t run = MIN((uint32_t)parser->payloadLength - parser->payloadCounter, length - pos);
+                    ubxChecksumUpdate(&parser->ckA, &parser->ckB, data + pos, run);
+                    if (parser->handler) {
+                        memcpy((uint8_t *)parser->buffer + parser->payloadCounter, data + pos, run);
+                    }
+                    parser->payloadCounter += run;
+                    pos += run;
+                    if (parser->payloadCounter == parser->payloadLength) {
+                        parser->step = UBX_PARSER_CK_A;
+                    }
+                }
+                break;
+
+            case UBX_PARSER_CK_A:
+                if (data[pos++] != parser->ckA) {
+                    parser->errorCount++;
+                    parser->handler = NULL;
+                    parser->step = UBX_PARSER_SYNC1;
+                } else {
+                    parser->step = UBX_PARSER_CK_B;
+                }
+                break;
+
+            case UBX_PARSER_CK_B:
+                parser->step = UBX_PARSER_SYNC1;
+                if (data[pos++] != parser->ckB) {
+                    parser->errorCount++;
+                    parser->handler = NULL;
+                    break;
+                }
+                if (ubxDispatch(parser, (const uint8_t *)parser->buffer)) {
+                    *newSolution = true;
+                    return pos;
+                }
+                break;
+        }
+    }
+
+    return pos;
+}
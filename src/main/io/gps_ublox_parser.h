@@ -0,0 +1,100 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Streaming UBX parser.
+ *
+ * Consumes whole chunks of received bytes. Messages are dispatched through a
+ * table of handlers keyed by (class, id); the payload a handler sees is 4 byte
+ * aligned and only valid for the duration of the call. A payload that lies
+ * aligned within the chunk is passed in place, anything else is assembled in
+ * the caller supplied buffer. Messages without a handler are checksummed and
+ * skipped, never copied.
+ */
+
+// Return true if the message completed a new navigation solution
+typedef bool (*ubxMessageHandlerFnPtr)(const void *payload, uint16_t length);
+
+typedef struct ubxMessageHandler_s {
+    uint8_t msgClass;
+    uint8_t msgId;
+    uint16_t minLength;             // Shorter payloads are dropped
+    ubxMessageHandlerFnPtr fn;
+} ubxMessageHandler_t;
+
+typedef enum {
+    UBX_PARSER_SYNC1 = 0,
+    UBX_PARSER_SYNC2,
+    UBX_PARSER_CLASS,
+    UBX_PARSER_ID,
+    UBX_PARSER_LENGTH1,
+    UBX_PARSER_LENGTH2,
+    UBX_PARSER_PAYLOAD,
+    UBX_PARSER_CK_A,
+    UBX_PARSER_CK_B,
+} ubxParserStep_e;
+
+typedef struct ubxParser_s {
+    const ubxMessageHandler_t *handlers;
+    uint8_t handlerCount;
+    uint16_t maxPayloadLength;      // Longer messages are treated as garbage
+    uint32_t *buffer;               // Aligned assembly buffer, at least maxPayloadLength bytes
+    uint16_t bufferSize;
+
+    ubxParserStep_e step;
+    uint8_t msgClass;
+    uint8_t msgId;
+    uint8_t ckA;
+    uint8_t ckB;
+    uint16_t payloadLength;
+    uint16_t payloadCounter;
+    const ubxMessageHandler_t *handler;     // Handler of the message being received, NULL if skipped
+
+    uint32_t packetCount;
+    uint32_t errorCount;
+} ubxParser_t;
+
+void ubxParserInit(ubxParser_t *parser, const ubxMessageHandler_t *handlers, uint8_t handlerCount, uint32_t *buffer, uint16_t bufferSize);
+void ubxParserReset(ubxParser_t *parser);
+
+// Returns the number of bytes consumed. Stops right after a message whose handler reported a new solution.
+uint32_t ubxParserFeed(ubxParser_t *parser, const uint8_t *data, uint32_t length, bool *newSolution);
+
+// Bytes still needed before the message in progress can complete, a whole frame while hunting for sync
+uint32_t ubxParserBytesToCompletion(const ubxParser_t *parser);
+
+void ubxChecksumUpdate(uint8_t *ckA, uint8_t *ckB, const uint8_t *data, uint32_t length);
+
+#ifdef __cplusplus
+}
+#endif
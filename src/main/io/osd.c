@@ -46,6 +46,7 @@
 #include "common/filter.h"
 #include "common/log.h"
 #include "common/olc.h"
+#include "common/numfmt.h"
 #include "common/printf.h"
 #include "common/string_light.h"
 #include "common/time.h"
@@ -201,6 +202,22 @@ static bool refreshWaitForResumeCmdRelease;
 
 static bool fullRedraw = false;
 
+// Enabled elements of the active layout, in drawing order, with their
+// screen positions resolved. Rebuilt when the layout or its config changes.
+typedef struct osdRenderItem_s {
+    uint8_t item;
+    uint8_t x;
+    uint8_t y;
+} osdRenderItem_t;
+
+static osdRenderItem_t osdRenderList[OSD_ITEM_COUNT];
+static uint8_t osdRenderListCount;
+static uint8_t osdRenderListIndex;
+static bool osdRenderListValid = false;
+static uint8_t osdRenderListSensorState;   // Runtime state osdIncElementIndex() depends on
+static osdRenderItem_t osdRenderHorizon;    // OSD_ARTIFICIAL_HORIZON is drawn on every refresh
+static bool osdRenderHorizonEnabled;
+
 static uint8_t armState;
 
 static textAttributes_t osdGetMultiFunctionMessage(char *buff);
@@ -224,7 +241,8 @@ static bool osdDisplayHasCanvas;
 
 #define AH_MAX_PITCH_DEFAULT 20 // Specify default maximum AHI pitch value displayed (degrees)
 
-PG_REGISTER_WITH_RESET_TEMPLATE(osdConfig_t, osdConfig, PG_OSD_CONFIG, 15);
+// PG version is 4 bits wide, so it wraps from 15 back to 0
+PG_REGISTER_WITH_RESET_TEMPLATE(osdConfig_t, osdConfig, PG_OSD_CONFIG, 0);
 PG_REGISTER_WITH_RESET_FN(osdLayoutsConfig_t, osdLayoutsConfig, PG_OSD_LAYOUTS_CONFIG, 3);
 
 void osdStartedSaveProcess(void) {
@@ -233,6 +251,7 @@ void osdStartedSaveProcess(void) {
 
 void osdShowEEPROMSavedNotification(void) {
     savingSettings = false;
+    osdRenderListValid = false;
     notify_settings_saved = millis() + 5000;
 }
 
@@ -254,6 +273,22 @@ bool osdIsNotMetric(void) {
     return !(osdConfig()->units == OSD_UNIT_METRIC || osdConfig()->units == OSD_UNIT_METRIC_MPH);
 }
 
+// Writes "<value><sym>", equivalent to "%d%c"
+static void osdFormatIntWithSymbol(char *buff, int32_t value, uint8_t width, char sym)
+{
+    int len = numfmtSigned(buff, value, width, ' ');
+    buff[len++] = sym;
+    buff[len] = '\0';
+}
+
+// Writes "<hundredths / 100>.<hundredths % 100><sym>"
+static void osdFormatHundredthsWithSymbol(char *buff, int32_t hundredths, char sym)
+{
+    int len = numfmtFixed(buff, hundredths, 2, 0);
+    buff[len++] = sym;
+    buff[len] = '\0';
+}
+
 /**
  * Converts distance into a string based on the current unit system
  * prefixed by a a symbol to indicate the unit used.
@@ -330,11 +365,10 @@ static void osdFormatDistanceStr(char *buff, int32_t dist)
         centifeet = CENTIMETERS_TO_CENTIFEET(dist);
         if (abs(centifeet) < FEET_PER_MILE * 100 / 2) {
             // Show feet when dist < 0.5mi
-            tfp_sprintf(buff, "%d%c", (int)(centifeet / 100), SYM_FT);
+            osdFormatIntWithSymbol(buff, centifeet / 100, 0, SYM_FT);
         } else {
             // Show miles when dist >= 0.5mi
-            tfp_sprintf(buff, "%d.%02d%c", (int)(centifeet / (100*FEET_PER_MILE)),
-                (abs(centifeet) % (100 * FEET_PER_MILE)) / FEET_PER_MILE, SYM_MI);
+            osdFormatHundredthsWithSymbol(buff, centifeet / FEET_PER_MILE, SYM_MI);
         }
         break;
     case OSD_UNIT_METRIC_MPH:
@@ -342,22 +376,20 @@ static void osdFormatDistanceStr(char *buff, int32_t dist)
     case OSD_UNIT_METRIC:
         if (abs(dist) < METERS_PER_KILOMETER * 100) {
             // Show meters when dist < 1km
-            tfp_sprintf(buff, "%d%c", (int)(dist / 100), SYM_M);
+            osdFormatIntWithSymbol(buff, dist / 100, 0, SYM_M);
         } else {
             // Show kilometers when dist >= 1km
-            tfp_sprintf(buff, "%d.%02d%c", (int)(dist / (100*METERS_PER_KILOMETER)),
-                (abs(dist) % (100 * METERS_PER_KILOMETER)) / METERS_PER_KILOMETER, SYM_KM);
+            osdFormatHundredthsWithSymbol(buff, dist / METERS_PER_KILOMETER, SYM_KM);
         }
         break;
     case OSD_UNIT_GA:
          centifeet = CENTIMETERS_TO_CENTIFEET(dist);
         if (abs(centifeet) < 100000) {
             // Show feet when dist < 1000ft
-            tfp_sprintf(buff, "%d%c", (int)(centifeet / 100), SYM_FT);
+            osdFormatIntWithSymbol(buff, centifeet / 100, 0, SYM_FT);
         } else {
             // Show nautical miles when dist >= 1000ft
-            tfp_sprintf(buff, "%d.%02d%c", (int)(centifeet / (100 * FEET_PER_NAUTICALMILE)),
-                (int)((abs(centifeet) % (int)(100 * FEET_PER_NAUTICALMILE)) / FEET_PER_NAUTICALMILE), SYM_NM);
+            osdFormatHundredthsWithSymbol(buff, (int32_t)(centifeet / FEET_PER_NAUTICALMILE), SYM_NM);
         }
         break;
     }
@@ -393,33 +425,28 @@ static int32_t osdConvertVelocityToUnit(int32_t vel)
  */
 void osdFormatVelocityStr(char* buff, int32_t vel, bool _3D, bool _max)
 {
+    char sym;
     switch ((osd_unit_e)osdConfig()->units) {
     case OSD_UNIT_UK:
         FALLTHROUGH;
     case OSD_UNIT_METRIC_MPH:
         FALLTHROUGH;
     case OSD_UNIT_IMPERIAL:
-        if (_max) {
-            tfp_sprintf(buff, "%c%3d%c", SYM_MAX, (int)osdConvertVelocityToUnit(vel), (_3D ? SYM_3D_MPH : SYM_MPH));
-        } else {
-            tfp_sprintf(buff, "%3d%c", (int)osdConvertVelocityToUnit(vel), (_3D ? SYM_3D_MPH : SYM_MPH));
-        }
-        break;
-    case OSD_UNIT_METRIC:
-        if (_max) {
-            tfp_sprintf(buff, "%c%3d%c", SYM_MAX, (int)osdConvertVelocityToUnit(vel), (_3D ? SYM_3D_KMH : SYM_KMH));
-        } else {
-            tfp_sprintf(buff, "%3d%c", (int)osdConvertVelocityToUnit(vel), (_3D ? SYM_3D_KMH : SYM_KMH));
-        }
+        sym = _3D ? SYM_3D_MPH : SYM_MPH;
         break;
     case OSD_UNIT_GA:
-        if (_max) {
-            tfp_sprintf(buff, "%c%3d%c", SYM_MAX, (int)osdConvertVelocityToUnit(vel), (_3D ? SYM_3D_KT : SYM_KT));
-        } else {
-            tfp_sprintf(buff, "%3d%c", (int)osdConvertVelocityToUnit(vel), (_3D ? SYM_3D_KT : SYM_KT));
-        }
+        sym = _3D ? SYM_3D_KT : SYM_KT;
+        break;
+    case OSD_UNIT_METRIC:
+    default:
+        sym = _3D ? SYM_3D_KMH : SYM_KMH;
         break;
     }
+
+    if (_max) {
+        *buff++ = SYM_MAX;
+    }
+    osdFormatIntWithSymbol(buff, osdConvertVelocityToUnit(vel), 3, sym);
 }
 
 /**
@@ -550,13 +577,13 @@ static void osdFormatAltitudeStr(char *buff, int32_t alt)
             FALLTHROUGH;
         case OSD_UNIT_IMPERIAL:
             value = CENTIMETERS_TO_FEET(alt);
-            tfp_sprintf(buff, "%d%c", (int)value, SYM_FT);
+            osdFormatIntWithSymbol(buff, value, 0, SYM_FT);
             break;
         case OSD_UNIT_METRIC_MPH:
             FALLTHROUGH;
         case OSD_UNIT_METRIC:
             value = CENTIMETERS_TO_METERS(alt);
-            tfp_sprintf(buff, "%d%c", (int)value, SYM_M);
+            osdFormatIntWithSymbol(buff, value, 0, SYM_M);
             break;
     }
 }
@@ -571,7 +598,9 @@ static void osdFormatTime(char *buff, uint32_t seconds, char sym_m, char sym_h)
         value = seconds / 60;
     }
     buff[0] = sym;
-    tfp_sprintf(buff + 1, "%02d:%02d", (int)(value / 60), (int)(value % 60));
+    int len = 1 + numfmtUnsigned(buff + 1, value / 60, 2, '0');
+    buff[len++] = ':';
+    numfmtUnsigned(buff + len, value % 60, 2, '0');
 }
 
 static inline void osdFormatOnTime(char *buff)
@@ -682,7 +711,7 @@ static void osdDisplayTemperature(uint8_t elemPosX, uint8_t elemPosY, uint16_t s
 
         if ((temperature <= alarm_min) || (temperature >= alarm_max)) TEXT_ATTRIBUTES_ADD_BLINK(elemAttr);
         if (osdConfig()->units == OSD_UNIT_IMPERIAL) temperature = temperature * 9 / 5.0f + 320;
-        tfp_sprintf(buff, "%3d", temperature / 10);
+        numfmtSigned(buff, temperature / 10, 3, ' ');
 
     } else
         strcpy(buff, "---");
@@ -713,7 +742,12 @@ static void osdFormatCoordinate(char *buff, char sym, int32_t val)
     int32_t integerPart = val / GPS_DEGREES_DIVIDER;
     // Latitude maximum integer width is 3 (-90) while
     // longitude maximum integer width is 4 (-180).
-    int integerDigits = tfp_sprintf(buff + 1, (integerPart == 0 && val < 0) ? "-%d" : "%d", (int)integerPart);
+    int integerDigits = 0;
+    if (integerPart == 0 && val < 0) {
+        buff[1] = '-';
+        integerDigits++;
+    }
+    integerDigits += numfmtSigned(buff + 1 + integerDigits, integerPart, 0, ' ');
     // We can show up to 7 digits in decimalPart.
     int32_t decimalPart = abs(val % (int)GPS_DEGREES_DIVIDER);
     STATIC_ASSERT(GPS_DEGREES_DIVIDER == 1e7, adjust_max_decimal_digits);
@@ -727,13 +761,14 @@ static void osdFormatCoordinate(char *buff, char sym, int32_t val)
 #endif
 
     if (!djiCompat) {
-        decimalDigits = tfp_sprintf(buff + 1 + integerDigits, "%07d", (int)decimalPart);
+        decimalDigits = numfmtUnsigned(buff + 1 + integerDigits, decimalPart, 7, '0');
         // Embbed the decimal separator
         buff[1 + integerDigits - 1] += SYM_ZERO_HALF_TRAILING_DOT - '0';
         buff[1 + integerDigits] += SYM_ZERO_HALF_LEADING_DOT - '0';
     } else {
         // DJICOMPAT mode enabled
-        decimalDigits = tfp_sprintf(buff + 1 + integerDigits, ".%06d", (int)decimalPart);
+        buff[1 + integerDigits] = '.';
+        decimalDigits = 1 + numfmtUnsigned(buff + 2 + integerDigits, decimalPart, 6, '0');
     }
     // Fill up to coordinateLength with zeros
     int total = 1 + integerDigits + decimalDigits;
@@ -1037,12 +1072,16 @@ static const char * navigationStateMessage(void)
 
 static void osdFormatMessage(char *buff, size_t size, const char *message, bool isCenteredText)
 {
+    if (message && isCenteredText && strlen(message) < size) {
+        // SYM_BLANK is a space, the padding numfmtCentered() uses
+        numfmtCentered(buff, message, size);
+        return;
+    }
+
     // String is always filled with Blanks
     memset(buff, SYM_BLANK, size);
     if (message) {
-        size_t messageLength = strlen(message);
-        int rem = isCenteredText ? MAX(0, (int)size - (int)messageLength) : 0;
-        strncpy(buff + rem / 2, message, MIN((int)size - rem / 2, (int)messageLength));
+        strncpy(buff, message, MIN(size, strlen(message)));
     }
     // Ensure buff is zero terminated
     buff[size] = '\0';
@@ -1209,7 +1248,7 @@ static bool osdIsHeadingValid(void)
 
 int16_t osdGetHeading(void)
 {
-    return attitude.values.yaw;
+    return imuGetAttitude()->values.yaw;
 }
 
 int16_t osdGetPanServoOffset(void)
@@ -1669,14 +1708,19 @@ static bool osdElementEnabled(uint8_t elementID, bool onlyCurrentLayout) {
     return elementEnabled;
 }
 
+static bool osdDrawElementAt(uint8_t item, uint8_t elemPosX, uint8_t elemPosY);
+
 static bool osdDrawSingleElement(uint8_t item)
 {
     uint16_t pos = osdLayoutsConfig()->item_pos[currentLayout][item];
     if (!OSD_VISIBLE(pos)) {
         return false;
     }
-    uint8_t elemPosX = OSD_X(pos);
-    uint8_t elemPosY = OSD_Y(pos);
+    return osdDrawElementAt(item, OSD_X(pos), OSD_Y(pos));
+}
+
+static bool osdDrawElementAt(uint8_t item, uint8_t elemPosX, uint8_t elemPosY)
+{
     textAttributes_t elemAttr = TEXT_ATTRIBUTES_NONE;
     char buff[32] = {0};
 
@@ -2228,16 +2272,16 @@ static bool osdDrawSingleElement(uint8_t item)
             buff[adsblen]='\0';
             displayWrite(osdDisplayPort, elemPosX, elemPosY, buff); // clear any previous chars because variable element size
             adsblen=1;
-            adsbVehicle_t *vehicle = findVehicleClosest();
-
-            if(vehicle != NULL){
-                recalculateVehicle(vehicle);
+            // Predicted conflict takes precedence over the plane that is just closest
+            adsbVehicle_t *vehicle = findVehicleMostThreatening();
+            if (vehicle == NULL) {
+                vehicle = findVehicleClosest();
             }
 
             if (
                     vehicle != NULL &&
                     (vehicle->calculatedVehicleValues.dist > 0) &&
-                    vehicle->calculatedVehicleValues.dist < METERS_TO_CENTIMETERS(osdConfig()->adsb_distance_warning) &&
+                    (vehicle->calculatedVehicleValues.threatLevel != ADSB_THREAT_NONE || vehicle->calculatedVehicleValues.dist < METERS_TO_CENTIMETERS(osdConfig()->adsb_distance_warning)) &&
                     (osdConfig()->adsb_ignore_plane_above_me_limit == 0 || METERS_TO_CENTIMETERS(osdConfig()->adsb_ignore_plane_above_me_limit) > vehicle->calculatedVehicleValues.verticalDistance)
             ){
                 buff[0] = SYM_ADSB;
@@ -2250,7 +2294,7 @@ static bool osdDrawSingleElement(uint8_t item)
                 osdFormatDistanceStr(&buff[adsblen], vehicle->calculatedVehicleValues.verticalDistance);
                 adsblen = strlen(buff)-1;
 
-                if (vehicle->calculatedVehicleValues.dist < METERS_TO_CENTIMETERS(osdConfig()->adsb_distance_alert)) {
+                if (vehicle->calculatedVehicleValues.threatLevel == ADSB_THREAT_HIGH || vehicle->calculatedVehicleValues.dist < METERS_TO_CENTIMETERS(osdConfig()->adsb_distance_alert)) {
                     TEXT_ATTRIBUTES_ADD_BLINK(elemAttr);
                 }
             }
@@ -2897,25 +2941,25 @@ static bool osdDrawSingleElement(uint8_t item)
 
     case OSD_ATTITUDE_ROLL:
         buff[0] = SYM_ROLL_LEVEL;
-        if (ABS(attitude.values.roll) >= 1)
-            buff[0] += (attitude.values.roll < 0 ? -1 : 1);
-        osdFormatCentiNumber(buff + 1, DECIDEGREES_TO_CENTIDEGREES(ABS(attitude.values.roll)), 0, 1, 0, 3, false);
+        if (ABS(imuGetAttitude()->values.roll) >= 1)
+            buff[0] += (imuGetAttitude()->values.roll < 0 ? -1 : 1);
+        osdFormatCentiNumber(buff + 1, DECIDEGREES_TO_CENTIDEGREES(ABS(imuGetAttitude()->values.roll)), 0, 1, 0, 3, false);
         break;
 
     case OSD_ATTITUDE_PITCH:
-        if (ABS(attitude.values.pitch) < 1)
+        if (ABS(imuGetAttitude()->values.pitch) < 1)
             buff[0] = 'P';
-        else if (attitude.values.pitch > 0)
+        else if (imuGetAttitude()->values.pitch > 0)
             buff[0] = SYM_PITCH_DOWN;
-        else if (attitude.values.pitch < 0)
+        else if (imuGetAttitude()->values.pitch < 0)
             buff[0] = SYM_PITCH_UP;
-        osdFormatCentiNumber(buff + 1, DECIDEGREES_TO_CENTIDEGREES(ABS(attitude.values.pitch)), 0, 1, 0, 3, false);
+        osdFormatCentiNumber(buff + 1, DECIDEGREES_TO_CENTIDEGREES(ABS(imuGetAttitude()->values.pitch)), 0, 1, 0, 3, false);
         break;
 
     case OSD_ARTIFICIAL_HORIZON:
         {
-            float rollAngle = DECIDEGREES_TO_RADIANS(attitude.values.roll);
-            float pitchAngle = DECIDEGREES_TO_RADIANS(attitude.values.pitch);
+            float rollAngle = DECIDEGREES_TO_RADIANS(imuGetAttitude()->values.roll);
+            float pitchAngle = DECIDEGREES_TO_RADIANS(imuGetAttitude()->values.pitch);
 
             pitchAngle -= osdConfig()->ahi_camera_uptilt_comp ? DEGREES_TO_RADIANS(osdConfig()->camera_uptilt) : 0;
             pitchAngle += DEGREES_TO_RADIANS(getFixedWingLevelTrim());
@@ -3658,7 +3702,7 @@ static bool osdDrawSingleElement(uint8_t item)
             float horizontalWindSpeed;
             uint16_t angle;
             horizontalWindSpeed = getEstimatedHorizontalWindSpeed(&angle);
-            int16_t windDirection = osdGetHeadingAngle( CENTIDEGREES_TO_DEGREES((int)angle) - DECIDEGREES_TO_DEGREES(attitude.values.yaw) + 22);
+            int16_t windDirection = osdGetHeadingAngle( CENTIDEGREES_TO_DEGREES((int)angle) - DECIDEGREES_TO_DEGREES(imuGetAttitude()->values.yaw) + 22);
             buff[0] = SYM_WIND_HORIZONTAL;
             buff[1] = SYM_DECORATION + (windDirection*2 / 90);
             osdFormatWindSpeedStr(buff + 2, horizontalWindSpeed, valid);
@@ -4153,17 +4197,67 @@ uint8_t osdIncElementIndex(uint8_t elementIndex)
     return elementIndex;
 }
 
-void osdDrawNextElement(void)
+// Features are latched at boot, but sensor detection and ESC telemetry can change at runtime
+static uint8_t osdGetRenderListSensorState(void)
 {
-    static uint8_t elementIndex = 0;
-    // Flag for end of loop, also prevents infinite loop when no elements are enabled
-    uint8_t index = elementIndex;
+    return (STATE(ESC_SENSOR_ENABLED) ? BIT(0) : 0) |
+           (sensors(SENSOR_MAG) ? BIT(1) : 0) |
+           (sensors(SENSOR_ACC) ? BIT(2) : 0);
+}
+
+/*
+ * Walk the active layout once in osdIncElementIndex() order and keep only
+ * the visible elements, so each refresh can draw the next one directly.
+ */
+static void osdCompileRenderList(void)
+{
+    const uint16_t *itemPos = osdLayoutsConfig()->item_pos[currentLayout];
+    uint8_t elementIndex = 0;
+
+    osdRenderListCount = 0;
     do {
         elementIndex = osdIncElementIndex(elementIndex);
-    } while (!osdDrawSingleElement(elementIndex) && index != elementIndex);
+        const uint16_t pos = itemPos[elementIndex];
+        if (OSD_VISIBLE(pos)) {
+            osdRenderItem_t *renderItem = &osdRenderList[osdRenderListCount++];
+            renderItem->item = elementIndex;
+            renderItem->x = OSD_X(pos);
+            renderItem->y = OSD_Y(pos);
+        }
+    } while (elementIndex != 0);
+
+    const uint16_t horizonPos = itemPos[OSD_ARTIFICIAL_HORIZON];
+    osdRenderHorizonEnabled = OSD_VISIBLE(horizonPos);
+    osdRenderHorizon.item = OSD_ARTIFICIAL_HORIZON;
+    osdRenderHorizon.x = OSD_X(horizonPos);
+    osdRenderHorizon.y = OSD_Y(horizonPos);
+
+    osdRenderListIndex = 0;
+    osdRenderListSensorState = osdGetRenderListSensorState();
+    osdRenderListValid = true;
+}
+
+void osdDrawNextElement(void)
+{
+    if (!osdRenderListValid || osdRenderListSensorState != osdGetRenderListSensorState()) {
+        osdCompileRenderList();
+    }
+
+    // Elements without output for the current state (e.g. missing sensor data) are skipped
+    for (uint8_t tries = 0; tries < osdRenderListCount; tries++) {
+        const osdRenderItem_t *renderItem = &osdRenderList[osdRenderListIndex];
+        if (++osdRenderListIndex >= osdRenderListCount) {
+            osdRenderListIndex = 0;
+        }
+        if (osdDrawElementAt(renderItem->item, renderItem->x, renderItem->y)) {
+            break;
+        }
+    }
 
     // Draw artificial horizon + tracking telemetry last
-    osdDrawSingleElement(OSD_ARTIFICIAL_HORIZON);
+    if (osdRenderHorizonEnabled) {
+        osdDrawElementAt(osdRenderHorizon.item, osdRenderHorizon.x, osdRenderHorizon.y);
+    }
     if (osdConfig()->telemetry>0){
         osdDisplayTelemetry();
     }
@@ -4214,6 +4308,7 @@ PG_RESET_TEMPLATE(osdConfig_t, osdConfig,
     .video_system = SETTING_OSD_VIDEO_SYSTEM_DEFAULT,
     .row_shiftdown = SETTING_OSD_ROW_SHIFTDOWN_DEFAULT,
     .msp_displayport_fullframe_interval = SETTING_OSD_MSP_DISPLAYPORT_FULLFRAME_INTERVAL_DEFAULT,
+    .msp_displayport_batch = SETTING_OSD_MSP_DISPLAYPORT_BATCH_DEFAULT,
 
     .ahi_reverse_roll = SETTING_OSD_AHI_REVERSE_ROLL_DEFAULT,
     .ahi_max_pitch = SETTING_OSD_AHI_MAX_PITCH_DEFAULT,
@@ -5983,6 +6078,7 @@ void osdUpdate(timeUs_t currentTimeUs)
 void osdStartFullRedraw(void)
 {
     fullRedraw = true;
+    osdRenderListValid = false;
 }
 
 void osdOverrideLayout(int layout, timeMs_t duration)
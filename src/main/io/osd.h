@@ -412,6 +412,7 @@ typedef struct osdConfig_s {
     videoSystem_e   video_system;
     uint8_t         row_shiftdown;
     int16_t         msp_displayport_fullframe_interval;
+    bool            msp_displayport_batch;              // Pack several string runs into one MSP_DISPLAYPORT frame
 
     // Preferences
     uint8_t         main_voltage_decimals;
@@ -1267,9 +1267,9 @@ static mspResult_e djiProcessMspCommand(mspPacket_t *cmd, mspPacket_t *reply, ms
             break;
 
         case DJI_MSP_ATTITUDE:
-            sbufWriteU16(dst, attitude.values.roll);
-            sbufWriteU16(dst, attitude.values.pitch);
-            sbufWriteU16(dst, DECIDEGREES_TO_DEGREES(attitude.values.yaw));
+            sbufWriteU16(dst, imuGetAttitude()->values.roll);
+            sbufWriteU16(dst, imuGetAttitude()->values.pitch);
+            sbufWriteU16(dst, DECIDEGREES_TO_DEGREES(imuGetAttitude()->values.yaw));
             break;
 
         case DJI_MSP_ALTITUDE:
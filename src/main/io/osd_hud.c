@@ -152,7 +152,7 @@ void osdHudDrawPoi(uint32_t poiDistance, int16_t poiDirection, int32_t poiAltitu
         } else { // POI is on sight, compute the vertical
             float poi_angle = atan2_approx(-poiAltitude, poiDistance);
             poi_angle = RADIANS_TO_DEGREES(poi_angle);
-            int16_t plane_angle = attitude.values.pitch / 10;
+            int16_t plane_angle = imuGetAttitude()->values.pitch / 10;
             int camera_angle = osdConfig()->camera_uptilt;
             int16_t error_y = poi_angle - plane_angle + camera_angle;
             float scaled_y = sin_approx(DEGREES_TO_RADIANS(error_y)) / sin_approx(DEGREES_TO_RADIANS(osdConfig()->camera_fov_v / 2));
@@ -382,7 +382,7 @@ void osdHudDrawHoming(uint8_t px, uint8_t py)
 
         float crh_home_angle = atan2_approx(crh_altitude, crh_distance);
         crh_home_angle = RADIANS_TO_DEGREES(crh_home_angle);
-        int crh_plane_angle = attitude.values.pitch / 10;
+        int crh_plane_angle = imuGetAttitude()->values.pitch / 10;
         int crh_camera_angle = osdConfig()->camera_uptilt;
         int crh_diff_vert = crh_home_angle - crh_plane_angle + crh_camera_angle;
 
@@ -18,7 +18,7 @@
 #include "io/osd_utils.h"
 
 #include "common/maths.h"
-#include "common/typeconversion.h"
+#include "common/numfmt.h"
 #include "drivers/osd_symbols.h"
 #include "io/displayport_msp_dji_compat.h"
 
@@ -119,8 +119,7 @@ bool osdFormatCentiNumber(char *buff, int32_t centivalue, uint32_t scale, int ma
         ptr++;
     }
     // Now write the digits.
-    ui2a(integerPart, 10, 0, ptr);
-    ptr += digits;
+    ptr += numfmtUnsigned(ptr, integerPart, 0, ' ');
 
     if (decimals > 0) {
         if (explicitDecimal) {
@@ -135,13 +134,7 @@ bool osdFormatCentiNumber(char *buff, int32_t centivalue, uint32_t scale, int ma
             factor--;
             millis /= 10;
         }
-        int decimalDigits = digitCount(millis);
-        while (decimalDigits < decimals) {
-            decimalDigits++;
-            *ptr = '0';
-            ptr++;
-        }
-        ui2a(millis, 10, 0, ptr);
+        numfmtUnsigned(ptr, millis, decimals, '0');
         if (!explicitDecimal) {
             *dec += SYM_ZERO_HALF_LEADING_DOT - '0';
         }
@@ -119,4 +119,9 @@
 #define MSP2_INAV_GEOZONE                      0x2210
 #define MSP2_INAV_SET_GEOZONE                  0x2211
 #define MSP2_INAV_GEOZONE_VERTEX               0x2212
-#define MSP2_INAV_SET_GEOZONE_VERTEX           0x2213
\ No newline at end of file
+#define MSP2_INAV_SET_GEOZONE_VERTEX           0x2213
+
+#define MSP2_INAV_CONFIG_SNAPSHOT              0x2220
+#define MSP2_INAV_SET_CONFIG_SNAPSHOT          0x2221
+
+#define MSP2_INAV_RX_LATENCY                   0x2230
@@ -259,14 +259,6 @@ static bool mspSerialProcessReceivedData(mspPort_t *mspPort, uint8_t c)
     return true;
 }
 
-static uint8_t mspSerialChecksumBuf(uint8_t checksum, const uint8_t *data, int len)
-{
-    while (len-- > 0) {
-        checksum ^= *data++;
-    }
-    return checksum;
-}
-
 #define JUMBO_FRAME_SIZE_LIMIT 255
 static int mspSerialSendFrame(mspPort_t *msp, const uint8_t * hdr, int hdrLen, const uint8_t * data, int dataLen, const uint8_t * crc, int crcLen)
 {
@@ -327,8 +319,8 @@ static int mspSerialEncode(mspPort_t *msp, mspPacket_t *packet, mspVersion_e msp
         }
 
         // Pre-calculate CRC
-        crcBuf[crcLen] = mspSerialChecksumBuf(0, hdrBuf + V1_CHECKSUM_STARTPOS, hdrLen - V1_CHECKSUM_STARTPOS);
-        crcBuf[crcLen] = mspSerialChecksumBuf(crcBuf[crcLen], sbufPtr(&packet->buf), dataLen);
+        crcBuf[crcLen] = crc8_xor_update(0, hdrBuf + V1_CHECKSUM_STARTPOS, hdrLen - V1_CHECKSUM_STARTPOS);
+        crcBuf[crcLen] = crc8_xor_update(crcBuf[crcLen], sbufPtr(&packet->buf), dataLen);
         crcLen++;
     }
     else if (mspVersion == MSP_V2_OVER_V1) {
@@ -365,9 +357,9 @@ static int mspSerialEncode(mspPort_t *msp, mspPacket_t *packet, mspVersion_e msp
         crcLen++;
 
         // V1 CRC: All headers + data payload + V2 CRC byte
-        crcBuf[crcLen] = mspSerialChecksumBuf(0, hdrBuf + V1_CHECKSUM_STARTPOS, hdrLen - V1_CHECKSUM_STARTPOS);
-        crcBuf[crcLen] = mspSerialChecksumBuf(crcBuf[crcLen], sbufPtr(&packet->buf), dataLen);
-        crcBuf[crcLen] = mspSerialChecksumBuf(crcBuf[crcLen], crcBuf, crcLen);
+        crcBuf[crcLen] = crc8_xor_update(0, hdrBuf + V1_CHECKSUM_STARTPOS, hdrLen - V1_CHECKSUM_STARTPOS);
+        crcBuf[crcLen] = crc8_xor_update(crcBuf[crcLen], sbufPtr(&packet->buf), dataLen);
+        crcBuf[crcLen] = crc8_xor_update(crcBuf[crcLen], crcBuf, crcLen);
         crcLen++;
     }
     else if (mspVersion == MSP_V2_NATIVE) {
@@ -268,6 +268,8 @@ uint16_t navFlags;
 uint16_t navEPH;
 uint16_t navEPV;
 int16_t navAccNEU[3];
+uint16_t navGpsLatency;
+uint8_t navPosHistoryDepth;
 //End of blackbox states
 
 static fpVector3_t * rthGetHomeTargetPosition(rthTargetMode_e mode);
@@ -1688,7 +1690,10 @@ static navigationFSMEvent_t navOnEnteringState_NAV_STATE_RTH_HEAD_HOME(navigatio
 #ifdef USE_GEOZONE
         // Check for NFZ in our way
         int8_t wpCount = geozoneCheckForNFZAtCourse(true);
-        if (wpCount > 0) {
+        if (wpCount == GEOZONE_RTH_COURSE_PENDING) {
+            // Course around the zones is calculated over several cycles, keep the current target meanwhile
+            return NAV_FSM_EVENT_NONE;
+        } else if (wpCount > 0) {
             calculateAndSetActiveWaypointToLocalPosition(geozoneGetCurrentRthAvoidWaypoint());
             return NAV_FSM_EVENT_NONE;
         } else if (geozone.avoidInRTHInProgress) {
@@ -3941,6 +3946,37 @@ void setWaypoint(uint8_t wpNumber, const navWaypoint_t * wpData)
     }
 }
 
+// Replace a waypoint of the loaded mission, the number of waypoints doesn't change
+bool replaceWaypoint(uint8_t wpNumber, const navWaypoint_t * wpData)
+{
+    // Not allowed while WP mode is active or on a multi mission
+    if ((wpNumber < 1) || (wpNumber > posControl.waypointCount) || FLIGHT_MODE(NAV_WP_MODE)) {
+        return false;
+    }
+#ifdef USE_MULTI_MISSION
+    if (posControl.multiMissionCount > 1) {
+        return false;
+    }
+#endif
+
+    navWaypoint_t *wp = &posControl.waypointList[wpNumber - 1];
+    *wp = *wpData;
+    wp->flag = (wpNumber == posControl.waypointCount) ? NAV_WP_FLAG_LAST : 0;
+    if (wp->action == NAV_WP_ACTION_JUMP) {
+        wp->p1 -= 1; // make index (vice WP #)
+    }
+
+    posControl.geoWaypointCount = 0;
+    for (int i = 0; i < posControl.waypointCount; i++) {
+        const uint8_t action = posControl.waypointList[i].action;
+        if (action != NAV_WP_ACTION_SET_POI && action != NAV_WP_ACTION_SET_HEAD && action != NAV_WP_ACTION_JUMP) {
+            posControl.geoWaypointCount++;
+        }
+    }
+
+    return true;
+}
+
 void resetWaypointList(void)
 {
     posControl.waypointCount = 0;
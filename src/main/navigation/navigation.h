@@ -153,6 +153,8 @@ enum noWayHomeAction {
 #define GEOZONE_TYPE_EXCLUSIVE 0
 #define GEOZONE_TYPE_INCLUSIVE 1
 
+#define GEOZONE_RTH_COURSE_PENDING -2
+
 typedef struct geoZoneConfig_s
 {
     uint8_t shape;
@@ -277,6 +279,11 @@ typedef enum {
     NAV_RESET_ON_EACH_ARM,
 } nav_reset_type_e;
 
+typedef enum {
+    NAV_ESTIMATOR_COMPLEMENTARY = 0,
+    NAV_ESTIMATOR_EKF,
+} navPositionEstimatorType_e;
+
 typedef enum {
     NAV_RTH_ALLOW_LANDING_NEVER = 0,
     NAV_RTH_ALLOW_LANDING_ALWAYS = 1,
@@ -382,6 +389,10 @@ typedef struct positionEstimationConfig_s {
 #ifdef USE_GPS_FIX_ESTIMATION
     uint8_t allow_gps_fix_estimation;
 #endif
+
+    uint8_t estimator_type;     // navPositionEstimatorType_e
+    uint16_t ekf_acc_noise;     // EKF accelerometer process noise (cm/s/s)
+    uint16_t gps_latency;       // GPS measurement latency (ms), 0 to fuse GPS as current
 } positionEstimationConfig_t;
 
 PG_DECLARE(positionEstimationConfig_t, positionEstimationConfig);
@@ -706,6 +717,7 @@ int getWaypointCount(void);
 bool isWaypointListValid(void);
 void getWaypoint(uint8_t wpNumber, navWaypoint_t * wpData);
 void setWaypoint(uint8_t wpNumber, const navWaypoint_t * wpData);
+bool replaceWaypoint(uint8_t wpNumber, const navWaypoint_t * wpData);
 void resetWaypointList(void);
 bool loadNonVolatileWaypointList(bool clearIfLoaded);
 bool saveNonVolatileWaypointList(void);
@@ -839,3 +851,5 @@ extern uint16_t navFlags;
 extern uint16_t navEPH;
 extern uint16_t navEPV;
 extern int16_t navAccNEU[3];
+extern uint16_t navGpsLatency;
+extern uint8_t navPosHistoryDepth;
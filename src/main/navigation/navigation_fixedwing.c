@@ -757,14 +757,14 @@ bool isFixedWingLandingDetected(void)
         DEBUG_SET(DEBUG_LANDING, 4, 2);
         DEBUG_SET(DEBUG_LANDING, 5, fixAxisCheck);
         if (!fixAxisCheck) {        // capture roll and pitch angles to be used as datums to check for absolute change
-            fwLandSetRollDatum = attitude.values.roll;  //0.1 deg increments
-            fwLandSetPitchDatum = attitude.values.pitch;
+            fwLandSetRollDatum = imuGetAttitude()->values.roll;  //0.1 deg increments
+            fwLandSetPitchDatum = imuGetAttitude()->values.pitch;
             fixAxisCheck = true;
             fwLandingTimerStartAt = currentTimeMs;
         } else {
             const uint8_t angleLimit = 5 * sensitivity;
-            bool isRollAxisStatic = ABS(fwLandSetRollDatum - attitude.values.roll) < angleLimit;
-            bool isPitchAxisStatic = ABS(fwLandSetPitchDatum - attitude.values.pitch) < angleLimit;
+            bool isRollAxisStatic = ABS(fwLandSetRollDatum - imuGetAttitude()->values.roll) < angleLimit;
+            bool isPitchAxisStatic = ABS(fwLandSetPitchDatum - imuGetAttitude()->values.pitch) < angleLimit;
             DEBUG_SET(DEBUG_LANDING, 6, isRollAxisStatic);
             DEBUG_SET(DEBUG_LANDING, 7, isPitchAxisStatic);
             if (isRollAxisStatic && isPitchAxisStatic) {
@@ -47,6 +47,8 @@
 
 #include "navigation/navigation.h"
 #include "navigation/navigation_private.h"
+#include "navigation/navigation_geozone_index.h"
+#include "navigation/navigation_geozone_planner.h"
 
 #ifdef USE_GEOZONE
 
@@ -54,7 +56,6 @@
 #define MAX_GEOZONES (MAX_GEOZONES_IN_CONFIG + 1) // +1 for safe home
 
 #define MAX_DISTANCE_FLY_OVER_POINTS 50000
-#define MAX_PATH_PONITS (2 + 2 * MAX_VERTICES)
 #define POS_DETECTION_DISTANCE 7500 
 #define STICK_LOCK_MIN_TIME 2500
 #define AVOID_TIMEOUT 30000
@@ -62,8 +63,10 @@
 #define GEOZONE_INCLUSE_IGNORE_DISTANCE 2000 * 100 // m
 #define STICK_MOVE_THRESHOULD 40
 #define MAX_RTH_WAYPOINTS (MAX_VERTICES / 2)
+#define CIRCLE_POLY_SIDES 6
 #define GEOZONE_INACTIVE INT8_MAX
 #define RTH_OVERRIDE_TIMEOUT 1000
+#define GEOZONE_RTH_PLANNER_SLICE_US 500
 
 #define K_EPSILON 1e-8f
 
@@ -87,19 +90,21 @@ typedef struct geoZoneRuntimeConfig_s
     bool isInfZone;
     uint32_t radius;
     fpVector2_t *verticesLocal;
+    // Geometry cache, filled by geoZoneInit
+    float *edgeLengths;         // Rounded length of edge i (vertex i-1 to i)
+    float capNormalZ;           // Normal of the floor and ceiling planes, only z is non zero
 } geoZoneRuntimeConfig_t;
 
-typedef struct pathPoint_s pathPoint_t;
-struct pathPoint_s {
-    fpVector3_t point;
-    pathPoint_t* prev;
-    float distance;
-    bool visited;
-};
+typedef enum {
+    RTH_PLANNER_STATE_IDLE,
+    RTH_PLANNER_STATE_COLLECT,
+    RTH_PLANNER_STATE_SEARCH
+} rthPlannerState_e;
 
 static bool isInitalised = false;
 static geoZoneRuntimeConfig_t *currentZones[MAX_GEOZONES];
 static fpVector2_t verticesLocal[MAX_VERTICES];
+static float edgeLengthsLocal[MAX_VERTICES];
 static uint8_t currentZoneCount = 0;
 
 static bool isAtLeastOneInclusiveZoneActive = false;
@@ -121,6 +126,17 @@ static timeMs_t rthOverrideStartTime;
 static bool noZoneRTH = false;
 static bool rthHomeSwitchLastState = false;
 static bool lockRTZ = false;
+static geozonePlanner_t rthPlanner;
+static rthPlannerState_e rthPlannerState = RTH_PLANNER_STATE_IDLE;
+static uint8_t rthPlannerZoneIdx;
+static fpVector3_t rthPlannerTarget;
+static bool rthRouteValid = false;    // Route is read back from rthPlanner
+static fpVector3_t rthRouteTarget;
+static fpVector3_t rthRouteSafeHome;
+static geozoneIndex_t geozoneIndex;
+static bool geozoneIndexValid = false;
+
+STATIC_ASSERT(MAX_GEOZONES <= GEOZONE_INDEX_MAX_ZONES, MAX_GEOZONES_exceeds_geozone_index_capacity);
 
 geozone_t geozone;
 
@@ -430,12 +446,12 @@ static fpVector2_t calcNearestPointOnLine(const fpVector2_t *lineStart, const fp
 	return result;
 }
 
-static bool isPointOnLine2(const fpVector2_t *lineStart, const fpVector2_t *lineEnd, const fpVector2_t *linepoint) 
+// lineLength: roundf(calculateDistance2(lineStart, lineEnd))
+static bool isPointOnLine2(const fpVector2_t *lineStart, const fpVector2_t *lineEnd, const float lineLength, const fpVector2_t *linepoint) 
 {
 	float a = roundf(calculateDistance2(linepoint, lineStart));
 	float b = roundf(calculateDistance2(linepoint, lineEnd));
-	float c = roundf(calculateDistance2(lineStart, lineEnd));
-	return a + b == c;
+	return a + b == lineLength;
 }
 
 static bool isPointOnLine3(const fpVector3_t *lineStart, const fpVector3_t *lineEnd, const fpVector3_t *linepoint) 
@@ -494,16 +510,14 @@ static bool calcLineTriangleIntersection(fpVector3_t *intersection, const fpVect
 }
 
 
-static bool calcLinePolygonIntersection(fpVector3_t *intersect, const fpVector3_t *pos, const fpVector3_t *pos2, const float height, fpVector2_t* vertices, const uint8_t verticesNum) 
+static bool calcLinePolygonIntersection(fpVector3_t *intersect, const fpVector3_t *pos, const fpVector3_t *pos2, const float height, fpVector2_t* vertices, const uint8_t verticesNum, const float normalZ) 
 {
 	if (verticesNum < 3) {
 		return false;
 	}
 	
 	fpVector3_t p1 = { .x = vertices[0].x, .y = vertices[0].y, .z = height };
-	fpVector3_t p2 = { .x = vertices[1].x, .y = vertices[1].y, .z = height };
-	fpVector3_t p3 = { .x = vertices[2].x, .y = vertices[2].y, .z = height };
-	fpVector3_t normale = calcPlaneNormalFromPoints(&p1, &p2, &p3);
+	fpVector3_t normale = { .x = 0, .y = 0, .z = normalZ };
 	fpVector3_t dir = calcDirVectorFromPoints(pos, pos2);
 
 	fpVector3_t tmp;	
@@ -584,7 +598,7 @@ static void generateOffsetPolygon(fpVector2_t* verticesNew, fpVector2_t* vertice
 
 // Calculates the nearest intersection point
 // Inspired by raytracing algortyhms
-static bool calcLineCylinderIntersection(fpVector3_t* intersection, float* distance, const fpVector3_t* startPos, const fpVector3_t* endPos, const fpVector3_t* circleCenter, const float radius, const float height, const bool inside)
+static bool calcLineCylinderIntersection(fpVector3_t* intersection, float* distance, const fpVector3_t* startPos, const fpVector3_t* endPos, const fpVector3_t* circleCenter, const float radius, const float height, const float normalZ, const bool inside)
 {
 	float distToIntersection = FLT_MAX;
 	fpVector3_t intersect;
@@ -624,13 +638,8 @@ static bool calcLineCylinderIntersection(fpVector3_t* intersection, float* dista
 
 	fpVector3_t intersectCap;
 	fpVector3_t dir = calcDirVectorFromPoints(startPos, endPos);
+	const fpVector3_t normal = { .x = 0, .y = 0, .z = normalZ };
 	if (startPos->z < circleCenter->z || (inside && circleCenter->z != 0)) {
-		fpVector3_t p1 = *circleCenter;
-		p1.x = circleCenter->x + radius;
-		fpVector3_t p2 = *circleCenter;
-		p2.y = circleCenter->y + radius;
-		fpVector3_t normal = calcPlaneNormalFromPoints(circleCenter, &p1, &p2);
-
 		if (calcIntersectionLinePlane(&intersectCap, &dir, endPos, &normal, circleCenter)
 			&& isPointInCircle((fpVector2_t*)&intersectCap, (fpVector2_t*)circleCenter, radius)
 			&& isInFront(startPos, &intersectCap, endPos)) {
@@ -643,11 +652,8 @@ static bool calcLineCylinderIntersection(fpVector3_t* intersection, float* dista
 	}
 
 	if (startPos->z > circleCenter->z + height || inside) {
-		fpVector3_t p1 = { .x = circleCenter->x + radius, .y = circleCenter->y, .z = circleCenter->z + height };
-		fpVector3_t p2 = { .x = circleCenter->x, .y = circleCenter->y + radius, .z = circleCenter->z + height };
 		fpVector3_t p3 = *circleCenter;
 		p3.z = circleCenter->z + height;
-		fpVector3_t normal = calcPlaneNormalFromPoints(&p3, &p1, &p2);
 
 		if (calcIntersectionLinePlane(&intersectCap, &dir, startPos, &normal, &p3)
 			&& isPointInCircle((fpVector2_t*)&intersectCap, (fpVector2_t*)circleCenter, radius)
@@ -668,15 +674,28 @@ static bool calcLineCylinderIntersection(fpVector3_t* intersection, float* dista
 	return false;
 }
 
-static bool calcLine3dPolygonIntersection(fpVector3_t *intersection, float *distance, const fpVector3_t *startPos, const fpVector3_t *endPos, fpVector2_t *vertices, const uint8_t numVertices, const float minHeight, const float maxHeight, const bool isInclusiveZone)
+static bool calcLine3dPolygonIntersection(fpVector3_t *intersection, float *distance, const fpVector3_t *startPos, const fpVector3_t *endPos, fpVector2_t *vertices, const uint8_t numVertices, const float minHeight, const float maxHeight, const float capNormalZ, const bool isInclusiveZone)
 {
     float distToIntersection = FLT_MAX;
     fpVector3_t intersect;
+    geozoneBounds_t segmentBounds;
+    geozoneBoundsFromSegment(&segmentBounds, (fpVector2_t*)startPos, (fpVector2_t*)endPos);
 
     fpVector2_t* prev = &vertices[numVertices - 1];
 	fpVector2_t* current;
 	for (uint8_t i = 0; i < numVertices; i++) {
 		current = &vertices[i];
+
+		// A wall hit that can end up on the segment has to be close to it,
+		// walls further away can only give hits the caller would reject
+		const geozoneBounds_t edgeBounds = {
+			.minX = MIN(prev->x, current->x), .minY = MIN(prev->y, current->y),
+			.maxX = MAX(prev->x, current->x), .maxY = MAX(prev->y, current->y)
+		};
+		if (!geozoneBoundsOverlap(&segmentBounds, &edgeBounds)) {
+			prev = current;
+			continue;
+		}
 		
 		fpVector3_t p1 = { .x = prev->x, .y = prev->y, .z = minHeight };
 		fpVector3_t p2 = { .x = prev->x, .y = prev->y, .z = maxHeight };
@@ -698,7 +717,7 @@ static bool calcLine3dPolygonIntersection(fpVector3_t *intersection, float *dist
 
     fpVector3_t intersectCap;
     if (startPos->z < minHeight || (isInclusiveZone && minHeight != 0)) {
-		if (calcLinePolygonIntersection(&intersectCap, startPos, endPos, minHeight, vertices, numVertices) && isInFront(startPos, &intersectCap, endPos))
+		if (calcLinePolygonIntersection(&intersectCap, startPos, endPos, minHeight, vertices, numVertices, capNormalZ) && isInFront(startPos, &intersectCap, endPos))
 		{
 			float distanceCap = calculateDistance3(startPos, &intersectCap);
             if (distanceCap < distToIntersection) {
@@ -709,7 +728,7 @@ static bool calcLine3dPolygonIntersection(fpVector3_t *intersection, float *dist
 	}
 
     if (startPos->z > maxHeight || isInclusiveZone) {
-		if (calcLinePolygonIntersection(&intersectCap, startPos, endPos, maxHeight, vertices, numVertices) && isInFront(startPos, &intersectCap, endPos))
+		if (calcLinePolygonIntersection(&intersectCap, startPos, endPos, maxHeight, vertices, numVertices, capNormalZ) && isInFront(startPos, &intersectCap, endPos))
 		{
 			float distanceCap = calculateDistance3(startPos, &intersectCap);
             if (distanceCap < distToIntersection) {
@@ -744,7 +763,7 @@ static bool isPointOnBorder(geoZoneRuntimeConfig_t *zone, const fpVector3_t *pos
     bool isOnBorder = false;
     for (uint8_t i = 0; i < zone->config.vertexCount; i++) {
         current = &zone->verticesLocal[i];
-        if (isPointOnLine2(prev, current, (fpVector2_t*)pos)) {
+        if (isPointOnLine2(prev, current, zone->edgeLengths[i], (fpVector2_t*)pos)) {
             isOnBorder = true;
             break;
         }
@@ -783,10 +802,36 @@ static bool isInGeozone(geoZoneRuntimeConfig_t *zone, const fpVector3_t *pos, bo
     return isIn2D;
 }
 
+static geozoneMask_t getAllZonesMask(void)
+{
+    return activeGeoZonesCount >= GEOZONE_INDEX_MAX_ZONES ? ~(geozoneMask_t)0 : ((geozoneMask_t)1 << activeGeoZonesCount) - 1;
+}
+
+// Zones that can contain pos, exact test is still required
+static geozoneMask_t getCandidateZonesForPos(const fpVector3_t *pos)
+{
+    if (!geozoneIndexValid) {
+        return getAllZonesMask();
+    }
+    return geozoneIndexQueryPoint(&geozoneIndex, (fpVector2_t*)pos) & getAllZonesMask();
+}
+
+// Zones that can be intersected by the segment start -> end, exact test is still required
+static geozoneMask_t getCandidateZonesForSegment(const fpVector3_t *start, const fpVector3_t *end)
+{
+    if (!geozoneIndexValid) {
+        return getAllZonesMask();
+    }
+    geozoneBounds_t segmentBounds;
+    geozoneBoundsFromSegment(&segmentBounds, (fpVector2_t*)start, (fpVector2_t*)end);
+    return geozoneIndexQuerySegment(&geozoneIndex, &segmentBounds) & getAllZonesMask();
+}
+
 static bool isPointInAnyOtherZone(const geoZoneRuntimeConfig_t *zone, uint8_t type, const fpVector3_t *pos)
 {
     bool isInZone = false;        
-    for (uint8_t i = 0; i < activeGeoZonesCount; i++) {
+    for (geozoneMask_t candidates = getCandidateZonesForPos(pos); candidates; candidates &= candidates - 1) {
+        const uint8_t i = __builtin_ctzll(candidates);
         if (zone != &activeGeoZones[i] && activeGeoZones[i].config.type == type && isInGeozone(&activeGeoZones[i], pos, false)) {
             isInZone = true;
             break;
@@ -798,7 +843,8 @@ static bool isPointInAnyOtherZone(const geoZoneRuntimeConfig_t *zone, uint8_t ty
 static uint8_t getZonesForPos(geoZoneRuntimeConfig_t *zones[], const fpVector3_t *pos, const bool ignoreAltitude) 
 {
     uint8_t count = 0;
-    for (int i = 0; i < activeGeoZonesCount; i++) {
+    for (geozoneMask_t candidates = getCandidateZonesForPos(pos); candidates; candidates &= candidates - 1) {
+        const uint8_t i = __builtin_ctzll(candidates);
         if (isInGeozone(&activeGeoZones[i], pos, ignoreAltitude)) {
             zones[count++] = &activeGeoZones[i];
         }
@@ -854,6 +900,7 @@ static bool calcIntersectionForZone(fpVector3_t *intersection, float *distance,
             zone->config.vertexCount,
             zone->config.minAltitude,
             zone->config.maxAltitude,
+            zone->capNormalZ,
             zone->config.type == GEOZONE_TYPE_INCLUSIVE)) {
                 hasIntersection = true;
         }
@@ -867,6 +914,7 @@ static bool calcIntersectionForZone(fpVector3_t *intersection, float *distance,
             &circleCenter, 
             zone->radius, 
             zone->config.maxAltitude - zone->config.minAltitude,
+            zone->capNormalZ,
             zone->config.type == GEOZONE_TYPE_INCLUSIVE)) {
                 hasIntersection = true;
         }
@@ -922,7 +970,8 @@ static bool findNearestIntersectionZone(geoZoneRuntimeConfig_t **intersectZone,
     fpVector3_t intersect;
     float distanceToZone = FLT_MAX;  
 
-    for (uint8_t i = 0; i < activeGeoZonesCount; i++) {
+    for (geozoneMask_t candidates = getCandidateZonesForSegment(start, end); candidates; candidates &= candidates - 1) {
+        const uint8_t i = __builtin_ctzll(candidates);
         fpVector3_t currentIntersect;
         float currentDistance = FLT_MAX;
             if (!calcIntersectionForZone(
@@ -962,7 +1011,8 @@ static bool isPointDirectReachable(const fpVector3_t* start, const fpVector3_t *
     }
     */
 
-    for (uint8_t i = 0; i < activeGeoZonesCount; i++) {
+    for (geozoneMask_t candidates = getCandidateZonesForSegment(start, point); candidates; candidates &= candidates - 1) {
+        const uint8_t i = __builtin_ctzll(candidates);
         fpVector3_t currentIntersect;
         
         if (!calcIntersectionForZone(&currentIntersect, &currentDistance, &activeGeoZones[i], start, point)) {
@@ -1053,19 +1103,6 @@ static int32_t calcBounceCourseForZone(geoZoneRuntimeConfig_t *zone, fpVector3_t
     return course;
 }
 
-static bool initPathPoint(pathPoint_t *pathPoints, const fpVector3_t pos, uint8_t *idx)
-{
-    if (*idx + 1 >= MAX_PATH_PONITS) {
-        return false;
-    }
-
-    pathPoints[*idx].distance = FLT_MAX;
-    pathPoints[*idx].visited = false;
-    pathPoints[(*idx)++].point = pos;
-
-    return true;
-}
-
 static bool isPosInGreenAlt(geoZoneRuntimeConfig_t *zones[], const uint8_t zoneCount, const float alt) 
 {
     bool isInNfz = false, isInFz = false;
@@ -1116,163 +1153,183 @@ static bool checkPathPointOrSetAlt(fpVector3_t *pos)
     return !isInExclusice;
 }
 
-// Return value: 0 - Target direct reachable; -1 No way; >= 1 Waypoints to target 
-#define CIRCLE_POLY_SIDES 6
-static int8_t calcRthCourse(fpVector3_t* waypoints, const fpVector3_t* point, fpVector3_t* target)
+// Inclusive zones are "reduced", exclusive zones are "enlarged" to keep distance,
+// round zones are converted into hexagons.
+// Only needed while collecting RTH path points, so they are not kept in RAM.
+static uint8_t generateSafeZoneVertices(fpVector2_t *verticesSafe, const geoZoneRuntimeConfig_t *zone)
 {
-    pathPoint_t pathPoints[MAX_PATH_PONITS];
-    uint8_t pathPointCount = 0, waypointCount = 0;
-    fpVector3_t start = *point;
-    
-    if (isPointDirectReachable(&start, target)) {
-        return 0;
-    } 
-    
-    // Set starting point slightly away from our current position 
-    float offset = geozoneGetDetectionDistance();
-    if (geozone.distanceVertToNearestZone <= offset) {
-        int bearing = wrap_36000(geozone.directionToNearestZone + 18000);
-        start.x += offset * cos_approx(CENTIDEGREES_TO_RADIANS(bearing));
-        start.y += offset * sin_approx(CENTIDEGREES_TO_RADIANS(bearing));
+    float offset = geozoneGetDetectionDistance() * 2 / 3;
+    if (zone->config.type == GEOZONE_TYPE_INCLUSIVE) {
+        offset *= -1;
     }
 
-    pathPoints[pathPointCount].visited = true;
-    pathPoints[pathPointCount].distance = 0;
-    pathPoints[pathPointCount++].point = start;
+    if (zone->config.shape == GEOZONE_SHAPE_POLYGON) {
+        generateOffsetPolygon(verticesSafe, zone->verticesLocal, zone->config.vertexCount, offset);
+        return zone->config.vertexCount;
+    }
 
-    // Calculate possible waypoints
-    // Vertices of the zones are possible waypoints, 
-    // inclusive zones are “reduced”, exclusive zones are “enlarged” to keep distance,
-    // round zones are converted into hexagons and long sides get additional points to be able to fly over zones.
-    for (uint8_t i = 0 ; i < activeGeoZonesCount; i++) {        
-        fpVector2_t *verticesZone;
-        fpVector2_t verticesCirclePoly[CIRCLE_POLY_SIDES];
-        uint8_t verticesZoneCount;
-        if (activeGeoZones[i].config.shape == GEOZONE_SHAPE_POLYGON) {
-            verticesZone = activeGeoZones[i].verticesLocal;
-            verticesZoneCount = activeGeoZones[i].config.vertexCount;
-        } else {
-            generatePolygonFromCircle(verticesCirclePoly, &activeGeoZones[i].verticesLocal[0], activeGeoZones[i].radius, CIRCLE_POLY_SIDES);
-            verticesZone = verticesCirclePoly;
-            verticesZoneCount = CIRCLE_POLY_SIDES;
-        }        
-        
-        fpVector2_t safeZone[MAX_VERTICES];
-        offset = geozoneGetDetectionDistance() * 2 / 3;
-        if (activeGeoZones[i].config.type == GEOZONE_TYPE_INCLUSIVE) {
-            offset *= -1;
-        }
-        
-        float zMin = start.z, zMax = 0;
-        if (!isInZoneAltitudeRange(&activeGeoZones[i], start.z) && activeGeoZones[i].config.minAltitude > 0) {
-            zMin = activeGeoZones[i].config.minAltitude + 2 * geoZoneConfig()->safeAltitudeDistance;
-        }
+    fpVector2_t verticesCirclePoly[CIRCLE_POLY_SIDES];
+    generatePolygonFromCircle(verticesCirclePoly, &zone->verticesLocal[0], zone->radius, CIRCLE_POLY_SIDES);
+    generateOffsetPolygon(verticesSafe, verticesCirclePoly, CIRCLE_POLY_SIDES, offset);
+    return CIRCLE_POLY_SIDES;
+}
 
-        if (activeGeoZones[i].config.type == GEOZONE_TYPE_INCLUSIVE && (!activeGeoZones[i].isInfZone || activeGeoZones[i].config.maxAltitude < INT32_MAX)) {
-            zMax = activeGeoZones[i].config.maxAltitude - 2 * geoZoneConfig()->safeAltitudeDistance;
-        } else if (activeGeoZones[i].config.type == GEOZONE_TYPE_EXCLUSIVE && (!activeGeoZones[i].isInfZone || activeGeoZones[i].config.maxAltitude < INT32_MAX)) {
-            zMax = activeGeoZones[i].config.maxAltitude + 2 * geoZoneConfig()->safeAltitudeDistance;
-        }
-                
-        generateOffsetPolygon(safeZone, verticesZone, verticesZoneCount, offset);
-        fpVector2_t *prev = &safeZone[verticesZoneCount - 1];
-        fpVector2_t *current;
-        for (uint8_t j = 0; j < verticesZoneCount; j++) {
-            current = &safeZone[j];
+// Vertices of the safe zones are possible waypoints, 
+// long sides of exclusive zones get additional points to be able to fly over zones.
+static bool addRthPathPoints(geoZoneRuntimeConfig_t *zone, const float startAlt)
+{
+    if (zone->verticesLocal == NULL) {
+        return true;
+    }
+
+    float zMin = startAlt, zMax = 0;
+    if (!isInZoneAltitudeRange(zone, startAlt) && zone->config.minAltitude > 0) {
+        zMin = zone->config.minAltitude + 2 * geoZoneConfig()->safeAltitudeDistance;
+    }
+
+    if (zone->config.type == GEOZONE_TYPE_INCLUSIVE && (!zone->isInfZone || zone->config.maxAltitude < INT32_MAX)) {
+        zMax = zone->config.maxAltitude - 2 * geoZoneConfig()->safeAltitudeDistance;
+    } else if (zone->config.type == GEOZONE_TYPE_EXCLUSIVE && (!zone->isInfZone || zone->config.maxAltitude < INT32_MAX)) {
+        zMax = zone->config.maxAltitude + 2 * geoZoneConfig()->safeAltitudeDistance;
+    }
             
-            if (zMax > 0 ) {
-                fpVector3_t max = { .x = current->x, .y = current->y, .z = zMax };
-                if (checkPathPointOrSetAlt(&max)) {
-                    if (!initPathPoint(pathPoints, max, &pathPointCount)) {
-                        return -1;
-                    }
+    fpVector2_t safeZone[MAX_VERTICES];
+    const uint8_t verticesZoneCount = generateSafeZoneVertices(safeZone, zone);
+    if (verticesZoneCount == 0) {
+        return true;
+    }
+
+    fpVector2_t *prev = &safeZone[verticesZoneCount - 1];
+    fpVector2_t *current;
+    for (uint8_t j = 0; j < verticesZoneCount; j++) {
+        current = &safeZone[j];
+        
+        if (zMax > 0 ) {
+            fpVector3_t max = { .x = current->x, .y = current->y, .z = zMax };
+            if (checkPathPointOrSetAlt(&max)) {
+                if (!geozonePlannerAddNode(&rthPlanner, &max)) {
+                    return false;
                 }
+            }
 
-                if (activeGeoZones[i].config.type == GEOZONE_TYPE_EXCLUSIVE) {
-                    // Set some "fly over points"
-                    float dist = calculateDistance2(prev, current);
-                    if (dist > MAX_DISTANCE_FLY_OVER_POINTS) {
-                        uint8_t sectionCount = (uint8_t)(dist / MAX_DISTANCE_FLY_OVER_POINTS);
-                        float dist = MAX_DISTANCE_FLY_OVER_POINTS;
-                        for (uint8_t k = 0; k < sectionCount; k++) {
-                            fpVector3_t flyOverPoint;
-                            calcPointOnLine((fpVector2_t*)&flyOverPoint, prev, current, dist);
-                            fpVector3_t maxFo = { .x = flyOverPoint.x, .y = flyOverPoint.y, .z = zMax };
-                            if (checkPathPointOrSetAlt(&maxFo)) {
-                                if (!initPathPoint(pathPoints, maxFo, &pathPointCount)) {
-                                    return -1;
-                                }
+            if (zone->config.type == GEOZONE_TYPE_EXCLUSIVE) {
+                // Set some "fly over points"
+                float dist = calculateDistance2(prev, current);
+                if (dist > MAX_DISTANCE_FLY_OVER_POINTS) {
+                    uint8_t sectionCount = (uint8_t)(dist / MAX_DISTANCE_FLY_OVER_POINTS);
+                    float dist = MAX_DISTANCE_FLY_OVER_POINTS;
+                    for (uint8_t k = 0; k < sectionCount; k++) {
+                        fpVector3_t flyOverPoint;
+                        calcPointOnLine((fpVector2_t*)&flyOverPoint, prev, current, dist);
+                        fpVector3_t maxFo = { .x = flyOverPoint.x, .y = flyOverPoint.y, .z = zMax };
+                        if (checkPathPointOrSetAlt(&maxFo)) {
+                            if (!geozonePlannerAddNode(&rthPlanner, &maxFo)) {
+                                return false;
                             }
-                            dist += MAX_DISTANCE_FLY_OVER_POINTS;
                         }
+                        dist += MAX_DISTANCE_FLY_OVER_POINTS;
                     }
-                }            
-            }
+                }
+            }            
+        }
 
-            if (zMin > 0) {
-                fpVector3_t min = { .x = current->x, .y = current->y, .z = zMin };
-                if (checkPathPointOrSetAlt(&min)) {
-                    if (!initPathPoint(pathPoints, min, &pathPointCount)) {
-                        return -1;
-                    }
-                } 
-                
-            }
-            prev = current;
+        if (zMin > 0) {
+            fpVector3_t min = { .x = current->x, .y = current->y, .z = zMin };
+            if (checkPathPointOrSetAlt(&min)) {
+                if (!geozonePlannerAddNode(&rthPlanner, &min)) {
+                    return false;
+                }
+            } 
         }
+        prev = current;
     }
 
-    if (!initPathPoint(pathPoints, *target, &pathPointCount)) {
-        return -1;
+    return true;
+}
+
+static void startRthCourse(const fpVector3_t* point, const fpVector3_t* target)
+{
+    fpVector3_t start = *point;
+
+    // Set starting point slightly away from our current position 
+    float offset = geozoneGetDetectionDistance();
+    if (geozone.distanceVertToNearestZone <= offset) {
+        int bearing = wrap_36000(geozone.directionToNearestZone + 18000);
+        start.x += offset * cos_approx(CENTIDEGREES_TO_RADIANS(bearing));
+        start.y += offset * sin_approx(CENTIDEGREES_TO_RADIANS(bearing));
     }
 
-    // Dijkstra
-    pathPoint_t *current = pathPoints;
-    while (!pathPoints[pathPointCount - 1].visited) {
-        pathPoint_t *next = current;
-        float min = FLT_MAX;
-        for (uint8_t i = 1; i < pathPointCount; i++) {
-            
-            float currentDist = FLT_MAX;
-            if (isPointDirectReachable(&current->point, &pathPoints[i].point)) {
-                float dist2D = calculateDistance2((fpVector2_t*)&current->point, (fpVector2_t*)&pathPoints[i].point);
-                float distAlt = ABS(current->point.z - pathPoints[i].point.z);
-                currentDist = current->distance + dist2D + 2 * distAlt;
-            }
+    rthRouteValid = false;
+    geozonePlannerInit(&rthPlanner, &start, isPointDirectReachable);
+    rthPlannerTarget = *target;
+    rthPlannerZoneIdx = 0;
+    rthPlannerState = RTH_PLANNER_STATE_COLLECT;
+}
 
-            if (currentDist < pathPoints[i].distance && !pathPoints[i].visited) {
-                pathPoints[i].distance = currentDist;
-                pathPoints[i].prev = current;
-            }
-            if (min > pathPoints[i].distance && !pathPoints[i].visited) {
-                min = pathPoints[i].distance;
-                next = &pathPoints[i];
+// Continues the course calculation for at most GEOZONE_RTH_PLANNER_SLICE_US
+// Return value: GEOZONE_RTH_COURSE_PENDING - Not finished yet; 0 - Target direct reachable; -1 No way; >= 1 Waypoints to target 
+static int8_t stepRthCourse(fpVector3_t* waypoints)
+{
+    const timeUs_t startTime = micros();
+
+    while (rthPlannerState == RTH_PLANNER_STATE_COLLECT) {
+        if (rthPlannerZoneIdx >= activeGeoZonesCount) {
+            if (!geozonePlannerSetTarget(&rthPlanner, &rthPlannerTarget)) {
+                rthPlannerState = RTH_PLANNER_STATE_IDLE;
+                return -1;
             }
+            rthPlannerState = RTH_PLANNER_STATE_SEARCH;
+            break;
         }
 
-        if (min == FLT_MAX) {
+        if (!addRthPathPoints(&activeGeoZones[rthPlannerZoneIdx++], rthPlanner.nodes[0].point.z)) {
+            rthPlannerState = RTH_PLANNER_STATE_IDLE;
             return -1;
         }
-        
-        current = next;
-        current->visited = true;
+
+        if (cmpTimeUs(micros(), startTime) >= GEOZONE_RTH_PLANNER_SLICE_US) {
+            return GEOZONE_RTH_COURSE_PENDING;
+        }
     }
-    
-    waypointCount = 0;
-    current = &pathPoints[pathPointCount - 1];
-    while (current != pathPoints) {
-        waypointCount++;
-        current = current->prev;
+
+    const timeDelta_t budget = GEOZONE_RTH_PLANNER_SLICE_US - cmpTimeUs(micros(), startTime);
+    switch (geozonePlannerStep(&rthPlanner, budget)) {
+        case GEOZONE_PLANNER_RUNNING:
+            return GEOZONE_RTH_COURSE_PENDING;
+        case GEOZONE_PLANNER_FOUND:
+            rthPlannerState = RTH_PLANNER_STATE_IDLE;
+            return geozonePlannerGetRoute(&rthPlanner, waypoints, MAX_RTH_WAYPOINTS);
+        default:
+            rthPlannerState = RTH_PLANNER_STATE_IDLE;
+            return -1;
     }
-    // Don't set home to the WP list
-    current = pathPoints[pathPointCount - 1].prev;
-    uint8_t i = waypointCount - 2;
-    while (current != pathPoints) {
-        waypoints[i] = current->point;
-        current = current->prev;
-        i--;
+}
+
+// A route found before stays valid as long as the zones, home and the safe home zone don't change.
+// Join it at the last waypoint that is direct reachable from the current position.
+static int8_t getCachedRthCourse(fpVector3_t* waypoints, const fpVector3_t* point, const fpVector3_t* target)
+{
+    if (!rthRouteValid || memcmp(&rthRouteTarget, target, sizeof(fpVector3_t)) != 0 ||
+        memcmp(&rthRouteSafeHome, &posControl.safehomeState.nearestSafeHome, sizeof(fpVector3_t)) != 0) {
+        return 0;
+    }
+
+    // The planner keeps the solved search until the next course is started
+    const int8_t routeCount = geozonePlannerGetRoute(&rthPlanner, waypoints, MAX_RTH_WAYPOINTS);
+    for (int8_t i = routeCount - 1; i >= 0; i--) {
+        if (isPointDirectReachable(point, &waypoints[i])) {
+            memmove(waypoints, &waypoints[i], (routeCount - i) * sizeof(fpVector3_t));
+            return routeCount - i;
+        }
     }
-    return waypointCount - 1;    
+    return 0;
+}
+
+static void cacheRthCourse(const fpVector3_t* target)
+{
+    rthRouteValid = true;
+    rthRouteTarget = *target;
+    rthRouteSafeHome = posControl.safehomeState.nearestSafeHome;
 }
 
 static void updateCurrentZones(void)
@@ -1603,8 +1660,63 @@ static void endFenceAction(void)
     abortSendTo();
 }
 
+// Zone geometry only changes in geoZoneInit, precompute everything that doesn't depend on the position
+static void buildGeozoneCache(void)
+{
+    for (uint8_t i = 0; i < activeGeoZonesCount; i++) {
+        geoZoneRuntimeConfig_t *zone = &activeGeoZones[i];
+
+        zone->edgeLengths = NULL;
+        if (zone->verticesLocal == NULL) {
+            continue;
+        }
+
+        if (zone->config.shape == GEOZONE_SHAPE_POLYGON && zone->config.vertexCount >= 3) {
+            const fpVector3_t p1 = { .x = zone->verticesLocal[0].x, .y = zone->verticesLocal[0].y, .z = 0 };
+            const fpVector3_t p2 = { .x = zone->verticesLocal[1].x, .y = zone->verticesLocal[1].y, .z = 0 };
+            const fpVector3_t p3 = { .x = zone->verticesLocal[2].x, .y = zone->verticesLocal[2].y, .z = 0 };
+            zone->capNormalZ = calcPlaneNormalFromPoints(&p1, &p2, &p3).z;
+        } else if (zone->config.shape == GEOZONE_SHAPE_CIRCULAR) {
+            const fpVector3_t center = { .x = zone->verticesLocal[0].x, .y = zone->verticesLocal[0].y, .z = 0 };
+            const fpVector3_t p1 = { .x = center.x + zone->radius, .y = center.y, .z = 0 };
+            const fpVector3_t p2 = { .x = center.x, .y = center.y + zone->radius, .z = 0 };
+            zone->capNormalZ = calcPlaneNormalFromPoints(&center, &p1, &p2).z;
+        }
+
+        if (zone->config.shape == GEOZONE_SHAPE_POLYGON) {
+            zone->edgeLengths = &edgeLengthsLocal[zone->verticesLocal - verticesLocal];
+            const fpVector2_t *prev = &zone->verticesLocal[zone->config.vertexCount - 1];
+            for (uint8_t j = 0; j < zone->config.vertexCount; j++) {
+                zone->edgeLengths[j] = roundf(calculateDistance2(prev, &zone->verticesLocal[j]));
+                prev = &zone->verticesLocal[j];
+            }
+        }
+    }
+}
+
+static void buildGeozoneIndex(void)
+{
+    geozoneBounds_t zoneBounds[MAX_GEOZONES];
+
+    for (uint8_t i = 0; i < activeGeoZonesCount; i++) {
+        if (activeGeoZones[i].verticesLocal == (fpVector2_t*)&posControl.safehomeState.nearestSafeHome) {
+            // Safe home zone follows the nearest safe home, keep it out of the grid
+            geozoneBoundsSetUnbounded(&zoneBounds[i]);
+        } else if (activeGeoZones[i].config.shape == GEOZONE_SHAPE_POLYGON) {
+            geozoneBoundsFromPolygon(&zoneBounds[i], activeGeoZones[i].verticesLocal, activeGeoZones[i].config.vertexCount);
+        } else {
+            geozoneBoundsFromCircle(&zoneBounds[i], &activeGeoZones[i].verticesLocal[0], activeGeoZones[i].radius);
+        }
+    }
+
+    geozoneIndexBuild(&geozoneIndex, zoneBounds, activeGeoZonesCount);
+    geozoneIndexValid = true;
+}
+
 static void geoZoneInit(void)
 {
+    geozoneIndexValid = false;
+    rthRouteValid = false;
     activeGeoZonesCount = 0;
     uint8_t expectedVertices = 0, configuredVertices = 0;
     for (uint8_t i = 0; i < MAX_GEOZONES_IN_CONFIG; i++)
@@ -1689,6 +1801,7 @@ static void geoZoneInit(void)
         configuredVertices++;
     }
 
+    buildGeozoneCache();
     updateCurrentZones();
     uint8_t newActiveZoneCount = activeGeoZonesCount;
     for (uint8_t i = 0; i < activeGeoZonesCount; i++) {
@@ -1726,6 +1839,7 @@ static void geoZoneInit(void)
     geozoneIsEnabled = true;
 
     qsort(activeGeoZones, MAX_GEOZONES, sizeof(geoZoneRuntimeConfig_t), geoZoneRTComp);
+    buildGeozoneIndex();
     
     for (int i = 0; i < activeGeoZonesCount; i++) {
         if (activeGeoZones[i].config.type == GEOZONE_TYPE_INCLUSIVE) {
@@ -2006,6 +2120,7 @@ bool geoZoneIsLastRthWaypoint(void)
 void geozoneResetRTH(void)
 {
     geozone.avoidInRTHInProgress = false;
+    rthPlannerState = RTH_PLANNER_STATE_IDLE;
     rthWaypointIndex = 0;
     rthWaypointCount = 0;
 }
@@ -2019,6 +2134,7 @@ void geozoneSetupRTH(void) {
 }
 
 // Return value
+// GEOZONE_RTH_COURSE_PENDING: Course is still being calculated
 // -1: Unable to calculate a course home
 //  0: No NFZ in the way
 // >0: Number of waypoints 
@@ -2030,15 +2146,33 @@ int8_t geozoneCheckForNFZAtCourse(bool isRTH)
         return 0;
     }
 
-    updateCurrentZones();
-    
-    // Never mind, lets fly out of the zone on current course 
-    if (geozone.insideNfz || (isAtLeastOneInclusiveZoneActive && !geozone.insideFz)) {
-        return 0;
+    const fpVector3_t *pos = &navGetCurrentActualPositionAndVelocity()->pos;
+    const fpVector3_t *home = &posControl.rthState.homePosition.pos;
+    int8_t waypointCount;
+
+    if (rthPlannerState == RTH_PLANNER_STATE_IDLE) {
+        updateCurrentZones();
+        
+        // Never mind, lets fly out of the zone on current course 
+        if (geozone.insideNfz || (isAtLeastOneInclusiveZoneActive && !geozone.insideFz)) {
+            return 0;
+        }
+
+        if (isPointDirectReachable(pos, home)) {
+            return 0;
+        }
+
+        waypointCount = getCachedRthCourse(rthWaypoints, pos, home);
+        if (waypointCount == 0) {
+            startRthCourse(pos, home);
+            waypointCount = stepRthCourse(rthWaypoints);
+        }
+    } else {
+        waypointCount = stepRthCourse(rthWaypoints);
     }
 
-    int8_t waypointCount = calcRthCourse(rthWaypoints, &navGetCurrentActualPositionAndVelocity()->pos, &posControl.rthState.homePosition.pos);
     if (waypointCount > 0) {
+        cacheRthCourse(home);
         rthWaypointCount = waypointCount;
         rthWaypointIndex = 0;
         geozone.avoidInRTHInProgress = true;
@@ -0,0 +1,188 @@
+/*
+ * This file is part of INAV.
+ *
+ * INAV is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * INAV is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with INAV.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Spatial index for geozone queries in local NEU coordinates.
+ *
+ * Every zone gets a conservative 2D bounding box, and the union of all boxes is
+ * covered by a uniform grid of zone masks. Point queries look up a single cell,
+ * segment queries test the segment box against the zone boxes. Both return
+ * candidate zones only, the exact containment and intersection tests still
+ * have to be done by the caller.
+ */
+
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+#include "platform.h"
+
+#include "common/maths.h"
+#include "common/utils.h"
+
+#include "navigation/navigation_geozone_index.h"
+
+static float geozoneIndexDistance(const fpVector2_t *a, const fpVector2_t *b)
+{
+    return calc_length_pythagorean_2D(b->x - a->x, b->y - a->y);
+}
+
+void geozoneBoundsFromPolygon(geozoneBounds_t *bounds, const fpVector2_t *vertices, uint8_t count)
+{
+    float longestEdge = 0;
+
+    bounds->minX = bounds->minY = FLT_MAX;
+    bounds->maxX = bounds->maxY = -FLT_MAX;
+
+    const fpVector2_t *prev = &vertices[count - 1];
+    for (uint8_t i = 0; i < count; i++) {
+        const fpVector2_t *current = &vertices[i];
+        bounds->minX = MIN(bounds->minX, current->x);
+        bounds->minY = MIN(bounds->minY, current->y);
+        bounds->maxX = MAX(bounds->maxX, current->x);
+        bounds->maxY = MAX(bounds->maxY, current->y);
+        longestEdge = MAX(longestEdge, geozoneIndexDistance(prev, current));
+        prev = current;
+    }
+
+    // Border test compares rounded distances, which accepts points up to about
+    // sqrt(0.75 * edge length) away from an edge. Keep those inside the box.
+    const float margin = fast_fsqrtf(longestEdge) + 1.0f;
+    bounds->minX -= margin;
+    bounds->minY -= margin;
+    bounds->maxX += margin;
+    bounds->maxY += margin;
+}
+
+void geozoneBoundsFromCircle(geozoneBounds_t *bounds, const fpVector2_t *center, float radius)
+{
+    bounds->minX = center->x - radius;
+    bounds->minY = center->y - radius;
+    bounds->maxX = center->x + radius;
+    bounds->maxY = center->y + radius;
+}
+
+void geozoneBoundsSetUnbounded(geozoneBounds_t *bounds)
+{
+    bounds->minX = bounds->minY = -FLT_MAX;
+    bounds->maxX = bounds->maxY = FLT_MAX;
+}
+
+void geozoneBoundsFromSegment(geozoneBounds_t *bounds, const fpVector2_t *start, const fpVector2_t *end)
+{
+    // Intersections are accepted up to about sqrt(0.75 * segment length) off the
+    // segment by the rounded on-line test, so grow the box by that much
+    const float margin = fast_fsqrtf(geozoneIndexDistance(start, end)) + 1.0f;
+
+    bounds->minX = MIN(start->x, end->x) - margin;
+    bounds->minY = MIN(start->y, end->y) - margin;
+    bounds->maxX = MAX(start->x, end->x) + margin;
+    bounds->maxY = MAX(start->y, end->y) + margin;
+}
+
+bool geozoneBoundsOverlap(const geozoneBounds_t *a, const geozoneBounds_t *b)
+{
+    return a->minX <= b->maxX && b->minX <= a->maxX && a->minY <= b->maxY && b->minY <= a->maxY;
+}
+
+static bool geozoneBoundsIsUnbounded(const geozoneBounds_t *bounds)
+{
+    return bounds->minX == -FLT_MAX || bounds->maxX == FLT_MAX || bounds->minY == -FLT_MAX || bounds->maxY == FLT_MAX;
+}
+
+static int geozoneIndexCell(float value, float min, float scale)
+{
+    return constrain((int)((value - min) * scale), 0, GEOZONE_INDEX_GRID_SIZE - 1);
+}
+
+void geozoneIndexBuild(geozoneIndex_t *index, const geozoneBounds_t *zoneBounds, uint8_t zoneCount)
+{
+    memset(index, 0, sizeof(*index));
+    index->zoneCount = MIN(zoneCount, GEOZONE_INDEX_MAX_ZONES);
+
+    index->gridBounds.minX = index->gridBounds.minY = FLT_MAX;
+    index->gridBounds.maxX = index->gridBounds.maxY = -FLT_MAX;
+
+    for (uint8_t i = 0; i < index->zoneCount; i++) {
+        const geozoneBounds_t *bounds = &zoneBounds[i];
+        index->zoneBounds[i] = *bounds;
+
+        if (geozoneBoundsIsUnbounded(bounds)) {
+            index->unbounded |= (geozoneMask_t)1 << i;
+            continue;
+        }
+
+        index->gridBounds.minX = MIN(index->gridBounds.minX, bounds->minX);
+        index->gridBounds.minY = MIN(index->gridBounds.minY, bounds->minY);
+        index->gridBounds.maxX = MAX(index->gridBounds.maxX, bounds->maxX);
+        index->gridBounds.maxY = MAX(index->gridBounds.maxY, bounds->maxY);
+    }
+
+    if (index->gridBounds.minX > index->gridBounds.maxX) {
+        // No bounded zones, grid stays empty
+        return;
+    }
+
+    index->cellScaleX = GEOZONE_INDEX_GRID_SIZE / MAX(index->gridBounds.maxX - index->gridBounds.minX, 1.0f);
+    index->cellScaleY = GEOZONE_INDEX_GRID_SIZE / MAX(index->gridBounds.maxY - index->gridBounds.minY, 1.0f);
+
+    for (uint8_t i = 0; i < index->zoneCount; i++) {
+        const geozoneBounds_t *bounds = &index->zoneBounds[i];
+        if (index->unbounded & ((geozoneMask_t)1 << i)) {
+            continue;
+        }
+
+        const int x0 = geozoneIndexCell(bounds->minX, index->gridBounds.minX, index->cellScaleX);
+        const int x1 = geozoneIndexCell(bounds->maxX, index->gridBounds.minX, index->cellScaleX);
+        const int y0 = geozoneIndexCell(bounds->minY, index->gridBounds.minY, index->cellScaleY);
+        const int y1 = geozoneIndexCell(bounds->maxY, index->gridBounds.minY, index->cellScaleY);
+
+        for (int x = x0; x <= x1; x++) {
+            for (int y = y0; y <= y1; y++) {
+                index->cells[x][y] |= (geozoneMask_t)1 << i;
+            }
+        }
+    }
+}
+
+geozoneMask_t geozoneIndexQueryPoint(const geozoneIndex_t *index, const fpVector2_t *point)
+{
+    if (point->x < index->gridBounds.minX || point->x > index->gridBounds.maxX ||
+        point->y < index->gridBounds.minY || point->y > index->gridBounds.maxY) {
+        return index->unbounded;
+    }
+
+    const int x = geozoneIndexCell(point->x, index->gridBounds.minX, index->cellScaleX);
+    const int y = geozoneIndexCell(point->y, index->gridBounds.minY, index->cellScaleY);
+    return index->cells[x][y] | index->unbounded;
+}
+
+geozoneMask_t geozoneIndexQuerySegment(const geozoneIndex_t *index, const geozoneBounds_t *segmentBounds)
+{
+    geozoneMask_t result = index->unbounded;
+
+    if (!geozoneBoundsOverlap(segmentBounds, &index->gridBounds)) {
+        return result;
+    }
+
+    for (uint8_t i = 0; i < index->zoneCount; i++) {
+        if (geozoneBoundsOverlap(segmentBounds, &index->zoneBounds[i])) {
+            result |= (geozoneMask_t)1 << i;
+        }
+    }
+    return result;
+}
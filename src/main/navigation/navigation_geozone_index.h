@@ -0,0 +1,66 @@
+/*
+ * This file is part of INAV.
+ *
+ * INAV is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * INAV is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with INAV.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/vector.h"
+
+// One bit per zone in query results, zone index as passed to geozoneIndexBuild()
+#ifdef MAX_GEOZONES_IN_CONFIG
+#define GEOZONE_INDEX_MAX_ZONES (MAX_GEOZONES_IN_CONFIG + 1) // +1 for safe home
+#else
+#define GEOZONE_INDEX_MAX_ZONES 64
+#endif
+
+// 8 x 8 cells keep the grid at 512 bytes with 64 zones, the exact test after the query does the rest
+#define GEOZONE_INDEX_GRID_SIZE 8
+
+#if GEOZONE_INDEX_MAX_ZONES <= 32
+typedef uint32_t geozoneMask_t;
+#else
+typedef uint64_t geozoneMask_t;
+#endif
+
+typedef struct geozoneBounds_s {
+    float minX;
+    float minY;
+    float maxX;
+    float maxY;
+} geozoneBounds_t;
+
+typedef struct geozoneIndex_s {
+    geozoneBounds_t zoneBounds[GEOZONE_INDEX_MAX_ZONES];
+    geozoneBounds_t gridBounds;
+    float cellScaleX;               // cells per cm
+    float cellScaleY;
+    geozoneMask_t cells[GEOZONE_INDEX_GRID_SIZE][GEOZONE_INDEX_GRID_SIZE];
+    geozoneMask_t unbounded;        // zones returned by every query
+    uint8_t zoneCount;
+} geozoneIndex_t;
+
+void geozoneBoundsFromPolygon(geozoneBounds_t *bounds, const fpVector2_t *vertices, uint8_t count);
+void geozoneBoundsFromCircle(geozoneBounds_t *bounds, const fpVector2_t *center, float radius);
+void geozoneBoundsSetUnbounded(geozoneBounds_t *bounds);
+void geozoneBoundsFromSegment(geozoneBounds_t *bounds, const fpVector2_t *start, const fpVector2_t *end);
+bool geozoneBoundsOverlap(const geozoneBounds_t *a, const geozoneBounds_t *b);
+
+void geozoneIndexBuild(geozoneIndex_t *index, const geozoneBounds_t *zoneBounds, uint8_t zoneCount);
+geozoneMask_t geozoneIndexQueryPoint(const geozoneIndex_t *index, const fpVector2_t *point);
+geozoneMask_t geozoneIndexQuerySegment(const geozoneIndex_t *index, const geozoneBounds_t *segmentBounds);
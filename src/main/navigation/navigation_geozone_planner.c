@@ -0,0 +1,180 @@
+/*
+ * This file is part of INAV.
+ *
+ * INAV is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * INAV is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with INAV.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * A* search over the visibility graph of the geozone safe vertices.
+ *
+ * Edges are not precomputed, the reachability of two nodes is only checked
+ * when the edge would improve the cost of the neighbour. The search state is
+ * kept in the planner, so it can be split over several calls with a time
+ * budget each.
+ */
+
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+#include "platform.h"
+
+#include "common/maths.h"
+
+#include "drivers/time.h"
+
+#include "navigation/navigation_geozone_planner.h"
+
+// Same metric as the previous Dijkstra search: altitude changes count double
+static float geozonePlannerCost(const fpVector3_t *from, const fpVector3_t *to)
+{
+    return calc_length_pythagorean_2D(to->x - from->x, to->y - from->y) + 2 * fabsf(to->z - from->z);
+}
+
+void geozonePlannerInit(geozonePlanner_t *planner, const fpVector3_t *start, geozonePlannerReachableFnPtr isReachable)
+{
+    planner->nodeCount = 0;
+    planner->current = -1;
+    planner->nextNeighbour = 0;
+    planner->state = GEOZONE_PLANNER_IDLE;
+    planner->isReachable = isReachable;
+    planner->reachableChecks = 0;
+
+    geozonePlannerAddNode(planner, start);
+    planner->nodes[0].cost = 0;
+}
+
+bool geozonePlannerAddNode(geozonePlanner_t *planner, const fpVector3_t *point)
+{
+    if (planner->nodeCount >= GEOZONE_PLANNER_MAX_NODES || planner->state != GEOZONE_PLANNER_IDLE) {
+        return false;
+    }
+
+    geozonePlannerNode_t *node = &planner->nodes[planner->nodeCount++];
+    node->point = *point;
+    node->cost = FLT_MAX;
+    node->prev = -1;
+    node->closed = false;
+    return true;
+}
+
+// Target is always the last node, adding it starts the search
+bool geozonePlannerSetTarget(geozonePlanner_t *planner, const fpVector3_t *target)
+{
+    if (!geozonePlannerAddNode(planner, target)) {
+        return false;
+    }
+
+    planner->state = GEOZONE_PLANNER_RUNNING;
+    return true;
+}
+
+// The straight line cost to the target is consistent, the first time the target is selected its cost is optimal.
+// It is not stored per node to save RAM, only reached open nodes need it.
+static void geozonePlannerSelectNext(geozonePlanner_t *planner)
+{
+    const fpVector3_t *target = &planner->nodes[planner->nodeCount - 1].point;
+    float min = FLT_MAX;
+    int16_t next = -1;
+
+    for (uint16_t i = 0; i < planner->nodeCount; i++) {
+        const geozonePlannerNode_t *node = &planner->nodes[i];
+        if (node->closed || node->cost >= min) {
+            continue;
+        }
+
+        const float estimate = node->cost + geozonePlannerCost(&node->point, target);
+        if (estimate < min) {
+            min = estimate;
+            next = i;
+        }
+    }
+
+    if (next < 0) {
+        planner->state = GEOZONE_PLANNER_NO_PATH;
+    } else if (next == planner->nodeCount - 1) {
+        planner->state = GEOZONE_PLANNER_FOUND;
+    } else {
+        planner->nodes[next].closed = true;
+        planner->current = next;
+        planner->nextNeighbour = 0;
+    }
+}
+
+static void geozonePlannerRelaxNext(geozonePlanner_t *planner)
+{
+    if (planner->nextNeighbour >= planner->nodeCount) {
+        planner->current = -1;
+        return;
+    }
+
+    const geozonePlannerNode_t *current = &planner->nodes[planner->current];
+    geozonePlannerNode_t *neighbour = &planner->nodes[planner->nextNeighbour];
+
+    if (!neighbour->closed) {
+        const float cost = current->cost + geozonePlannerCost(&current->point, &neighbour->point);
+        // Only pay for the reachability check if the edge would be an improvement
+        if (cost < neighbour->cost) {
+            planner->reachableChecks++;
+            if (planner->isReachable(&current->point, &neighbour->point)) {
+                neighbour->cost = cost;
+                neighbour->prev = planner->current;
+            }
+        }
+    }
+
+    planner->nextNeighbour++;
+}
+
+geozonePlannerState_e geozonePlannerStep(geozonePlanner_t *planner, timeDelta_t budgetUs)
+{
+    const timeUs_t startTime = micros();
+
+    while (planner->state == GEOZONE_PLANNER_RUNNING) {
+        if (planner->current < 0) {
+            geozonePlannerSelectNext(planner);
+        } else {
+            geozonePlannerRelaxNext(planner);
+        }
+
+        if (cmpTimeUs(micros(), startTime) >= budgetUs) {
+            break;
+        }
+    }
+
+    return planner->state;
+}
+
+// Route without start and target, -1 if it doesn't fit into waypoints
+int8_t geozonePlannerGetRoute(const geozonePlanner_t *planner, fpVector3_t *waypoints, uint8_t maxWaypoints)
+{
+    if (planner->state != GEOZONE_PLANNER_FOUND) {
+        return -1;
+    }
+
+    uint8_t count = 0;
+    for (int16_t i = planner->nodes[planner->nodeCount - 1].prev; i > 0; i = planner->nodes[i].prev) {
+        count++;
+    }
+
+    if (count > maxWaypoints) {
+        return -1;
+    }
+
+    int8_t idx = count - 1;
+    for (int16_t i = planner->nodes[planner->nodeCount - 1].prev; i > 0; i = planner->nodes[i].prev) {
+        waypoints[idx--] = planner->nodes[i].point;
+    }
+    return count;
+}
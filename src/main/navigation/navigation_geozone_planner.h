@@ -0,0 +1,59 @@
+/*
+ * This file is part of INAV.
+ *
+ * INAV is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * INAV is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with INAV.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/time.h"
+#include "common/vector.h"
+
+// Start, target and every safe vertex at two altitudes
+#define GEOZONE_PLANNER_MAX_NODES (2 + 2 * (MAX_VERTICES_IN_CONFIG + 1))
+
+typedef bool (*geozonePlannerReachableFnPtr)(const fpVector3_t *from, const fpVector3_t *to);
+
+typedef enum {
+    GEOZONE_PLANNER_IDLE = 0,
+    GEOZONE_PLANNER_RUNNING,
+    GEOZONE_PLANNER_FOUND,
+    GEOZONE_PLANNER_NO_PATH,
+} geozonePlannerState_e;
+
+typedef struct geozonePlannerNode_s {
+    fpVector3_t point;
+    float cost;         // Cost of the best known path from the start
+    int16_t prev;
+    bool closed;
+} geozonePlannerNode_t;
+
+typedef struct geozonePlanner_s {
+    geozonePlannerNode_t nodes[GEOZONE_PLANNER_MAX_NODES];
+    uint16_t nodeCount;
+    int16_t current;            // Node being expanded, -1 if none
+    uint16_t nextNeighbour;     // Next neighbour of current to check
+    geozonePlannerState_e state;
+    geozonePlannerReachableFnPtr isReachable;
+    uint32_t reachableChecks;
+} geozonePlanner_t;
+
+void geozonePlannerInit(geozonePlanner_t *planner, const fpVector3_t *start, geozonePlannerReachableFnPtr isReachable);
+bool geozonePlannerAddNode(geozonePlanner_t *planner, const fpVector3_t *point);
+bool geozonePlannerSetTarget(geozonePlanner_t *planner, const fpVector3_t *target);
+geozonePlannerState_e geozonePlannerStep(geozonePlanner_t *planner, timeDelta_t budgetUs);
+int8_t geozonePlannerGetRoute(const geozonePlanner_t *planner, fpVector3_t *waypoints, uint8_t maxWaypoints);
@@ -792,7 +792,7 @@ bool isMulticopterCrashedInverted(timeMs_t currentTimeMs)
 
     static timeMs_t startTime = 0;
 
-    if ((ABS(attitude.values.roll) > 1000 || ABS(attitude.values.pitch) > 700) && fabsf(baroAltRate) < 200.0f) {
+    if ((ABS(imuGetAttitude()->values.roll) > 1000 || ABS(imuGetAttitude()->values.pitch) > 700) && fabsf(baroAltRate) < 200.0f) {
         if (startTime == 0) {
             startTime = currentTimeMs;
         }
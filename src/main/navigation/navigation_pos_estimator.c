@@ -56,7 +56,7 @@
 navigationPosEstimator_t posEstimator;
 static float initialBaroAltitudeOffset = 0.0f;
 
-PG_REGISTER_WITH_RESET_TEMPLATE(positionEstimationConfig_t, positionEstimationConfig, PG_POSITION_ESTIMATION_CONFIG, 8);
+PG_REGISTER_WITH_RESET_TEMPLATE(positionEstimationConfig_t, positionEstimationConfig, PG_POSITION_ESTIMATION_CONFIG, 10);
 
 PG_RESET_TEMPLATE(positionEstimationConfig_t, positionEstimationConfig,
         // Inertial position estimator parameters
@@ -93,8 +93,12 @@ PG_RESET_TEMPLATE(positionEstimationConfig_t, positionEstimationConfig,
 
         .default_alt_sensor = SETTING_INAV_DEFAULT_ALT_SENSOR_DEFAULT,
 #ifdef USE_GPS_FIX_ESTIMATION
-        .allow_gps_fix_estimation = SETTING_INAV_ALLOW_GPS_FIX_ESTIMATION_DEFAULT
+        .allow_gps_fix_estimation = SETTING_INAV_ALLOW_GPS_FIX_ESTIMATION_DEFAULT,
 #endif
+
+        .estimator_type = SETTING_INAV_ESTIMATOR_TYPE_DEFAULT,
+        .ekf_acc_noise = SETTING_INAV_EKF_ACC_NOISE_DEFAULT,
+        .gps_latency = SETTING_INAV_GPS_LATENCY_DEFAULT,
 );
 
 #define resetTimer(tim, currentTimeUs) { (tim)->deltaTime = 0; (tim)->lastTriggeredTime = currentTimeUs; }
@@ -258,6 +262,9 @@ void onNewGPSData(void)
 
                 /* Indicate a last valid reading of Pos/Vel */
                 posEstimator.gps.lastUpdateTime = currentTimeUs;
+
+                /* Match GPS velocity against past estimates to measure GPS latency */
+                navPosHistoryUpdateLatency(&posEstimator.history, currentTimeUs, &posEstimator.gps.vel);
             }
 
             previousLat = gpsSol.llh.lat;
@@ -547,18 +554,8 @@ static void estimationPredict(estimationContext_t * ctx)
     }
 }
 
-static bool estimationCalculateCorrection_Z(estimationContext_t * ctx)
+static void estimationCalculateAltitudeWeights(const estimationContext_t * ctx, float * wGpsOut, float * wBaroOut)
 {
-    DEBUG_SET(DEBUG_ALTITUDE, 0, posEstimator.est.pos.z);       // Position estimate
-    DEBUG_SET(DEBUG_ALTITUDE, 2, posEstimator.baro.alt);        // Baro altitude
-    DEBUG_SET(DEBUG_ALTITUDE, 4, posEstimator.gps.pos.z);       // GPS altitude
-    DEBUG_SET(DEBUG_ALTITUDE, 6, accGetVibrationLevel());       // Vibration level
-    DEBUG_SET(DEBUG_ALTITUDE, 1, posEstimator.est.vel.z);       // Vertical speed estimate
-    DEBUG_SET(DEBUG_ALTITUDE, 3, posEstimator.imu.accelNEU.z);  // Vertical acceleration on earth frame
-    DEBUG_SET(DEBUG_ALTITUDE, 5, posEstimator.gps.vel.z);       // GPS vertical speed
-    DEBUG_SET(DEBUG_ALTITUDE, 7, accGetClipCount());            // Clip count
-
-    bool correctOK = false;
     const uint8_t defaultAltitudeSource = positionEstimationConfig()->default_alt_sensor;
     float wGps = defaultAltitudeSource == ALTITUDE_SOURCE_BARO_ONLY && ctx->newFlags & EST_BARO_VALID ? 0.0f : 1.0f;
     float wBaro = defaultAltitudeSource == ALTITUDE_SOURCE_GPS_ONLY && ctx->newFlags & EST_GPS_Z_VALID ? 0.0f : 1.0f;
@@ -580,27 +577,51 @@ static bool estimationCalculateCorrection_Z(estimationContext_t * ctx)
         }
     }
 
-    if (ctx->newFlags & EST_BARO_VALID && wBaro) {
-        timeUs_t currentTimeUs = micros();
+    *wGpsOut = wGps;
+    *wBaroOut = wBaro;
+}
 
-        if (!ARMING_FLAG(ARMED)) {
-            posEstimator.state.baroGroundAlt = posEstimator.est.pos.z;
-            posEstimator.state.isBaroGroundValid = true;
-            posEstimator.state.baroGroundTimeout = currentTimeUs + 250000;   // 0.25 sec
+static bool estimationDetectAirCushion(const estimationContext_t * ctx)
+{
+    timeUs_t currentTimeUs = micros();
+
+    if (!ARMING_FLAG(ARMED)) {
+        posEstimator.state.baroGroundAlt = posEstimator.est.pos.z;
+        posEstimator.state.isBaroGroundValid = true;
+        posEstimator.state.baroGroundTimeout = currentTimeUs + 250000;   // 0.25 sec
+    }
+    else {
+        if (posEstimator.est.vel.z > 15) {
+            posEstimator.state.isBaroGroundValid = currentTimeUs > posEstimator.state.baroGroundTimeout ? false: true;
         }
         else {
-            if (posEstimator.est.vel.z > 15) {
-                posEstimator.state.isBaroGroundValid = currentTimeUs > posEstimator.state.baroGroundTimeout ? false: true;
-            }
-            else {
-                posEstimator.state.baroGroundTimeout = currentTimeUs + 250000;   // 0.25 sec
-            }
+            posEstimator.state.baroGroundTimeout = currentTimeUs + 250000;   // 0.25 sec
         }
+    }
+
+    // We might be experiencing air cushion effect during takeoff - use sonar or baro ground altitude to detect it
+    return ARMING_FLAG(ARMED) &&
+           (((ctx->newFlags & EST_SURFACE_VALID) && posEstimator.surface.alt < 20.0f && posEstimator.state.isBaroGroundValid) ||
+            ((ctx->newFlags & EST_BARO_VALID) && posEstimator.state.isBaroGroundValid && posEstimator.baro.alt < posEstimator.state.baroGroundAlt));
+}
+
+static bool estimationCalculateCorrection_Z(estimationContext_t * ctx)
+{
+    DEBUG_SET(DEBUG_ALTITUDE, 0, posEstimator.est.pos.z);       // Position estimate
+    DEBUG_SET(DEBUG_ALTITUDE, 2, posEstimator.baro.alt);        // Baro altitude
+    DEBUG_SET(DEBUG_ALTITUDE, 4, posEstimator.gps.pos.z);       // GPS altitude
+    DEBUG_SET(DEBUG_ALTITUDE, 6, accGetVibrationLevel());       // Vibration level
+    DEBUG_SET(DEBUG_ALTITUDE, 1, posEstimator.est.vel.z);       // Vertical speed estimate
+    DEBUG_SET(DEBUG_ALTITUDE, 3, posEstimator.imu.accelNEU.z);  // Vertical acceleration on earth frame
+    DEBUG_SET(DEBUG_ALTITUDE, 5, posEstimator.gps.vel.z);       // GPS vertical speed
+    DEBUG_SET(DEBUG_ALTITUDE, 7, accGetClipCount());            // Clip count
+
+    bool correctOK = false;
+    float wGps, wBaro;
+    estimationCalculateAltitudeWeights(ctx, &wGps, &wBaro);
 
-        // We might be experiencing air cushion effect during takeoff - use sonar or baro ground altitude to detect it
-        bool isAirCushionEffectDetected = ARMING_FLAG(ARMED) &&
-                                            (((ctx->newFlags & EST_SURFACE_VALID) && posEstimator.surface.alt < 20.0f && posEstimator.state.isBaroGroundValid) ||
-                                             ((ctx->newFlags & EST_BARO_VALID) && posEstimator.state.isBaroGroundValid && posEstimator.baro.alt < posEstimator.state.baroGroundAlt));
+    if (ctx->newFlags & EST_BARO_VALID && wBaro) {
+        const bool isAirCushionEffectDetected = estimationDetectAirCushion(ctx);
 
         // Altitude
         const float baroAltResidual = wBaro * ((isAirCushionEffectDetected ? posEstimator.state.baroGroundAlt : posEstimator.baro.alt) - posEstimator.est.pos.z);
@@ -630,8 +651,8 @@ static bool estimationCalculateCorrection_Z(estimationContext_t * ctx)
         }
         else {
             // Altitude
-            const float gpsAltResidual = wGps * (posEstimator.gps.pos.z - posEstimator.est.pos.z);
-            const float gpsVelZResidual = wGps * (posEstimator.gps.vel.z - posEstimator.est.vel.z);
+            const float gpsAltResidual = wGps * (posEstimator.gps.pos.z - ctx->gpsRefPos.z);
+            const float gpsVelZResidual = wGps * (posEstimator.gps.vel.z - ctx->gpsRefVel.z);
             const float w_z_gps_p = positionEstimationConfig()->w_z_gps_p;
 
             ctx->estPosCorr.z += gpsAltResidual * w_z_gps_p * ctx->dt;
@@ -661,10 +682,10 @@ static bool estimationCalculateCorrection_XY_GPS(estimationContext_t * ctx)
             ctx->newEPH = posEstimator.gps.eph;
         }
         else {
-            const float gpsPosXResidual = posEstimator.gps.pos.x - posEstimator.est.pos.x;
-            const float gpsPosYResidual = posEstimator.gps.pos.y - posEstimator.est.pos.y;
-            const float gpsVelXResidual = posEstimator.gps.vel.x - posEstimator.est.vel.x;
-            const float gpsVelYResidual = posEstimator.gps.vel.y - posEstimator.est.vel.y;
+            const float gpsPosXResidual = posEstimator.gps.pos.x - ctx->gpsRefPos.x;
+            const float gpsPosYResidual = posEstimator.gps.pos.y - ctx->gpsRefPos.y;
+            const float gpsVelXResidual = posEstimator.gps.vel.x - ctx->gpsRefVel.x;
+            const float gpsVelYResidual = posEstimator.gps.vel.y - ctx->gpsRefVel.y;
             const float gpsPosResidualMag = calc_length_pythagorean_2D(gpsPosXResidual, gpsPosYResidual);
 
             //const float gpsWeightScaler = scaleRangef(bellCurve(gpsPosResidualMag, INAV_GPS_ACCEPTANCE_EPE), 0.0f, 1.0f, 0.1f, 1.0f);
@@ -712,6 +733,292 @@ static void estimationCalculateGroundCourse(timeUs_t currentTimeUs)
     }
 }
 
+/**
+ * GPS samples are inav_gps_latency old when they arrive - compare them against
+ * the estimate from that moment, not the current one
+ */
+static void estimationCalculateGpsReference(estimationContext_t * ctx)
+{
+    const uint16_t gpsLatencyMs = positionEstimationConfig()->gps_latency;
+    const timeUs_t gpsSampleTime = posEstimator.gps.lastUpdateTime - MS2US(gpsLatencyMs);
+
+    if (gpsLatencyMs == 0 || !navPosHistoryGetState(&posEstimator.history, gpsSampleTime, &ctx->gpsRefPos, &ctx->gpsRefVel)) {
+        ctx->gpsRefPos = posEstimator.est.pos;
+        ctx->gpsRefVel = posEstimator.est.vel;
+    }
+}
+
+/**
+ * Complementary filter: fixed-gain corrections from GPS, BARO and FLOW
+ */
+static void estimationUpdateComplementary(estimationContext_t * ctx)
+{
+    const float max_eph_epv = positionEstimationConfig()->max_eph_epv;
+
+    /* Prediction stage: X,Y,Z */
+    estimationPredict(ctx);
+    estimationCalculateGpsReference(ctx);
+
+    /* Correction stage: Z */
+    const bool estZCorrectOk =
+        estimationCalculateCorrection_Z(ctx);
+
+    /* Correction stage: XY: GPS, FLOW */
+    // FIXME: Handle transition from FLOW to GPS and back - seamlessly fly indoor/outdoor
+    const bool estXYCorrectOk =
+        estimationCalculateCorrection_XY_GPS(ctx) ||
+        estimationCalculateCorrection_XY_FLOW(ctx);
+
+    // If we can't apply correction or accuracy is off the charts - decay velocity to zero
+    if (!estXYCorrectOk || ctx->newEPH > max_eph_epv) {
+        ctx->estVelCorr.x = (0.0f - posEstimator.est.vel.x) * positionEstimationConfig()->w_xy_res_v * ctx->dt;
+        ctx->estVelCorr.y = (0.0f - posEstimator.est.vel.y) * positionEstimationConfig()->w_xy_res_v * ctx->dt;
+    }
+
+    if (!estZCorrectOk || ctx->newEPV > max_eph_epv) {
+        ctx->estVelCorr.z = (0.0f - posEstimator.est.vel.z) * positionEstimationConfig()->w_z_res_v * ctx->dt;
+    }
+    // Boost the corrections based on accWeight
+    const float accWeight = navGetAccelerometerWeight();
+    vectorScale(&ctx->estPosCorr, &ctx->estPosCorr, 1.0f/accWeight);
+    vectorScale(&ctx->estVelCorr, &ctx->estVelCorr, 1.0f/accWeight);
+    // Apply corrections
+    vectorAdd(&posEstimator.est.pos, &posEstimator.est.pos, &ctx->estPosCorr);
+    vectorAdd(&posEstimator.est.vel, &posEstimator.est.vel, &ctx->estVelCorr);
+    navPosHistoryAddCorrection(&posEstimator.history, &ctx->estPosCorr, &ctx->estVelCorr);
+
+    /* Correct accelerometer bias */
+    const float w_acc_bias = positionEstimationConfig()->w_acc_bias;
+    if (w_acc_bias > 0.0f) {
+        const float accelBiasCorrMagnitudeSq = sq(ctx->accBiasCorr.x) + sq(ctx->accBiasCorr.y) + sq(ctx->accBiasCorr.z);
+        if (accelBiasCorrMagnitudeSq < sq(INAV_ACC_BIAS_ACCEPTANCE_VALUE)) {
+            /* transform error vector from NEU frame to body frame */
+            imuTransformVectorEarthToBody(&ctx->accBiasCorr);
+
+            /* Correct accel bias */
+            posEstimator.imu.accelBias.x += ctx->accBiasCorr.x * w_acc_bias * ctx->dt;
+            posEstimator.imu.accelBias.y += ctx->accBiasCorr.y * w_acc_bias * ctx->dt;
+            posEstimator.imu.accelBias.z += ctx->accBiasCorr.z * w_acc_bias * ctx->dt;
+        }
+    }
+}
+
+static void estimationResetEKF(void)
+{
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        // EPH is horizontal, split it between axes
+        const float posVar = (axis == Z) ? sq(posEstimator.est.epv) : sq(posEstimator.est.eph) / 2.0f;
+        navEkfAxisReset(&posEstimator.ekf.axis[axis], posEstimator.est.pos.v[axis], posEstimator.est.vel.v[axis],
+                        posVar, sq(INAV_EKF_INITIAL_VEL_SIGMA), sq(INAV_EKF_ACC_BIAS_SIGMA));
+    }
+
+    memset(posEstimator.ekf.rejectCount, 0, sizeof(posEstimator.ekf.rejectCount));
+    posEstimator.ekf.lastGpsUpdateTime = 0;
+    posEstimator.ekf.lastBaroUpdateTime = 0;
+}
+
+/*
+ * Fuse a scalar measurement, fall back to the measurement itself if the filter
+ * keeps rejecting it (sensor reference jump, filter divergence)
+ */
+static void estimationFuseEKF(navEkfAxis_t * axis, navEkfState_e state, navEkfMeasurement_e meas, float measurement, float measVar)
+{
+    uint8_t * rejectCount = &posEstimator.ekf.rejectCount[meas];
+
+    if (navEkfAxisUpdate(axis, state, measurement, measVar, INAV_EKF_INNOVATION_GATE)) {
+        *rejectCount = 0;
+        return;
+    }
+
+    posEstimator.ekf.rejectedTotal++;
+
+    if (++(*rejectCount) >= INAV_EKF_MAX_REJECTED_UPDATES) {
+        navEkfAxisSetState(axis, state, measurement, measVar);
+        *rejectCount = 0;
+    }
+}
+
+/**
+ * Kalman filter: position, velocity and accelerometer bias fused from GPS and BARO,
+ * EPH and EPV are taken from the filter covariance
+ */
+static void estimationUpdateEKF(estimationContext_t * ctx)
+{
+    navPositionEstimatorEKF_t * ekf = &posEstimator.ekf;
+    const float max_eph_epv = positionEstimationConfig()->max_eph_epv;
+
+    /* Start from the current estimate when switched on */
+    if (!ekf->isActive) {
+        estimationResetEKF();
+        ekf->isActive = true;
+    }
+
+    /* Vibration and clipping make accelerometer less trustworthy - inflate process noise */
+    const float accVar = sq(positionEstimationConfig()->ekf_acc_noise / navGetAccelerometerWeight());
+    const float biasVar = sq(INAV_EKF_ACC_BIAS_NOISE);
+
+    /* Prediction stage: Z */
+    bool isZValid = ctx->newFlags & EST_Z_VALID;
+    if (isZValid) {
+        navEkfAxis_t * axis = &ekf->axis[Z];
+        // Hold velocity until first armed
+        const float accZ = ARMING_FLAG(WAS_EVER_ARMED) ? posEstimator.imu.accelNEU.z : axis->x[NAV_EKF_ACC_BIAS];
+        navEkfAxisPredict(axis, accZ, ctx->dt, accVar, biasVar);
+    }
+
+    /* Prediction stage: XY */
+    bool isXYValid = ctx->newFlags & EST_XY_VALID;
+    if (isXYValid) {
+        const bool isAccelUsable = navIsHeadingUsable() && navIsAccelerationUsable();
+        for (int i = X; i <= Y; i++) {
+            navEkfAxis_t * axis = &ekf->axis[i];
+            if (isAccelUsable) {
+                navEkfAxisPredict(axis, posEstimator.imu.accelNEU.v[i], ctx->dt, accVar, biasVar);
+            }
+            else {
+                navEkfAxisPredict(axis, axis->x[NAV_EKF_ACC_BIAS], ctx->dt, sq(INAV_EKF_NO_HEADING_ACC_SIGMA), biasVar);
+            }
+        }
+    }
+
+    estimationCalculateGpsReference(ctx);
+
+    fpVector3_t predictedPos, predictedVel;
+    for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
+        predictedPos.v[i] = ekf->axis[i].x[NAV_EKF_POS];
+        predictedVel.v[i] = ekf->axis[i].x[NAV_EKF_VEL];
+    }
+
+    const bool isNewGpsSample = posEstimator.gps.lastUpdateTime != ekf->lastGpsUpdateTime;
+    const bool isNewBaroSample = posEstimator.baro.lastUpdateTime != ekf->lastBaroUpdateTime;
+
+    /* Correction stage: Z */
+    bool estZCorrectOk = false;
+    float wGps, wBaro;
+    estimationCalculateAltitudeWeights(ctx, &wGps, &wBaro);
+
+    if (ctx->newFlags & EST_BARO_VALID && wBaro) {
+        const bool isAirCushionEffectDetected = estimationDetectAirCushion(ctx);
+        const float baroAlt = isAirCushionEffectDetected ? posEstimator.state.baroGroundAlt : posEstimator.baro.alt;
+
+        if (isNewBaroSample) {
+            if (!isZValid) {
+                navEkfAxisSetState(&ekf->axis[Z], NAV_EKF_POS, baroAlt, sq(posEstimator.baro.epv));
+                isZValid = true;
+            }
+            else {
+                estimationFuseEKF(&ekf->axis[Z], NAV_EKF_POS, EKF_MEAS_BARO_ALT, baroAlt, sq(posEstimator.baro.epv / wBaro));
+            }
+        }
+
+        estZCorrectOk = ARMING_FLAG(WAS_EVER_ARMED);    // No correction until first armed
+    }
+
+    if (ctx->newFlags & EST_GPS_Z_VALID && wGps) {
+        if (isNewGpsSample) {
+            if (!isZValid) {
+                navEkfAxisSetState(&ekf->axis[Z], NAV_EKF_POS, posEstimator.gps.pos.z, sq(posEstimator.gps.epv));
+                navEkfAxisSetState(&ekf->axis[Z], NAV_EKF_VEL, posEstimator.gps.vel.z, sq(INAV_EKF_GPS_VEL_SIGMA));
+            }
+            else {
+                // Delayed measurement: innovation is taken against the estimate at GPS sample time
+                const float gpsPosZ = posEstimator.gps.pos.z + predictedPos.z - ctx->gpsRefPos.z;
+                const float gpsVelZ = posEstimator.gps.vel.z + predictedVel.z - ctx->gpsRefVel.z;
+                estimationFuseEKF(&ekf->axis[Z], NAV_EKF_POS, EKF_MEAS_GPS_POS_Z, gpsPosZ, sq(posEstimator.gps.epv / wGps));
+                estimationFuseEKF(&ekf->axis[Z], NAV_EKF_VEL, EKF_MEAS_GPS_VEL_Z, gpsVelZ, sq(2.0f * INAV_EKF_GPS_VEL_SIGMA / wGps));
+            }
+        }
+
+        estZCorrectOk = ARMING_FLAG(WAS_EVER_ARMED);    // No correction until first armed
+    }
+
+    /* Correction stage: XY */
+    bool estXYCorrectOk = false;
+    if (ctx->newFlags & EST_GPS_XY_VALID) {
+        if (isNewGpsSample) {
+            // GPS EPH is horizontal, split it between axes
+            const float posVar = sq(posEstimator.gps.eph) / 2.0f;
+
+            for (int i = X; i <= Y; i++) {
+                if (!isXYValid) {
+                    navEkfAxisSetState(&ekf->axis[i], NAV_EKF_POS, posEstimator.gps.pos.v[i], posVar);
+                    navEkfAxisSetState(&ekf->axis[i], NAV_EKF_VEL, posEstimator.gps.vel.v[i], sq(INAV_EKF_GPS_VEL_SIGMA));
+                }
+                else {
+                    const float gpsPos = posEstimator.gps.pos.v[i] + predictedPos.v[i] - ctx->gpsRefPos.v[i];
+                    const float gpsVel = posEstimator.gps.vel.v[i] + predictedVel.v[i] - ctx->gpsRefVel.v[i];
+                    estimationFuseEKF(&ekf->axis[i], NAV_EKF_POS, EKF_MEAS_GPS_POS_X + i, gpsPos, posVar);
+                    estimationFuseEKF(&ekf->axis[i], NAV_EKF_VEL, EKF_MEAS_GPS_VEL_X + i, gpsVel, sq(INAV_EKF_GPS_VEL_SIGMA));
+                }
+            }
+        }
+
+        estXYCorrectOk = true;
+    }
+    else if (estimationCalculateCorrection_XY_FLOW(ctx)) {
+        // Optical flow keeps its complementary correction, applied on top of the filter state
+        for (int i = X; i <= Y; i++) {
+            navEkfAxis_t * axis = &ekf->axis[i];
+            navEkfAxisSetState(axis, NAV_EKF_POS, axis->x[NAV_EKF_POS] + ctx->estPosCorr.v[i], sq(ctx->newEPH) / 2.0f);
+            axis->x[NAV_EKF_VEL] += ctx->estVelCorr.v[i];
+        }
+
+        estXYCorrectOk = true;
+    }
+
+    ekf->lastGpsUpdateTime = posEstimator.gps.lastUpdateTime;
+    ekf->lastBaroUpdateTime = posEstimator.baro.lastUpdateTime;
+
+    /* Uncertainty comes straight from the covariance */
+    ctx->newEPH = fast_fsqrtf(navEkfAxisGetVariance(&ekf->axis[X], NAV_EKF_POS) + navEkfAxisGetVariance(&ekf->axis[Y], NAV_EKF_POS));
+    ctx->newEPV = fast_fsqrtf(navEkfAxisGetVariance(&ekf->axis[Z], NAV_EKF_POS));
+
+    // If we can't apply correction or accuracy is off the charts - decay velocity to zero
+    if (!estXYCorrectOk || ctx->newEPH > max_eph_epv) {
+        ekf->axis[X].x[NAV_EKF_VEL] -= ekf->axis[X].x[NAV_EKF_VEL] * positionEstimationConfig()->w_xy_res_v * ctx->dt;
+        ekf->axis[Y].x[NAV_EKF_VEL] -= ekf->axis[Y].x[NAV_EKF_VEL] * positionEstimationConfig()->w_xy_res_v * ctx->dt;
+    }
+
+    if (!estZCorrectOk || ctx->newEPV > max_eph_epv) {
+        ekf->axis[Z].x[NAV_EKF_VEL] -= ekf->axis[Z].x[NAV_EKF_VEL] * positionEstimationConfig()->w_z_res_v * ctx->dt;
+    }
+
+    fpVector3_t posCorr, velCorr;
+    for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
+        posEstimator.est.pos.v[i] = ekf->axis[i].x[NAV_EKF_POS];
+        posEstimator.est.vel.v[i] = ekf->axis[i].x[NAV_EKF_VEL];
+        posCorr.v[i] = posEstimator.est.pos.v[i] - predictedPos.v[i];
+        velCorr.v[i] = posEstimator.est.vel.v[i] - predictedVel.v[i];
+    }
+    navPosHistoryAddCorrection(&posEstimator.history, &posCorr, &velCorr);
+}
+
+static void estimationUpdateStats(const estimationContext_t * ctx)
+{
+    static timeUs_t lastGpsUpdateTime;
+    static timeUs_t lastBaroUpdateTime;
+
+    if (debugMode != DEBUG_POS_EST_STATS) {
+        return;
+    }
+
+    if ((ctx->newFlags & EST_GPS_XY_VALID) && posEstimator.gps.lastUpdateTime != lastGpsUpdateTime) {
+        DEBUG_SET(DEBUG_POS_EST_STATS, 1, lrintf(posEstimator.gps.pos.x - posEstimator.est.pos.x));     // GPS residual X (cm)
+        DEBUG_SET(DEBUG_POS_EST_STATS, 2, lrintf(posEstimator.gps.pos.y - posEstimator.est.pos.y));     // GPS residual Y (cm)
+        DEBUG_SET(DEBUG_POS_EST_STATS, 3, lrintf(posEstimator.gps.pos.z - posEstimator.est.pos.z));     // GPS residual Z (cm)
+    }
+
+    if ((ctx->newFlags & EST_BARO_VALID) && posEstimator.baro.lastUpdateTime != lastBaroUpdateTime) {
+        DEBUG_SET(DEBUG_POS_EST_STATS, 4, lrintf(posEstimator.baro.alt - posEstimator.est.pos.z));      // BARO residual (cm)
+    }
+
+    DEBUG_SET(DEBUG_POS_EST_STATS, 5, posEstimator.ekf.rejectedTotal);                                  // Measurements rejected by EKF gate
+    DEBUG_SET(DEBUG_POS_EST_STATS, 6, lrintf(posEstimator.est.eph));
+    DEBUG_SET(DEBUG_POS_EST_STATS, 7, lrintf(posEstimator.est.epv));
+    lastGpsUpdateTime = posEstimator.gps.lastUpdateTime;
+    lastBaroUpdateTime = posEstimator.baro.lastUpdateTime;
+}
+
 /**
  * Calculate next estimate using IMU and apply corrections from reference sensors (GPS, BARO etc)
  *  Function is called at main loop rate
@@ -731,6 +1038,8 @@ static void updateEstimatedTopic(timeUs_t currentTimeUs)
         posEstimator.est.eph = max_eph_epv + 0.001f;
         posEstimator.est.epv = max_eph_epv + 0.001f;
         posEstimator.flags = 0;
+        posEstimator.ekf.isActive = false;
+        navPosHistoryReset(&posEstimator.history);
         return;
     }
 
@@ -745,50 +1054,23 @@ static void updateEstimatedTopic(timeUs_t currentTimeUs)
     /* AGL estimation - separate process, decouples from Z coordinate */
     estimationCalculateAGL(&ctx);
 
-    /* Prediction stage: X,Y,Z */
-    estimationPredict(&ctx);
-
-    /* Correction stage: Z */
-    const bool estZCorrectOk =
-        estimationCalculateCorrection_Z(&ctx);
+    /* Track residuals against the newest GPS sample before it is fused */
+    estimationUpdateStats(&ctx);
 
-    /* Correction stage: XY: GPS, FLOW */
-    // FIXME: Handle transition from FLOW to GPS and back - seamlessly fly indoor/outdoor
-    const bool estXYCorrectOk =
-        estimationCalculateCorrection_XY_GPS(&ctx) ||
-        estimationCalculateCorrection_XY_FLOW(&ctx);
+    const timeUs_t estimationStartUs = (debugMode == DEBUG_POS_EST_STATS) ? micros() : 0;
 
-    // If we can't apply correction or accuracy is off the charts - decay velocity to zero
-    if (!estXYCorrectOk || ctx.newEPH > max_eph_epv) {
-        ctx.estVelCorr.x = (0.0f - posEstimator.est.vel.x) * positionEstimationConfig()->w_xy_res_v * ctx.dt;
-        ctx.estVelCorr.y = (0.0f - posEstimator.est.vel.y) * positionEstimationConfig()->w_xy_res_v * ctx.dt;
+    if (positionEstimationConfig()->estimator_type == NAV_ESTIMATOR_EKF) {
+        estimationUpdateEKF(&ctx);
     }
-
-    if (!estZCorrectOk || ctx.newEPV > max_eph_epv) {
-        ctx.estVelCorr.z = (0.0f - posEstimator.est.vel.z) * positionEstimationConfig()->w_z_res_v * ctx.dt;
+    else {
+        posEstimator.ekf.isActive = false;
+        estimationUpdateComplementary(&ctx);
     }
-    // Boost the corrections based on accWeight
-    const float accWeight = navGetAccelerometerWeight();
-    vectorScale(&ctx.estPosCorr, &ctx.estPosCorr, 1.0f/accWeight);
-    vectorScale(&ctx.estVelCorr, &ctx.estVelCorr, 1.0f/accWeight);
-    // Apply corrections
-    vectorAdd(&posEstimator.est.pos, &posEstimator.est.pos, &ctx.estPosCorr);
-    vectorAdd(&posEstimator.est.vel, &posEstimator.est.vel, &ctx.estVelCorr);
 
-    /* Correct accelerometer bias */
-    const float w_acc_bias = positionEstimationConfig()->w_acc_bias;
-    if (w_acc_bias > 0.0f) {
-        const float accelBiasCorrMagnitudeSq = sq(ctx.accBiasCorr.x) + sq(ctx.accBiasCorr.y) + sq(ctx.accBiasCorr.z);
-        if (accelBiasCorrMagnitudeSq < sq(INAV_ACC_BIAS_ACCEPTANCE_VALUE)) {
-            /* transform error vector from NEU frame to body frame */
-            imuTransformVectorEarthToBody(&ctx.accBiasCorr);
+    DEBUG_SET(DEBUG_POS_EST_STATS, 0, micros() - estimationStartUs);
 
-            /* Correct accel bias */
-            posEstimator.imu.accelBias.x += ctx.accBiasCorr.x * w_acc_bias * ctx.dt;
-            posEstimator.imu.accelBias.y += ctx.accBiasCorr.y * w_acc_bias * ctx.dt;
-            posEstimator.imu.accelBias.z += ctx.accBiasCorr.z * w_acc_bias * ctx.dt;
-        }
-    }
+    /* Remember the estimate for delayed GPS fusion */
+    navPosHistoryPush(&posEstimator.history, currentTimeUs, &posEstimator.est.pos, &posEstimator.est.vel);
 
     /* Update ground course */
     estimationCalculateGroundCourse(currentTimeUs);
@@ -808,14 +1090,23 @@ static void updateEstimatedTopic(timeUs_t currentTimeUs)
 static void publishEstimatedTopic(timeUs_t currentTimeUs)
 {
     static navigationTimer_t posPublishTimer;
+    static timeUs_t lastPublishedGpsUpdateTime;
+
+    /* Publish right after a GPS sample has been fused and restart the timer from there, this keeps
+     * the navigation controllers in phase with the receiver instead of aliasing against its rate */
+    const bool isNewGpsSample = posEstimator.gps.lastUpdateTime != lastPublishedGpsUpdateTime;
+    if (isNewGpsSample) {
+        lastPublishedGpsUpdateTime = posEstimator.gps.lastUpdateTime;
+        posPublishTimer.lastTriggeredTime = currentTimeUs - HZ2US(INAV_POSITION_PUBLISH_RATE_HZ);
+    }
 
     /* Position and velocity are published with INAV_POSITION_PUBLISH_RATE_HZ */
     if (updateTimer(&posPublishTimer, HZ2US(INAV_POSITION_PUBLISH_RATE_HZ), currentTimeUs)) {
         /* Publish heading update */
         /* IMU operates in decidegrees while INAV operates in deg*100
         * Use course over ground when GPS heading valid */
-        int16_t cogValue = isGPSHeadingValid() ? posEstimator.est.cog : attitude.values.yaw;
-        updateActualHeading(navIsHeadingUsable(), DECIDEGREES_TO_CENTIDEGREES(attitude.values.yaw), DECIDEGREES_TO_CENTIDEGREES(cogValue));
+        int16_t cogValue = isGPSHeadingValid() ? posEstimator.est.cog : imuGetAttitude()->values.yaw;
+        updateActualHeading(navIsHeadingUsable(), DECIDEGREES_TO_CENTIDEGREES(imuGetAttitude()->values.yaw), DECIDEGREES_TO_CENTIDEGREES(cogValue));
 
         /* Publish position update */
         if (posEstimator.est.eph < positionEstimationConfig()->max_eph_epv) {
@@ -839,6 +1130,8 @@ static void publishEstimatedTopic(timeUs_t currentTimeUs)
         //Update Blackbox states
         navEPH = posEstimator.est.eph;
         navEPV = posEstimator.est.epv;
+        navGpsLatency = navPosHistoryGetMeasuredLatencyMs(&posEstimator.history);
+        navPosHistoryDepth = navPosHistoryGetDepth(&posEstimator.history);
 
         DEBUG_SET(DEBUG_POS_EST, 0, (int32_t) posEstimator.est.pos.x*1000.0F);                // Position estimate X
         DEBUG_SET(DEBUG_POS_EST, 1, (int32_t) posEstimator.est.pos.y*1000.0F);                // Position estimate Y
@@ -852,7 +1145,7 @@ static void publishEstimatedTopic(timeUs_t currentTimeUs)
         }
         DEBUG_SET(DEBUG_POS_EST, 3, (int32_t) posEstimator.est.vel.x*1000.0F);                // Speed estimate VX
         DEBUG_SET(DEBUG_POS_EST, 4, (int32_t) posEstimator.est.vel.y*1000.0F);                // Speed estimate VY
-        DEBUG_SET(DEBUG_POS_EST, 6, (int32_t) attitude.values.yaw);                           // Yaw estimate (4 bytes still available here)
+        DEBUG_SET(DEBUG_POS_EST, 6, (int32_t) imuGetAttitude()->values.yaw);                           // Yaw estimate (4 bytes still available here)
         DEBUG_SET(DEBUG_POS_EST, 7, (int32_t) (posEstimator.flags & 0b1111111)<<20 |          // navPositionEstimationFlags fit into 8bits
                                               (MIN(navEPH, 1000) & 0x3FF)<<10 |
                                               (MIN(navEPV, 1000) & 0x3FF));                   // Horizontal and vertical uncertainties (max value = 1000, fit into 20bits)
@@ -899,6 +1192,8 @@ void initializePositionEstimator(void)
         posEstimator.est.vel.v[axis] = 0;
     }
 
+    navPosHistoryReset(&posEstimator.history);
+
     pt1FilterInit(&posEstimator.baro.avgFilter, INAV_BARO_AVERAGE_HZ, 0.0f);
     pt1FilterInit(&posEstimator.surface.avgFilter, INAV_SURFACE_AVERAGE_HZ, 0.0f);
 }
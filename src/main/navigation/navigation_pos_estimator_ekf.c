@@ -0,0 +1,152 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+#include <string.h>
+
+#include "platform.h"
+
+#include "common/maths.h"
+
+#include "navigation/navigation_pos_estimator_ekf.h"
+
+#define NAV_EKF_MIN_VARIANCE    1e-4f
+
+// Index of element (i,j) in packed upper triangle storage
+static const uint8_t covIdx[NAV_EKF_STATE_COUNT][NAV_EKF_STATE_COUNT] = {
+    { 0, 1, 2 },
+    { 1, 3, 4 },
+    { 2, 4, 5 },
+};
+
+#define COV(ekf, i, j)  ((ekf)->P[covIdx[i][j]])
+
+void navEkfAxisReset(navEkfAxis_t * ekf, float pos, float vel, float posVar, float velVar, float biasVar)
+{
+    ekf->x[NAV_EKF_POS] = pos;
+    ekf->x[NAV_EKF_VEL] = vel;
+    ekf->x[NAV_EKF_ACC_BIAS] = 0.0f;
+
+    memset(ekf->P, 0, sizeof(ekf->P));
+    COV(ekf, NAV_EKF_POS, NAV_EKF_POS) = posVar;
+    COV(ekf, NAV_EKF_VEL, NAV_EKF_VEL) = velVar;
+    COV(ekf, NAV_EKF_ACC_BIAS, NAV_EKF_ACC_BIAS) = biasVar;
+}
+
+/*
+ * Overwrite a single state and decorrelate it from the rest of the filter
+ */
+void navEkfAxisSetState(navEkfAxis_t * ekf, navEkfState_e state, float value, float variance)
+{
+    ekf->x[state] = value;
+
+    for (int i = 0; i < NAV_EKF_STATE_COUNT; i++) {
+        COV(ekf, state, i) = 0.0f;
+    }
+    COV(ekf, state, state) = variance;
+}
+
+/*
+ * x' = F x + B a, P' = F P F' + Q
+ *
+ *      | 1  dt  -dt^2/2 |
+ *  F = | 0  1   -dt     |
+ *      | 0  0    1      |
+ *
+ * Acceleration noise enters through G = [dt^2/2, dt, 0], bias is a random walk.
+ */
+void navEkfAxisPredict(navEkfAxis_t * ekf, float accel, float dt, float accVar, float biasVar)
+{
+    const float dt2 = sq(dt) / 2.0f;
+    const float acc = accel - ekf->x[NAV_EKF_ACC_BIAS];
+
+    ekf->x[NAV_EKF_POS] += ekf->x[NAV_EKF_VEL] * dt + acc * dt2;
+    ekf->x[NAV_EKF_VEL] += acc * dt;
+
+    const float p00 = COV(ekf, 0, 0), p01 = COV(ekf, 0, 1), p02 = COV(ekf, 0, 2);
+    const float p11 = COV(ekf, 1, 1), p12 = COV(ekf, 1, 2);
+    const float p22 = COV(ekf, 2, 2);
+
+    // F * P, rows 0 and 1 (row 2 is unchanged)
+    const float fp00 = p00 + dt * p01 - dt2 * p02;
+    const float fp01 = p01 + dt * p11 - dt2 * p12;
+    const float fp02 = p02 + dt * p12 - dt2 * p22;
+    const float fp11 = p11 - dt * p12;
+    const float fp12 = p12 - dt * p22;
+
+    // (F * P) * F'
+    COV(ekf, 0, 0) = fp00 + dt * fp01 - dt2 * fp02 + sq(dt2) * accVar;
+    COV(ekf, 0, 1) = fp01 - dt * fp02 + dt2 * dt * accVar;
+    COV(ekf, 0, 2) = fp02;
+    COV(ekf, 1, 1) = fp11 - dt * fp12 + sq(dt) * accVar;
+    COV(ekf, 1, 2) = fp12;
+    COV(ekf, 2, 2) = p22 + biasVar * dt;
+}
+
+/*
+ * Fuse a direct scalar measurement of one state (H is a unit row vector).
+ * Innovation covariance is a scalar so the gain needs a single division.
+ * Measurements further than gate * sigma from the prediction are rejected.
+ */
+bool navEkfAxisUpdate(navEkfAxis_t * ekf, navEkfState_e state, float measurement, float measVar, float gate)
+{
+    const float innov = measurement - ekf->x[state];
+    const float S = COV(ekf, state, state) + measVar;
+
+    if (S <= 0.0f) {
+        return false;
+    }
+
+    if (gate > 0.0f && sq(innov) > sq(gate) * S) {
+        return false;
+    }
+
+    float PHt[NAV_EKF_STATE_COUNT];
+    for (int i = 0; i < NAV_EKF_STATE_COUNT; i++) {
+        PHt[i] = COV(ekf, i, state);
+    }
+
+    const float invS = 1.0f / S;
+    for (int i = 0; i < NAV_EKF_STATE_COUNT; i++) {
+        ekf->x[i] += PHt[i] * invS * innov;
+
+        for (int j = i; j < NAV_EKF_STATE_COUNT; j++) {
+            COV(ekf, i, j) -= PHt[i] * PHt[j] * invS;
+        }
+    }
+
+    // Guard against loss of positive definiteness due to rounding
+    for (int i = 0; i < NAV_EKF_STATE_COUNT; i++) {
+        COV(ekf, i, i) = MAX(COV(ekf, i, i), NAV_EKF_MIN_VARIANCE);
+    }
+
+    return true;
+}
+
+float navEkfAxisGetVariance(const navEkfAxis_t * ekf, navEkfState_e state)
+{
+    return COV(ekf, state, state);
+}
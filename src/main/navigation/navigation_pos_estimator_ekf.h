@@ -0,0 +1,59 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+
+/*
+ * Compact Kalman filter for one axis of the position estimator.
+ * State is position (cm), velocity (cm/s) and accelerometer bias (cm/s/s) in
+ * the NEU frame. The prediction model is linear and the axes are decoupled,
+ * so three of these filters are equivalent to a full 9-state EKF at a
+ * fraction of the cost.
+ *
+ * Covariance is kept in packed symmetric storage (upper triangle, row-major)
+ * and measurements are fused one scalar at a time, so no matrix inversion is
+ * ever needed.
+ */
+
+#define NAV_EKF_STATE_COUNT     3
+#define NAV_EKF_COV_COUNT       (NAV_EKF_STATE_COUNT * (NAV_EKF_STATE_COUNT + 1) / 2)
+
+typedef enum {
+    NAV_EKF_POS = 0,
+    NAV_EKF_VEL,
+    NAV_EKF_ACC_BIAS,
+} navEkfState_e;
+
+typedef struct {
+    float x[NAV_EKF_STATE_COUNT];
+    float P[NAV_EKF_COV_COUNT];
+} navEkfAxis_t;
+
+void navEkfAxisReset(navEkfAxis_t * ekf, float pos, float vel, float posVar, float velVar, float biasVar);
+void navEkfAxisSetState(navEkfAxis_t * ekf, navEkfState_e state, float value, float variance);
+void navEkfAxisPredict(navEkfAxis_t * ekf, float accel, float dt, float accVar, float biasVar);
+bool navEkfAxisUpdate(navEkfAxis_t * ekf, navEkfState_e state, float measurement, float measVar, float gate);
+float navEkfAxisGetVariance(const navEkfAxis_t * ekf, navEkfState_e state);
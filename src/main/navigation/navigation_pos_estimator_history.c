@@ -0,0 +1,166 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+#include <string.h>
+
+#include "platform.h"
+
+#include "common/maths.h"
+#include "common/vector.h"
+
+#include "navigation/navigation_pos_estimator_history.h"
+
+#define NAV_POS_HISTORY_REBASE_LIMIT        10000.0f    // Fold corrections into entries before they lose float precision (cm)
+#define NAV_POS_HISTORY_LAG_FILTER          0.05f       // Weight of a new sample in the lag error filter
+#define NAV_POS_HISTORY_LAG_MIN_SAMPLES     20          // Samples a lag needs before it can be picked
+#define NAV_POS_HISTORY_MIN_EXCITATION      100.0f      // Only measure latency while accelerating at least this much (cm/s/s)
+#define NAV_POS_HISTORY_MAX_MEAS_INTERVAL   1000000     // Ignore measurement pairs further apart (us)
+
+static const navPosHistoryEntry_t * getEntry(const navPosHistory_t * history, int age)
+{
+    return &history->entries[(history->head + NAV_POS_HISTORY_SIZE - age) % NAV_POS_HISTORY_SIZE];
+}
+
+void navPosHistoryReset(navPosHistory_t * history)
+{
+    memset(history, 0, sizeof(navPosHistory_t));
+}
+
+void navPosHistoryPush(navPosHistory_t * history, timeUs_t time, const fpVector3_t * pos, const fpVector3_t * vel)
+{
+    if (history->count > 0 && (time - history->entries[history->head].time) < NAV_POS_HISTORY_PERIOD_US) {
+        return;
+    }
+
+    history->head = (history->head + 1) % NAV_POS_HISTORY_SIZE;
+    history->count = MIN(history->count + 1, NAV_POS_HISTORY_SIZE);
+
+    navPosHistoryEntry_t * entry = &history->entries[history->head];
+    entry->time = time;
+    vectorSub(&entry->pos, pos, &history->posCorr);
+    vectorSub(&entry->vel, vel, &history->velCorr);
+}
+
+void navPosHistoryAddCorrection(navPosHistory_t * history, const fpVector3_t * posCorr, const fpVector3_t * velCorr)
+{
+    vectorAdd(&history->posCorr, &history->posCorr, posCorr);
+    vectorAdd(&history->velCorr, &history->velCorr, velCorr);
+
+    if (fabsf(history->posCorr.x) > NAV_POS_HISTORY_REBASE_LIMIT || fabsf(history->posCorr.y) > NAV_POS_HISTORY_REBASE_LIMIT ||
+        fabsf(history->posCorr.z) > NAV_POS_HISTORY_REBASE_LIMIT) {
+        for (int i = 0; i < NAV_POS_HISTORY_SIZE; i++) {
+            vectorAdd(&history->entries[i].pos, &history->entries[i].pos, &history->posCorr);
+            vectorAdd(&history->entries[i].vel, &history->entries[i].vel, &history->velCorr);
+        }
+        vectorZero(&history->posCorr);
+        vectorZero(&history->velCorr);
+    }
+}
+
+/*
+ * Corrected state at the given time, interpolated between entries.
+ * Clamped to the oldest/newest entry outside of the recorded window.
+ */
+bool navPosHistoryGetState(const navPosHistory_t * history, timeUs_t time, fpVector3_t * pos, fpVector3_t * vel)
+{
+    if (history->count == 0) {
+        return false;
+    }
+
+    const navPosHistoryEntry_t * newer = getEntry(history, 0);
+    const navPosHistoryEntry_t * older = newer;
+
+    for (int age = 1; age < history->count && cmpTimeUs(older->time, time) > 0; age++) {
+        newer = older;
+        older = getEntry(history, age);
+    }
+
+    float k = 0.0f;
+    if (newer != older && cmpTimeUs(older->time, time) < 0) {
+        k = constrainf((float)(time - older->time) / (float)(newer->time - older->time), 0.0f, 1.0f);
+    }
+
+    for (int axis = 0; axis < 3; axis++) {
+        pos->v[axis] = older->pos.v[axis] + (newer->pos.v[axis] - older->pos.v[axis]) * k + history->posCorr.v[axis];
+        vel->v[axis] = older->vel.v[axis] + (newer->vel.v[axis] - older->vel.v[axis]) * k + history->velCorr.v[axis];
+    }
+
+    return true;
+}
+
+/*
+ * Measure latency of a velocity source by finding the history lag that best
+ * matches it. Only samples taken while accelerating carry lag information.
+ * A lag starts from its first error rather than from 0 and is only considered
+ * once it has seen enough samples, so lags only recently covered by the
+ * history don't win by default.
+ */
+void navPosHistoryUpdateLatency(navPosHistory_t * history, timeUs_t measTime, const fpVector3_t * measVel)
+{
+    const timeDelta_t measDt = cmpTimeUs(measTime, history->lastMeasTime);
+
+    if (history->lastMeasTime != 0 && measDt > 0 && measDt < NAV_POS_HISTORY_MAX_MEAS_INTERVAL) {
+        const float measAccel = calc_length_pythagorean_2D(measVel->x - history->lastMeasVel.x, measVel->y - history->lastMeasVel.y) / US2S(measDt);
+
+        if (measAccel >= NAV_POS_HISTORY_MIN_EXCITATION) {
+            int bestLag = -1;
+
+            for (int age = 0; age < history->count; age++) {
+                const navPosHistoryEntry_t * entry = getEntry(history, age);
+                const float error = sq(measVel->x - (entry->vel.x + history->velCorr.x)) + sq(measVel->y - (entry->vel.y + history->velCorr.y));
+
+                if (history->lagSamples[age] == 0) {
+                    history->lagError[age] = error;
+                } else {
+                    history->lagError[age] += (error - history->lagError[age]) * NAV_POS_HISTORY_LAG_FILTER;
+                }
+                history->lagSamples[age] = MIN(history->lagSamples[age] + 1, UINT8_MAX);
+
+                if (history->lagSamples[age] >= NAV_POS_HISTORY_LAG_MIN_SAMPLES && (bestLag < 0 || history->lagError[age] < history->lagError[bestLag])) {
+                    bestLag = age;
+                }
+            }
+
+            if (bestLag >= 0) {
+                history->measuredLatencyMs = (measTime - getEntry(history, bestLag)->time) / 1000;
+            }
+        }
+    }
+
+    history->lastMeasVel = *measVel;
+    history->lastMeasTime = measTime;
+}
+
+uint8_t navPosHistoryGetDepth(const navPosHistory_t * history)
+{
+    return history->count;
+}
+
+uint16_t navPosHistoryGetMeasuredLatencyMs(const navPosHistory_t * history)
+{
+    return history->measuredLatencyMs;
+}
@@ -0,0 +1,73 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/time.h"
+#include "common/vector.h"
+
+/*
+ * History of past position estimates, used to fuse delayed measurements
+ * (GPS) against the state at the time they were taken.
+ *
+ * Entries are stored without the corrections applied after they were
+ * recorded. The running sum of corrections is kept separately, so a past
+ * state is "entry + correction sum" and corrections never need to be
+ * propagated through the whole buffer.
+ */
+
+#define NAV_POS_HISTORY_SIZE            32
+#define NAV_POS_HISTORY_PERIOD_US       10000   // 100Hz, 320ms of history
+
+typedef struct {
+    timeUs_t    time;
+    fpVector3_t pos;
+    fpVector3_t vel;
+} navPosHistoryEntry_t;
+
+typedef struct {
+    navPosHistoryEntry_t entries[NAV_POS_HISTORY_SIZE];
+    uint8_t     head;                               // Index of the newest entry
+    uint8_t     count;
+    fpVector3_t posCorr;                            // Corrections applied since entries were rebased
+    fpVector3_t velCorr;
+
+    // Latency measurement
+    float       lagError[NAV_POS_HISTORY_SIZE];     // Filtered horizontal velocity mismatch for each lag
+    uint8_t     lagSamples[NAV_POS_HISTORY_SIZE];   // Samples in lagError, saturating
+    fpVector3_t lastMeasVel;
+    timeUs_t    lastMeasTime;
+    uint16_t    measuredLatencyMs;
+} navPosHistory_t;
+
+void navPosHistoryReset(navPosHistory_t * history);
+void navPosHistoryPush(navPosHistory_t * history, timeUs_t time, const fpVector3_t * pos, const fpVector3_t * vel);
+void navPosHistoryAddCorrection(navPosHistory_t * history, const fpVector3_t * posCorr, const fpVector3_t * velCorr);
+bool navPosHistoryGetState(const navPosHistory_t * history, timeUs_t time, fpVector3_t * pos, fpVector3_t * vel);
+void navPosHistoryUpdateLatency(navPosHistory_t * history, timeUs_t measTime, const fpVector3_t * measVel);
+uint8_t navPosHistoryGetDepth(const navPosHistory_t * history);
+uint16_t navPosHistoryGetMeasuredLatencyMs(const navPosHistory_t * history);
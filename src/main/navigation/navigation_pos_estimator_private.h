@@ -25,6 +25,9 @@
 #include "common/filter.h"
 #include "common/calibration.h"
 
+#include "navigation/navigation_pos_estimator_ekf.h"
+#include "navigation/navigation_pos_estimator_history.h"
+
 #include "sensors/sensors.h"
 
 #define INAV_GPS_DEFAULT_EPH                200.0f  // 2m GPS HDOP  (gives about 1.6s of dead-reckoning if GPS is temporary lost)
@@ -51,6 +54,14 @@
 #define INAV_BARO_AVERAGE_HZ                1.0f
 #define INAV_SURFACE_AVERAGE_HZ             1.0f
 
+#define INAV_EKF_INNOVATION_GATE            5.0f    // Reject measurements further than 5 sigma from prediction
+#define INAV_EKF_MAX_REJECTED_UPDATES       10      // Reset the state to the measurement after this many consecutive rejections
+#define INAV_EKF_GPS_VEL_SIGMA              50.0f   // GPS velocity noise (cm/s)
+#define INAV_EKF_INITIAL_VEL_SIGMA          100.0f  // Velocity uncertainty when the filter is (re)initialised (cm/s)
+#define INAV_EKF_ACC_BIAS_SIGMA             20.0f   // Initial accelerometer bias uncertainty (cm/s/s)
+#define INAV_EKF_ACC_BIAS_NOISE             1.0f    // Accelerometer bias random walk (cm/s/s/sqrt(s))
+#define INAV_EKF_NO_HEADING_ACC_SIGMA       500.0f  // Acceleration uncertainty when accelerometer can't be used (cm/s/s)
+
 #define INAV_ACC_CLIPPING_RC_CONSTANT           (0.010f)    // Reduce acc weight for ~10ms after clipping
 
 #define RANGEFINDER_RELIABILITY_RC_CONSTANT     (0.47802f)
@@ -153,6 +164,26 @@ typedef enum {
     ALTITUDE_SOURCE_BARO_ONLY,
 } navDefaultAltitudeSensor_e;
 
+typedef enum {
+    EKF_MEAS_GPS_POS_X,
+    EKF_MEAS_GPS_POS_Y,
+    EKF_MEAS_GPS_POS_Z,
+    EKF_MEAS_GPS_VEL_X,
+    EKF_MEAS_GPS_VEL_Y,
+    EKF_MEAS_GPS_VEL_Z,
+    EKF_MEAS_BARO_ALT,
+    EKF_MEAS_COUNT
+} navEkfMeasurement_e;
+
+typedef struct {
+    bool            isActive;
+    navEkfAxis_t    axis[XYZ_AXIS_COUNT];
+    timeUs_t        lastGpsUpdateTime;          // Time of the last GPS sample fused
+    timeUs_t        lastBaroUpdateTime;         // Time of the last baro sample fused
+    uint8_t         rejectCount[EKF_MEAS_COUNT];
+    uint16_t        rejectedTotal;
+} navPositionEstimatorEKF_t;
+
 typedef struct {
     timeUs_t    baroGroundTimeout;
     float       baroGroundAlt;
@@ -176,6 +207,12 @@ typedef struct {
     // Estimate
     navPositionEstimatorESTIMATE_t  est;
 
+    // EKF estimator state
+    navPositionEstimatorEKF_t   ekf;
+
+    // Past estimates for delayed GPS fusion
+    navPosHistory_t             history;
+
     // Extra state variables
     navPositionEstimatorSTATE_t state;
 } navigationPosEstimator_t;
@@ -188,6 +225,8 @@ typedef struct {
     fpVector3_t estPosCorr;
     fpVector3_t estVelCorr;
     fpVector3_t accBiasCorr;
+    fpVector3_t gpsRefPos;      // Estimate at the time the latest GPS sample was taken
+    fpVector3_t gpsRefVel;
 } estimationContext_t;
 
 extern navigationPosEstimator_t posEstimator;
@@ -24,8 +24,15 @@
  * Trackpoints logged with precedence for course/altitude changes. Distance based changes
  * only logged if no course/altitude changes logged over an extended distance.
  * Tracking suspended during fixed wing loiter (PosHold and WP Mode timed hold).
+ * Trackpoints are stored as meter offsets from the previous point. When the store
+ * is full the point closest to the line between its neighbours is merged away,
+ * so the whole track is kept with decreasing detail instead of dropping its start.
  * --------------------------------------------------------------------------------- */
 
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
 #include "platform.h"
 
 #include "fc/multifunction.h"
@@ -37,6 +44,141 @@
 
 rth_trackback_t rth_trackback;
 
+static fpVector3_t trackBackTarget;
+
+static void rthTrackBackApplyDelta(fpVector3_t *point, const rth_trackback_delta_t *delta, const int8_t sign)
+{
+    point->x += sign * METERS_TO_CENTIMETERS(delta->x);
+    point->y += sign * METERS_TO_CENTIMETERS(delta->y);
+    point->z += sign * METERS_TO_CENTIMETERS(delta->z);
+}
+
+static bool rthTrackBackMergeDelta(rth_trackback_delta_t *result, const rth_trackback_delta_t *a, const rth_trackback_delta_t *b)
+{
+    const int32_t x = a->x + b->x;
+    const int32_t y = a->y + b->y;
+    const int32_t z = a->z + b->z;
+
+    if (ABS(x) > INT16_MAX || ABS(y) > INT16_MAX || ABS(z) > INT16_MAX) {
+        return false;
+    }
+
+    result->x = x;
+    result->y = y;
+    result->z = z;
+    return true;
+}
+
+static float distanceToSegment(const fpVector3_t *point, const fpVector3_t *start, const fpVector3_t *end)
+{
+    const fpVector3_t segment = { .x = end->x - start->x, .y = end->y - start->y, .z = end->z - start->z };
+    const fpVector3_t toPoint = { .x = point->x - start->x, .y = point->y - start->y, .z = point->z - start->z };
+    const float lengthSq = sq(segment.x) + sq(segment.y) + sq(segment.z);
+
+    float t = lengthSq > 0 ? (toPoint.x * segment.x + toPoint.y * segment.y + toPoint.z * segment.z) / lengthSq : 0;
+    t = constrainf(t, 0.0f, 1.0f);
+    return fast_fsqrtf(sq(toPoint.x - t * segment.x) + sq(toPoint.y - t * segment.y) + sq(toPoint.z - t * segment.z));
+}
+
+static void rthTrackBackRemovePoint(int16_t index, const rth_trackback_delta_t *mergedDelta)
+{
+    // Point index is dropped, its successor is now reached directly from its predecessor
+    rth_trackback.deltaList[index - 1] = *mergedDelta;
+    memmove(&rth_trackback.deltaList[index], &rth_trackback.deltaList[index + 1], (rth_trackback.pointCount - 2 - index) * sizeof(rth_trackback_delta_t));
+    rth_trackback.pointCount--;
+}
+
+// Incremental Douglas-Peucker: merge the point that deviates least from the line between its neighbours
+static bool rthTrackBackSimplify(void)
+{
+    float minDeviation = FLT_MAX;
+    int16_t minIndex = -1;
+    rth_trackback_delta_t minMerged = { 0 };
+
+    fpVector3_t prev = rth_trackback.firstPoint;
+    fpVector3_t current = prev;
+    rthTrackBackApplyDelta(&current, &rth_trackback.deltaList[0], 1);
+
+    for (int16_t i = 1; i < rth_trackback.pointCount - 1; i++) {
+        fpVector3_t next = current;
+        rthTrackBackApplyDelta(&next, &rth_trackback.deltaList[i], 1);
+
+        rth_trackback_delta_t merged;
+        if (rthTrackBackMergeDelta(&merged, &rth_trackback.deltaList[i - 1], &rth_trackback.deltaList[i])) {
+            const float deviation = distanceToSegment(&current, &prev, &next);
+            if (deviation < minDeviation) {
+                minDeviation = deviation;
+                minIndex = i;
+                minMerged = merged;
+            }
+        }
+
+        prev = current;
+        current = next;
+    }
+
+    if (minIndex < 0) {
+        return false;
+    }
+
+    rthTrackBackRemovePoint(minIndex, &minMerged);
+    return true;
+}
+
+static void rthTrackBackDropOldestPoint(void)
+{
+    rthTrackBackApplyDelta(&rth_trackback.firstPoint, &rth_trackback.deltaList[0], 1);
+    memmove(&rth_trackback.deltaList[0], &rth_trackback.deltaList[1], (rth_trackback.pointCount - 2) * sizeof(rth_trackback_delta_t));
+    rth_trackback.pointCount--;
+}
+
+static void rthTrackBackAppendDelta(const rth_trackback_delta_t *delta)
+{
+    if (rth_trackback.pointCount >= NAV_RTH_TRACKBACK_POINTS && !rthTrackBackSimplify()) {
+        rthTrackBackDropOldestPoint();
+    }
+
+    rth_trackback.deltaList[rth_trackback.pointCount - 1] = *delta;
+    rth_trackback.pointCount++;
+    rthTrackBackApplyDelta(&rth_trackback.lastPoint, delta, 1);
+}
+
+static void rthTrackBackSavePoint(const fpVector3_t *pos)
+{
+    if (rth_trackback.activePointIndex < 0 || rth_trackback.pointCount == 0) {
+        rth_trackback.firstPoint = rth_trackback.lastPoint = *pos;
+        rth_trackback.pointCount = 1;
+    } else {
+        if (rth_trackback.activePointIndex < rth_trackback.pointCount - 1) {
+            // Trackback was interrupted, continue recording from the point it got to
+            rth_trackback.pointCount = rth_trackback.activePointIndex + 1;
+            rth_trackback.lastPoint = rth_trackback.activePoint;
+        }
+
+        // Offsets are taken from the stored (rounded) last point, so rounding errors don't add up
+        const float dx = roundf(CENTIMETERS_TO_METERS((pos->x - rth_trackback.lastPoint.x)));
+        const float dy = roundf(CENTIMETERS_TO_METERS((pos->y - rth_trackback.lastPoint.y)));
+        const float dz = roundf(CENTIMETERS_TO_METERS((pos->z - rth_trackback.lastPoint.z)));
+
+        // Split jumps that don't fit into a single offset
+        const int32_t steps = ceilf(MAX(MAX(fabsf(dx), fabsf(dy)), fabsf(dz)) / INT16_MAX);
+        int32_t doneX = 0, doneY = 0, doneZ = 0;
+        for (int32_t step = 1; step <= MAX(steps, 1); step++) {
+            const int32_t targetX = lrintf(dx * step / MAX(steps, 1));
+            const int32_t targetY = lrintf(dy * step / MAX(steps, 1));
+            const int32_t targetZ = lrintf(dz * step / MAX(steps, 1));
+            const rth_trackback_delta_t delta = { .x = targetX - doneX, .y = targetY - doneY, .z = targetZ - doneZ };
+            rthTrackBackAppendDelta(&delta);
+            doneX = targetX;
+            doneY = targetY;
+            doneZ = targetZ;
+        }
+    }
+
+    rth_trackback.activePointIndex = rth_trackback.lastSavedIndex = rth_trackback.pointCount - 1;
+    rth_trackback.activePoint = rth_trackback.lastPoint;
+}
+
 bool rthTrackBackCanBeActivated(void)
 {
     return posControl.flags.estPosStatus >= EST_USABLE &&
@@ -83,11 +225,11 @@ void rthTrackBackUpdate(bool forceSaveTrackPoint)
                     saveTrackpoint = true;
                 } else if (distanceCounter >= 9) {
                     // Distance based trackpoint logged if at least 10 distance increments occur without altitude or course change and deviation from projected course path > 20m
-                    float distToPrevPoint = calculateDistanceToDestination(&rth_trackback.pointsList[rth_trackback.activePointIndex]);
+                    float distToPrevPoint = calculateDistanceToDestination(&rth_trackback.activePoint);
 
                     fpVector3_t virtualCoursePoint;
-                    virtualCoursePoint.x = rth_trackback.pointsList[rth_trackback.activePointIndex].x + distToPrevPoint * cos_approx(DEGREES_TO_RADIANS(previousTBCourse));
-                    virtualCoursePoint.y = rth_trackback.pointsList[rth_trackback.activePointIndex].y + distToPrevPoint * sin_approx(DEGREES_TO_RADIANS(previousTBCourse));
+                    virtualCoursePoint.x = rth_trackback.activePoint.x + distToPrevPoint * cos_approx(DEGREES_TO_RADIANS(previousTBCourse));
+                    virtualCoursePoint.y = rth_trackback.activePoint.y + distToPrevPoint * sin_approx(DEGREES_TO_RADIANS(previousTBCourse));
 
                     saveTrackpoint = calculateDistanceToDestination(&virtualCoursePoint) > METERS_TO_CENTIMETERS(NAV_RTH_TRACKBACK_MIN_XY_DIST_TO_SAVE);
                 }
@@ -95,7 +237,7 @@ void rthTrackBackUpdate(bool forceSaveTrackPoint)
                 previousTBTripDist = posControl.totalTripDistance;
             } else if (!GPSCourseIsValid) {
                 // If no reliable course revert to basic distance logging based on direct distance from last point
-                saveTrackpoint = calculateDistanceToDestination(&rth_trackback.pointsList[rth_trackback.activePointIndex]) > METERS_TO_CENTIMETERS(NAV_RTH_TRACKBACK_MIN_XY_DIST_TO_SAVE);
+                saveTrackpoint = calculateDistanceToDestination(&rth_trackback.activePoint) > METERS_TO_CENTIMETERS(NAV_RTH_TRACKBACK_MIN_XY_DIST_TO_SAVE);
                 previousTBTripDist = posControl.totalTripDistance;
             }
 
@@ -105,19 +247,9 @@ void rthTrackBackUpdate(bool forceSaveTrackPoint)
             }
         }
 
-        // When trackpoint store full, overwrite from start of store using 'WrapAroundCounter' to track overwrite position
+        // When trackpoint store full, the least significant point is merged into its neighbours
         if (saveTrackpoint) {
-            if (rth_trackback.activePointIndex == (NAV_RTH_TRACKBACK_POINTS - 1)) {   // Wraparound to start
-                rth_trackback.WrapAroundCounter = rth_trackback.activePointIndex = 0;
-            } else {
-                rth_trackback.activePointIndex++;
-                if (rth_trackback.WrapAroundCounter > -1) {   // Track wraparound overwrite position after store first filled
-                    rth_trackback.WrapAroundCounter = rth_trackback.activePointIndex;
-                }
-            }
-
-            rth_trackback.pointsList[rth_trackback.activePointIndex] = posControl.actualState.abs.pos;
-            rth_trackback.lastSavedIndex = rth_trackback.activePointIndex;
+            rthTrackBackSavePoint(&posControl.actualState.abs.pos);
             previousTBAltitude = CENTIMETERS_TO_METERS(posControl.actualState.abs.pos.z);
             previousTBCourse = GPSCourseIsValid ? DECIDEGREES_TO_DEGREES(gpsSol.groundCourse) : previousTBCourse;
             distanceCounter = 0;
@@ -131,7 +263,7 @@ bool rthTrackBackSetNewPosition(void)
         return false;   // will fall back to RTH initialize allowing full RTH to handle position loss correctly
     }
 
-    const int32_t distFromStartTrackback = CENTIMETERS_TO_METERS(calculateDistanceToDestination(&rth_trackback.pointsList[rth_trackback.lastSavedIndex]));
+    const int32_t distFromStartTrackback = CENTIMETERS_TO_METERS(calculateDistanceToDestination(&rth_trackback.lastPoint));
 
 #ifdef USE_MULTI_FUNCTIONS
     const bool overrideTrackback = rthAltControlStickOverrideCheck(ROLL) || MULTI_FUNC_FLAG(MF_SUSPEND_TRACKBACK);
@@ -141,23 +273,21 @@ bool rthTrackBackSetNewPosition(void)
     const bool cancelTrackback = distFromStartTrackback > navConfig()->general.rth_trackback_distance || (overrideTrackback && !posControl.flags.forcedRTHActivated);
 
     if (rth_trackback.activePointIndex < 0 || cancelTrackback) {
-        rth_trackback.WrapAroundCounter = rth_trackback.activePointIndex = -1;
-        posControl.flags.rthTrackbackActive = false;
+        resetRthTrackBack();
         return false;    // No more trackback points to set, procede to home
     }
 
     if (isWaypointReached(&posControl.activeWaypoint.pos, &posControl.activeWaypoint.bearing)) {
-        rth_trackback.activePointIndex--;
-
-        if (rth_trackback.WrapAroundCounter > -1 && rth_trackback.activePointIndex < 0) {
-            rth_trackback.activePointIndex = NAV_RTH_TRACKBACK_POINTS - 1;
+        if (rth_trackback.activePointIndex == 0) {
+            resetRthTrackBack();
+            return false;    // Oldest trackback point reached, procede to home
         }
 
-        calculateAndSetActiveWaypointToLocalPosition(getRthTrackBackPosition());
+        // Walk the track backwards from the decoded active point
+        rthTrackBackApplyDelta(&rth_trackback.activePoint, &rth_trackback.deltaList[rth_trackback.activePointIndex - 1], -1);
+        rth_trackback.activePointIndex--;
 
-        if (rth_trackback.activePointIndex - rth_trackback.WrapAroundCounter == 0) {
-            rth_trackback.WrapAroundCounter = rth_trackback.activePointIndex = -1;
-        }
+        calculateAndSetActiveWaypointToLocalPosition(getRthTrackBackPosition());
     } else {
         setDesiredPosition(getRthTrackBackPosition(), 0, NAV_POS_UPDATE_XY | NAV_POS_UPDATE_Z | NAV_POS_UPDATE_BEARING);
     }
@@ -168,16 +298,17 @@ bool rthTrackBackSetNewPosition(void)
 fpVector3_t *getRthTrackBackPosition(void)
 {
     // Ensure trackback altitude never lower than altitude of start point
-    if (rth_trackback.pointsList[rth_trackback.activePointIndex].z < rth_trackback.pointsList[rth_trackback.lastSavedIndex].z) {
-        rth_trackback.pointsList[rth_trackback.activePointIndex].z = rth_trackback.pointsList[rth_trackback.lastSavedIndex].z;
+    trackBackTarget = rth_trackback.activePoint;
+    if (trackBackTarget.z < rth_trackback.lastPoint.z) {
+        trackBackTarget.z = rth_trackback.lastPoint.z;
     }
 
-    return &rth_trackback.pointsList[rth_trackback.activePointIndex];
+    return &trackBackTarget;
 }
 
 void resetRthTrackBack(void)
 {
     rth_trackback.activePointIndex = -1;
+    rth_trackback.pointCount = 0;
     posControl.flags.rthTrackbackActive = false;
-    rth_trackback.WrapAroundCounter = -1;
 }
\ No newline at end of file
@@ -19,18 +19,29 @@
 
 #include "common/vector.h"
 
-#define NAV_RTH_TRACKBACK_POINTS                50 // max number RTH trackback points
+#define NAV_RTH_TRACKBACK_POINTS                100 // max number RTH trackback points
 #define NAV_RTH_TRACKBACK_MIN_DIST_TO_START     50 // start recording when some distance from home (meters)
 #define NAV_RTH_TRACKBACK_MIN_XY_DIST_TO_SAVE   20 // minimum XY distance between two points to store in the buffer (meters)
 #define NAV_RTH_TRACKBACK_MIN_Z_DIST_TO_SAVE    10 // minimum Z distance between two points to store in the buffer (meters)
 #define NAV_RTH_TRACKBACK_MIN_TRIP_DIST_TO_SAVE 10 // minimum trip distance between two points to store in the buffer (meters)
 
+// Offset of a trackback point from the previous one (meters)
 typedef struct
 {
-    fpVector3_t pointsList[NAV_RTH_TRACKBACK_POINTS]; // buffer of points stored
-    int16_t lastSavedIndex;                           // last trackback point index saved
-    int16_t activePointIndex;                         // trackback points counter
-    int16_t WrapAroundCounter;                        // stores trackpoint array overwrite index position
+    int16_t x;
+    int16_t y;
+    int16_t z;
+} rth_trackback_delta_t;
+
+typedef struct
+{
+    fpVector3_t firstPoint;                                     // oldest point stored
+    fpVector3_t lastPoint;                                      // newest point stored
+    fpVector3_t activePoint;                                    // decoded point at activePointIndex
+    rth_trackback_delta_t deltaList[NAV_RTH_TRACKBACK_POINTS - 1]; // deltaList[i - 1] leads from point i - 1 to point i
+    int16_t pointCount;                                         // number of points stored
+    int16_t lastSavedIndex;                                     // last trackback point index saved
+    int16_t activePointIndex;                                   // trackback points counter
 } rth_trackback_t;
 
 extern rth_trackback_t rth_trackback;
@@ -31,6 +31,7 @@
 #include "config/parameter_group.h"
 #include "config/parameter_group_ids.h"
 #include "programming/global_variables.h"
+#include "programming/logic_condition.h"
 #include "common/maths.h"
 #include "build/build_config.h"
  
@@ -57,7 +58,11 @@ int32_t gvGet(uint8_t index) {
 
 void gvSet(uint8_t index, int32_t value) {
     if (index < MAX_GLOBAL_VARIABLES) {
-        globalVariableState[index] = constrain(value, globalVariableConfigs(index)->min, globalVariableConfigs(index)->max);
+        const int32_t newValue = constrain(value, globalVariableConfigs(index)->min, globalVariableConfigs(index)->max);
+        if (newValue != globalVariableState[index]) {
+            globalVariableState[index] = newValue;
+            logicConditionNotifyGvarChange(index);
+        }
     }
 }
 
@@ -23,6 +23,7 @@
  */
 
 #include <stdbool.h>
+#include <string.h>
 
 #include "config/config_reset.h"
 #include "config/parameter_group.h"
@@ -88,6 +89,43 @@ void pgResetFn_logicConditions(logicCondition_t *instance)
 
 logicConditionState_t logicConditionStates[MAX_LOGIC_CONDITIONS];
 
+typedef int32_t (*logicOperandFetchFn)(int32_t arg);
+
+typedef struct logicOperandProgram_s {
+    logicOperandFetchFn fetch;  // NULL when operand is a constant
+    int32_t arg;                // constant value or fetcher argument
+} logicOperandProgram_t;
+
+typedef struct logicConditionInstruction_s {
+    logicOperandProgram_t operandA;
+    logicOperandProgram_t operandB;
+    logicOperation_e operation;
+    int8_t activatorId;
+    uint8_t lcIndex;
+} logicConditionInstruction_t;
+
+// LC sets are kept as 64 bit masks
+STATIC_ASSERT(MAX_LOGIC_CONDITIONS <= 64, MAX_LOGIC_CONDITIONS_exceeds_mask_width);
+
+// State LCs share besides their values, used to keep accesses to it in index order.
+// One bit per global variable, plus one for flight, RC and navigation state
+#define LOGIC_CONDITION_STATE_GVARS     ((1U << MAX_GLOBAL_VARIABLES) - 1)
+#define LOGIC_CONDITION_STATE_SYSTEM    (1U << MAX_GLOBAL_VARIABLES)
+
+static logicConditionInstruction_t logicConditionProgram[MAX_LOGIC_CONDITIONS];
+static uint8_t logicConditionProgramLength;
+static bool logicConditionProgramValid;
+
+// Event driven evaluation state, see logicConditionProcessPending()
+static uint64_t logicConditionDirty;            // LCs with inputs changed since they were last evaluated
+static uint64_t logicConditionPolled;           // LCs with sampled inputs or side effects, evaluated on every task run
+static uint64_t logicConditionEventSafe;        // LCs that can be evaluated outside of the task
+static uint64_t logicConditionDependents[MAX_LOGIC_CONDITIONS];
+static uint64_t logicConditionRcSubscribers;
+static uint64_t logicConditionFlightModeSubscribers;
+static uint64_t logicConditionGvarSubscribers[MAX_GLOBAL_VARIABLES];
+static uint64_t logicConditionFlightModeState;
+
 static int logicConditionCompute(
     int32_t currentValue,
     logicOperation_e operation,
@@ -527,41 +565,6 @@ static int logicConditionCompute(
     }
 }
 
-void logicConditionProcess(uint8_t i) {
-
-    const int32_t activatorValue = logicConditionGetValue(logicConditions(i)->activatorId);
-
-    if (logicConditions(i)->enabled && activatorValue && !cliMode) {
-
-        /*
-         * Process condition only when latch flag is not set
-         * Latched LCs can only go from OFF to ON, not the other way
-         */
-        if (!(logicConditionStates[i].flags & LOGIC_CONDITION_FLAG_LATCH)) {
-            const int32_t operandAValue = logicConditionGetOperandValue(logicConditions(i)->operandA.type, logicConditions(i)->operandA.value);
-            const int32_t operandBValue = logicConditionGetOperandValue(logicConditions(i)->operandB.type, logicConditions(i)->operandB.value);
-            const int32_t newValue = logicConditionCompute(
-                logicConditionStates[i].value,
-                logicConditions(i)->operation,
-                operandAValue,
-                operandBValue,
-                i
-            );
-
-            logicConditionStates[i].value = newValue;
-
-            /*
-             * if value evaluates as true, put a latch on logic condition
-             */
-            if (logicConditions(i)->flags & LOGIC_CONDITION_FLAG_LATCH && newValue) {
-                logicConditionStates[i].flags |= LOGIC_CONDITION_FLAG_LATCH;
-            }
-        }
-    } else {
-        logicConditionStates[i].value = false;
-    }
-}
-
 static int logicConditionGetWaypointOperandValue(int operand) {
 
     switch (operand) {
@@ -748,15 +751,15 @@ static int logicConditionGetFlightOperandValue(int operand) {
             break;
 
         case LOGIC_CONDITION_OPERAND_FLIGHT_ATTITUDE_ROLL: // deg
-            return constrain(attitude.values.roll / 10, -180, 180);
+            return constrain(imuGetAttitude()->values.roll / 10, -180, 180);
             break;
 
         case LOGIC_CONDITION_OPERAND_FLIGHT_ATTITUDE_PITCH: // deg
-            return constrain(attitude.values.pitch / 10, -180, 180);
+            return constrain(imuGetAttitude()->values.pitch / 10, -180, 180);
             break;
 
         case LOGIC_CONDITION_OPERAND_FLIGHT_ATTITUDE_YAW: // deg
-            return constrain(attitude.values.yaw / 10, 0, 360);
+            return constrain(imuGetAttitude()->values.yaw / 10, 0, 360);
             break;
 
         case LOGIC_CONDITION_OPERAND_FLIGHT_IS_ARMED: // 0/1
@@ -970,57 +973,105 @@ static int logicConditionGetFlightModeOperandValue(int operand) {
     }
 }
 
-int32_t logicConditionGetOperandValue(logicOperandType_e type, int operand) {
-    int32_t retVal = 0;
+static int32_t logicOperandFetchRcChannel(int32_t arg) {
+    return rxGetChannelValue(arg);
+}
+
+static int32_t logicOperandFetchFlight(int32_t arg) {
+    return logicConditionGetFlightOperandValue(arg);
+}
+
+static int32_t logicOperandFetchFlightMode(int32_t arg) {
+    return logicConditionGetFlightModeOperandValue(arg);
+}
+
+static int32_t logicOperandFetchLogicCondition(int32_t arg) {
+    return logicConditionStates[arg].value;
+}
+
+static int32_t logicOperandFetchGvar(int32_t arg) {
+    return gvGet(arg);
+}
+
+static int32_t logicOperandFetchPid(int32_t arg) {
+    return programmingPidGetOutput(arg);
+}
+
+static int32_t logicOperandFetchWaypoint(int32_t arg) {
+    return logicConditionGetWaypointOperandValue(arg);
+}
+
+/*
+ * Resolve operand type and index to a fetcher once, so evaluation does not have to
+ * go through the type switch. Constants and out of range operands resolve to fetch == NULL
+ */
+static void logicConditionResolveOperand(logicOperandProgram_t *program, logicOperandType_e type, int operand) {
+    program->fetch = NULL;
+    program->arg = 0;
 
     switch (type) {
 
         case LOGIC_CONDITION_OPERAND_TYPE_VALUE:
-            retVal = operand;
+            program->arg = operand;
             break;
 
         case LOGIC_CONDITION_OPERAND_TYPE_RC_CHANNEL:
             //Extract RC channel raw value
             if (operand >= 1 && operand <= MAX_SUPPORTED_RC_CHANNEL_COUNT) {
-                retVal = rxGetChannelValue(operand - 1);
+                program->fetch = logicOperandFetchRcChannel;
+                program->arg = operand - 1;
             }
             break;
 
         case LOGIC_CONDITION_OPERAND_TYPE_FLIGHT:
-            retVal = logicConditionGetFlightOperandValue(operand);
+            program->fetch = logicOperandFetchFlight;
+            program->arg = operand;
             break;
 
         case LOGIC_CONDITION_OPERAND_TYPE_FLIGHT_MODE:
-            retVal = logicConditionGetFlightModeOperandValue(operand);
+            program->fetch = logicOperandFetchFlightMode;
+            program->arg = operand;
             break;
 
         case LOGIC_CONDITION_OPERAND_TYPE_LC:
             if (operand >= 0 && operand < MAX_LOGIC_CONDITIONS) {
-                retVal = logicConditionGetValue(operand);
+                program->fetch = logicOperandFetchLogicCondition;
+                program->arg = operand;
             }
             break;
 
         case LOGIC_CONDITION_OPERAND_TYPE_GVAR:
             if (operand >= 0 && operand < MAX_GLOBAL_VARIABLES) {
-                retVal = gvGet(operand);
+                program->fetch = logicOperandFetchGvar;
+                program->arg = operand;
             }
             break;
 
         case LOGIC_CONDITION_OPERAND_TYPE_PID:
             if (operand >= 0 && operand < MAX_PROGRAMMING_PID_COUNT) {
-                retVal = programmingPidGetOutput(operand);
+                program->fetch = logicOperandFetchPid;
+                program->arg = operand;
             }
             break;
 
         case LOGIC_CONDITION_OPERAND_TYPE_WAYPOINTS:
-            retVal = logicConditionGetWaypointOperandValue(operand);
+            program->fetch = logicOperandFetchWaypoint;
+            program->arg = operand;
             break;
 
         default:
             break;
     }
+}
+
+static inline int32_t logicConditionFetchOperand(const logicOperandProgram_t *program) {
+    return program->fetch ? program->fetch(program->arg) : program->arg;
+}
 
-    return retVal;
+int32_t logicConditionGetOperandValue(logicOperandType_e type, int operand) {
+    logicOperandProgram_t program;
+    logicConditionResolveOperand(&program, type, operand);
+    return logicConditionFetchOperand(&program);
 }
 
 /*
@@ -1034,6 +1085,391 @@ int32_t logicConditionGetValue(int8_t conditionId) {
     }
 }
 
+/*
+ * Operations without side effects or internal state, their result depends only on operands
+ */
+static bool logicConditionIsPureOperation(logicOperation_e operation) {
+    switch (operation) {
+        case LOGIC_CONDITION_TRUE:
+        case LOGIC_CONDITION_EQUAL:
+        case LOGIC_CONDITION_APPROX_EQUAL:
+        case LOGIC_CONDITION_GREATER_THAN:
+        case LOGIC_CONDITION_LOWER_THAN:
+        case LOGIC_CONDITION_LOW:
+        case LOGIC_CONDITION_MID:
+        case LOGIC_CONDITION_HIGH:
+        case LOGIC_CONDITION_AND:
+        case LOGIC_CONDITION_OR:
+        case LOGIC_CONDITION_XOR:
+        case LOGIC_CONDITION_NAND:
+        case LOGIC_CONDITION_NOR:
+        case LOGIC_CONDITION_NOT:
+        case LOGIC_CONDITION_ADD:
+        case LOGIC_CONDITION_SUB:
+        case LOGIC_CONDITION_MUL:
+        case LOGIC_CONDITION_DIV:
+        case LOGIC_CONDITION_MODULUS:
+        case LOGIC_CONDITION_SIN:
+        case LOGIC_CONDITION_COS:
+        case LOGIC_CONDITION_TAN:
+        case LOGIC_CONDITION_MIN:
+        case LOGIC_CONDITION_MAX:
+        case LOGIC_CONDITION_MAP_INPUT:
+        case LOGIC_CONDITION_MAP_OUTPUT:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/*
+ * Operations that give the same result when evaluated more than once per task run,
+ * so they can be evaluated from logicConditionProcessPending() as well
+ */
+static bool logicConditionIsEventSafeOperation(logicOperation_e operation) {
+    switch (operation) {
+        case LOGIC_CONDITION_GVAR_SET:
+        case LOGIC_CONDITION_OVERRIDE_ARMING_SAFETY:
+        case LOGIC_CONDITION_OVERRIDE_THROTTLE_SCALE:
+        case LOGIC_CONDITION_SWAP_ROLL_YAW:
+        case LOGIC_CONDITION_INVERT_ROLL:
+        case LOGIC_CONDITION_INVERT_PITCH:
+        case LOGIC_CONDITION_INVERT_YAW:
+        case LOGIC_CONDITION_OVERRIDE_THROTTLE:
+        case LOGIC_CONDITION_SET_OSD_LAYOUT:
+        case LOGIC_CONDITION_RC_CHANNEL_OVERRIDE:
+        case LOGIC_CONDITION_LOITER_OVERRIDE:
+        case LOGIC_CONDITION_FLIGHT_AXIS_ANGLE_OVERRIDE:
+        case LOGIC_CONDITION_FLIGHT_AXIS_RATE_OVERRIDE:
+            return true;
+        default:
+            return logicConditionIsPureOperation(operation);
+    }
+}
+
+static uint64_t logicConditionFlightModeSnapshot(void) {
+    // USER boxes are read from RC modes and are not part of flightModeFlags
+    const uint64_t userModes =
+        (IS_RC_MODE_ACTIVE(BOXUSER1) ? 1 : 0) | (IS_RC_MODE_ACTIVE(BOXUSER2) ? 2 : 0) |
+        (IS_RC_MODE_ACTIVE(BOXUSER3) ? 4 : 0) | (IS_RC_MODE_ACTIVE(BOXUSER4) ? 8 : 0);
+    return (userModes << 32) | flightModeFlags;
+}
+
+static void logicConditionSubscribeOperand(const logicOperandProgram_t *operand, uint64_t mask) {
+    if (operand->fetch == logicOperandFetchRcChannel) {
+        logicConditionRcSubscribers |= mask;
+    } else if (operand->fetch == logicOperandFetchFlightMode) {
+        logicConditionFlightModeSubscribers |= mask;
+    } else if (operand->fetch == logicOperandFetchGvar) {
+        logicConditionGvarSubscribers[operand->arg] |= mask;
+    } else if (operand->fetch && operand->fetch != logicOperandFetchLogicCondition) {
+        // Flight, PID and waypoint operands have no change notification and are sampled
+        logicConditionPolled |= mask;
+    }
+}
+
+static uint64_t logicConditionDependencies(const logicCondition_t *condition) {
+    uint64_t dependencies = 0;
+
+    if (condition->activatorId >= 0 && condition->activatorId < MAX_LOGIC_CONDITIONS) {
+        dependencies |= 1ULL << condition->activatorId;
+    }
+    if (condition->operandA.type == LOGIC_CONDITION_OPERAND_TYPE_LC && condition->operandA.value >= 0 && condition->operandA.value < MAX_LOGIC_CONDITIONS) {
+        dependencies |= 1ULL << condition->operandA.value;
+    }
+    if (condition->operandB.type == LOGIC_CONDITION_OPERAND_TYPE_LC && condition->operandB.value >= 0 && condition->operandB.value < MAX_LOGIC_CONDITIONS) {
+        dependencies |= 1ULL << condition->operandB.value;
+    }
+
+    return dependencies;
+}
+
+static uint16_t logicConditionOperandStateReads(const logicOperand_t *operand) {
+    switch (operand->type) {
+        case LOGIC_CONDITION_OPERAND_TYPE_GVAR:
+            return (operand->value >= 0 && operand->value < MAX_GLOBAL_VARIABLES) ? 1U << operand->value : 0;
+        case LOGIC_CONDITION_OPERAND_TYPE_RC_CHANNEL:
+        case LOGIC_CONDITION_OPERAND_TYPE_FLIGHT:
+        case LOGIC_CONDITION_OPERAND_TYPE_FLIGHT_MODE:
+        case LOGIC_CONDITION_OPERAND_TYPE_PID:
+        case LOGIC_CONDITION_OPERAND_TYPE_WAYPOINTS:
+            return LOGIC_CONDITION_STATE_SYSTEM;
+        default:
+            return 0;
+    }
+}
+
+static uint16_t logicConditionStateReads(const logicCondition_t *condition) {
+    return logicConditionOperandStateReads(&condition->operandA) | logicConditionOperandStateReads(&condition->operandB);
+}
+
+static uint16_t logicConditionStateWrites(const logicCondition_t *condition) {
+    switch (condition->operation) {
+        case LOGIC_CONDITION_GVAR_SET:
+        case LOGIC_CONDITION_GVAR_INC:
+        case LOGIC_CONDITION_GVAR_DEC:
+            if (condition->operandA.type == LOGIC_CONDITION_OPERAND_TYPE_VALUE) {
+                return (condition->operandA.value >= 0 && condition->operandA.value < MAX_GLOBAL_VARIABLES) ? 1U << condition->operandA.value : 0;
+            }
+            // Target picked at run time
+            return LOGIC_CONDITION_STATE_GVARS;
+        case LOGIC_CONDITION_STICKY:
+        case LOGIC_CONDITION_EDGE:
+        case LOGIC_CONDITION_DELAY:
+        case LOGIC_CONDITION_TIMER:
+        case LOGIC_CONDITION_DELTA:
+            // State is private to the LC
+            return 0;
+        default:
+            return logicConditionIsPureOperation(condition->operation) ? 0 : LOGIC_CONDITION_STATE_SYSTEM;
+    }
+}
+
+/*
+ * Operand referencing LC that is already known to be constant becomes a constant itself
+ */
+static void logicConditionFoldOperand(logicOperandProgram_t *operand, uint64_t constantMask) {
+    if (operand->fetch == logicOperandFetchLogicCondition && (constantMask & (1ULL << operand->arg))) {
+        operand->fetch = NULL;
+        operand->arg = logicConditionStates[operand->arg].value;
+    }
+}
+
+/*
+ * Emit LC into the program, or fold it into a constant when its inputs allow it.
+ * Returns true when LC value is constant
+ */
+static bool logicConditionCompileCondition(uint8_t i, uint64_t constantMask) {
+    const logicCondition_t *condition = logicConditions(i);
+    logicConditionInstruction_t *instruction = &logicConditionProgram[logicConditionProgramLength];
+
+    instruction->lcIndex = i;
+    instruction->operation = condition->operation;
+    instruction->activatorId = condition->activatorId;
+    logicConditionResolveOperand(&instruction->operandA, condition->operandA.type, condition->operandA.value);
+    logicConditionResolveOperand(&instruction->operandB, condition->operandB.type, condition->operandB.value);
+    logicConditionFoldOperand(&instruction->operandA, constantMask);
+    logicConditionFoldOperand(&instruction->operandB, constantMask);
+
+    if (instruction->activatorId >= 0 && instruction->activatorId < MAX_LOGIC_CONDITIONS && (constantMask & (1ULL << instruction->activatorId))) {
+        if (!logicConditionStates[instruction->activatorId].value) {
+            // Activator can never become true, LC stays off
+            logicConditionStates[i].value = false;
+            return true;
+        }
+        instruction->activatorId = -1;
+    }
+
+    if (instruction->activatorId < 0 && !instruction->operandA.fetch && !instruction->operandB.fetch && logicConditionIsPureOperation(instruction->operation)) {
+        logicConditionStates[i].value = logicConditionCompute(0, instruction->operation, instruction->operandA.arg, instruction->operandB.arg, i);
+        return true;
+    }
+
+    logicConditionProgramLength++;
+    return false;
+}
+
+/*
+ * Compile enabled LCs into a program ordered so that every LC is evaluated after
+ * the LCs it references (operands and activator), which lets chains settle in a
+ * single pass. LCs that access the same global variable or flight state, with at
+ * least one of them writing it, keep their index order, so a GVAR_SET is still seen
+ * by the LCs after it and not by the ones before it. Ties are broken by index, so
+ * independent LCs keep their configured order. LCs that are part of a reference
+ * loop keep index order after the rest.
+ */
+static void logicConditionCompileProgram(void) {
+    uint64_t dependencies[MAX_LOGIC_CONDITIONS];
+    uint16_t stateReads[MAX_LOGIC_CONDITIONS];
+    uint16_t stateWrites[MAX_LOGIC_CONDITIONS];
+    uint64_t pending = 0;
+    uint64_t constantMask = 0;
+    uint64_t loopMask = 0;
+
+    logicConditionProgramLength = 0;
+    logicConditionDirty = 0;
+    logicConditionPolled = 0;
+    logicConditionEventSafe = 0;
+    logicConditionRcSubscribers = 0;
+    logicConditionFlightModeSubscribers = 0;
+    memset(logicConditionDependents, 0, sizeof(logicConditionDependents));
+    memset(logicConditionGvarSubscribers, 0, sizeof(logicConditionGvarSubscribers));
+
+    for (uint8_t i = 0; i < MAX_LOGIC_CONDITIONS; i++) {
+        if (logicConditions(i)->enabled) {
+            pending |= 1ULL << i;
+        } else {
+            // Disabled LCs are constant false and are never evaluated
+            logicConditionStates[i].value = false;
+            constantMask |= 1ULL << i;
+        }
+    }
+
+    for (uint8_t i = 0; i < MAX_LOGIC_CONDITIONS; i++) {
+        dependencies[i] = logicConditionDependencies(logicConditions(i)) & pending;
+        if (dependencies[i] & (1ULL << i)) {
+            loopMask |= 1ULL << i;
+            dependencies[i] &= ~(1ULL << i);
+        }
+
+        stateReads[i] = 0;
+        stateWrites[i] = 0;
+        if (pending & (1ULL << i)) {
+            stateReads[i] = logicConditionStateReads(logicConditions(i));
+            stateWrites[i] = logicConditionStateWrites(logicConditions(i));
+        }
+    }
+
+    for (uint8_t j = 0; j < MAX_LOGIC_CONDITIONS; j++) {
+        for (uint8_t i = 0; i < j; i++) {
+            if ((stateWrites[i] & (stateReads[j] | stateWrites[j])) || (stateReads[i] & stateWrites[j])) {
+                dependencies[j] |= 1ULL << i;
+            }
+        }
+    }
+
+    while (pending) {
+        uint64_t ready = 0;
+        for (uint8_t i = 0; i < MAX_LOGIC_CONDITIONS; i++) {
+            if ((pending & (1ULL << i)) && !(dependencies[i] & pending)) {
+                ready = 1ULL << i;
+                break;
+            }
+        }
+
+        if (!ready) {
+            // Only reference loops and LCs depending on them are left, evaluate them in index order
+            loopMask |= pending;
+            ready = pending & -pending;
+        }
+
+        const uint8_t i = __builtin_ctzll(ready);
+        pending &= ~ready;
+        if (logicConditionCompileCondition(i, constantMask)) {
+            constantMask |= ready;
+        }
+    }
+
+    for (uint8_t k = 0; k < logicConditionProgramLength; k++) {
+        const logicConditionInstruction_t *instruction = &logicConditionProgram[k];
+        const uint64_t mask = 1ULL << instruction->lcIndex;
+
+        // Only LC references propagate value changes, global variable changes reach
+        // readers through logicConditionNotifyGvarChange()
+        const uint64_t references = logicConditionDependencies(logicConditions(instruction->lcIndex)) & ~(constantMask | mask);
+        for (uint64_t deps = references; deps; deps &= deps - 1) {
+            logicConditionDependents[__builtin_ctzll(deps)] |= mask;
+        }
+
+        logicConditionSubscribeOperand(&instruction->operandA, mask);
+        logicConditionSubscribeOperand(&instruction->operandB, mask);
+
+        if (!logicConditionIsPureOperation(instruction->operation) || (loopMask & mask)) {
+            // Side effects have to be reapplied after global flags are cleared on every run,
+            // LCs in reference loops (counters etc.) advance once per run
+            logicConditionPolled |= mask;
+        }
+        if (logicConditionIsEventSafeOperation(instruction->operation) && !(loopMask & mask)) {
+            logicConditionEventSafe |= mask;
+        }
+        logicConditionDirty |= mask;
+    }
+
+    logicConditionFlightModeState = logicConditionFlightModeSnapshot();
+    logicConditionProgramValid = true;
+}
+
+void logicConditionInvalidateProgram(void) {
+    logicConditionProgramValid = false;
+}
+
+void logicConditionNotifyRxFrame(void) {
+    logicConditionDirty |= logicConditionRcSubscribers;
+}
+
+void logicConditionNotifyGvarChange(uint8_t index) {
+    if (index < MAX_GLOBAL_VARIABLES) {
+        logicConditionDirty |= logicConditionGvarSubscribers[index];
+    }
+}
+
+static void logicConditionCheckFlightModes(void) {
+    const uint64_t state = logicConditionFlightModeSnapshot();
+    if (state != logicConditionFlightModeState) {
+        logicConditionFlightModeState = state;
+        logicConditionDirty |= logicConditionFlightModeSubscribers;
+    }
+}
+
+/*
+ * Run LCs that are dirty or listed in always, limited to allowed. Program order
+ * guarantees that dependents marked dirty by a value change are visited in the same pass
+ */
+static void logicConditionRunProgram(uint64_t always, uint64_t allowed) {
+    for (uint8_t k = 0; k < logicConditionProgramLength; k++) {
+        const logicConditionInstruction_t *instruction = &logicConditionProgram[k];
+        const uint8_t i = instruction->lcIndex;
+        const uint64_t mask = 1ULL << i;
+
+        if (!((logicConditionDirty | always) & allowed & mask)) {
+            continue;
+        }
+        logicConditionDirty &= ~mask;
+
+        const int32_t previousValue = logicConditionStates[i].value;
+
+        if (!logicConditionGetValue(instruction->activatorId)) {
+            logicConditionStates[i].value = false;
+        } else if (!(logicConditionStates[i].flags & LOGIC_CONDITION_FLAG_LATCH)) {
+            /*
+             * Process condition only when latch flag is not set
+             * Latched LCs can only go from OFF to ON, not the other way
+             */
+            const int32_t newValue = logicConditionCompute(
+                logicConditionStates[i].value,
+                instruction->operation,
+                logicConditionFetchOperand(&instruction->operandA),
+                logicConditionFetchOperand(&instruction->operandB),
+                i
+            );
+
+            logicConditionStates[i].value = newValue;
+
+            /*
+             * if value evaluates as true, put a latch on logic condition
+             */
+            if (logicConditions(i)->flags & LOGIC_CONDITION_FLAG_LATCH && newValue) {
+                logicConditionStates[i].flags |= LOGIC_CONDITION_FLAG_LATCH;
+            }
+        }
+
+        if (logicConditionStates[i].value != previousValue) {
+            logicConditionDirty |= logicConditionDependents[i];
+        }
+    }
+}
+
+/*
+ * Low latency hook, called after RX and flight mode processing. Evaluates only LCs
+ * whose inputs changed since the last run, and only those that are safe to evaluate
+ * between task runs. Everything else is picked up by logicConditionUpdateTask()
+ */
+void logicConditionProcessPending(void) {
+    if (cliMode) {
+        return;
+    }
+
+    if (!logicConditionProgramValid) {
+        logicConditionCompileProgram();
+    }
+
+    logicConditionCheckFlightModes();
+
+    if (logicConditionDirty & logicConditionEventSafe) {
+        logicConditionRunProgram(0, logicConditionEventSafe);
+    }
+}
+
 void logicConditionUpdateTask(timeUs_t currentTimeUs) {
     UNUSED(currentTimeUs);
 
@@ -1049,10 +1485,24 @@ void logicConditionUpdateTask(timeUs_t currentTimeUs) {
         flightAxisOverride[i].angleTargetActive = false;
     }
 
-    for (uint8_t i = 0; i < MAX_LOGIC_CONDITIONS; i++) {
-        logicConditionProcess(i);
+    if (cliMode) {
+        // All LCs are off while in CLI, program is rebuilt when leaving it
+        for (uint8_t i = 0; i < MAX_LOGIC_CONDITIONS; i++) {
+            logicConditionStates[i].value = false;
+        }
+        logicConditionProgramValid = false;
+        return;
     }
 
+    if (!logicConditionProgramValid) {
+        logicConditionCompileProgram();
+    }
+
+    logicConditionCheckFlightModes();
+
+    // LCs with only event driven inputs keep their value until one of the inputs changes
+    logicConditionRunProgram(logicConditionPolled, UINT64_MAX);
+
 #ifdef USE_I2C_IO_EXPANDER
     ioPortExpanderSync();
 #endif
@@ -1065,6 +1515,8 @@ void logicConditionReset(void) {
         logicConditionStates[i].flags = 0;
         logicConditionStates[i].timeout = 0;
     }
+    // Folded constants live in LC state, have them recomputed
+    logicConditionProgramValid = false;
 }
 
 float NOINLINE getThrottleScale(float globalThrottleScale) {
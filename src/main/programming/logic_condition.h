@@ -250,13 +250,15 @@ extern uint64_t logicConditionsGlobalFlags;
 #define LOGIC_CONDITION_GLOBAL_FLAG_ENABLE(mask) (logicConditionsGlobalFlags |= (mask))
 #define LOGIC_CONDITION_GLOBAL_FLAG(mask) (logicConditionsGlobalFlags & (mask))
 
-void logicConditionProcess(uint8_t i);
-
 int32_t logicConditionGetOperandValue(logicOperandType_e type, int operand);
 
 int32_t logicConditionGetValue(int8_t conditionId);
 void logicConditionUpdateTask(timeUs_t currentTimeUs);
 void logicConditionReset(void);
+void logicConditionInvalidateProgram(void);
+void logicConditionProcessPending(void);
+void logicConditionNotifyRxFrame(void);
+void logicConditionNotifyGvarChange(uint8_t index);
 
 float getThrottleScale(float globalThrottleScale);
 int16_t getRcCommandOverride(int16_t command[], uint8_t axis);
@@ -43,6 +43,7 @@
 #include "telemetry/crsf.h"
 #define CRSF_TIME_NEEDED_PER_FRAME_US   1100 // 700 ms + 400 ms for potential ad-hoc request
 #define CRSF_TIME_BETWEEN_FRAMES_US     6667 // At fastest, frames are sent by the transmitter every 6.667 milliseconds, 150 Hz
+#define CRSF_TIME_PER_BYTE_US           22   // 21.43us per byte at 420000 baud
 
 #define CRSF_DIGITAL_CHANNEL_MIN 172
 #define CRSF_DIGITAL_CHANNEL_MAX 1811
@@ -56,6 +57,7 @@ STATIC_UNIT_TESTED uint32_t crsfChannelData[CRSF_MAX_CHANNEL];
 
 static serialPort_t *serialPort;
 static timeUs_t crsfFrameStartAt = 0;
+static uint8_t crsfFramePosition = 0;
 static uint8_t telemetryBuf[CRSF_FRAME_SIZE_MAX];
 static uint8_t telemetryBufLen = 0;
 
@@ -128,21 +130,39 @@ typedef struct crsfPayloadLinkStatistics_s crsfPayloadLinkStatistics_t;
 STATIC_UNIT_TESTED uint8_t crsfFrameCRC(void)
 {
     // CRC includes type and payload
-    uint8_t crc = crc8_dvb_s2(0, crsfFrame.frame.type);
-    for (int ii = 0; ii < crsfFrame.frame.frameLength - CRSF_FRAME_LENGTH_TYPE_CRC; ++ii) {
-        crc = crc8_dvb_s2(crc, crsfFrame.frame.payload[ii]);
-    }
-    return crc;
+    const uint8_t crc = crc8_dvb_s2(0, crsfFrame.frame.type);
+    const int payloadLength = crsfFrame.frame.frameLength - CRSF_FRAME_LENGTH_TYPE_CRC;
+    return payloadLength > 0 ? crc8_dvb_s2_update(crc, crsfFrame.frame.payload, payloadLength) : crc;
 }
 
-// Receive ISR callback, called back from serial port
-STATIC_UNIT_TESTED void crsfDataReceive(uint16_t c, void *rxCallbackData)
+static void crsfFrameReceived(int fullFrameLength)
 {
-    UNUSED(rxCallbackData);
-
-    static uint8_t crsfFramePosition = 0;
-    const timeUs_t now = micros();
+    if (crsfFrame.frame.type == CRSF_FRAMETYPE_RC_CHANNELS_PACKED) {
+        rxFrameArrived();
+    } else {
+        const uint8_t crc = crsfFrameCRC();
+        if (crc == crsfFrame.bytes[fullFrameLength - 1]) {
+            switch (crsfFrame.frame.type)
+            {
+#if defined(USE_MSP_OVER_TELEMETRY)
+                case CRSF_FRAMETYPE_MSP_REQ:
+                case CRSF_FRAMETYPE_MSP_WRITE: {
+                    uint8_t *frameStart = (uint8_t *)&crsfFrame.frame.payload + CRSF_FRAME_ORIGIN_DEST_SIZE;
+                    if (bufferCrsfMspFrame(frameStart, CRSF_FRAME_RX_MSP_FRAME_SIZE)) {
+                        crsfScheduleMspResponse();
+                    }
+                    break;
+                }
+#endif
+                default:
+                    break;
+            }
+        }
+    }
+}
 
+static void crsfReceiveByte(uint8_t c, timeUs_t now)
+{
 #ifdef DEBUG_CRSF_PACKETS
     debug[2] = now - crsfFrameStartAt;
 #endif
@@ -161,34 +181,47 @@ STATIC_UNIT_TESTED void crsfDataReceive(uint16_t c, void *rxCallbackData)
     const int fullFrameLength = crsfFramePosition < 3 ? 5 : crsfFrame.frame.frameLength + CRSF_FRAME_LENGTH_ADDRESS + CRSF_FRAME_LENGTH_FRAMELENGTH;
 
     if (crsfFramePosition < fullFrameLength) {
-        crsfFrame.bytes[crsfFramePosition++] = (uint8_t)c;
+        crsfFrame.bytes[crsfFramePosition++] = c;
         crsfFrameDone = crsfFramePosition < fullFrameLength ? false : true;
         if (crsfFrameDone) {
             crsfFramePosition = 0;
-            if (crsfFrame.frame.type != CRSF_FRAMETYPE_RC_CHANNELS_PACKED) {
-                const uint8_t crc = crsfFrameCRC();
-                if (crc == crsfFrame.bytes[fullFrameLength - 1]) {
-                    switch (crsfFrame.frame.type)
-                    {
-#if defined(USE_MSP_OVER_TELEMETRY)
-                        case CRSF_FRAMETYPE_MSP_REQ:
-                        case CRSF_FRAMETYPE_MSP_WRITE: {
-                            uint8_t *frameStart = (uint8_t *)&crsfFrame.frame.payload + CRSF_FRAME_ORIGIN_DEST_SIZE;
-                            if (bufferCrsfMspFrame(frameStart, CRSF_FRAME_RX_MSP_FRAME_SIZE)) {
-                                crsfScheduleMspResponse();
-                            }
-                            break;
-                        }
-#endif
-                        default:
-                            break;
-                    }
-                }
-            }
+            crsfFrameReceived(fullFrameLength);
         }
     }
 }
 
+// Receive ISR callback, called back from serial port
+STATIC_UNIT_TESTED void crsfDataReceive(uint16_t c, void *rxCallbackData)
+{
+    UNUSED(rxCallbackData);
+
+    crsfReceiveByte((uint8_t)c, micros());
+}
+
+// Receive ISR callback for ports delivering whole bursts ended by line idle
+STATIC_UNIT_TESTED void crsfDataReceiveFrame(const uint8_t *data, uint16_t length, void *rxCallbackData)
+{
+    UNUSED(rxCallbackData);
+
+    // The burst started roughly one transfer time ago, keep the telemetry timing window anchored there
+    const timeUs_t now = micros() - length * CRSF_TIME_PER_BYTE_US;
+
+    // Common case, exactly one complete frame: validate and decode in one go
+    if (crsfFramePosition == 0 && length >= CRSF_FRAME_LENGTH_ADDRESS + CRSF_FRAME_LENGTH_FRAMELENGTH + CRSF_FRAME_LENGTH_TYPE_CRC &&
+        data[1] + CRSF_FRAME_LENGTH_ADDRESS + CRSF_FRAME_LENGTH_FRAMELENGTH == length && length <= CRSF_FRAME_SIZE_MAX) {
+        crsfFrameStartAt = now;
+        memcpy(crsfFrame.bytes, data, length);
+        crsfFrameDone = true;
+        crsfFrameReceived(length);
+        return;
+    }
+
+    // Anything else (several frames per burst, split frames) goes through the byte state machine
+    for (unsigned i = 0; i < length; i++) {
+        crsfReceiveByte(data[i], now);
+    }
+}
+
 STATIC_UNIT_TESTED uint8_t crsfFrameStatus(rxRuntimeConfig_t *rxRuntimeConfig)
 {
     UNUSED(rxRuntimeConfig);
@@ -282,6 +315,11 @@ void crsfRxWriteTelemetryData(const void *data, int len)
     telemetryBufLen = len;
 }
 
+bool crsfRxIsTelemetryBufEmpty(void)
+{
+    return telemetryBufLen == 0;
+}
+
 void crsfRxSendTelemetryData(void)
 {
     // if there is telemetry data to write
@@ -324,6 +362,11 @@ bool crsfRxInit(const rxConfig_t *rxConfig, rxRuntimeConfig_t *rxRuntimeConfig)
         CRSF_PORT_OPTIONS | (tristateWithDefaultOffIsActive(rxConfig->halfDuplex) ? SERIAL_BIDIR : 0)
         );
 
+    if (serialPort) {
+        // Prefer frame level delivery, falls back to per byte callback if the port can't detect line idle
+        serialSetRxFrameCallback(serialPort, crsfDataReceiveFrame);
+    }
+
     return serialPort != NULL;
 }
 
@@ -130,11 +130,9 @@ void ghstRxSendTelemetryData(void)
 STATIC_UNIT_TESTED uint8_t ghstFrameCRC(ghstFrame_t *pGhstFrame)
 {
     // CRC includes type and payload
-    uint8_t crc = crc8_dvb_s2(0, pGhstFrame->frame.type);
-    for (int i = 0; i < pGhstFrame->frame.len - GHST_FRAME_LENGTH_TYPE_CRC - 1; ++i) {
-        crc = crc8_dvb_s2(crc, pGhstFrame->frame.payload[i]);
-    }
-    return crc;
+    const uint8_t crc = crc8_dvb_s2(0, pGhstFrame->frame.type);
+    const int payloadLength = pGhstFrame->frame.len - GHST_FRAME_LENGTH_TYPE_CRC - 1;
+    return payloadLength > 0 ? crc8_dvb_s2_update(crc, pGhstFrame->frame.payload, payloadLength) : crc;
 }
 
 // Receive ISR callback, called back from serial port
@@ -168,6 +166,7 @@ STATIC_UNIT_TESTED void ghstDataReceive(uint16_t c, void *data)
             // handled in ghstFrameStatus
             memcpy(&ghstValidatedFrame, &ghstIncomingFrame, sizeof(ghstIncomingFrame));
             ghstFrameAvailable = true;
+            rxFrameArrived();
 
             // remember what time the incoming (Rx) packet ended, so that we can ensure a quite bus before sending telemetry
             ghstRxFrameEndAtUs = microsISR();
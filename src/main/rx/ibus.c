@@ -119,6 +119,7 @@ static void ibusDataReceive(uint16_t c, void *rxCallbackData)
 
     if (ibusFramePosition == ibusFrameSize - 1) {
         ibusFrameDone = true;
+        rxFrameArrived();
     } else {
         ibusFramePosition++;
     }
@@ -31,6 +31,8 @@
 
 #include "programming/logic_condition.h"
 
+#include "scheduler/scheduler.h"
+
 #include "config/feature.h"
 #include "config/parameter_group.h"
 #include "config/parameter_group_ids.h"
@@ -94,11 +96,19 @@ static bool isRxSuspended = false;
 
 static rcChannel_t rcChannels[MAX_SUPPORTED_RC_CHANNEL_COUNT];
 
+#define RX_LATENCY_MOVING_SUM_COUNT 16
+#define RX_LATENCY_MAX_DECAY        256     // Peak loses 1/256 (at least 1us) per frame, a single spike fades within a few seconds
+
+static volatile timeUs_t rxFrameArrivedAtUs = 0;    // Written from receiver ISRs
+static timeUs_t rxFrameCompletedArrivalUs = 0;      // Arrival of the frame picked up by rxUpdateCheck
+static timeDelta_t rxFrameLatencyMovingSum = 0;
+static rxFrameLatency_t rxFrameLatency;
+
 rxLinkStatistics_t rxLinkStatistics;
 rxRuntimeConfig_t rxRuntimeConfig;
 static uint8_t rcSampleIndex = 0;
 
-PG_REGISTER_WITH_RESET_TEMPLATE(rxConfig_t, rxConfig, PG_RX_CONFIG, 12);
+PG_REGISTER_WITH_RESET_TEMPLATE(rxConfig_t, rxConfig, PG_RX_CONFIG, 13);
 
 #ifndef SERIALRX_PROVIDER
 #define SERIALRX_PROVIDER 0
@@ -133,6 +143,9 @@ PG_RESET_TEMPLATE(rxConfig_t, rxConfig,
     .mspOverrideChannels = SETTING_MSP_OVERRIDE_CHANNELS_DEFAULT,
 #endif
     .rssi_source = SETTING_RSSI_SOURCE_DEFAULT,
+#ifdef USE_SERIAL_RX
+    .frameTrigger = SETTING_RX_FRAME_TRIGGER_DEFAULT,
+#endif
 #ifdef USE_SERIALRX_SRXL2
     .srxl2_unit_id = SETTING_SRXL2_UNIT_ID_DEFAULT,
     .srxl2_baud_fast = SETTING_SRXL2_BAUD_FAST_DEFAULT,
@@ -413,6 +426,13 @@ bool rxUpdateCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTime)
         rxSignalReceived = (frameStatus & RX_FRAME_FAILSAFE) == 0;
         needRxSignalBefore = currentTimeUs + rxRuntimeConfig.rxSignalTimeout;
         rxDataProcessingRequired = true;
+
+        // Zero if the receiver driver doesn't report frame arrival
+        rxFrameCompletedArrivalUs = rxFrameArrivedAtUs;
+        rxFrameArrivedAtUs = 0;
+        if (rxFrameCompletedArrivalUs) {
+            DEBUG_SET(DEBUG_RX_LATENCY, 1, cmpTimeUs(currentTimeUs, rxFrameCompletedArrivalUs));
+        }
     }
     else if ((frameStatus & RX_FRAME_FAILSAFE) && rxSignalReceived) {
         // All other receiver statuses are allowed to report failsafe, but not allowed to leave it
@@ -519,6 +539,8 @@ bool calculateRxChannelsAndUpdateFailsafe(timeUs_t currentTimeUs)
         failsafeOnValidDataFailed();
     }
 
+    logicConditionNotifyRxFrame();
+
     rcSampleIndex++;
     return true;
 }
@@ -699,3 +721,38 @@ uint16_t lqTrackerGet(rxLinkQualityTracker_e * lqTracker)
 
     return lqTracker->lqValue;
 }
+
+// Called from receiver ISRs when a complete RC frame has been received
+void rxFrameArrived(void)
+{
+    rxFrameArrivedAtUs = micros();
+
+    if (rxConfig()->frameTrigger) {
+        schedulerSignalTask(TASK_RX);
+    }
+}
+
+// Called by the PID loop when it first uses new RC data
+void rxFrameConsumed(timeUs_t currentTimeUs)
+{
+    if (!rxFrameCompletedArrivalUs) {
+        return;
+    }
+
+    const timeDelta_t latencyUs = cmpTimeUs(currentTimeUs, rxFrameCompletedArrivalUs);
+    rxFrameCompletedArrivalUs = 0;
+
+    rxFrameLatencyMovingSum += latencyUs - rxFrameLatencyMovingSum / RX_LATENCY_MOVING_SUM_COUNT;
+    rxFrameLatency.lastUs = latencyUs;
+    rxFrameLatency.averageUs = rxFrameLatencyMovingSum / RX_LATENCY_MOVING_SUM_COUNT;
+    rxFrameLatency.maxUs = MAX(rxFrameLatency.maxUs - MAX(rxFrameLatency.maxUs / RX_LATENCY_MAX_DECAY, 1), latencyUs);
+
+    DEBUG_SET(DEBUG_RX_LATENCY, 0, latencyUs);
+    DEBUG_SET(DEBUG_RX_LATENCY, 2, rxFrameLatency.averageUs);
+    DEBUG_SET(DEBUG_RX_LATENCY, 3, rxFrameLatency.maxUs);
+}
+
+const rxFrameLatency_t *rxGetFrameLatency(void)
+{
+    return &rxFrameLatency;
+}
@@ -128,6 +128,7 @@ typedef struct rxConfig_s {
     uint8_t autoSmoothFactor;               // auto smooth rx input factor (1 = no smoothing, 100 = lots of smoothing)
     uint16_t mspOverrideChannels;           // Channels to override with MSP RC when BOXMSPRCOVERRIDE is active
     uint8_t rssi_source;
+    uint8_t frameTrigger;                   // Signal the scheduler from the receiver ISR when a frame completes
 #ifdef USE_SERIALRX_SRXL2
     uint8_t srxl2_unit_id;
     uint8_t srxl2_baud_fast;
@@ -193,6 +194,12 @@ typedef struct rxLinkStatistics_s {
     char        mode[6];
 } rxLinkStatistics_t;
 
+typedef struct rxFrameLatency_s {
+    timeDelta_t lastUs;                 // Frame arrival to the first PID iteration using its data
+    timeDelta_t averageUs;
+    timeDelta_t maxUs;                  // Peak hold, decays so old spikes don't stick
+} rxFrameLatency_t;
+
 typedef uint16_t (*rcReadRawDataFnPtr)(const rxRuntimeConfig_t *rxRuntimeConfig, uint8_t chan); // used by receiver driver to return channel data
 typedef uint8_t (*rcFrameStatusFnPtr)(rxRuntimeConfig_t *rxRuntimeConfig);
 typedef bool (*rcProcessFrameFnPtr)(const rxRuntimeConfig_t *rxRuntimeConfig);
@@ -228,6 +235,10 @@ void resetAllRxChannelRangeConfigurations(void);
 void suspendRxSignal(void);
 void resumeRxSignal(void);
 
+void rxFrameArrived(void);
+void rxFrameConsumed(timeUs_t currentTimeUs);
+const rxFrameLatency_t *rxGetFrameLatency(void);
+
 // Processed RC channel value. These values might include
 // filtering and some extra processing like value holding
 // during failsafe.
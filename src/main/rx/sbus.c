@@ -149,6 +149,7 @@ static void sbusDataReceive(uint16_t c, void *data)
 
                     memcpy((void *)&sbusFrameData->frame, (void *)&sbusFrameData->buffer[0], SBUS_FRAME_SIZE);
                     sbusFrameData->frameDone = true;
+                    rxFrameArrived();
                 }
             }
             break;
@@ -183,6 +184,7 @@ static void sbusDataReceive(uint16_t c, void *data)
                     memcpy((void *)&sbusFrameData->frameHigh, (void *)&sbusFrameData->buffer[0], SBUS_FRAME_SIZE);
                     sbusFrameData->frameDone = true;
                     sbusFrameData->is26channels = true;
+                    rxFrameArrived();
                 }
             }
             break;
@@ -103,6 +103,7 @@ static void sumdDataReceive(uint16_t c, void *rxCallbackData)
         if (sumdIndex == sumdChannelCount * 2 + 5) {
             sumdIndex = 0;
             sumdFrameDone = true;
+            rxFrameArrived();
         }
 }
 
@@ -199,6 +199,14 @@ void schedulerResetTaskStatistics(cfTaskId_e taskId)
     }
 }
 
+// Safe to call from interrupt context
+void schedulerSignalTask(cfTaskId_e taskId)
+{
+    if (taskId < TASK_COUNT && cfTasks[taskId].checkFunc) {
+        cfTasks[taskId].eventPending = true;
+    }
+}
+
 void schedulerInit(void)
 {
     queueClear();
@@ -239,6 +247,12 @@ void FAST_CODE NOINLINE scheduler(void)
                 waitingTasks++;
             } else {
                 task->taskAgeCycles = 0;
+                task->eventPending = false;
+            }
+
+            // Signalled tasks only yield to overdue realtime tasks
+            if (task->eventPending && task->dynamicPriority > 0) {
+                task->dynamicPriority = UINT16_MAX;
             }
         } else if (task->staticPriority == TASK_PRIORITY_REALTIME) {
             //realtime tasks take absolute priority. Any RT tasks that is overdue, should be execute immediately
@@ -274,6 +288,7 @@ void FAST_CODE NOINLINE scheduler(void)
         selectedTask->taskLatestDeltaTime = (timeDelta_t)(currentTimeUs - selectedTask->lastExecutedAt);
         selectedTask->lastExecutedAt = currentTimeUs;
         selectedTask->dynamicPriority = 0;
+        selectedTask->eventPending = false;
 
         // Execute task
         const timeUs_t currentTimeBeforeTaskCall = micros();
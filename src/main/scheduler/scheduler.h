@@ -162,6 +162,7 @@ typedef struct {
     uint16_t taskAgeCycles;
     timeUs_t lastExecutedAt;        // last time of invocation
     timeUs_t lastSignaledAt;        // time of invocation event for event-driven tasks
+    volatile bool eventPending;     // event-driven task signalled from an interrupt, runs ahead of other tasks
     timeDelta_t taskLatestDeltaTime;
 
     /* Statistics */
@@ -179,6 +180,7 @@ void rescheduleTask(cfTaskId_e taskId, timeDelta_t newPeriodUs);
 void setTaskEnabled(cfTaskId_e taskId, bool newEnabledState);
 timeDelta_t getTaskDeltaTime(cfTaskId_e taskId);
 void schedulerResetTaskStatistics(cfTaskId_e taskId);
+void schedulerSignalTask(cfTaskId_e taskId);
 
 void schedulerInit(void);
 void scheduler(void);
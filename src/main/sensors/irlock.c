@@ -111,8 +111,8 @@ bool irlockGetPosition(float *distX, float *distY)
 
     // compensate for altitude and attitude
     float altitude = CENTIMETERS_TO_METERS(getEstimatedActualPosition(Z));
-    *distX = altitude * tan_approx(atan2_approx(uDistX, 1.0f) - DECIDEGREES_TO_RADIANS(attitude.values.roll));
-    *distY = altitude * tan_approx(atan2_approx(uDistY, 1.0f) + DECIDEGREES_TO_RADIANS(attitude.values.pitch));
+    *distX = altitude * tan_approx(atan2_approx(uDistX, 1.0f) - DECIDEGREES_TO_RADIANS(imuGetAttitude()->values.roll));
+    *distY = altitude * tan_approx(atan2_approx(uDistY, 1.0f) + DECIDEGREES_TO_RADIANS(imuGetAttitude()->values.pitch));
 
     return true;
 }
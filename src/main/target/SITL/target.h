@@ -83,6 +83,7 @@
 #define USE_GEOZONE
 #define MAX_GEOZONES_IN_CONFIG 63
 #define MAX_VERTICES_IN_CONFIG 126
+#define MAX_ADSB_VEHICLES 16
 
 #undef USE_GYRO_KALMAN // Strange behaviour under x86/x64 ?!?
 #undef USE_VCP
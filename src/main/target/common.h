@@ -186,8 +186,11 @@
 //ADSB RECEIVER
 #ifdef USE_GPS
 #define USE_ADSB
-#define MAX_ADSB_VEHICLES               5
 #define ADSB_LIMIT_CM                   6400000
+#if defined(STM32H7)
+// Longer traffic list where RAM allows, see common_post.h for the default
+#define MAX_ADSB_VEHICLES               16
+#endif
 #endif
 
 #define USE_SERIAL_GIMBAL
@@ -198,10 +201,13 @@
 #if defined(STM32F7) || defined(STM32H7)
 // needs bi-direction inverter, not available on F4 hardware.
 #define USE_TELEMETRY_SBUS2
+// CRC unit with programmable polynomial, F4 and AT32 only do fixed CRC-32
+#define USE_CRC_HW
 #endif
 
 //Designed to free space of F722 and F411 MCUs
 #if (MCU_FLASH_SIZE > 512)
+#define USE_CRC_SLICE_BY_4
 #define USE_VTX_FFPV
 #define USE_SERIALRX_SUMD
 #define USE_TELEMETRY_HOTT
@@ -30,6 +30,10 @@ extern uint8_t __config_end;
 #endif
 
 
+#if defined(USE_ADSB) && !defined(MAX_ADSB_VEHICLES)
+#define MAX_ADSB_VEHICLES 5
+#endif
+
 // Make sure DEFAULT_I2C_BUS is valid
 #ifndef DEFAULT_I2C_BUS
 
@@ -61,6 +61,7 @@
 #include "telemetry/crsf.h"
 #include "telemetry/telemetry.h"
 #include "telemetry/msp_shared.h"
+#include "telemetry/telemetry_scheduler.h"
 
 
 #define CRSF_CYCLETIME_US                   100000  // 100ms, 10 Hz
@@ -105,27 +106,24 @@ bool bufferCrsfMspFrame(uint8_t *frameStart, int frameLength)
     }
 }
 
-bool handleCrsfMspFrameBuffer(uint8_t payloadSize, mspResponseFnPtr responseFn)
+// Replies are sent from handleCrsfTelemetry() as downlink slots become free
+static void processCrsfMspFrameBuffer(void)
 {
-    bool requestHandled = false;
     if (!mspRxBuffer.len) {
-        return false;
+        return;
     }
     int pos = 0;
     while (true) {
         const int mspFrameLength = mspRxBuffer.bytes[pos];
-        if (handleMspFrame(&mspRxBuffer.bytes[CRSF_MSP_LENGTH_OFFSET + pos], mspFrameLength)) {
-            requestHandled |= sendMspReply(payloadSize, responseFn);
-        }
+        handleMspFrame(&mspRxBuffer.bytes[CRSF_MSP_LENGTH_OFFSET + pos], mspFrameLength);
         pos += CRSF_MSP_LENGTH_OFFSET + mspFrameLength;
         ATOMIC_BLOCK(NVIC_PRIO_SERIALUART) {
             if (pos >= mspRxBuffer.len) {
                 mspRxBuffer.len = 0;
-                return requestHandled;
+                return;
             }
         }
     }
-    return requestHandled;
 }
 #endif
 
@@ -210,13 +208,14 @@ static void crsfFrameGps(sbuf_t *dst)
     // use sbufWrite since CRC does not include frame length
     sbufWriteU8(dst, CRSF_FRAME_GPS_PAYLOAD_SIZE + CRSF_FRAME_LENGTH_TYPE_CRC);
     crsfSerialize8(dst, CRSF_FRAMETYPE_GPS);
-    crsfSerialize32(dst, gpsSol.llh.lat); // CRSF and betaflight use same units for degrees
-    crsfSerialize32(dst, gpsSol.llh.lon);
-    crsfSerialize16(dst, (gpsSol.groundSpeed * 36 + 50) / 100); // gpsSol.groundSpeed is in cm/s
-    crsfSerialize16(dst, DECIDEGREES_TO_CENTIDEGREES(gpsSol.groundCourse)); // gpsSol.groundCourse is 0.1 degrees, need 0.01 deg
-    const uint16_t altitude = (getEstimatedActualPosition(Z) / 100) + 1000;
+    const telemetryGps_t *gps = telemetryGetGps();
+    crsfSerialize32(dst, gps->lat); // CRSF and betaflight use same units for degrees
+    crsfSerialize32(dst, gps->lon);
+    crsfSerialize16(dst, (gps->groundSpeed * 36 + 50) / 100); // groundSpeed is in cm/s
+    crsfSerialize16(dst, DECIDEGREES_TO_CENTIDEGREES(gps->groundCourse)); // groundCourse is 0.1 degrees, need 0.01 deg
+    const uint16_t altitude = (telemetryGetAltitude()->altitude / 100) + 1000;
     crsfSerialize16(dst, altitude);
-    crsfSerialize8(dst, gpsSol.numSat);
+    crsfSerialize8(dst, gps->numSat);
 }
 
 /*
@@ -229,7 +228,7 @@ static void crsfFrameVarioSensor(sbuf_t *dst)
     // use sbufWrite since CRC does not include frame length
     sbufWriteU8(dst, CRSF_FRAME_VARIO_SENSOR_PAYLOAD_SIZE + CRSF_FRAME_LENGTH_TYPE_CRC);
     crsfSerialize8(dst, CRSF_FRAMETYPE_VARIO_SENSOR);
-    crsfSerialize16(dst, lrintf(getEstimatedActualVelocity(Z)));
+    crsfSerialize16(dst, telemetryGetAltitude()->vario);
 }
 
 /*
@@ -245,17 +244,17 @@ static void crsfFrameBatterySensor(sbuf_t *dst)
     // use sbufWrite since CRC does not include frame length
     sbufWriteU8(dst, CRSF_FRAME_BATTERY_SENSOR_PAYLOAD_SIZE + CRSF_FRAME_LENGTH_TYPE_CRC);
     crsfSerialize8(dst, CRSF_FRAMETYPE_BATTERY_SENSOR);
+    const telemetryBattery_t *battery = telemetryGetBattery();
     if (telemetryConfig()->report_cell_voltage) {
-        crsfSerialize16(dst, getBatteryAverageCellVoltage() / 10);
+        crsfSerialize16(dst, battery->cellVoltage / 10);
     } else {
-        crsfSerialize16(dst, getBatteryVoltage() / 10); // vbat is in units of 0.01V
+        crsfSerialize16(dst, battery->voltage / 10); // vbat is in units of 0.01V
     }
-    crsfSerialize16(dst, getAmperage() / 10);
-    const uint8_t batteryRemainingPercentage = calculateBatteryPercentage();
-    crsfSerialize8(dst, (getMAhDrawn() >> 16));
-    crsfSerialize8(dst, (getMAhDrawn() >> 8));
-    crsfSerialize8(dst, (uint8_t)getMAhDrawn());
-    crsfSerialize8(dst, batteryRemainingPercentage);
+    crsfSerialize16(dst, battery->amperage / 10);
+    crsfSerialize8(dst, (battery->mAhDrawn >> 16));
+    crsfSerialize8(dst, (battery->mAhDrawn >> 8));
+    crsfSerialize8(dst, (uint8_t)battery->mAhDrawn);
+    crsfSerialize8(dst, battery->remainingPercent);
 }
 
 typedef enum {
@@ -302,11 +301,12 @@ static int16_t decidegrees2Radians10000(int16_t angle_decidegree)
 
 static void crsfFrameAttitude(sbuf_t *dst)
 {
+     const telemetryAttitude_t *attitude = telemetryGetAttitude();
      sbufWriteU8(dst, CRSF_FRAME_ATTITUDE_PAYLOAD_SIZE + CRSF_FRAME_LENGTH_TYPE_CRC);
      crsfSerialize8(dst, CRSF_FRAMETYPE_ATTITUDE);
-     crsfSerialize16(dst, decidegrees2Radians10000(attitude.values.pitch));
-     crsfSerialize16(dst, decidegrees2Radians10000(attitude.values.roll));
-     crsfSerialize16(dst, decidegrees2Radians10000(attitude.values.yaw));
+     crsfSerialize16(dst, decidegrees2Radians10000(attitude->pitch));
+     crsfSerialize16(dst, decidegrees2Radians10000(attitude->roll));
+     crsfSerialize16(dst, decidegrees2Radians10000(attitude->yaw));
 }
 
 /*
@@ -405,9 +405,7 @@ static void crsfFrameDeviceInfo(sbuf_t *dst)
     *lengthPtr = sbufPtr(dst) - lengthPtr;
 }
 
-#define BV(x)  (1 << (x)) // bit value
-
-// schedule array to decide how often each type of frame is sent
+// frames sent by the telemetry schedule
 typedef enum {
     CRSF_FRAME_START_INDEX = 0,
     CRSF_FRAME_ATTITUDE_INDEX = CRSF_FRAME_START_INDEX,
@@ -418,16 +416,16 @@ typedef enum {
     CRSF_SCHEDULE_COUNT_MAX
 } crsfFrameTypeIndex_e;
 
-static uint8_t crsfScheduleCount;
-static uint8_t crsfSchedule[CRSF_SCHEDULE_COUNT_MAX];
+static telemetryScheduleEntry_t crsfScheduleEntries[CRSF_SCHEDULE_COUNT_MAX];
+static telemetrySchedule_t crsfSchedule;
 
 #if defined(USE_MSP_OVER_TELEMETRY)
 
-static bool mspReplyPending;
+static bool mspRequestPending;
 
 void crsfScheduleMspResponse(void)
 {
-    mspReplyPending = true;
+    mspRequestPending = true;
 }
 
 void crsfSendMspResponse(uint8_t *payload)
@@ -447,42 +445,36 @@ void crsfSendMspResponse(uint8_t *payload)
 
 static void processCrsf(void)
 {
-    static uint8_t crsfScheduleIndex = 0;
-    const uint8_t currentSchedule = crsfSchedule[crsfScheduleIndex];
-
     sbuf_t crsfPayloadBuf;
     sbuf_t *dst = &crsfPayloadBuf;
 
-    if (currentSchedule & BV(CRSF_FRAME_ATTITUDE_INDEX)) {
-        crsfInitializeFrame(dst);
+    crsfInitializeFrame(dst);
+
+    switch (telemetryScheduleNext(&crsfSchedule)) {
+    case CRSF_FRAME_ATTITUDE_INDEX:
         crsfFrameAttitude(dst);
-        crsfFinalize(dst);
-    }
-    if (currentSchedule & BV(CRSF_FRAME_BATTERY_SENSOR_INDEX)) {
-        crsfInitializeFrame(dst);
+        break;
+    case CRSF_FRAME_BATTERY_SENSOR_INDEX:
         crsfFrameBatterySensor(dst);
-        crsfFinalize(dst);
-    }
-    if (currentSchedule & BV(CRSF_FRAME_FLIGHT_MODE_INDEX)) {
-        crsfInitializeFrame(dst);
+        break;
+    case CRSF_FRAME_FLIGHT_MODE_INDEX:
         crsfFrameFlightMode(dst);
-        crsfFinalize(dst);
-    }
+        break;
 #ifdef USE_GPS
-    if (currentSchedule & BV(CRSF_FRAME_GPS_INDEX)) {
-        crsfInitializeFrame(dst);
+    case CRSF_FRAME_GPS_INDEX:
         crsfFrameGps(dst);
-        crsfFinalize(dst);
-    }
+        break;
 #endif
 #if defined(USE_BARO) || defined(USE_GPS)
-    if (currentSchedule & BV(CRSF_FRAME_VARIO_SENSOR_INDEX)) {
-        crsfInitializeFrame(dst);
+    case CRSF_FRAME_VARIO_SENSOR_INDEX:
         crsfFrameVarioSensor(dst);
-        crsfFinalize(dst);
-    }
+        break;
 #endif
-    crsfScheduleIndex = (crsfScheduleIndex + 1) % crsfScheduleCount;
+    default:
+        return;
+    }
+
+    crsfFinalize(dst);
 }
 
 void crsfScheduleDeviceInfoResponse(void)
@@ -498,24 +490,25 @@ void initCrsfTelemetry(void)
 
     deviceInfoReplyPending = false;
 #if defined(USE_MSP_OVER_TELEMETRY)
-    mspReplyPending = false;
+    mspRequestPending = false;
+    initSharedMsp();
 #endif
 
-    int index = 0;
-    crsfSchedule[index++] = BV(CRSF_FRAME_ATTITUDE_INDEX);
-    crsfSchedule[index++] = BV(CRSF_FRAME_BATTERY_SENSOR_INDEX);
-    crsfSchedule[index++] = BV(CRSF_FRAME_FLIGHT_MODE_INDEX);
+    // Attitude and position go out twice as often as the rest
+    telemetryScheduleInit(&crsfSchedule, crsfScheduleEntries, ARRAYLEN(crsfScheduleEntries));
+    telemetryScheduleAdd(&crsfSchedule, CRSF_FRAME_ATTITUDE_INDEX, TELEMETRY_RATE_FAST);
+    telemetryScheduleAdd(&crsfSchedule, CRSF_FRAME_BATTERY_SENSOR_INDEX, TELEMETRY_RATE_NORMAL);
+    telemetryScheduleAdd(&crsfSchedule, CRSF_FRAME_FLIGHT_MODE_INDEX, TELEMETRY_RATE_NORMAL);
 #ifdef USE_GPS
     if (feature(FEATURE_GPS)) {
-        crsfSchedule[index++] = BV(CRSF_FRAME_GPS_INDEX);
+        telemetryScheduleAdd(&crsfSchedule, CRSF_FRAME_GPS_INDEX, TELEMETRY_RATE_FAST);
     }
 #endif
 #if defined(USE_BARO) || defined(USE_GPS)
     if (sensors(SENSOR_BARO) || (STATE(FIXED_WING_LEGACY) && feature(FEATURE_GPS))) {
-        crsfSchedule[index++] = BV(CRSF_FRAME_VARIO_SENSOR_INDEX);
+        telemetryScheduleAdd(&crsfSchedule, CRSF_FRAME_VARIO_SENSOR_INDEX, TELEMETRY_RATE_NORMAL);
     }
 #endif
-    crsfScheduleCount = (uint8_t)index;
 }
 
 bool checkCrsfTelemetryState(void)
@@ -538,15 +531,19 @@ void handleCrsfTelemetry(timeUs_t currentTimeUs)
     // in between the RX frames.
     crsfRxSendTelemetryData();
 
-    // Send ad-hoc response frames as soon as possible
 #if defined(USE_MSP_OVER_TELEMETRY)
-    if (mspReplyPending) {
-        mspReplyPending = handleCrsfMspFrameBuffer(CRSF_FRAME_TX_MSP_FRAME_SIZE, &crsfSendMspResponse);
-        crsfLastCycleTime = currentTimeUs; // reset telemetry timing due to ad-hoc request
-        return;
+    if (mspRequestPending) {
+        mspRequestPending = false;
+        processCrsfMspFrameBuffer();
     }
 #endif
 
+    // The receiver holds a single frame, wait until the last one went out
+    if (!crsfRxIsTelemetryBufEmpty()) {
+        return;
+    }
+
+    // Send ad-hoc response frames as soon as possible
     if (deviceInfoReplyPending) {
         sbuf_t crsfPayloadBuf;
         sbuf_t *dst = &crsfPayloadBuf;
@@ -558,12 +555,20 @@ void handleCrsfTelemetry(timeUs_t currentTimeUs)
         return;
     }
 
-    // Actual telemetry data only needs to be sent at a low frequency, ie 10Hz
-    // Spread out scheduled frames evenly so each frame is sent at the same frequency.
-    if (currentTimeUs >= crsfLastCycleTime + (CRSF_CYCLETIME_US / crsfScheduleCount)) {
+    // Actual telemetry data only needs to be sent at a low frequency, ie 10Hz on average per frame.
+    // The schedule spreads the frames out, flight critical ones get more of the slots.
+    if (currentTimeUs >= crsfLastCycleTime + (CRSF_CYCLETIME_US / telemetryScheduleCount(&crsfSchedule))) {
         crsfLastCycleTime = currentTimeUs;
         processCrsf();
+        return;
     }
+
+    // MSP replies get every slot left between telemetry frames
+#if defined(USE_MSP_OVER_TELEMETRY)
+    if (isMspReplyPending()) {
+        sendMspReply(CRSF_FRAME_TX_MSP_FRAME_SIZE, &crsfSendMspResponse);
+    }
+#endif
 }
 
 int getCrsfFrame(uint8_t *frame, crsfFrameType_e frameType)
@@ -63,6 +63,7 @@
 
 #include "telemetry/telemetry.h"
 #include "telemetry/msp_shared.h"
+#include "telemetry/telemetry_scheduler.h"
 
 #include "telemetry/ghst.h"
 
@@ -100,14 +101,15 @@ void ghstFramePackTelemetry(sbuf_t *dst)
     sbufWriteU8(dst, GHST_FRAME_PACK_PAYLOAD_SIZE + GHST_FRAME_LENGTH_CRC + GHST_FRAME_LENGTH_TYPE);
     sbufWriteU8(dst, 0x23);                     // GHST_DL_PACK_STAT
 
+    const telemetryBattery_t *battery = telemetryGetBattery();
     if (telemetryConfig()->report_cell_voltage) {
-        sbufWriteU16(dst, getBatteryAverageCellVoltage());      // units of 10mV
+        sbufWriteU16(dst, battery->cellVoltage);                // units of 10mV
     } else {
-        sbufWriteU16(dst, getBatteryVoltage());
+        sbufWriteU16(dst, battery->voltage);
     }
-    sbufWriteU16(dst, getAmperage());                           // units of 10mA
+    sbufWriteU16(dst, battery->amperage);                       // units of 10mA
 
-    sbufWriteU16(dst, getMAhDrawn() / 10);                      // units of 10mAh (range of 0-655.36Ah)
+    sbufWriteU16(dst, battery->mAhDrawn / 10);                  // units of 10mAh (range of 0-655.36Ah)
 
     sbufWriteU8(dst, 0x00);                     // Rx Voltage, units of 100mV (not passed from BF, added in Ghost Rx)
 
@@ -124,11 +126,12 @@ void ghstFrameGpsPrimaryTelemetry(sbuf_t *dst)
     sbufWriteU8(dst, GHST_FRAME_GPS_PAYLOAD_SIZE + GHST_FRAME_LENGTH_CRC + GHST_FRAME_LENGTH_TYPE);
     sbufWriteU8(dst, GHST_DL_GPS_PRIMARY);
 
-    sbufWriteU32(dst, gpsSol.llh.lat);
-    sbufWriteU32(dst, gpsSol.llh.lon);
+    const telemetryGps_t *gps = telemetryGetGps();
+    sbufWriteU32(dst, gps->lat);
+    sbufWriteU32(dst, gps->lon);
 
     // constrain alt. from -32,000m to +32,000m, units of meters
-    const int16_t altitude = (constrain(getEstimatedActualPosition(Z), -32000 * 100, 32000 * 100) / 100);
+    const int16_t altitude = (constrain(telemetryGetAltitude()->altitude, -32000 * 100, 32000 * 100) / 100);
     sbufWriteU16(dst, altitude);
 }
 
@@ -139,12 +142,13 @@ void ghstFrameGpsSecondaryTelemetry(sbuf_t *dst)
     sbufWriteU8(dst, GHST_FRAME_GPS_PAYLOAD_SIZE + GHST_FRAME_LENGTH_CRC + GHST_FRAME_LENGTH_TYPE);
     sbufWriteU8(dst, GHST_DL_GPS_SECONDARY);
 
-    sbufWriteU16(dst, gpsSol.groundSpeed);      // speed in 0.1m/s
-    sbufWriteU16(dst, gpsSol.groundCourse);     // degrees * 10
-    sbufWriteU8(dst, gpsSol.numSat);
+    const telemetryGps_t *gps = telemetryGetGps();
+    sbufWriteU16(dst, gps->groundSpeed);        // speed in 0.1m/s
+    sbufWriteU16(dst, gps->groundCourse);       // degrees * 10
+    sbufWriteU8(dst, gps->numSat);
 
-    sbufWriteU16(dst, (uint16_t) (GPS_distanceToHome / 10));    // use units of 10m to increase range of U16 to 655.36km
-    sbufWriteU16(dst, GPS_directionToHome);
+    sbufWriteU16(dst, (uint16_t) (gps->distanceToHome / 10));   // use units of 10m to increase range of U16 to 655.36km
+    sbufWriteU16(dst, gps->directionToHome);
 
     uint8_t gpsFlags = 0;
     if (STATE(GPS_FIX)
@@ -160,7 +164,7 @@ void ghstFrameGpsSecondaryTelemetry(sbuf_t *dst)
     sbufWriteU8(dst, gpsFlags);
 }
 
-// schedule array to decide how often each type of frame is sent
+// frames sent by the telemetry schedule
 typedef enum {
     GHST_FRAME_START_INDEX = 0,
     GHST_FRAME_PACK_INDEX = GHST_FRAME_START_INDEX, // Battery (Pack) data
@@ -169,37 +173,31 @@ typedef enum {
    GHST_SCHEDULE_COUNT_MAX
 } ghstFrameTypeIndex_e;
 
-static uint8_t ghstScheduleCount;
-static uint8_t ghstSchedule[GHST_SCHEDULE_COUNT_MAX];
+static telemetryScheduleEntry_t ghstScheduleEntries[GHST_SCHEDULE_COUNT_MAX];
+static telemetrySchedule_t ghstSchedule;
 
 static void processGhst(void)
 {
-    static uint8_t ghstScheduleIndex = 0;
-
-    const uint8_t currentSchedule = ghstSchedule[ghstScheduleIndex];
-
     sbuf_t ghstPayloadBuf;
     sbuf_t *dst = &ghstPayloadBuf;
 
-    if (currentSchedule & BIT(GHST_FRAME_PACK_INDEX)) {
-        ghstInitializeFrame(dst);
-        ghstFramePackTelemetry(dst);
-        ghstFinalize(dst);
-    } 
+    ghstInitializeFrame(dst);
 
-    if (currentSchedule & BIT(GHST_FRAME_GPS_PRIMARY_INDEX)) {
-        ghstInitializeFrame(dst);
+    switch (telemetryScheduleNext(&ghstSchedule)) {
+    case GHST_FRAME_PACK_INDEX:
+        ghstFramePackTelemetry(dst);
+        break;
+    case GHST_FRAME_GPS_PRIMARY_INDEX:
         ghstFrameGpsPrimaryTelemetry(dst);
-        ghstFinalize(dst);
-    }
-
-   if (currentSchedule & BIT(GHST_FRAME_GPS_SECONDARY_INDEX)) {
-        ghstInitializeFrame(dst);
+        break;
+    case GHST_FRAME_GPS_SECONDARY_INDEX:
         ghstFrameGpsSecondaryTelemetry(dst);
-        ghstFinalize(dst);
+        break;
+    default:
+        return;
     }
 
-    ghstScheduleIndex = (ghstScheduleIndex + 1) % ghstScheduleCount;
+    ghstFinalize(dst);
 }
 
 void initGhstTelemetry(void)
@@ -211,19 +209,18 @@ void initGhstTelemetry(void)
         return;
     }
 
-    int index = 0;
+    // Position goes out more often than the slowly changing GPS status
+    telemetryScheduleInit(&ghstSchedule, ghstScheduleEntries, ARRAYLEN(ghstScheduleEntries));
     if (isBatteryVoltageConfigured() || isAmperageConfigured()) {
-        ghstSchedule[index++] = BIT(GHST_FRAME_PACK_INDEX);
+        telemetryScheduleAdd(&ghstSchedule, GHST_FRAME_PACK_INDEX, TELEMETRY_RATE_NORMAL);
     }
 
 #ifdef USE_GPS
     if (feature(FEATURE_GPS)) {
-        ghstSchedule[index++] = BIT(GHST_FRAME_GPS_PRIMARY_INDEX);
-        ghstSchedule[index++] = BIT(GHST_FRAME_GPS_SECONDARY_INDEX);
+        telemetryScheduleAdd(&ghstSchedule, GHST_FRAME_GPS_PRIMARY_INDEX, TELEMETRY_RATE_FAST);
+        telemetryScheduleAdd(&ghstSchedule, GHST_FRAME_GPS_SECONDARY_INDEX, TELEMETRY_RATE_SLOW);
     }
 #endif
-
-    ghstScheduleCount = (uint8_t)index;
  }
 
 bool checkGhstTelemetryState(void)
@@ -236,12 +233,12 @@ bool checkGhstTelemetryState(void)
 {
     static timeUs_t ghstLastCycleTime;
 
-    if (!ghstTelemetryEnabled) {
+    if (!ghstTelemetryEnabled || telemetryScheduleCount(&ghstSchedule) == 0) {
         return;
     }
 
     // Ready to send telemetry?
-    if (currentTimeUs >= ghstLastCycleTime + (GHST_CYCLETIME_US / ghstScheduleCount)) {
+    if (currentTimeUs >= ghstLastCycleTime + (GHST_CYCLETIME_US / telemetryScheduleCount(&ghstSchedule))) {
         ghstLastCycleTime = currentTimeUs;
         processGhst();
     }
@@ -86,6 +86,7 @@
 
 #include "telemetry/hott.h"
 #include "telemetry/telemetry.h"
+#include "telemetry/telemetry_scheduler.h"
 
 #if defined (USE_HOTT_TEXTMODE) && defined (USE_CMS)
 #include "scheduler/scheduler.h"
@@ -224,14 +225,17 @@ void addGPSCoordinates(HOTT_GPS_MSG_t *hottGPSMessage, int32_t latitude, int32_t
 
 void hottPrepareGPSResponse(HOTT_GPS_MSG_t *hottGPSMessage)
 {
-    hottGPSMessage->gps_satelites = gpsSol.numSat;
+    const telemetryGps_t *gps = telemetryGetGps();
+    const int16_t vario = telemetryGetAltitude()->vario;
+
+    hottGPSMessage->gps_satelites = gps->numSat;
 
     // Report climb rate regardless of GPS fix
-    const int32_t climbrate = MAX(0, getEstimatedActualVelocity(Z) + 30000);
+    const int32_t climbrate = MAX(0, vario + 30000);
     hottGPSMessage->climbrate_L = climbrate & 0xFF;
     hottGPSMessage->climbrate_H = climbrate >> 8;
 
-    const int32_t climbrate3s = MAX(0, 3.0f * getEstimatedActualVelocity(Z) / 100 + 120);
+    const int32_t climbrate3s = MAX(0, 3.0f * vario / 100 + 120);
     hottGPSMessage->climbrate3s = climbrate3s & 0xFF;
 
 #ifdef USE_GPS_FIX_ESTIMATION
@@ -244,28 +248,28 @@ void hottPrepareGPSResponse(HOTT_GPS_MSG_t *hottGPSMessage)
         return;
     }
 
-    if (gpsSol.fixType == GPS_FIX_3D) {
+    if (gps->fixType == GPS_FIX_3D) {
         hottGPSMessage->gps_fix_char = GPS_FIX_CHAR_3D;
     } else {
         hottGPSMessage->gps_fix_char = GPS_FIX_CHAR_2D;
     }
 
-    addGPSCoordinates(hottGPSMessage, gpsSol.llh.lat, gpsSol.llh.lon);
+    addGPSCoordinates(hottGPSMessage, gps->lat, gps->lon);
 
     // GPS Speed is returned in cm/s (from io/gps.c) and must be sent in km/h (Hott requirement)
-    const uint16_t speed = (gpsSol.groundSpeed * 36) / 1000;
+    const uint16_t speed = (gps->groundSpeed * 36) / 1000;
     hottGPSMessage->gps_speed_L = speed & 0x00FF;
     hottGPSMessage->gps_speed_H = speed >> 8;
 
-    hottGPSMessage->home_distance_L = GPS_distanceToHome & 0x00FF;
-    hottGPSMessage->home_distance_H = GPS_distanceToHome >> 8;
+    hottGPSMessage->home_distance_L = gps->distanceToHome & 0x00FF;
+    hottGPSMessage->home_distance_H = gps->distanceToHome >> 8;
 
-    const uint16_t hottGpsAltitude = (gpsSol.llh.alt / 100) + HOTT_GPS_ALTITUDE_OFFSET; // meters
+    const uint16_t hottGpsAltitude = (gps->alt / 100) + HOTT_GPS_ALTITUDE_OFFSET; // meters
 
     hottGPSMessage->altitude_L = hottGpsAltitude & 0x00FF;
     hottGPSMessage->altitude_H = hottGpsAltitude >> 8;
 
-    hottGPSMessage->home_direction = GPS_directionToHome;
+    hottGPSMessage->home_direction = gps->directionToHome / 2;    // 2 degree steps
 }
 #endif
 
@@ -288,7 +292,7 @@ static inline void updateAlarmBatteryStatus(HOTT_EAM_MSG_t *hottEAMMessage)
 
 static inline void hottEAMUpdateBattery(HOTT_EAM_MSG_t *hottEAMMessage)
 {
-    uint8_t vbat_dcv = getBatteryVoltage() / 10; // vbat resolution is 10mV convert to 100mv (deciVolt)
+    uint8_t vbat_dcv = telemetryGetBattery()->voltage / 10; // vbat resolution is 10mV convert to 100mv (deciVolt)
     hottEAMMessage->main_voltage_L = vbat_dcv & 0xFF;
     hottEAMMessage->main_voltage_H = vbat_dcv >> 8;
     hottEAMMessage->batt1_voltage_L = vbat_dcv & 0xFF;
@@ -299,29 +303,31 @@ static inline void hottEAMUpdateBattery(HOTT_EAM_MSG_t *hottEAMMessage)
 
 static inline void hottEAMUpdateCurrentMeter(HOTT_EAM_MSG_t *hottEAMMessage)
 {
-    const int32_t amp = getAmperage() / 10;
+    const int32_t amp = telemetryGetBattery()->amperage / 10;
     hottEAMMessage->current_L = amp & 0xFF;
     hottEAMMessage->current_H = amp >> 8;
 }
 
 static inline void hottEAMUpdateBatteryDrawnCapacity(HOTT_EAM_MSG_t *hottEAMMessage)
 {
-    const int32_t mAh = getMAhDrawn() / 10;
+    const int32_t mAh = telemetryGetBattery()->mAhDrawn / 10;
     hottEAMMessage->batt_cap_L = mAh & 0xFF;
     hottEAMMessage->batt_cap_H = mAh >> 8;
 }
 
 static inline void hottEAMUpdateAltitudeAndClimbrate(HOTT_EAM_MSG_t *hottEAMMessage)
 {
-    const int32_t alt = MAX(0, (int32_t)(getEstimatedActualPosition(Z) / 100.0f + HOTT_GPS_ALTITUDE_OFFSET));     // Value of 500 = 0m
+    const telemetryAltitude_t *altitude = telemetryGetAltitude();
+
+    const int32_t alt = MAX(0, (int32_t)(altitude->altitude / 100.0f + HOTT_GPS_ALTITUDE_OFFSET));     // Value of 500 = 0m
     hottEAMMessage->altitude_L = alt & 0xFF;
     hottEAMMessage->altitude_H = alt >> 8;
 
-    const int32_t climbrate = MAX(0, (int32_t)(getEstimatedActualVelocity(Z) + 30000));
+    const int32_t climbrate = MAX(0, (int32_t)(altitude->vario + 30000));
     hottEAMMessage->climbrate_L = climbrate & 0xFF;
     hottEAMMessage->climbrate_H = climbrate >> 8;
 
-    const int32_t climbrate3s = MAX(0, (int32_t)(3.0f * getEstimatedActualVelocity(Z) / 100 + 120));
+    const int32_t climbrate3s = MAX(0, (int32_t)(3.0f * altitude->vario / 100 + 120));
     hottEAMMessage->climbrate3s = climbrate3s & 0xFF;
 }
 
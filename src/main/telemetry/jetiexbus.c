@@ -373,15 +373,15 @@ int32_t getSensorValue(uint8_t sensor)
         break;
 
     case EX_ROLL_ANGLE:
-        return attitude.values.roll;
+        return imuGetAttitude()->values.roll;
         break;
 
     case EX_PITCH_ANGLE:
-        return attitude.values.pitch;
+        return imuGetAttitude()->values.pitch;
         break;
 
     case EX_HEADING:
-        return attitude.values.yaw;
+        return imuGetAttitude()->values.yaw;
         break;
 
     case EX_VARIO:
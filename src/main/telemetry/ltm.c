@@ -75,6 +75,7 @@
 
 #include "telemetry/ltm.h"
 #include "telemetry/telemetry.h"
+#include "telemetry/telemetry_scheduler.h"
 
 
 #define TELEMETRY_LTM_INITIAL_PORT_MODE MODE_TX
@@ -115,6 +116,7 @@ static void ltm_finalise(sbuf_t *dst)
  */
 void ltm_gframe(sbuf_t *dst)
 {
+    const telemetryGps_t *gps = telemetryGetGps();
     uint8_t gps_fix_type = 0;
     int32_t ltm_lat = 0, ltm_lon = 0, ltm_alt = 0, ltm_gs = 0;
 
@@ -123,26 +125,26 @@ void ltm_gframe(sbuf_t *dst)
             || STATE(GPS_ESTIMATED_FIX)
 #endif
         ) {
-        if (gpsSol.fixType == GPS_NO_FIX)
+        if (gps->fixType == GPS_NO_FIX)
             gps_fix_type = 1;
-        else if (gpsSol.fixType == GPS_FIX_2D)
+        else if (gps->fixType == GPS_FIX_2D)
             gps_fix_type = 2;
-        else if (gpsSol.fixType == GPS_FIX_3D)
+        else if (gps->fixType == GPS_FIX_3D)
             gps_fix_type = 3;
 
-        ltm_lat = gpsSol.llh.lat;
-        ltm_lon = gpsSol.llh.lon;
-        ltm_gs = gpsSol.groundSpeed / 100;
+        ltm_lat = gps->lat;
+        ltm_lon = gps->lon;
+        ltm_gs = gps->groundSpeed / 100;
     }
 
-    ltm_alt = getEstimatedActualPosition(Z); // cm
+    ltm_alt = telemetryGetAltitude()->altitude; // cm
 
     sbufWriteU8(dst, 'G');
     sbufWriteU32(dst, ltm_lat);
     sbufWriteU32(dst, ltm_lon);
     sbufWriteU8(dst, (uint8_t)ltm_gs);
     sbufWriteU32(dst, ltm_alt);
-    sbufWriteU8(dst, (gpsSol.numSat << 2) | gps_fix_type);
+    sbufWriteU8(dst, (gps->numSat << 2) | gps_fix_type);
 }
 #endif
 
@@ -194,8 +196,8 @@ void ltm_sframe(sbuf_t *dst)
     if (failsafeIsActive())
         lt_statemode |= 2;
     sbufWriteU8(dst, 'S');
-    sbufWriteU16(dst, getBatteryVoltage() * 10);    //vbat converted to mv
-    sbufWriteU16(dst, (uint16_t)constrain(getMAhDrawn(), 0, 0xFFFF));    // current mAh (65535 mAh max)
+    sbufWriteU16(dst, telemetryGetBattery()->voltage * 10);    //vbat converted to mv
+    sbufWriteU16(dst, (uint16_t)constrain(telemetryGetBattery()->mAhDrawn, 0, 0xFFFF));    // current mAh (65535 mAh max)
     sbufWriteU8(dst, (uint8_t)((getRSSI() * 254) / 1023));        // scaled RSSI (uchar)
 #if defined(USE_PITOT)
     sbufWriteU8(dst, (sensors(SENSOR_PITOT) && pitotIsHealthy())? getAirspeedEstimate() / 100.0f : 0);  // in m/s
@@ -212,9 +214,10 @@ void ltm_sframe(sbuf_t *dst)
 void ltm_aframe(sbuf_t *dst)
 {
     sbufWriteU8(dst, 'A');
-    sbufWriteU16(dst, (int16_t)DECIDEGREES_TO_DEGREES(attitude.values.pitch));
-    sbufWriteU16(dst, (int16_t)DECIDEGREES_TO_DEGREES(attitude.values.roll));
-    sbufWriteU16(dst, (int16_t)DECIDEGREES_TO_DEGREES(attitude.values.yaw));
+    const telemetryAttitude_t *attitude = telemetryGetAttitude();
+    sbufWriteU16(dst, (int16_t)DECIDEGREES_TO_DEGREES(attitude->pitch));
+    sbufWriteU16(dst, (int16_t)DECIDEGREES_TO_DEGREES(attitude->roll));
+    sbufWriteU16(dst, (int16_t)DECIDEGREES_TO_DEGREES(attitude->yaw));
 }
 
 #if defined(USE_GPS)
@@ -245,7 +248,7 @@ void ltm_xframe(sbuf_t *dst)
 
     sbufWriteU8(dst, 'X');
 #if defined(USE_GPS)
-    sbufWriteU16(dst, gpsSol.hdop);
+    sbufWriteU16(dst, telemetryGetGps()->hdop);
 #else
     sbufWriteU16(dst, 9999);
 #endif
@@ -82,6 +82,7 @@
 #include "sensors/esc_sensor.h"
 
 #include "telemetry/mavlink.h"
+#include "telemetry/mavlink_param.h"
 #include "telemetry/telemetry.h"
 
 #include "blackbox/blackbox_io.h"
@@ -96,7 +97,17 @@
 
 #define TELEMETRY_MAVLINK_PORT_MODE     MODE_RXTX
 #define TELEMETRY_MAVLINK_MAXRATE       50
-#define TELEMETRY_MAVLINK_DELAY         ((1000 * 1000) / TELEMETRY_MAVLINK_MAXRATE)
+#define TELEMETRY_MAVLINK_BATCH_SIZE    (2 * MAVLINK_MAX_PACKET_LEN)
+#define TELEMETRY_MAVLINK_MIN_LINK_RATE 100     // bytes/s, lowest rate the link estimate backs off to
+
+#define MAVLINK_MISSION_WINDOW          8       // Items requested ahead during a mission upload
+#define MAVLINK_MISSION_TIMEOUT_US      300000  // No new item for this long re-requests the outstanding ones
+#define MAVLINK_MISSION_MAX_RETRIES     10
+
+#define MAVLINK_PARAM_INDEX_SIZE        1024    // Power of 2, keeps the param id hash table at most 3/4 full
+
+STATIC_ASSERT(SETTINGS_TABLE_COUNT <= MAVLINK_PARAM_INDEX_SIZE * 3 / 4, mavlink_param_index_too_small);
+STATIC_ASSERT(MAVLINK_PARAM_ID_LEN == MAVLINK_MSG_PARAM_VALUE_FIELD_PARAM_ID_LEN, mavlink_param_id_length_mismatch);
 
 /**
  * MAVLink requires angles to be in the range -Pi..Pi.
@@ -177,8 +188,64 @@ static uint8_t mavRates[] = {
 
 #define MAXSTREAMS (sizeof(mavRates) / sizeof(mavRates[0]))
 
-static timeUs_t lastMavlinkMessage = 0;
-static uint8_t mavTicks[MAXSTREAMS];
+/* Streams in the order they get bandwidth when the link can't carry everything */
+static const uint8_t mavStreamPriority[] = {
+    MAV_DATA_STREAM_EXTRA2,             // HEARTBEAT
+    MAV_DATA_STREAM_EXTENDED_STATUS,
+    MAV_DATA_STREAM_POSITION,
+    MAV_DATA_STREAM_EXTRA1,
+    MAV_DATA_STREAM_RC_CHANNELS,
+    MAV_DATA_STREAM_EXTRA3,
+};
+
+static timeUs_t mavNextDueUs[MAXSTREAMS];
+static uint16_t mavStreamCost[MAXSTREAMS];      // Bytes the stream took last time it was sent
+
+/* Token bucket in bytes, the fill rate tracks what the link can carry */
+static struct {
+    int32_t tokens;
+    uint32_t rate;          // bytes/s
+    uint32_t maxRate;       // bytes/s the serial port can carry
+    timeUs_t lastRefillUs;
+} mavLink;
+
+static uint8_t mavTxBatch[TELEMETRY_MAVLINK_BATCH_SIZE];
+static uint16_t mavTxBatchLength;
+static bool mavTxBatching;
+
+/* Param id hash table, setting index + 1 per used slot */
+static uint16_t mavParamIndex[MAVLINK_PARAM_INDEX_SIZE];
+static uint16_t mavParamCount;
+static bool mavParamIndexValid;
+
+/* PARAM_REQUEST_LIST in progress */
+static struct {
+    bool active;
+    uint16_t settingIndex;
+    uint16_t paramIndex;
+} mavParamList;
+
+/* Mission upload in progress (MISSION_COUNT or MISSION_WRITE_PARTIAL_LIST), items arriving
+ * out of order are held in the window until all the ones before them are in */
+static struct {
+    bool active;
+    bool partial;
+    bool requestInt;        // Request with MISSION_REQUEST_INT, falls back to MISSION_REQUEST
+    bool itemReceived;
+    uint8_t result;         // Last MISSION_ACK result, repeated when the GCS didn't get it
+    uint8_t gcsSystemId;
+    uint8_t gcsComponentId;
+    uint8_t retries;
+    uint16_t count;         // Mission length
+    uint16_t endSeq;        // One past the last item of the transfer
+    uint16_t nextSeq;       // First item not stored yet
+    uint16_t requestSeq;    // First item not requested yet
+    uint16_t resendSeq;     // Next outstanding item to request again after a timeout
+    timeUs_t lastProgressUs;
+    int16_t windowSeq[MAVLINK_MISSION_WINDOW];
+    navWaypoint_t window[MAVLINK_MISSION_WINDOW];
+} mavMissionUpload = { .result = MAV_MISSION_ERROR };
+
 static mavlink_message_t mavSendMsg;
 static mavlink_message_t mavRecvMsg;
 static mavlink_status_t mavRecvStatus;
@@ -248,26 +315,76 @@ static APM_PLANE_MODE inavToArduPlaneMap(flightModeForTelemetry_e flightMode)
     }
 }
 
-static int mavlinkStreamTrigger(enum MAV_DATA_STREAM streamNum)
+static bool mavlinkStreamDue(enum MAV_DATA_STREAM streamNum, timeUs_t currentTimeUs)
 {
-    uint8_t rate = (uint8_t) mavRates[streamNum];
-    if (rate == 0) {
-        return 0;
+    return mavRates[streamNum] && (timeDelta_t)(currentTimeUs - mavNextDueUs[streamNum]) >= 0;
+}
+
+static void mavlinkStreamSent(enum MAV_DATA_STREAM streamNum, timeUs_t currentTimeUs)
+{
+    const timeUs_t periodUs = 1000000 / MIN(mavRates[streamNum], TELEMETRY_MAVLINK_MAXRATE);
+
+    // Keep the average rate, but don't try to catch up after the stream was held back
+    mavNextDueUs[streamNum] += periodUs;
+    if ((timeDelta_t)(currentTimeUs - mavNextDueUs[streamNum]) >= 0) {
+        mavNextDueUs[streamNum] = currentTimeUs + periodUs;
     }
+}
 
-    if (mavTicks[streamNum] == 0) {
-        // we're triggering now, setup the next trigger point
-        if (rate > TELEMETRY_MAVLINK_MAXRATE) {
-            rate = TELEMETRY_MAVLINK_MAXRATE;
-        }
+static int32_t mavlinkBucketSize(void)
+{
+    // 100ms worth of traffic, but always enough for the largest stream
+    return MAX(mavLink.rate / 10, (uint32_t)TELEMETRY_MAVLINK_BATCH_SIZE);
+}
 
-        mavTicks[streamNum] = (TELEMETRY_MAVLINK_MAXRATE / rate);
-        return 1;
+static void mavlinkRefillTokens(timeUs_t currentTimeUs)
+{
+    const timeUs_t elapsedUs = currentTimeUs - mavLink.lastRefillUs;
+    const uint32_t refill = ((uint64_t)elapsedUs * mavLink.rate) / 1000000;
+
+    if (refill == 0) {
+        return;
     }
 
-    // count down at TASK_RATE_HZ
-    mavTicks[streamNum]--;
-    return 0;
+    mavLink.tokens += refill;
+    mavLink.lastRefillUs += ((uint64_t)refill * 1000000) / mavLink.rate;
+
+    if (mavLink.tokens >= mavlinkBucketSize()) {
+        mavLink.tokens = mavlinkBucketSize();
+        mavLink.lastRefillUs = currentTimeUs;
+    }
+}
+
+// RADIO_STATUS feedback, back off quickly when the radio buffer fills up and probe for more bandwidth slowly
+static void mavlinkUpdateLinkRate(uint8_t txbuf)
+{
+    const uint8_t minTxbuff = telemetryConfig()->mavlink.min_txbuff;
+
+    if (txbuf < minTxbuff) {
+        mavLink.rate = MAX(mavLink.rate * 3 / 4, (uint32_t)TELEMETRY_MAVLINK_MIN_LINK_RATE);
+        mavLink.tokens = MIN(mavLink.tokens, 0);
+    } else if (txbuf > (100 + minTxbuff) / 2) {
+        mavLink.rate = MIN(mavLink.rate + mavLink.maxRate / 32, mavLink.maxRate);
+    }
+}
+
+static void mavlinkResetScheduler(uint32_t baudRate)
+{
+    // 10 bits per byte on the wire
+    mavLink.maxRate = MAX(baudRate / 10, (uint32_t)TELEMETRY_MAVLINK_MIN_LINK_RATE);
+    mavLink.rate = mavLink.maxRate;
+    mavLink.tokens = mavlinkBucketSize();
+    mavLink.lastRefillUs = micros();
+
+    for (unsigned i = 0; i < MAXSTREAMS; i++) {
+        mavNextDueUs[i] = mavLink.lastRefillUs;
+        mavStreamCost[i] = MAVLINK_MAX_PACKET_LEN;
+    }
+
+    mavTxBatchLength = 0;
+    mavTxBatching = false;
+    mavParamList.active = false;
+    mavMissionUpload.active = false;
 }
 
 void freeMAVLinkTelemetryPort(void)
@@ -301,6 +418,8 @@ void configureMAVLinkTelemetryPort(void)
         return;
     }
 
+    mavlinkResetScheduler(baudRates[baudRateIndex]);
+
     mavlinkTelemetryEnabled = true;
 }
 
@@ -329,10 +448,16 @@ void checkMAVLinkTelemetryState(void)
         freeMAVLinkTelemetryPort();
 }
 
-static void mavlinkSendMessage(void)
+static void mavlinkFlushBatch(void)
 {
-    uint8_t mavBuffer[MAVLINK_MAX_PACKET_LEN];
+    if (mavTxBatchLength) {
+        serialWriteBuf(mavlinkPort, mavTxBatch, mavTxBatchLength);
+        mavTxBatchLength = 0;
+    }
+}
 
+static void mavlinkSendMessage(void)
+{
     mavlink_status_t* chan_state = mavlink_get_channel_status(MAVLINK_COMM_0);
     if (telemetryConfig()->mavlink.version == 1) {
         chan_state->flags |= MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
@@ -340,10 +465,17 @@ static void mavlinkSendMessage(void)
         chan_state->flags &= ~MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
     }
 
-    int msgLength = mavlink_msg_to_send_buffer(mavBuffer, &mavSendMsg);
+    if (mavTxBatchLength + MAVLINK_MAX_PACKET_LEN > TELEMETRY_MAVLINK_BATCH_SIZE) {
+        mavlinkFlushBatch();
+    }
+
+    const int msgLength = mavlink_msg_to_send_buffer(&mavTxBatch[mavTxBatchLength], &mavSendMsg);
+    mavTxBatchLength += msgLength;
+    mavLink.tokens -= msgLength;
 
-    for (int i = 0; i < msgLength; i++) {
-        serialWrite(mavlinkPort, mavBuffer[i]);
+    // Replies outside of the stream scheduler go out immediately
+    if (!mavTxBatching) {
+        mavlinkFlushBatch();
     }
 }
 
@@ -645,7 +777,7 @@ void mavlinkSendPosition(timeUs_t currentTimeUs)
         // [cm/s] Ground Z Speed (Altitude, positive down)
         getEstimatedActualVelocity(Z),
         // [cdeg] Vehicle heading (yaw angle) (0.0..359.99 degrees, 0=north)
-        DECIDEGREES_TO_CENTIDEGREES(attitude.values.yaw)
+        DECIDEGREES_TO_CENTIDEGREES(imuGetAttitude()->values.yaw)
     );
 
     mavlinkSendMessage();
@@ -671,11 +803,11 @@ void mavlinkSendAttitude(void)
         // time_boot_ms Timestamp (milliseconds since system boot)
         millis(),
         // roll Roll angle (rad)
-        RADIANS_TO_MAVLINK_RANGE(DECIDEGREES_TO_RADIANS(attitude.values.roll)),
+        RADIANS_TO_MAVLINK_RANGE(DECIDEGREES_TO_RADIANS(imuGetAttitude()->values.roll)),
         // pitch Pitch angle (rad)
-        RADIANS_TO_MAVLINK_RANGE(DECIDEGREES_TO_RADIANS(-attitude.values.pitch)),
+        RADIANS_TO_MAVLINK_RANGE(DECIDEGREES_TO_RADIANS(-imuGetAttitude()->values.pitch)),
         // yaw Yaw angle (rad)
-        RADIANS_TO_MAVLINK_RANGE(DECIDEGREES_TO_RADIANS(attitude.values.yaw)),
+        RADIANS_TO_MAVLINK_RANGE(DECIDEGREES_TO_RADIANS(imuGetAttitude()->values.yaw)),
         // rollspeed Roll angular speed (rad/s)
         gyro.gyroADCf[FD_ROLL],
         // pitchspeed Pitch angular speed (rad/s)
@@ -721,7 +853,7 @@ void mavlinkSendHUDAndHeartbeat(void)
         // groundspeed Current ground speed in m/s
         mavGroundSpeed,
         // heading Current heading in degrees, in compass units (0..360, 0=north)
-        DECIDEGREES_TO_DEGREES(attitude.values.yaw),
+        DECIDEGREES_TO_DEGREES(imuGetAttitude()->values.yaw),
         // throttle Current throttle setting in integer percent, 0 to 100
         thr,
         // alt Current altitude (MSL), in meters, if we have surface or baro use them, otherwise use GPS (less accurate)
@@ -731,7 +863,6 @@ void mavlinkSendHUDAndHeartbeat(void)
 
     mavlinkSendMessage();
 
-
     uint8_t mavModes = MAV_MODE_FLAG_MANUAL_INPUT_ENABLED | MAV_MODE_FLAG_CUSTOM_MODE_ENABLED;
     if (ARMING_FLAG(ARMED))
         mavModes |= MAV_MODE_FLAG_SAFETY_ARMED;
@@ -867,7 +998,6 @@ void mavlinkSendBatteryTemperatureStatusText(void)
 
     mavlinkSendMessage();
 
-
     int16_t temperature;
     sensors(SENSOR_BARO) ? getBaroTemperature(&temperature) : getIMUTemperature(&temperature);
     mavlink_msg_scaled_pressure_pack(mavSystemId, mavComponentId, &mavSendMsg,
@@ -879,7 +1009,6 @@ void mavlinkSendBatteryTemperatureStatusText(void)
 
     mavlinkSendMessage();
 
-
 // FIXME - Status text is limited to boards with USE_OSD
 #ifdef USE_OSD
     char buff[MAVLINK_MSG_STATUSTEXT_FIELD_TEXT_LEN] = {" "};
@@ -901,39 +1030,304 @@ void mavlinkSendBatteryTemperatureStatusText(void)
         mavlinkSendMessage();
     }
 #endif
+}
+
+#ifdef USE_ADSB
+void mavlinkSendCollision(void)
+{
+    const adsbVehicle_t *threat = findVehicleMostThreatening();
+    if (threat == NULL) {
+        return;
+    }
 
+    mavlink_msg_collision_pack(mavSystemId, mavComponentId, &mavSendMsg,
+        // src Collision data source
+        MAV_COLLISION_SRC_ADSB,
+        // id Unique identifier, domain based on src field
+        threat->vehicleValues.icao,
+        // action Action that is being taken to avoid this collision
+        MAV_COLLISION_ACTION_REPORT,
+        // threat_level How concerned the aircraft is about this collision
+        threat->calculatedVehicleValues.threatLevel == ADSB_THREAT_HIGH ? MAV_COLLISION_THREAT_LEVEL_HIGH : MAV_COLLISION_THREAT_LEVEL_LOW,
+        // time_to_minimum_delta Estimated time until collision occurs (seconds)
+        threat->calculatedVehicleValues.cpaTime / 10.0f,
+        // altitude_minimum_delta Closest vertical distance between vehicle and object (meters)
+        CENTIMETERS_TO_METERS(fabsf((float)threat->calculatedVehicleValues.cpaVerticalDistance)),
+        // horizontal_minimum_delta Closest horizontal distance between vehicle and object (meters)
+        CENTIMETERS_TO_METERS((float)threat->calculatedVehicleValues.cpaDist));
 
+    mavlinkSendMessage();
 }
+#endif
 
-void processMAVLinkTelemetry(timeUs_t currentTimeUs)
+static void mavlinkSendStream(enum MAV_DATA_STREAM streamNum, timeUs_t currentTimeUs)
 {
-    // is executed @ TELEMETRY_MAVLINK_MAXRATE rate
-    if (mavlinkStreamTrigger(MAV_DATA_STREAM_EXTENDED_STATUS)) {
-        mavlinkSendSystemStatus();
+    UNUSED(currentTimeUs);
+
+    switch (streamNum) {
+        case MAV_DATA_STREAM_EXTENDED_STATUS:
+            mavlinkSendSystemStatus();
+            break;
+        case MAV_DATA_STREAM_RC_CHANNELS:
+            mavlinkSendRCChannelsAndRSSI();
+            break;
+#ifdef USE_GPS
+        case MAV_DATA_STREAM_POSITION:
+            mavlinkSendPosition(currentTimeUs);
+            break;
+#endif
+        case MAV_DATA_STREAM_EXTRA1:
+            mavlinkSendAttitude();
+            break;
+        case MAV_DATA_STREAM_EXTRA2:
+            mavlinkSendHUDAndHeartbeat();
+            break;
+        case MAV_DATA_STREAM_EXTRA3:
+            mavlinkSendBatteryTemperatureStatusText();
+#ifdef USE_ADSB
+            mavlinkSendCollision();
+#endif
+            break;
+        default:
+            break;
     }
+}
+
+static void mavlinkSendMissionAck(uint8_t targetSystem, uint8_t targetComponent, uint8_t result)
+{
+    mavlink_msg_mission_ack_pack(mavSystemId, mavComponentId, &mavSendMsg, targetSystem, targetComponent, result, MAV_MISSION_TYPE_MISSION);
+    mavlinkSendMessage();
+}
+
+static void mavlinkMissionUploadFinish(uint8_t result)
+{
+    mavMissionUpload.active = false;
+    mavMissionUpload.result = result;
+    mavlinkSendMissionAck(mavMissionUpload.gcsSystemId, mavMissionUpload.gcsComponentId, result);
+}
 
-    if (mavlinkStreamTrigger(MAV_DATA_STREAM_RC_CHANNELS)) {
-        mavlinkSendRCChannelsAndRSSI();
+static void mavlinkMissionUploadStart(uint16_t startSeq, uint16_t endSeq, uint16_t count, bool partial)
+{
+    mavMissionUpload.active = true;
+    mavMissionUpload.partial = partial;
+    mavMissionUpload.requestInt = true;
+    mavMissionUpload.itemReceived = false;
+    mavMissionUpload.gcsSystemId = mavRecvMsg.sysid;
+    mavMissionUpload.gcsComponentId = mavRecvMsg.compid;
+    mavMissionUpload.retries = 0;
+    mavMissionUpload.count = count;
+    mavMissionUpload.endSeq = endSeq;
+    mavMissionUpload.nextSeq = startSeq;
+    mavMissionUpload.requestSeq = startSeq;
+    mavMissionUpload.resendSeq = startSeq;
+    mavMissionUpload.lastProgressUs = micros();
+
+    for (unsigned i = 0; i < MAVLINK_MISSION_WINDOW; i++) {
+        mavMissionUpload.windowSeq[i] = -1;
     }
+}
 
-#ifdef USE_GPS
-    if (mavlinkStreamTrigger(MAV_DATA_STREAM_POSITION)) {
-        mavlinkSendPosition(currentTimeUs);
+static bool mavlinkMissionItemInWindow(uint16_t seq)
+{
+    return mavMissionUpload.windowSeq[seq % MAVLINK_MISSION_WINDOW] == seq;
+}
+
+// Keeps up to MAVLINK_MISSION_WINDOW item requests in flight and requests the missing ones again when the upload stalls
+static void mavlinkMissionUploadUpdate(timeUs_t currentTimeUs)
+{
+    if (!mavMissionUpload.active) {
+        return;
     }
-#endif
 
-    if (mavlinkStreamTrigger(MAV_DATA_STREAM_EXTRA1)) {
-        mavlinkSendAttitude();
+    if (cmpTimeUs(currentTimeUs, mavMissionUpload.lastProgressUs) >= MAVLINK_MISSION_TIMEOUT_US) {
+        if (++mavMissionUpload.retries > MAVLINK_MISSION_MAX_RETRIES) {
+            mavlinkMissionUploadFinish(MAV_MISSION_OPERATION_CANCELLED);
+            return;
+        }
+
+        // A GCS that never answered may not know MISSION_REQUEST_INT
+        if (!mavMissionUpload.itemReceived) {
+            mavMissionUpload.requestInt = !mavMissionUpload.requestInt;
+        }
+
+        mavMissionUpload.resendSeq = mavMissionUpload.nextSeq;
+        mavMissionUpload.lastProgressUs = currentTimeUs;
+    }
+
+    const uint32_t cost = MAVLINK_NUM_NON_PAYLOAD_BYTES + MAVLINK_MSG_ID_MISSION_REQUEST_INT_LEN;
+
+    while (mavLink.tokens >= (int32_t)cost && serialTxBytesFree(mavlinkPort) >= mavTxBatchLength + cost) {
+        uint16_t seq;
+
+        if (mavMissionUpload.resendSeq < mavMissionUpload.requestSeq) {
+            seq = mavMissionUpload.resendSeq++;
+            if (mavlinkMissionItemInWindow(seq)) {
+                continue;
+            }
+        } else if (mavMissionUpload.requestSeq < mavMissionUpload.endSeq && mavMissionUpload.requestSeq < mavMissionUpload.nextSeq + MAVLINK_MISSION_WINDOW) {
+            seq = mavMissionUpload.requestSeq++;
+            mavMissionUpload.resendSeq = mavMissionUpload.requestSeq;
+        } else {
+            break;
+        }
+
+        if (mavMissionUpload.requestInt) {
+            mavlink_msg_mission_request_int_pack(mavSystemId, mavComponentId, &mavSendMsg, mavMissionUpload.gcsSystemId, mavMissionUpload.gcsComponentId, seq, MAV_MISSION_TYPE_MISSION);
+        } else {
+            mavlink_msg_mission_request_pack(mavSystemId, mavComponentId, &mavSendMsg, mavMissionUpload.gcsSystemId, mavMissionUpload.gcsComponentId, seq, MAV_MISSION_TYPE_MISSION);
+        }
+        mavlinkSendMessage();
+    }
+}
+
+// Parameters are the entries of the settings table, minus the string settings MAVLink can't carry
+static void mavlinkParamId(const setting_t *setting, char *paramId)
+{
+    char name[SETTING_MAX_NAME_LENGTH];
+    settingGetName(setting, name);
+    mavlinkParamIdFromName(name, paramId);
+}
+
+static bool mavlinkParamIsSupported(const setting_t *setting)
+{
+    return SETTING_TYPE(setting) != VAR_STRING;
+}
+
+static void mavlinkParamBuildIndex(void)
+{
+    char paramId[MAVLINK_PARAM_ID_LEN];
+
+    memset(mavParamIndex, 0, sizeof(mavParamIndex));
+    mavParamCount = 0;
+
+    for (unsigned i = 0; i < SETTINGS_TABLE_COUNT; i++) {
+        const setting_t *setting = settingGet(i);
+        if (!mavlinkParamIsSupported(setting)) {
+            continue;
+        }
+
+        mavlinkParamId(setting, paramId);
+        unsigned slot = mavlinkParamHash(paramId, MAVLINK_PARAM_ID_LEN) & (MAVLINK_PARAM_INDEX_SIZE - 1);
+        while (mavParamIndex[slot]) {
+            slot = (slot + 1) & (MAVLINK_PARAM_INDEX_SIZE - 1);
+        }
+        mavParamIndex[slot] = i + 1;
+        mavParamCount++;
+    }
+
+    mavParamIndexValid = true;
+}
+
+static const setting_t *mavlinkParamFindById(const char *paramId)
+{
+    char candidateId[MAVLINK_PARAM_ID_LEN];
+
+    unsigned slot = mavlinkParamHash(paramId, MAVLINK_PARAM_ID_LEN) & (MAVLINK_PARAM_INDEX_SIZE - 1);
+    while (mavParamIndex[slot]) {
+        const setting_t *setting = settingGet(mavParamIndex[slot] - 1);
+        mavlinkParamId(setting, candidateId);
+        if (strncmp(candidateId, paramId, MAVLINK_PARAM_ID_LEN) == 0) {
+            return setting;
+        }
+        slot = (slot + 1) & (MAVLINK_PARAM_INDEX_SIZE - 1);
     }
 
-    if (mavlinkStreamTrigger(MAV_DATA_STREAM_EXTRA2)) {
-        mavlinkSendHUDAndHeartbeat();
+    return NULL;
+}
+
+static const setting_t *mavlinkParamFindByIndex(int paramIndex, unsigned *settingIndex)
+{
+    for (unsigned i = 0; i < SETTINGS_TABLE_COUNT; i++) {
+        const setting_t *setting = settingGet(i);
+        if (mavlinkParamIsSupported(setting) && paramIndex-- == 0) {
+            *settingIndex = i;
+            return setting;
+        }
     }
 
-    if (mavlinkStreamTrigger(MAV_DATA_STREAM_EXTRA3)) {
-        mavlinkSendBatteryTemperatureStatusText();
+    return NULL;
+}
+
+static uint16_t mavlinkParamIndexOf(unsigned settingIndex)
+{
+    uint16_t paramIndex = 0;
+    for (unsigned i = 0; i < settingIndex; i++) {
+        if (mavlinkParamIsSupported(settingGet(i))) {
+            paramIndex++;
+        }
     }
+    return paramIndex;
+}
+
+static void mavlinkSendParam(const setting_t *setting, uint16_t paramIndex)
+{
+    char paramId[MAVLINK_PARAM_ID_LEN];
+    mavlinkParamId(setting, paramId);
+
+    mavlink_msg_param_value_pack(mavSystemId, mavComponentId, &mavSendMsg,
+        paramId, mavlinkParamEncode(SETTING_TYPE(setting), settingGetValuePointer(setting)), MAV_PARAM_TYPE_REAL32, mavParamCount, paramIndex);
 
+    mavlinkSendMessage();
+}
+
+// PARAM_REQUEST_LIST replies go out with whatever bandwidth the telemetry streams leave
+static void mavlinkSendParamList(void)
+{
+    const uint32_t cost = MAVLINK_NUM_NON_PAYLOAD_BYTES + MAVLINK_MSG_ID_PARAM_VALUE_LEN;
+
+    while (mavParamList.active && mavLink.tokens >= (int32_t)cost && serialTxBytesFree(mavlinkPort) >= mavTxBatchLength + cost) {
+        while (mavParamList.settingIndex < SETTINGS_TABLE_COUNT && !mavlinkParamIsSupported(settingGet(mavParamList.settingIndex))) {
+            mavParamList.settingIndex++;
+        }
+
+        if (mavParamList.settingIndex >= SETTINGS_TABLE_COUNT) {
+            mavParamList.active = false;
+            break;
+        }
+
+        mavlinkSendParam(settingGet(mavParamList.settingIndex), mavParamList.paramIndex);
+        mavParamList.settingIndex++;
+        mavParamList.paramIndex++;
+    }
+}
+
+void processMAVLinkTelemetry(timeUs_t currentTimeUs)
+{
+    mavlinkRefillTokens(currentTimeUs);
+
+    // Due streams go out in priority order, packed into as few serial writes as possible.
+    // A stream the link can't afford yet holds back everything below it.
+    mavTxBatching = true;
+    bool linkBusy = false;
+
+    // Mission item requests are small and a GCS is waiting on them
+    mavlinkMissionUploadUpdate(currentTimeUs);
+
+    for (unsigned i = 0; i < ARRAYLEN(mavStreamPriority); i++) {
+        const enum MAV_DATA_STREAM streamNum = mavStreamPriority[i];
+
+        if (!mavlinkStreamDue(streamNum, currentTimeUs)) {
+            continue;
+        }
+
+        const uint32_t cost = MIN(mavStreamCost[streamNum], (uint32_t)mavlinkBucketSize());
+        if (mavLink.tokens < (int32_t)cost || serialTxBytesFree(mavlinkPort) < mavTxBatchLength + cost) {
+            linkBusy = true;
+            break;
+        }
+
+        const int32_t tokensBefore = mavLink.tokens;
+        mavlinkSendStream(streamNum, currentTimeUs);
+        mavlinkStreamSent(streamNum, currentTimeUs);
+        mavStreamCost[streamNum] = tokensBefore - mavLink.tokens;
+    }
+
+    if (!linkBusy) {
+        mavlinkSendParamList();
+    }
+
+    mavTxBatching = false;
+    mavlinkFlushBatch();
 }
 
 static bool handleIncoming_MISSION_CLEAR_ALL(void)
@@ -943,6 +1337,7 @@ static bool handleIncoming_MISSION_CLEAR_ALL(void)
 
     // Check if this message is for us
     if (msg.target_system == mavSystemId) {
+        mavMissionUpload.active = false;
         resetWaypointList();
         mavlink_msg_mission_ack_pack(mavSystemId, mavComponentId, &mavSendMsg, mavRecvMsg.sysid, mavRecvMsg.compid, MAV_MISSION_ACCEPTED, MAV_MISSION_TYPE_MISSION);
         mavlinkSendMessage();
@@ -952,10 +1347,6 @@ static bool handleIncoming_MISSION_CLEAR_ALL(void)
     return false;
 }
 
-// Static state for MISSION UPLOAD transaction (starting with MISSION_COUNT)
-static int incomingMissionWpCount = 0;
-static int incomingMissionWpSequence = 0;
-
 static bool handleIncoming_MISSION_COUNT(void)
 {
     mavlink_mission_count_t msg;
@@ -963,90 +1354,166 @@ static bool handleIncoming_MISSION_COUNT(void)
 
     // Check if this message is for us
     if (msg.target_system == mavSystemId) {
-        if (msg.count <= NAV_MAX_WAYPOINTS) {
-            incomingMissionWpCount = msg.count; // We need to know how many items to request
-            incomingMissionWpSequence = 0;
-            mavlink_msg_mission_request_pack(mavSystemId, mavComponentId, &mavSendMsg, mavRecvMsg.sysid, mavRecvMsg.compid, incomingMissionWpSequence, MAV_MISSION_TYPE_MISSION);
-            mavlinkSendMessage();
-            return true;
-        }
-        else if (ARMING_FLAG(ARMED)) {
-            mavlink_msg_mission_ack_pack(mavSystemId, mavComponentId, &mavSendMsg, mavRecvMsg.sysid, mavRecvMsg.compid, MAV_MISSION_ERROR, MAV_MISSION_TYPE_MISSION);
-            mavlinkSendMessage();
-            return true;
-        }
-        else {
-            mavlink_msg_mission_ack_pack(mavSystemId, mavComponentId, &mavSendMsg, mavRecvMsg.sysid, mavRecvMsg.compid, MAV_MISSION_NO_SPACE, MAV_MISSION_TYPE_MISSION);
-            mavlinkSendMessage();
-            return true;
+        if (ARMING_FLAG(ARMED)) {
+            mavlinkSendMissionAck(mavRecvMsg.sysid, mavRecvMsg.compid, MAV_MISSION_ERROR);
+        } else if (msg.mission_type != MAV_MISSION_TYPE_MISSION) {
+            mavlinkSendMissionAck(mavRecvMsg.sysid, mavRecvMsg.compid, MAV_MISSION_UNSUPPORTED);
+        } else if (msg.count > NAV_MAX_WAYPOINTS) {
+            mavlinkSendMissionAck(mavRecvMsg.sysid, mavRecvMsg.compid, MAV_MISSION_NO_SPACE);
+        } else if (msg.count == 0) {
+            resetWaypointList();
+            mavlinkSendMissionAck(mavRecvMsg.sysid, mavRecvMsg.compid, MAV_MISSION_ACCEPTED);
+        } else {
+            // Items are requested by the telemetry scheduler
+            mavlinkMissionUploadStart(0, msg.count, msg.count, false);
         }
+        return true;
     }
 
     return false;
 }
 
-static bool handleIncoming_MISSION_ITEM(void)
+static bool handleIncoming_MISSION_WRITE_PARTIAL_LIST(void)
 {
-    mavlink_mission_item_t msg;
-    mavlink_msg_mission_item_decode(&mavRecvMsg, &msg);
+    mavlink_mission_write_partial_list_t msg;
+    mavlink_msg_mission_write_partial_list_decode(&mavRecvMsg, &msg);
 
     // Check if this message is for us
     if (msg.target_system == mavSystemId) {
-        // Check supported values first
+        const int wpCount = getWaypointCount();
+        const int endIndex = (msg.end_index < 0) ? wpCount - 1 : msg.end_index;
+
         if (ARMING_FLAG(ARMED)) {
-            mavlink_msg_mission_ack_pack(mavSystemId, mavComponentId, &mavSendMsg, mavRecvMsg.sysid, mavRecvMsg.compid, MAV_MISSION_ERROR, MAV_MISSION_TYPE_MISSION);
-            mavlinkSendMessage();
-            return true;
+            mavlinkSendMissionAck(mavRecvMsg.sysid, mavRecvMsg.compid, MAV_MISSION_ERROR);
+        } else if (msg.mission_type != MAV_MISSION_TYPE_MISSION) {
+            mavlinkSendMissionAck(mavRecvMsg.sysid, mavRecvMsg.compid, MAV_MISSION_UNSUPPORTED);
+        } else if (msg.start_index < 0 || msg.start_index > endIndex || endIndex >= wpCount) {
+            mavlinkSendMissionAck(mavRecvMsg.sysid, mavRecvMsg.compid, MAV_MISSION_INVALID_SEQUENCE);
+        } else {
+            mavlinkMissionUploadStart(msg.start_index, endIndex + 1, wpCount, true);
         }
+        return true;
+    }
 
-        if ((msg.autocontinue == 0) || (msg.command != MAV_CMD_NAV_WAYPOINT && msg.command != MAV_CMD_NAV_RETURN_TO_LAUNCH)) {
-            mavlink_msg_mission_ack_pack(mavSystemId, mavComponentId, &mavSendMsg, mavRecvMsg.sysid, mavRecvMsg.compid, MAV_MISSION_UNSUPPORTED, MAV_MISSION_TYPE_MISSION);
-            mavlinkSendMessage();
-            return true;
-        }
+    return false;
+}
 
-        if ((msg.frame != MAV_FRAME_GLOBAL_RELATIVE_ALT) && !(msg.frame == MAV_FRAME_MISSION && msg.command == MAV_CMD_NAV_RETURN_TO_LAUNCH)) {
-            mavlink_msg_mission_ack_pack(mavSystemId, mavComponentId, &mavSendMsg, mavRecvMsg.sysid, mavRecvMsg.compid, MAV_MISSION_UNSUPPORTED_FRAME, MAV_MISSION_TYPE_MISSION);
-            mavlinkSendMessage();
-            return true;
-        }
+static uint8_t mavlinkMissionItemToWaypoint(const mavlink_mission_item_int_t *item, navWaypoint_t *wp)
+{
+    if ((item->autocontinue == 0) || (item->command != MAV_CMD_NAV_WAYPOINT && item->command != MAV_CMD_NAV_RETURN_TO_LAUNCH)) {
+        return MAV_MISSION_UNSUPPORTED;
+    }
 
-        if (msg.seq == incomingMissionWpSequence) {
-            incomingMissionWpSequence++;
-
-            navWaypoint_t wp;
-            wp.action = (msg.command == MAV_CMD_NAV_RETURN_TO_LAUNCH) ? NAV_WP_ACTION_RTH : NAV_WP_ACTION_WAYPOINT;
-            wp.lat = (int32_t)(msg.x * 1e7f);
-            wp.lon = (int32_t)(msg.y * 1e7f);
-            wp.alt = msg.z * 100.0f;
-            wp.p1 = 0;
-            wp.p2 = 0;
-            wp.p3 = 0;
-            wp.flag = (incomingMissionWpSequence >= incomingMissionWpCount) ? NAV_WP_FLAG_LAST : 0;
-
-            setWaypoint(incomingMissionWpSequence, &wp);
-
-            if (incomingMissionWpSequence >= incomingMissionWpCount) {
-                if (isWaypointListValid()) {
-                    mavlink_msg_mission_ack_pack(mavSystemId, mavComponentId, &mavSendMsg, mavRecvMsg.sysid, mavRecvMsg.compid, MAV_MISSION_ACCEPTED, MAV_MISSION_TYPE_MISSION);
-                    mavlinkSendMessage();
-                }
-                else {
-                    mavlink_msg_mission_ack_pack(mavSystemId, mavComponentId, &mavSendMsg, mavRecvMsg.sysid, mavRecvMsg.compid, MAV_MISSION_INVALID, MAV_MISSION_TYPE_MISSION);
-                    mavlinkSendMessage();
-                }
-            }
-            else {
-                mavlink_msg_mission_request_pack(mavSystemId, mavComponentId, &mavSendMsg, mavRecvMsg.sysid, mavRecvMsg.compid, incomingMissionWpSequence, MAV_MISSION_TYPE_MISSION);
-                mavlinkSendMessage();
-            }
-        }
-        else {
-            // Wrong sequence number received
-            mavlink_msg_mission_ack_pack(mavSystemId, mavComponentId, &mavSendMsg, mavRecvMsg.sysid, mavRecvMsg.compid, MAV_MISSION_INVALID_SEQUENCE, MAV_MISSION_TYPE_MISSION);
-            mavlinkSendMessage();
+    const bool relativeAltFrame = (item->frame == MAV_FRAME_GLOBAL_RELATIVE_ALT) || (item->frame == MAV_FRAME_GLOBAL_RELATIVE_ALT_INT);
+    if (!relativeAltFrame && !(item->frame == MAV_FRAME_MISSION && item->command == MAV_CMD_NAV_RETURN_TO_LAUNCH)) {
+        return MAV_MISSION_UNSUPPORTED_FRAME;
+    }
+
+    wp->action = (item->command == MAV_CMD_NAV_RETURN_TO_LAUNCH) ? NAV_WP_ACTION_RTH : NAV_WP_ACTION_WAYPOINT;
+    wp->lat = item->x;
+    wp->lon = item->y;
+    wp->alt = item->z * 100.0f;
+    wp->p1 = 0;
+    wp->p2 = 0;
+    wp->p3 = 0;
+    wp->flag = 0;
+
+    return MAV_MISSION_ACCEPTED;
+}
+
+static bool mavlinkMissionStoreItem(uint16_t seq, navWaypoint_t *wp)
+{
+    if (mavMissionUpload.partial) {
+        return replaceWaypoint(seq + 1, wp);
+    }
+
+    wp->flag = (seq + 1 >= mavMissionUpload.count) ? NAV_WP_FLAG_LAST : 0;
+    setWaypoint(seq + 1, wp);
+    return true;
+}
+
+static void mavlinkHandleMissionItem(const mavlink_mission_item_int_t *item)
+{
+    if (!mavMissionUpload.active) {
+        // Most likely the GCS didn't get our MISSION_ACK and sent the last item again
+        mavlinkSendMissionAck(mavRecvMsg.sysid, mavRecvMsg.compid, mavMissionUpload.result);
+        return;
+    }
+
+    if (ARMING_FLAG(ARMED)) {
+        mavlinkMissionUploadFinish(MAV_MISSION_ERROR);
+        return;
+    }
+
+    navWaypoint_t wp;
+    const uint8_t result = mavlinkMissionItemToWaypoint(item, &wp);
+    if (result != MAV_MISSION_ACCEPTED) {
+        mavlinkMissionUploadFinish(result);
+        return;
+    }
+
+    // Anything outside of the window is a duplicate of an item we already have
+    if (item->seq < mavMissionUpload.nextSeq || item->seq >= mavMissionUpload.endSeq || item->seq >= mavMissionUpload.nextSeq + MAVLINK_MISSION_WINDOW) {
+        return;
+    }
+
+    const unsigned slot = item->seq % MAVLINK_MISSION_WINDOW;
+    mavMissionUpload.windowSeq[slot] = item->seq;
+    mavMissionUpload.window[slot] = wp;
+    mavMissionUpload.itemReceived = true;
+
+    // Waypoints have to be stored in order
+    while (mavMissionUpload.nextSeq < mavMissionUpload.endSeq && mavlinkMissionItemInWindow(mavMissionUpload.nextSeq)) {
+        const unsigned nextSlot = mavMissionUpload.nextSeq % MAVLINK_MISSION_WINDOW;
+
+        if (!mavlinkMissionStoreItem(mavMissionUpload.nextSeq, &mavMissionUpload.window[nextSlot])) {
+            mavlinkMissionUploadFinish(MAV_MISSION_ERROR);
+            return;
         }
 
+        mavMissionUpload.windowSeq[nextSlot] = -1;
+        mavMissionUpload.nextSeq++;
+        mavMissionUpload.retries = 0;
+        mavMissionUpload.lastProgressUs = micros();
+    }
+
+    if (mavMissionUpload.nextSeq >= mavMissionUpload.endSeq) {
+        mavlinkMissionUploadFinish(isWaypointListValid() ? MAV_MISSION_ACCEPTED : MAV_MISSION_INVALID);
+    }
+}
+
+static bool handleIncoming_MISSION_ITEM_INT(void)
+{
+    mavlink_mission_item_int_t msg;
+    mavlink_msg_mission_item_int_decode(&mavRecvMsg, &msg);
+
+    // Check if this message is for us
+    if (msg.target_system == mavSystemId) {
+        mavlinkHandleMissionItem(&msg);
+        return true;
+    }
+
+    return false;
+}
+
+static bool handleIncoming_MISSION_ITEM(void)
+{
+    mavlink_mission_item_t msg;
+    mavlink_msg_mission_item_decode(&mavRecvMsg, &msg);
+
+    // Check if this message is for us
+    if (msg.target_system == mavSystemId) {
+        const mavlink_mission_item_int_t item = {
+            .x = (int32_t)(msg.x * 1e7f),
+            .y = (int32_t)(msg.y * 1e7f),
+            .z = msg.z,
+            .seq = msg.seq,
+            .command = msg.command,
+            .frame = msg.frame,
+            .autocontinue = msg.autocontinue,
+        };
+
+        mavlinkHandleMissionItem(&item);
         return true;
     }
 
@@ -1068,6 +1535,37 @@ static bool handleIncoming_MISSION_REQUEST_LIST(void)
     return false;
 }
 
+static void mavlinkSendMissionItem(uint16_t seq, bool useInt)
+{
+    if (seq >= getWaypointCount()) {
+        mavlinkSendMissionAck(mavRecvMsg.sysid, mavRecvMsg.compid, MAV_MISSION_INVALID_SEQUENCE);
+        return;
+    }
+
+    navWaypoint_t wp;
+    getWaypoint(seq + 1, &wp);
+
+    const uint8_t frame = wp.action == NAV_WP_ACTION_RTH ? MAV_FRAME_MISSION : MAV_FRAME_GLOBAL_RELATIVE_ALT;
+    const uint16_t command = wp.action == NAV_WP_ACTION_RTH ? MAV_CMD_NAV_RETURN_TO_LAUNCH : MAV_CMD_NAV_WAYPOINT;
+
+    if (useInt) {
+        mavlink_msg_mission_item_int_pack(mavSystemId, mavComponentId, &mavSendMsg, mavRecvMsg.sysid, mavRecvMsg.compid,
+                    seq, frame, command, 0, 1, 0, 0, 0, 0,
+                    wp.lat,
+                    wp.lon,
+                    wp.alt / 100.0f,
+                    MAV_MISSION_TYPE_MISSION);
+    } else {
+        mavlink_msg_mission_item_pack(mavSystemId, mavComponentId, &mavSendMsg, mavRecvMsg.sysid, mavRecvMsg.compid,
+                    seq, frame, command, 0, 1, 0, 0, 0, 0,
+                    wp.lat / 1e7f,
+                    wp.lon / 1e7f,
+                    wp.alt / 100.0f,
+                    MAV_MISSION_TYPE_MISSION);
+    }
+    mavlinkSendMessage();
+}
+
 static bool handleIncoming_MISSION_REQUEST(void)
 {
     mavlink_mission_request_t msg;
@@ -1075,30 +1573,21 @@ static bool handleIncoming_MISSION_REQUEST(void)
 
     // Check if this message is for us
     if (msg.target_system == mavSystemId) {
-        int wpCount = getWaypointCount();
-
-        if (msg.seq < wpCount) {
-            navWaypoint_t wp;
-            getWaypoint(msg.seq + 1, &wp);
-
-            mavlink_msg_mission_item_pack(mavSystemId, mavComponentId, &mavSendMsg, mavRecvMsg.sysid, mavRecvMsg.compid,
-                        msg.seq,
-                        wp.action == NAV_WP_ACTION_RTH ? MAV_FRAME_MISSION : MAV_FRAME_GLOBAL_RELATIVE_ALT,
-                        wp.action == NAV_WP_ACTION_RTH ? MAV_CMD_NAV_RETURN_TO_LAUNCH : MAV_CMD_NAV_WAYPOINT,
-                        0,
-                        1,
-                        0, 0, 0, 0,
-                        wp.lat / 1e7f,
-                        wp.lon / 1e7f,
-                        wp.alt / 100.0f,
-                        MAV_MISSION_TYPE_MISSION);
-            mavlinkSendMessage();
-        }
-        else {
-            mavlink_msg_mission_ack_pack(mavSystemId, mavComponentId, &mavSendMsg, mavRecvMsg.sysid, mavRecvMsg.compid, MAV_MISSION_INVALID_SEQUENCE, MAV_MISSION_TYPE_MISSION);
-            mavlinkSendMessage();
-        }
+        mavlinkSendMissionItem(msg.seq, false);
+        return true;
+    }
 
+    return false;
+}
+
+static bool handleIncoming_MISSION_REQUEST_INT(void)
+{
+    mavlink_mission_request_int_t msg;
+    mavlink_msg_mission_request_int_decode(&mavRecvMsg, &msg);
+
+    // Check if this message is for us
+    if (msg.target_system == mavSystemId) {
+        mavlinkSendMissionItem(msg.seq, true);
         return true;
     }
 
@@ -1113,16 +1602,110 @@ static bool handleIncoming_RC_CHANNELS_OVERRIDE(void) {
     return true;
 }
 
+static void mavlinkParamEnsureIndex(void)
+{
+    if (!mavParamIndexValid) {
+        mavlinkParamBuildIndex();
+    }
+}
+
 static bool handleIncoming_PARAM_REQUEST_LIST(void) {
     mavlink_param_request_list_t msg;
     mavlink_msg_param_request_list_decode(&mavRecvMsg, &msg);
 
-    // Respond that we don't have any parameters to force Mission Planner to give up quickly
-    if (msg.target_system == mavSystemId) {
-        // mavlink_msg_param_value_pack(system_id, component_id, msg, param_value->param_id, param_value->param_value, param_value->param_type, param_value->param_count, param_value->param_index);
-        mavlink_msg_param_value_pack(mavSystemId, mavComponentId, &mavSendMsg, 0, 0, 0, 0, 0);
-        mavlinkSendMessage();
+    if (msg.target_system != mavSystemId) {
+        return false;
     }
+
+    mavlinkParamEnsureIndex();
+
+    // Restart the list, the parameters are sent by the stream scheduler
+    mavParamList.active = true;
+    mavParamList.settingIndex = 0;
+    mavParamList.paramIndex = 0;
+
+    return true;
+}
+
+static bool handleIncoming_PARAM_REQUEST_READ(void) {
+    mavlink_param_request_read_t msg;
+    mavlink_msg_param_request_read_decode(&mavRecvMsg, &msg);
+
+    if (msg.target_system != mavSystemId) {
+        return false;
+    }
+
+    mavlinkParamEnsureIndex();
+
+    const setting_t *setting;
+    unsigned settingIndex;
+
+    if (msg.param_index >= 0) {
+        setting = mavlinkParamFindByIndex(msg.param_index, &settingIndex);
+    } else {
+        setting = mavlinkParamFindById(msg.param_id);
+        settingIndex = setting ? settingGetIndex(setting) : 0;
+    }
+
+    if (!setting) {
+        return false;
+    }
+
+    mavlinkSendParam(setting, mavlinkParamIndexOf(settingIndex));
+    return true;
+}
+
+static bool handleIncoming_PARAM_SET(void) {
+    mavlink_param_set_t msg;
+    mavlink_msg_param_set_decode(&mavRecvMsg, &msg);
+
+    if (msg.target_system != mavSystemId) {
+        return false;
+    }
+
+    mavlinkParamEnsureIndex();
+
+    const setting_t *setting = mavlinkParamFindById(msg.param_id);
+    if (!setting) {
+        return false;
+    }
+
+    // A rejected value is answered with the current one, the GCS sees that the set didn't take
+    mavlinkParamDecode(SETTING_TYPE(setting), settingGetValuePointer(setting), msg.param_value, settingGetMin(setting), settingGetMax(setting));
+    mavlinkSendParam(setting, mavlinkParamIndexOf(settingGetIndex(setting)));
+    return true;
+}
+
+static bool handleIncoming_COMMAND_LONG(void) {
+    mavlink_command_long_t msg;
+    mavlink_msg_command_long_decode(&mavRecvMsg, &msg);
+
+    if (msg.target_system != mavSystemId) {
+        return false;
+    }
+
+    uint8_t result;
+
+    switch (msg.command) {
+        case MAV_CMD_PREFLIGHT_STORAGE:
+            // Only writing the parameters is supported, same rules as MSP_EEPROM_WRITE
+            if (msg.param1 != 1) {
+                result = MAV_RESULT_UNSUPPORTED;
+            } else if (ARMING_FLAG(ARMED)) {
+                result = MAV_RESULT_TEMPORARILY_REJECTED;
+            } else {
+                writeEEPROM();
+                readEEPROM();
+                result = MAV_RESULT_ACCEPTED;
+            }
+            break;
+        default:
+            result = MAV_RESULT_UNSUPPORTED;
+            break;
+    }
+
+    mavlink_msg_command_ack_pack(mavSystemId, mavComponentId, &mavSendMsg, msg.command, result, 0, 0, mavRecvMsg.sysid, mavRecvMsg.compid);
+    mavlinkSendMessage();
     return true;
 }
 
@@ -1153,6 +1736,7 @@ static bool handleIncoming_RADIO_STATUS(void) {
     mavlink_msg_radio_status_decode(&mavRecvMsg, &msg);
     txbuff_valid = true;
     txbuff_free = msg.txbuf;
+    mavlinkUpdateLinkRate(msg.txbuf);
        
     if (rxConfig()->receiverType == RX_TYPE_SERIAL &&
         rxConfig()->serialrx_provider == SERIALRX_MAVLINK) {
@@ -1190,6 +1774,8 @@ static bool handleIncoming_ADSB_VEHICLE(void) {
         vehicle->lon = msg.lon;
         vehicle->alt = (int32_t)(msg.altitude / 10);
         vehicle->heading = msg.heading;
+        vehicle->horVelocity = msg.hor_velocity;
+        vehicle->verVelocity = msg.ver_velocity;
         vehicle->flags = msg.flags;
         vehicle->altitudeType = msg.altitude_type;
         memcpy(&(vehicle->callsign), msg.callsign, sizeof(vehicle->callsign));
@@ -1235,16 +1821,28 @@ static bool processMAVLinkIncomingTelemetry(void)
                    return handleIncoming_HEARTBEAT();
                 case MAVLINK_MSG_ID_PARAM_REQUEST_LIST:
                     return handleIncoming_PARAM_REQUEST_LIST();
+                case MAVLINK_MSG_ID_PARAM_REQUEST_READ:
+                    return handleIncoming_PARAM_REQUEST_READ();
+                case MAVLINK_MSG_ID_PARAM_SET:
+                    return handleIncoming_PARAM_SET();
+                case MAVLINK_MSG_ID_COMMAND_LONG:
+                    return handleIncoming_COMMAND_LONG();
                 case MAVLINK_MSG_ID_MISSION_CLEAR_ALL:
                     return handleIncoming_MISSION_CLEAR_ALL();
                 case MAVLINK_MSG_ID_MISSION_COUNT:
                     return handleIncoming_MISSION_COUNT();
+                case MAVLINK_MSG_ID_MISSION_WRITE_PARTIAL_LIST:
+                    return handleIncoming_MISSION_WRITE_PARTIAL_LIST();
                 case MAVLINK_MSG_ID_MISSION_ITEM:
                     return handleIncoming_MISSION_ITEM();
+                case MAVLINK_MSG_ID_MISSION_ITEM_INT:
+                    return handleIncoming_MISSION_ITEM_INT();
                 case MAVLINK_MSG_ID_MISSION_REQUEST_LIST:
                     return handleIncoming_MISSION_REQUEST_LIST();
                 case MAVLINK_MSG_ID_MISSION_REQUEST:
                     return handleIncoming_MISSION_REQUEST();
+                case MAVLINK_MSG_ID_MISSION_REQUEST_INT:
+                    return handleIncoming_MISSION_REQUEST_INT();
                 case MAVLINK_MSG_ID_RC_CHANNELS_OVERRIDE:
                     handleIncoming_RC_CHANNELS_OVERRIDE();
                     // Don't set that we handled a message, otherwise RC channel packets will block telemetry messages
@@ -1285,19 +1883,17 @@ void handleMAVLinkTelemetry(timeUs_t currentTimeUs)
     bool receivedMessage = processMAVLinkIncomingTelemetry();
     bool shouldSendTelemetry = false;
 
-    // Determine whether to send telemetry back based on flow control / pacing
+    // Determine whether to send telemetry back based on flow control, pacing is done by the stream scheduler
     if (txbuff_valid) {
         // Use flow control if available
         shouldSendTelemetry = txbuff_free >= telemetryConfig()->mavlink.min_txbuff;
     } else {
-        // If not, use blind frame pacing - and back off for collision avoidance if half-duplex
-        bool halfDuplexBackoff = (isMAVLinkTelemetryHalfDuplex() && receivedMessage);
-        shouldSendTelemetry = ((currentTimeUs - lastMavlinkMessage) >= TELEMETRY_MAVLINK_DELAY) && !halfDuplexBackoff;
+        // If not, back off for collision avoidance if half-duplex
+        shouldSendTelemetry = !(isMAVLinkTelemetryHalfDuplex() && receivedMessage);
     }
 
     if (shouldSendTelemetry) {
         processMAVLinkTelemetry(currentTimeUs);
-        lastMavlinkMessage = currentTimeUs;
     }
 }
 
@@ -0,0 +1,117 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include "platform.h"
+
+#if defined(USE_TELEMETRY) && defined(USE_TELEMETRY_MAVLINK)
+
+#include "fc/settings.h"
+
+#include "telemetry/mavlink_param.h"
+
+uint32_t mavlinkParamHash(const char *str, size_t maxLength)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261U;
+    for (size_t i = 0; i < maxLength && str[i]; i++) {
+        hash = (hash ^ (uint8_t)str[i]) * 16777619U;
+    }
+    return hash;
+}
+
+void mavlinkParamIdFromName(const char *name, char *paramId)
+{
+    const size_t nameLength = strlen(name);
+    memset(paramId, 0, MAVLINK_PARAM_ID_LEN);
+
+    if (nameLength <= MAVLINK_PARAM_ID_LEN) {
+        memcpy(paramId, name, nameLength);
+        return;
+    }
+
+    static const char base32[] = "0123456789abcdefghijklmnopqrstuv";
+    const uint32_t hash = mavlinkParamHash(name, nameLength);
+
+    memcpy(paramId, name, MAVLINK_PARAM_ID_LEN - 5);
+    paramId[MAVLINK_PARAM_ID_LEN - 5] = '~';
+    for (unsigned i = 0; i < 4; i++) {
+        paramId[MAVLINK_PARAM_ID_LEN - 4 + i] = base32[(hash >> (5 * i)) & 0x1F];
+    }
+}
+
+float mavlinkParamEncode(uint8_t type, const void *ptr)
+{
+    switch (type) {
+        case VAR_UINT8:     return *(const uint8_t *)ptr;
+        case VAR_INT8:      return *(const int8_t *)ptr;
+        case VAR_UINT16:    return *(const uint16_t *)ptr;
+        case VAR_INT16:     return *(const int16_t *)ptr;
+        case VAR_UINT32:    return *(const uint32_t *)ptr;
+        case VAR_FLOAT:     return *(const float *)ptr;
+        default:            return 0;
+    }
+}
+
+bool mavlinkParamDecode(uint8_t type, void *ptr, float value, float min, float max)
+{
+    if (!isfinite(value) || value < min || value > max) {
+        return false;
+    }
+
+    const float rounded = roundf(value);
+
+    switch (type) {
+        case VAR_UINT8:
+            *(uint8_t *)ptr = rounded;
+            break;
+        case VAR_INT8:
+            *(int8_t *)ptr = rounded;
+            break;
+        case VAR_UINT16:
+            *(uint16_t *)ptr = rounded;
+            break;
+        case VAR_INT16:
+            *(int16_t *)ptr = rounded;
+            break;
+        case VAR_UINT32:
+            // UINT32_MAX isn't representable, it rounds up to 2^32
+            *(uint32_t *)ptr = (rounded >= 4294967296.0f) ? UINT32_MAX : (uint32_t)rounded;
+            break;
+        case VAR_FLOAT:
+            *(float *)ptr = value;
+            break;
+        default:
+            return false;
+    }
+
+    return true;
+}
+
+#endif
@@ -0,0 +1,50 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Mapping between settings and MAVLink parameters.
+ *
+ * Setting names that don't fit the 16 char param_id are shortened to their first 11 chars,
+ * a '~' and 4 base32 chars of the FNV-1a hash of the full name, so the id is unique and
+ * doesn't depend on the position of the setting in the table.
+ *
+ * All values are reported as MAV_PARAM_TYPE_REAL32 and carry the value cast to float, so a
+ * GCS that doesn't know about C cast encoding still shows and sets them correctly.
+ */
+
+#define MAVLINK_PARAM_ID_LEN    16
+
+uint32_t mavlinkParamHash(const char *str, size_t maxLength);
+void mavlinkParamIdFromName(const char *name, char *paramId);
+
+// type is a setting_type_e
+float mavlinkParamEncode(uint8_t type, const void *ptr);
+bool mavlinkParamDecode(uint8_t type, void *ptr, float value, float min, float max);
@@ -8,8 +8,12 @@
 
 #include "build/build_config.h"
 
+#include "common/crc.h"
+#include "common/maths.h"
 #include "common/utils.h"
 
+#include "drivers/time.h"
+
 #include "fc/fc_msp.h"
 
 #include "msp/msp.h"
@@ -19,12 +23,47 @@
 #include "telemetry/smartport.h"
 
 #define TELEMETRY_MSP_VERSION    1
+// Betaflight frames MSPv2 over telemetry as version 2, keep the windowed transport clear of 2 and 3
+#define TELEMETRY_MSP_VERSION_WINDOWED      6   // Data chunk with acks, see below
+#define TELEMETRY_MSP_VERSION_WINDOWED_ACK  7   // Acks only
 #define TELEMETRY_MSP_VER_SHIFT  5
 #define TELEMETRY_MSP_VER_MASK   (0x7 << TELEMETRY_MSP_VER_SHIFT)
 #define TELEMETRY_MSP_ERROR_FLAG (1 << 5)
 #define TELEMETRY_MSP_START_FLAG (1 << 4)
 #define TELEMETRY_MSP_SEQ_MASK   0x0F
 #define TELEMETRY_MSP_RES_ERROR (-10)
+#define TELEMETRY_MSP_RESET_FLAG (1 << 4)
+
+/*
+ * Windowed transport (versions 6 and 7)
+ *
+ * Version 1 carries one request and one reply at a time, and a lost chunk
+ * loses the whole message. The windowed transport keeps up to
+ * TELEMETRY_MSP_WINDOW chunks in flight in each direction, so requests can be
+ * pipelined and replies go out in every downlink slot, and lost chunks are
+ * resent selectively.
+ *
+ * Every frame starts with two bytes:
+ *   header: version (bits 7-5), START (bit 4, first chunk of a message), seq (bits 3-0)
+ *   ack:    next seq expected from the peer (bits 7-4), chunks received after it (bits 3-0)
+ * Data frames are version 6. An ack only frame (version 7) has no data, its
+ * bit 4 requests a new session.
+ * Both ends start with seq 0. A radio opens a session with a reset, the flight
+ * controller echoes it, and sends it unprompted if it lost its state.
+ *
+ * A message is split into chunks, the last one zero padded:
+ *   request: size, cmd (16 bit LE), payload, crc8 dvb-s2 of the preceding bytes
+ *   reply:   size, cmd (16 bit LE), status (0 ok, 1 error), payload, crc8 dvb-s2
+ * Replies are sent in the order the requests were received.
+ */
+#define TELEMETRY_MSP_WINDOW                5   // a cumulative ack and 4 selective bits describe all of them
+#define TELEMETRY_MSP_WINDOWED_HEADER_SIZE  2
+#define TELEMETRY_MSP_REQUEST_OVERHEAD      4
+#define TELEMETRY_MSP_REPLY_OVERHEAD        5
+#define TELEMETRY_MSP_RX_CHUNK_SIZE         (CRSF_FRAME_RX_MSP_FRAME_SIZE - TELEMETRY_MSP_WINDOWED_HEADER_SIZE) // largest uplink frame
+#define TELEMETRY_MSP_STREAM_SIZE           512 // must be a power of 2
+#define TELEMETRY_MSP_STREAM_MASK           (TELEMETRY_MSP_STREAM_SIZE - 1)
+#define TELEMETRY_MSP_RETRANSMIT_MS         250
 
 enum {
     TELEMETRY_MSP_VER_MISMATCH=0,
@@ -38,6 +77,50 @@ static mspRxBuffer_t mspRxBuffer;
 static mspTxBuffer_t mspTxBuffer;
 static mspPacket_t mspRxPacket;
 static mspPacket_t mspTxPacket;
+static bool mspLegacyReplyPending;
+
+typedef struct mspWindowTxChunk_s {
+    uint16_t offset;            // stream position of the first byte
+    uint8_t length;
+    uint8_t seq;
+    bool start;
+    bool sacked;                // received by the radio, but not in order yet
+    bool resend;
+    uint16_t sendOrder;         // tells which chunk went out last
+    timeMs_t sentAt;
+} mspWindowTxChunk_t;
+
+typedef struct mspWindowRxChunk_s {
+    bool valid;
+    bool start;
+    uint8_t length;
+    uint8_t data[TELEMETRY_MSP_RX_CHUNK_SIZE];
+} mspWindowRxChunk_t;
+
+static struct {
+    bool active;
+    bool resetPending;
+    bool ackPending;
+    bool replyPending;          // reply waiting in mspPackage for space in the stream
+
+    // Downlink, encoded replies are kept in the stream until the radio acks them
+    uint8_t stream[TELEMETRY_MSP_STREAM_SIZE];
+    uint16_t streamHead;
+    uint16_t streamSent;
+    uint16_t streamTail;
+    uint16_t messageRemaining;  // bytes of the current reply still to be chunked
+    uint16_t sendOrder;
+    uint8_t txSeq;
+    uint8_t txCount;
+    mspWindowTxChunk_t tx[TELEMETRY_MSP_WINDOW];    // in seq order
+
+    // Uplink, rx[i] holds chunk rxSeq + i
+    uint8_t rxSeq;
+    mspWindowRxChunk_t rx[TELEMETRY_MSP_WINDOW];
+    uint16_t requestReceived;
+    uint16_t requestExpected;
+    uint8_t requestCrc;
+} mspWindow;
 
 void initSharedMsp(void)
 {
@@ -80,7 +163,7 @@ void sendMspErrorResponse(uint8_t error, int16_t cmd)
     sbufSwitchToReader(&mspPackage.responsePacket->buf, mspPackage.responseBuffer);
 }
 
-bool handleMspFrame(uint8_t *frameStart, int frameLength)
+static bool handleLegacyMspFrame(uint8_t *frameStart, int frameLength)
 {
     static uint8_t mspStarted = 0;
     static uint8_t lastSeq = 0;
@@ -158,7 +241,7 @@ bool handleMspFrame(uint8_t *frameStart, int frameLength)
     return true;
 }
 
-bool sendMspReply(uint8_t payloadSize, mspResponseFnPtr responseFn)
+static bool sendLegacyMspReply(uint8_t payloadSize, mspResponseFnPtr responseFn)
 {
     static uint8_t checksum = 0;
     static uint8_t seq = 0;
@@ -222,4 +305,332 @@ bool sendMspReply(uint8_t payloadSize, mspResponseFnPtr responseFn)
     return false;
 }
 
+static uint8_t mspWindowSeqDistance(uint8_t from, uint8_t to)
+{
+    return (to - from) & TELEMETRY_MSP_SEQ_MASK;
+}
+
+static void mspWindowReset(void)
+{
+    initSharedMsp();
+    memset(&mspWindow, 0, sizeof(mspWindow));
+    mspWindow.active = true;
+}
+
+static uint16_t mspWindowStreamFree(void)
+{
+    return TELEMETRY_MSP_STREAM_SIZE - (uint16_t)(mspWindow.streamTail - mspWindow.streamHead);
+}
+
+static void mspWindowStreamPut(uint8_t c, uint8_t *crc)
+{
+    mspWindow.stream[mspWindow.streamTail++ & TELEMETRY_MSP_STREAM_MASK] = c;
+    *crc = crc8_dvb_s2(*crc, c);
+}
+
+// Moves the reply from mspPackage to the stream, false if it does not fit yet
+static bool mspWindowQueueReply(void)
+{
+    mspPacket_t *reply = mspPackage.responsePacket;
+    uint8_t status = reply->result < 0 ? 1 : 0;
+
+    if (sbufBytesRemaining(&reply->buf) > UINT8_MAX) {
+        sendMspErrorResponse(TELEMETRY_MSP_ERROR, reply->cmd);
+        status = 1;
+    }
+
+    const uint8_t size = sbufBytesRemaining(&reply->buf);
+    if (mspWindowStreamFree() < size + TELEMETRY_MSP_REPLY_OVERHEAD) {
+        return false;
+    }
+
+    uint8_t crc = 0;
+    mspWindowStreamPut(size, &crc);
+    mspWindowStreamPut(reply->cmd & 0xFF, &crc);
+    mspWindowStreamPut((reply->cmd >> 8) & 0xFF, &crc);
+    mspWindowStreamPut(status, &crc);
+    while (sbufBytesRemaining(&reply->buf)) {
+        mspWindowStreamPut(sbufReadU8(&reply->buf), &crc);
+    }
+    mspWindowStreamPut(crc, &crc);
+
+    return true;
+}
+
+static void mspWindowRequestComplete(void)
+{
+    mspPacket_t *packet = mspPackage.requestPacket;
+    const uint8_t size = mspWindow.requestExpected - TELEMETRY_MSP_REQUEST_OVERHEAD;
+
+    mspPackage.responsePacket->buf.ptr = mspPackage.responseBuffer;
+
+    if (mspWindow.requestCrc != 0) {
+        // The crc byte is included, a good message sums up to 0
+        sendMspErrorResponse(TELEMETRY_MSP_CRC_ERROR, packet->cmd);
+    } else if (size > sizeof(mspRxBuffer)) {
+        sendMspErrorResponse(TELEMETRY_MSP_ERROR, packet->cmd);
+    } else {
+        packet->buf.ptr = mspPackage.requestBuffer;
+        packet->buf.end = mspPackage.requestBuffer + size;
+        processMspPacket();
+        mspPackage.responsePacket->cmd = packet->cmd;
+    }
+
+    mspWindow.requestExpected = 0;
+    mspWindow.replyPending = !mspWindowQueueReply();
+}
+
+static void mspWindowConsumeChunk(const mspWindowRxChunk_t *chunk)
+{
+    mspPacket_t *packet = mspPackage.requestPacket;
+
+    if (chunk->start && chunk->length > 0) {
+        mspWindow.requestReceived = 0;
+        mspWindow.requestExpected = chunk->data[0] + TELEMETRY_MSP_REQUEST_OVERHEAD;
+        mspWindow.requestCrc = 0;
+        packet->cmd = 0;
+        packet->result = 0;
+    } else if (mspWindow.requestExpected == 0) {
+        // no start chunk, throw this one away
+        return;
+    }
+
+    for (unsigned i = 0; i < chunk->length && mspWindow.requestReceived < mspWindow.requestExpected; i++) {
+        const uint8_t c = chunk->data[i];
+        const uint16_t pos = mspWindow.requestReceived++;
+
+        mspWindow.requestCrc = crc8_dvb_s2(mspWindow.requestCrc, c);
+        if (pos == 1) {
+            packet->cmd = c;
+        } else if (pos == 2) {
+            packet->cmd |= c << 8;
+        } else if (pos >= 3 && pos - 3U < sizeof(mspRxBuffer)) {
+            mspPackage.requestBuffer[pos - 3] = c;
+        }
+    }
+
+    if (mspWindow.requestReceived == mspWindow.requestExpected) {
+        mspWindowRequestComplete();
+    }
+}
+
+// Hands the uplink chunks to the request parser in order
+static void mspWindowDeliver(void)
+{
+    while (mspWindow.rx[0].valid && !mspWindow.replyPending) {
+        mspWindowConsumeChunk(&mspWindow.rx[0]);
+
+        memmove(&mspWindow.rx[0], &mspWindow.rx[1], sizeof(mspWindow.rx[0]) * (TELEMETRY_MSP_WINDOW - 1));
+        mspWindow.rx[TELEMETRY_MSP_WINDOW - 1].valid = false;
+        mspWindow.rxSeq = (mspWindow.rxSeq + 1) & TELEMETRY_MSP_SEQ_MASK;
+    }
+}
+
+static void mspWindowProcessAck(uint8_t ack)
+{
+    const uint8_t next = ack >> 4;
+
+    // Everything before next has been received, a stale ack acks more than there is in flight
+    const uint8_t acked = mspWindow.txCount ? mspWindowSeqDistance(mspWindow.tx[0].seq, next) : 0;
+    if (acked > mspWindow.txCount) {
+        return;
+    }
+
+    if (acked > 0) {
+        const mspWindowTxChunk_t *last = &mspWindow.tx[acked - 1];
+        mspWindow.streamHead = last->offset + last->length;
+        mspWindow.txCount -= acked;
+        memmove(&mspWindow.tx[0], &mspWindow.tx[acked], sizeof(mspWindow.tx[0]) * mspWindow.txCount);
+    }
+
+    // Chunks received out of order, anything sent before one of them that is still missing was lost
+    for (unsigned i = 1; i < mspWindow.txCount; i++) {
+        mspWindowTxChunk_t *chunk = &mspWindow.tx[i];
+        if (chunk->sacked || !(ack & BIT(i - 1))) {
+            continue;
+        }
+
+        chunk->sacked = true;
+        for (unsigned j = 0; j < i; j++) {
+            mspWindowTxChunk_t *lost = &mspWindow.tx[j];
+            if (!lost->sacked && (int16_t)(chunk->sendOrder - lost->sendOrder) > 0) {
+                lost->resend = true;
+            }
+        }
+    }
+
+    if (mspWindow.replyPending && mspWindowQueueReply()) {
+        mspWindow.replyPending = false;
+        mspWindowDeliver();
+    }
+}
+
+static bool mspWindowChunkDue(const mspWindowTxChunk_t *chunk, timeMs_t currentTimeMs)
+{
+    return chunk->resend || (!chunk->sacked && currentTimeMs - chunk->sentAt >= TELEMETRY_MSP_RETRANSMIT_MS);
+}
+
+static bool mspWindowPending(void)
+{
+    if (mspWindow.resetPending || mspWindow.ackPending) {
+        return true;
+    }
+
+    if (mspWindow.txCount < TELEMETRY_MSP_WINDOW && mspWindow.streamSent != mspWindow.streamTail) {
+        return true;
+    }
+
+    const timeMs_t currentTimeMs = millis();
+    for (unsigned i = 0; i < mspWindow.txCount; i++) {
+        if (mspWindowChunkDue(&mspWindow.tx[i], currentTimeMs)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool handleWindowedMspFrame(uint8_t *frameStart, int frameLength)
+{
+    if (frameLength < TELEMETRY_MSP_WINDOWED_HEADER_SIZE) {
+        return mspWindow.active && mspWindowPending();
+    }
+
+    const uint8_t header = frameStart[0];
+    const uint8_t version = (header & TELEMETRY_MSP_VER_MASK) >> TELEMETRY_MSP_VER_SHIFT;
+
+    if (version == TELEMETRY_MSP_VERSION_WINDOWED_ACK && (header & TELEMETRY_MSP_RESET_FLAG)) {
+        mspWindowReset();
+        mspWindow.resetPending = true;
+        return true;
+    }
+
+    if (!mspWindow.active) {
+        // The radio thinks a session is open, tell it to start over
+        mspWindowReset();
+        mspWindow.resetPending = true;
+        return true;
+    }
+
+    mspWindowProcessAck(frameStart[1]);
+
+    if (version == TELEMETRY_MSP_VERSION_WINDOWED) {
+        const uint8_t offset = mspWindowSeqDistance(mspWindow.rxSeq, header & TELEMETRY_MSP_SEQ_MASK);
+        if (offset < TELEMETRY_MSP_WINDOW && !mspWindow.rx[offset].valid) {
+            mspWindowRxChunk_t *chunk = &mspWindow.rx[offset];
+            chunk->valid = true;
+            chunk->start = header & TELEMETRY_MSP_START_FLAG;
+            chunk->length = MIN(frameLength - TELEMETRY_MSP_WINDOWED_HEADER_SIZE, TELEMETRY_MSP_RX_CHUNK_SIZE);
+            memcpy(chunk->data, &frameStart[TELEMETRY_MSP_WINDOWED_HEADER_SIZE], chunk->length);
+        }
+
+        // Ack duplicates too, the radio may have missed the last ack
+        mspWindow.ackPending = true;
+        mspWindowDeliver();
+    }
+
+    return mspWindowPending();
+}
+
+static void mspWindowSend(uint8_t payloadSize, mspResponseFnPtr responseFn)
+{
+    uint8_t payloadOut[payloadSize];
+    const timeMs_t currentTimeMs = millis();
+    mspWindowTxChunk_t *chunk = NULL;
+
+    memset(payloadOut, 0, payloadSize);
+
+    if (!mspWindow.resetPending) {
+        // Lost chunks first, then new ones
+        for (unsigned i = 0; i < mspWindow.txCount; i++) {
+            if (mspWindowChunkDue(&mspWindow.tx[i], currentTimeMs)) {
+                chunk = &mspWindow.tx[i];
+                break;
+            }
+        }
+
+        if (!chunk && mspWindow.txCount < TELEMETRY_MSP_WINDOW && mspWindow.streamSent != mspWindow.streamTail) {
+            chunk = &mspWindow.tx[mspWindow.txCount++];
+            chunk->start = mspWindow.messageRemaining == 0;
+            if (chunk->start) {
+                mspWindow.messageRemaining = mspWindow.stream[mspWindow.streamSent & TELEMETRY_MSP_STREAM_MASK] + TELEMETRY_MSP_REPLY_OVERHEAD;
+            }
+            chunk->offset = mspWindow.streamSent;
+            chunk->length = MIN(mspWindow.messageRemaining, payloadSize - TELEMETRY_MSP_WINDOWED_HEADER_SIZE);
+            chunk->seq = mspWindow.txSeq;
+            chunk->sacked = false;
+
+            mspWindow.txSeq = (mspWindow.txSeq + 1) & TELEMETRY_MSP_SEQ_MASK;
+            mspWindow.streamSent += chunk->length;
+            mspWindow.messageRemaining -= chunk->length;
+        }
+    }
+
+    if (chunk && chunk->length > payloadSize - TELEMETRY_MSP_WINDOWED_HEADER_SIZE) {
+        // Frames shrank, another protocol took over, start over
+        mspWindowReset();
+        mspWindow.resetPending = true;
+        chunk = NULL;
+    }
+
+    const uint8_t ack = (mspWindow.rxSeq << 4) |
+        (mspWindow.rx[1].valid ? BIT(0) : 0) | (mspWindow.rx[2].valid ? BIT(1) : 0) |
+        (mspWindow.rx[3].valid ? BIT(2) : 0) | (mspWindow.rx[4].valid ? BIT(3) : 0);
+
+    if (chunk) {
+        payloadOut[0] = (TELEMETRY_MSP_VERSION_WINDOWED << TELEMETRY_MSP_VER_SHIFT) | (chunk->start ? TELEMETRY_MSP_START_FLAG : 0) | chunk->seq;
+        payloadOut[1] = ack;
+        for (unsigned i = 0; i < chunk->length; i++) {
+            payloadOut[TELEMETRY_MSP_WINDOWED_HEADER_SIZE + i] = mspWindow.stream[(chunk->offset + i) & TELEMETRY_MSP_STREAM_MASK];
+        }
+
+        chunk->resend = false;
+        chunk->sentAt = currentTimeMs;
+        chunk->sendOrder = mspWindow.sendOrder++;
+    } else if (mspWindow.resetPending || mspWindow.ackPending) {
+        payloadOut[0] = (TELEMETRY_MSP_VERSION_WINDOWED_ACK << TELEMETRY_MSP_VER_SHIFT) | (mspWindow.resetPending ? TELEMETRY_MSP_RESET_FLAG : 0);
+        payloadOut[1] = ack;
+        mspWindow.resetPending = false;
+    } else {
+        return;
+    }
+
+    mspWindow.ackPending = false;
+    responseFn(payloadOut);
+}
+
+bool handleMspFrame(uint8_t *frameStart, int frameLength)
+{
+    const uint8_t version = (frameStart[0] & TELEMETRY_MSP_VER_MASK) >> TELEMETRY_MSP_VER_SHIFT;
+
+    if (version == TELEMETRY_MSP_VERSION_WINDOWED || version == TELEMETRY_MSP_VERSION_WINDOWED_ACK) {
+        return handleWindowedMspFrame(frameStart, frameLength);
+    }
+
+    // a version 1 radio took over
+    mspWindow.active = false;
+    mspLegacyReplyPending = handleLegacyMspFrame(frameStart, frameLength);
+    return mspLegacyReplyPending;
+}
+
+bool sendMspReply(uint8_t payloadSize, mspResponseFnPtr responseFn)
+{
+    if (mspWindow.active) {
+        mspWindowSend(payloadSize, responseFn);
+        return mspWindowPending();
+    }
+
+    mspLegacyReplyPending = sendLegacyMspReply(payloadSize, responseFn);
+    return mspLegacyReplyPending;
+}
+
+bool isMspReplyPending(void)
+{
+    if (mspWindow.active) {
+        return mspWindowPending();
+    }
+
+    return mspLegacyReplyPending;
+}
+
 #endif
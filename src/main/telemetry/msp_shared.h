@@ -28,3 +28,4 @@ typedef union mspTxBuffer_u {
 void initSharedMsp(void);
 bool handleMspFrame(uint8_t *frameStart, int frameLength);
 bool sendMspReply(uint8_t payloadSize, mspResponseFnPtr responseFn);
+bool isMspReplyPending(void);
@@ -59,6 +59,7 @@
 #include "telemetry/telemetry.h"
 #include "telemetry/smartport.h"
 #include "telemetry/msp_shared.h"
+#include "telemetry/telemetry_scheduler.h"
 
 // these data identifiers are obtained from https://github.com/opentx/opentx/blob/2.3/radio/src/telemetry/frsky.h
 enum
@@ -95,43 +96,46 @@ enum
     FSSP_DATAID_GNSS            = 0x0480,
 };
 
-const uint16_t frSkyDataIdTable[] = {
-    FSSP_DATAID_SPEED,
-    FSSP_DATAID_VFAS,
-    FSSP_DATAID_CURRENT,
-    //FSSP_DATAID_RPM,
-    FSSP_DATAID_ALTITUDE,
-    FSSP_DATAID_FUEL,
-    //FSSP_DATAID_ADC1,
-    //FSSP_DATAID_ADC2,
-    FSSP_DATAID_LATLONG,
-    FSSP_DATAID_LATLONG, // twice
-    //FSSP_DATAID_CAP_USED,
-    FSSP_DATAID_VARIO,
-    //FSSP_DATAID_CELLS,
-    //FSSP_DATAID_CELLS_LAST,
-    FSSP_DATAID_HEADING,
-    FSSP_DATAID_FPV,
-    FSSP_DATAID_PITCH,
-    FSSP_DATAID_ROLL,
-    FSSP_DATAID_ACCX,
-    FSSP_DATAID_ACCY,
-    FSSP_DATAID_ACCZ,
-    FSSP_DATAID_MODES,
-    FSSP_DATAID_GNSS,
-    FSSP_DATAID_HOME_DIST,
-    FSSP_DATAID_GPS_ALT,
-    FSSP_DATAID_ASPD,
-    // FSSP_DATAID_A3,
-    FSSP_DATAID_A4,
-    FSSP_DATAID_AZIMUTH,
-    0
+// sensors sent by the telemetry schedule, attitude, altitude and position get the most slots
+static const struct {
+    uint16_t id;
+    telemetryRateClass_e rateClass;
+} frSkyDataIdTable[] = {
+    { FSSP_DATAID_SPEED,        TELEMETRY_RATE_NORMAL },
+    { FSSP_DATAID_VFAS,         TELEMETRY_RATE_NORMAL },
+    { FSSP_DATAID_CURRENT,      TELEMETRY_RATE_NORMAL },
+    //{ FSSP_DATAID_RPM,          TELEMETRY_RATE_NORMAL },
+    { FSSP_DATAID_ALTITUDE,     TELEMETRY_RATE_FAST },
+    { FSSP_DATAID_FUEL,         TELEMETRY_RATE_SLOW },
+    //{ FSSP_DATAID_ADC1,         TELEMETRY_RATE_SLOW },
+    //{ FSSP_DATAID_ADC2,         TELEMETRY_RATE_SLOW },
+    { FSSP_DATAID_LATLONG,      TELEMETRY_RATE_FAST },      // alternates between latitude and longitude
+    //{ FSSP_DATAID_CAP_USED,     TELEMETRY_RATE_SLOW },
+    { FSSP_DATAID_VARIO,        TELEMETRY_RATE_FAST },
+    //{ FSSP_DATAID_CELLS,        TELEMETRY_RATE_SLOW },
+    //{ FSSP_DATAID_CELLS_LAST,   TELEMETRY_RATE_SLOW },
+    { FSSP_DATAID_HEADING,      TELEMETRY_RATE_FAST },
+    { FSSP_DATAID_FPV,          TELEMETRY_RATE_NORMAL },
+    { FSSP_DATAID_PITCH,        TELEMETRY_RATE_FAST },
+    { FSSP_DATAID_ROLL,         TELEMETRY_RATE_FAST },
+    { FSSP_DATAID_ACCX,         TELEMETRY_RATE_NORMAL },
+    { FSSP_DATAID_ACCY,         TELEMETRY_RATE_NORMAL },
+    { FSSP_DATAID_ACCZ,         TELEMETRY_RATE_NORMAL },
+    { FSSP_DATAID_MODES,        TELEMETRY_RATE_FAST },
+    { FSSP_DATAID_GNSS,         TELEMETRY_RATE_SLOW },
+    { FSSP_DATAID_HOME_DIST,    TELEMETRY_RATE_NORMAL },
+    { FSSP_DATAID_GPS_ALT,      TELEMETRY_RATE_NORMAL },
+    { FSSP_DATAID_ASPD,         TELEMETRY_RATE_NORMAL },
+    //{ FSSP_DATAID_A3,           TELEMETRY_RATE_SLOW },
+    { FSSP_DATAID_A4,           TELEMETRY_RATE_SLOW },
+    { FSSP_DATAID_AZIMUTH,      TELEMETRY_RATE_NORMAL },
 };
 
 #define __USE_C99_MATH // for roundf()
 #define SMARTPORT_BAUD 57600
 #define SMARTPORT_UART_MODE MODE_RXTX
 #define SMARTPORT_SERVICE_TIMEOUT_MS 1 // max allowed time to find a value to send
+#define SMARTPORT_MSP_SLOTS_MAX 3 // MSP slots in a row before one goes to telemetry
 
 static serialPort_t *smartPortSerialPort = NULL; // The 'SmartPort'(tm) Port.
 static serialPortConfig_t *portConfig;
@@ -146,7 +150,9 @@ enum
 };
 
 static uint8_t telemetryState = TELEMETRY_STATE_UNINITIALIZED;
-static uint8_t smartPortIdCnt = 0;
+static telemetryScheduleEntry_t smartPortScheduleEntries[ARRAYLEN(frSkyDataIdTable)];
+static telemetrySchedule_t smartPortSchedule;
+static bool smartPortSendLongitude = false;
 
 typedef struct smartPortFrame_s {
     uint8_t  sensorId;
@@ -159,7 +165,7 @@ typedef struct smartPortFrame_s {
 static smartPortWriteFrameFn *smartPortWriteFrame;
 
 #if defined(USE_MSP_OVER_TELEMETRY)
-static bool smartPortMspReplyPending = false;
+static uint8_t smartPortMspSlots = 0;
 #endif
 
 static uint16_t frskyGetFlightMode(void)
@@ -213,13 +219,14 @@ static uint16_t frskyGetFlightMode(void)
 
 static uint16_t frskyGetGPSState(void)
 {
+    const telemetryGps_t *gps = telemetryGetGps();
     uint16_t tmpi = 0;
 
     // ones and tens columns (# of satellites 0 - 99)
-    tmpi += constrain(gpsSol.numSat, 0, 99);
+    tmpi += constrain(gps->numSat, 0, 99);
 
     // hundreds column (satellite accuracy HDOP: 0 = worst [HDOP > 5.5], 9 = best [HDOP <= 1.0])
-    tmpi += (9 - constrain((gpsSol.hdop - 51) / 50, 0, 9)) * 100;
+    tmpi += (9 - constrain((gps->hdop - 51) / 50, 0, 9)) * 100;
 
     // thousands column (GPS fix status)
     if (STATE(GPS_FIX))
@@ -341,6 +348,14 @@ static void smartPortSendPackage(uint16_t id, uint32_t val)
     smartPortWriteFrame(&payload);
 }
 
+static void smartPortInitSchedule(void)
+{
+    telemetryScheduleInit(&smartPortSchedule, smartPortScheduleEntries, ARRAYLEN(smartPortScheduleEntries));
+    for (unsigned i = 0; i < ARRAYLEN(frSkyDataIdTable); i++) {
+        telemetryScheduleAdd(&smartPortSchedule, frSkyDataIdTable[i].id, frSkyDataIdTable[i].rateClass);
+    }
+}
+
 bool initSmartPortTelemetry(void)
 {
     if (telemetryState == TELEMETRY_STATE_UNINITIALIZED) {
@@ -349,6 +364,10 @@ bool initSmartPortTelemetry(void)
             smartPortPortSharing = determinePortSharing(portConfig, FUNCTION_TELEMETRY_SMARTPORT);
 
             smartPortWriteFrame = smartPortWriteFrameInternal;
+            smartPortInitSchedule();
+#if defined(USE_MSP_OVER_TELEMETRY)
+            initSharedMsp();
+#endif
 
             telemetryState = TELEMETRY_STATE_INITIALIZED_SERIAL;
         }
@@ -363,6 +382,10 @@ bool initSmartPortTelemetryExternal(smartPortWriteFrameFn *smartPortWriteFrameEx
 {
     if (telemetryState == TELEMETRY_STATE_UNINITIALIZED) {
         smartPortWriteFrame = smartPortWriteFrameExternal;
+        smartPortInitSchedule();
+#if defined(USE_MSP_OVER_TELEMETRY)
+        initSharedMsp();
+#endif
 
         telemetryState = TELEMETRY_STATE_INITIALIZED_EXTERNAL;
 
@@ -433,7 +456,7 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
         if (smartPortPayloadContainsMSP(payload)) {
             // Pass only the payload: skip frameId
             uint8_t *frameStart = (uint8_t *)&payload->valueId;
-            smartPortMspReplyPending = handleMspFrame(frameStart, SMARTPORT_MSP_PAYLOAD_SIZE);
+            handleMspFrame(frameStart, SMARTPORT_MSP_PAYLOAD_SIZE);
         }
 #endif
     }
@@ -452,49 +475,46 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
         }
 
 #if defined(USE_MSP_OVER_TELEMETRY)
-        if (smartPortMspReplyPending) {
-            smartPortMspReplyPending = sendMspReply(SMARTPORT_MSP_PAYLOAD_SIZE, &smartPortSendMspResponse);
+        // MSP replies fill the slots, but telemetry keeps updating while they do
+        if (isMspReplyPending() && smartPortMspSlots < SMARTPORT_MSP_SLOTS_MAX) {
+            sendMspReply(SMARTPORT_MSP_PAYLOAD_SIZE, &smartPortSendMspResponse);
+            smartPortMspSlots++;
             *clearToSend = false;
 
             return;
         }
 #endif
 
-        // we can send back any data we want, our table keeps track of the order and frequency of each data type we send
-        uint16_t id = frSkyDataIdTable[smartPortIdCnt];
-        if (id == 0) { // end of table reached, loop back
-            smartPortIdCnt = 0;
-            id = frSkyDataIdTable[smartPortIdCnt];
-        }
-        smartPortIdCnt++;
+        // we can send back any data we want, the schedule keeps track of the order and frequency of each data type we send
+        uint16_t id = telemetryScheduleNext(&smartPortSchedule);
 
         switch (id) {
             case FSSP_DATAID_VFAS:
-                if (isBatteryVoltageConfigured()) {
-                    uint16_t vfasVoltage = telemetryConfig()->report_cell_voltage ? getBatteryAverageCellVoltage() : getBatteryVoltage();
+                if (telemetryGetBattery()->voltageConfigured) {
+                    uint16_t vfasVoltage = telemetryConfig()->report_cell_voltage ? telemetryGetBattery()->cellVoltage : telemetryGetBattery()->voltage;
                     smartPortSendPackage(id, vfasVoltage);
                     *clearToSend = false;
                 }
                 break;
             case FSSP_DATAID_CURRENT:
-                if (isAmperageConfigured()) {
-                    smartPortSendPackage(id, getAmperage() / 10); // given in 10mA steps, unknown requested unit
+                if (telemetryGetBattery()->amperageConfigured) {
+                    smartPortSendPackage(id, telemetryGetBattery()->amperage / 10); // given in 10mA steps, unknown requested unit
                     *clearToSend = false;
                 }
                 break;
             //case FSSP_DATAID_RPM:
             case FSSP_DATAID_ALTITUDE:
                 if (sensors(SENSOR_BARO)) {
-                    smartPortSendPackage(id, getEstimatedActualPosition(Z)); // unknown given unit, requested 100 = 1 meter
+                    smartPortSendPackage(id, telemetryGetAltitude()->altitude); // unknown given unit, requested 100 = 1 meter
                     *clearToSend = false;
                 }
                 break;
             case FSSP_DATAID_FUEL:
                 if (telemetryConfig()->smartportFuelUnit == SMARTPORT_FUEL_UNIT_PERCENT) {
-                    smartPortSendPackage(id, calculateBatteryPercentage()); // Show remaining battery % if smartport_fuel_percent=ON
+                    smartPortSendPackage(id, telemetryGetBattery()->remainingPercent); // Show remaining battery % if smartport_fuel_percent=ON
                     *clearToSend = false;
-                } else if (isAmperageConfigured()) {
-                    smartPortSendPackage(id, (telemetryConfig()->smartportFuelUnit == SMARTPORT_FUEL_UNIT_MAH ? getMAhDrawn() : getMWhDrawn()));
+                } else if (telemetryGetBattery()->amperageConfigured) {
+                    smartPortSendPackage(id, (telemetryConfig()->smartportFuelUnit == SMARTPORT_FUEL_UNIT_MAH ? telemetryGetBattery()->mAhDrawn : telemetryGetBattery()->mWhDrawn));
                     *clearToSend = false;
                 }
                 break;
@@ -503,23 +523,23 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
             //case FSSP_DATAID_CAP_USED:
             case FSSP_DATAID_VARIO:
                 if (sensors(SENSOR_BARO)) {
-                    smartPortSendPackage(id, lrintf(getEstimatedActualVelocity(Z))); // unknown given unit but requested in 100 = 1m/s
+                    smartPortSendPackage(id, telemetryGetAltitude()->vario); // unknown given unit but requested in 100 = 1m/s
                     *clearToSend = false;
                 }
                 break;
             case FSSP_DATAID_HEADING:
-                smartPortSendPackage(id, attitude.values.yaw * 10); // given in 10*deg, requested in 10000 = 100 deg
+                smartPortSendPackage(id, telemetryGetAttitude()->yaw * 10); // given in 10*deg, requested in 10000 = 100 deg
                 *clearToSend = false;
                 break;
             case FSSP_DATAID_PITCH:
                 if (telemetryConfig()->frsky_pitch_roll) {
-                    smartPortSendPackage(id, attitude.values.pitch); // given in 10*deg
+                    smartPortSendPackage(id, telemetryGetAttitude()->pitch); // given in 10*deg
                     *clearToSend = false;
                 }
                 break;
             case FSSP_DATAID_ROLL:
                 if (telemetryConfig()->frsky_pitch_roll) {
-                    smartPortSendPackage(id, attitude.values.roll); // given in 10*deg
+                    smartPortSendPackage(id, telemetryGetAttitude()->roll); // given in 10*deg
                     *clearToSend = false;
                 }
                 break;
@@ -566,55 +586,54 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
                 if (smartPortShouldSendGPSData()) {
                     //convert to knots: 1cm/s = 0.0194384449 knots
                     //Speed should be sent in knots/1000 (GPS speed is in cm/s)
-                    uint32_t tmpui = gpsSol.groundSpeed * 1944 / 100;
+                    uint32_t tmpui = telemetryGetGps()->groundSpeed * 1944 / 100;
                     smartPortSendPackage(id, tmpui);
                     *clearToSend = false;
                 }
                 break;
             case FSSP_DATAID_LATLONG:
                 if (smartPortShouldSendGPSData()) {
+                    const telemetryGps_t *gps = telemetryGetGps();
                     uint32_t tmpui = 0;
-                    // the same ID is sent twice, one for longitude, one for latitude
+                    // the same ID is used for both longitude and latitude
                     // the MSB of the sent uint32_t helps FrSky keep track
-                    // the even/odd bit of our counter helps us keep track
-                    if (smartPortIdCnt & 1) {
-                        tmpui = abs(gpsSol.llh.lon);  // now we have unsigned value and one bit to spare
+                    // we alternate between the two every time the ID is scheduled
+                    if (smartPortSendLongitude) {
+                        tmpui = abs(gps->lon);  // now we have unsigned value and one bit to spare
                         tmpui = (tmpui + tmpui / 2) / 25 | 0x80000000;  // 6/100 = 1.5/25, division by power of 2 is fast
-                        if (gpsSol.llh.lon < 0) tmpui |= 0x40000000;
+                        if (gps->lon < 0) tmpui |= 0x40000000;
                     }
                     else {
-                        tmpui = abs(gpsSol.llh.lat);  // now we have unsigned value and one bit to spare
+                        tmpui = abs(gps->lat);  // now we have unsigned value and one bit to spare
                         tmpui = (tmpui + tmpui / 2) / 25;  // 6/100 = 1.5/25, division by power of 2 is fast
-                        if (gpsSol.llh.lat < 0) tmpui |= 0x40000000;
+                        if (gps->lat < 0) tmpui |= 0x40000000;
                     }
+                    smartPortSendLongitude = !smartPortSendLongitude;
                     smartPortSendPackage(id, tmpui);
                     *clearToSend = false;
                 }
                 break;
             case FSSP_DATAID_HOME_DIST:
                 if (smartPortShouldSendGPSData()) {
-                    smartPortSendPackage(id, GPS_distanceToHome);
+                    smartPortSendPackage(id, telemetryGetGps()->distanceToHome);
                      *clearToSend = false;
                 }
                 break;
             case FSSP_DATAID_GPS_ALT:
                 if (smartPortShouldSendGPSData()) {
-                    smartPortSendPackage(id, gpsSol.llh.alt); // cm
+                    smartPortSendPackage(id, telemetryGetGps()->alt); // cm
                     *clearToSend = false;
                 }
                 break;
             case FSSP_DATAID_FPV:
                 if (smartPortShouldSendGPSData()) {
-                    smartPortSendPackage(id, gpsSol.groundCourse); // given in 10*deg
+                    smartPortSendPackage(id, telemetryGetGps()->groundCourse); // given in 10*deg
                     *clearToSend = false;
                 }
                 break;
             case FSSP_DATAID_AZIMUTH:
                 if (smartPortShouldSendGPSData()) {
-                    int16_t h = GPS_directionToHome;
-                    if (h < 0) {
-                        h += 360;
-                    }
+                    int16_t h = telemetryGetGps()->directionToHome;
                     if(h >= 180)
                         h = h - 180;
                     else
@@ -625,8 +644,8 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
                 break;
 #endif
             case FSSP_DATAID_A4:
-                if (isBatteryVoltageConfigured()) {
-                    smartPortSendPackage(id, getBatteryAverageCellVoltage());
+                if (telemetryGetBattery()->voltageConfigured) {
+                    smartPortSendPackage(id, telemetryGetBattery()->cellVoltage);
                     *clearToSend = false;
                 }
                 break;
@@ -640,8 +659,14 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
                 break;
             default:
                 break;
-                // if nothing is sent, hasRequest isn't cleared, we already incremented the counter, just loop back to the start
+                // if nothing is sent, hasRequest isn't cleared, the schedule already moved on, just loop back to the start
         }
+
+#if defined(USE_MSP_OVER_TELEMETRY)
+        if (!*clearToSend) {
+            smartPortMspSlots = 0;
+        }
+#endif
     }
 }
 
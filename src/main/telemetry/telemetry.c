@@ -43,6 +43,7 @@
 #include "rx/rx.h"
 
 #include "telemetry/telemetry.h"
+#include "telemetry/telemetry_scheduler.h"
 #include "telemetry/hott.h"
 #include "telemetry/smartport.h"
 #include "telemetry/ltm.h"
@@ -213,6 +214,8 @@ void telemetryProcess(timeUs_t currentTimeUs)
 {
     UNUSED(currentTimeUs); // since not used by all the telemetry protocols
 
+    telemetryDataInvalidate();
+
 #if defined(USE_TELEMETRY_HOTT)
     handleHoTTTelemetry(currentTimeUs);
 #endif
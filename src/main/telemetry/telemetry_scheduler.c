@@ -0,0 +1,175 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include "platform.h"
+
+#ifdef USE_TELEMETRY
+
+#include "common/axis.h"
+#include "common/maths.h"
+
+#include "flight/imu.h"
+
+#include "io/gps.h"
+
+#include "navigation/navigation.h"
+
+#include "sensors/battery.h"
+
+#include "telemetry/telemetry_scheduler.h"
+
+// Bumped on every telemetry task run, a group is refreshed on its first use after that
+static uint32_t telemetryDataTick = 1;
+
+static struct {
+    uint32_t attitude;
+    uint32_t battery;
+    uint32_t gps;
+    uint32_t altitude;
+} telemetryDataUpdatedTick;
+
+static telemetryAttitude_t telemetryAttitude;
+static telemetryBattery_t telemetryBattery;
+static telemetryGps_t telemetryGps;
+static telemetryAltitude_t telemetryAltitude;
+
+void telemetryDataInvalidate(void)
+{
+    telemetryDataTick++;
+}
+
+const telemetryAttitude_t *telemetryGetAttitude(void)
+{
+    if (telemetryDataUpdatedTick.attitude != telemetryDataTick) {
+        telemetryDataUpdatedTick.attitude = telemetryDataTick;
+
+        const attitudeEulerAngles_t *attitude = imuGetAttitude();
+        telemetryAttitude.roll = attitude->values.roll;
+        telemetryAttitude.pitch = attitude->values.pitch;
+        telemetryAttitude.yaw = attitude->values.yaw;
+    }
+
+    return &telemetryAttitude;
+}
+
+const telemetryBattery_t *telemetryGetBattery(void)
+{
+    if (telemetryDataUpdatedTick.battery != telemetryDataTick) {
+        telemetryDataUpdatedTick.battery = telemetryDataTick;
+
+        telemetryBattery.voltageConfigured = isBatteryVoltageConfigured();
+        telemetryBattery.amperageConfigured = isAmperageConfigured();
+        telemetryBattery.voltage = getBatteryVoltage();
+        telemetryBattery.cellVoltage = getBatteryAverageCellVoltage();
+        telemetryBattery.amperage = getAmperage();
+        telemetryBattery.remainingPercent = calculateBatteryPercentage();
+        telemetryBattery.mAhDrawn = getMAhDrawn();
+        telemetryBattery.mWhDrawn = getMWhDrawn();
+    }
+
+    return &telemetryBattery;
+}
+
+const telemetryGps_t *telemetryGetGps(void)
+{
+#ifdef USE_GPS
+    if (telemetryDataUpdatedTick.gps != telemetryDataTick) {
+        telemetryDataUpdatedTick.gps = telemetryDataTick;
+
+        telemetryGps.fixType = gpsSol.fixType;
+        telemetryGps.numSat = gpsSol.numSat;
+        telemetryGps.hdop = gpsSol.hdop;
+        telemetryGps.lat = gpsSol.llh.lat;
+        telemetryGps.lon = gpsSol.llh.lon;
+        telemetryGps.alt = gpsSol.llh.alt;
+        telemetryGps.groundSpeed = gpsSol.groundSpeed;
+        telemetryGps.groundCourse = gpsSol.groundCourse;
+        telemetryGps.distanceToHome = GPS_distanceToHome;
+        telemetryGps.directionToHome = (GPS_directionToHome < 0) ? GPS_directionToHome + 360 : GPS_directionToHome;
+    }
+#endif
+
+    return &telemetryGps;
+}
+
+const telemetryAltitude_t *telemetryGetAltitude(void)
+{
+    if (telemetryDataUpdatedTick.altitude != telemetryDataTick) {
+        telemetryDataUpdatedTick.altitude = telemetryDataTick;
+
+        telemetryAltitude.altitude = lrintf(getEstimatedActualPosition(Z));
+        telemetryAltitude.vario = lrintf(getEstimatedActualVelocity(Z));
+    }
+
+    return &telemetryAltitude;
+}
+
+void telemetryScheduleInit(telemetrySchedule_t *schedule, telemetryScheduleEntry_t *entries, uint8_t maxCount)
+{
+    schedule->entries = entries;
+    schedule->count = 0;
+    schedule->maxCount = maxCount;
+    schedule->totalWeight = 0;
+}
+
+void telemetryScheduleAdd(telemetrySchedule_t *schedule, uint16_t id, telemetryRateClass_e rateClass)
+{
+    if (schedule->count >= schedule->maxCount) {
+        return;
+    }
+
+    telemetryScheduleEntry_t *entry = &schedule->entries[schedule->count++];
+    entry->id = id;
+    entry->weight = rateClass;
+    entry->credit = 0;
+
+    schedule->totalWeight += rateClass;
+}
+
+uint16_t telemetryScheduleNext(telemetrySchedule_t *schedule)
+{
+    if (schedule->count == 0) {
+        return 0;
+    }
+
+    telemetryScheduleEntry_t *next = &schedule->entries[0];
+
+    for (unsigned i = 0; i < schedule->count; i++) {
+        telemetryScheduleEntry_t *entry = &schedule->entries[i];
+        entry->credit += entry->weight;
+        if (entry->credit > next->credit) {
+            next = entry;
+        }
+    }
+
+    next->credit -= schedule->totalWeight;
+    return next->id;
+}
+
+#endif
@@ -0,0 +1,108 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Values shared by the telemetry protocols. Each group is read from the flight
+ * controller at most once per telemetry task run, no matter how many protocols
+ * and frames use it.
+ */
+
+typedef struct telemetryAttitude_s {
+    int16_t roll;               // decidegrees
+    int16_t pitch;              // decidegrees
+    int16_t yaw;                // decidegrees, 0..3599
+} telemetryAttitude_t;
+
+typedef struct telemetryBattery_s {
+    bool voltageConfigured;
+    bool amperageConfigured;
+    uint16_t voltage;           // 0.01V
+    uint16_t cellVoltage;       // 0.01V
+    int16_t amperage;           // 0.01A
+    uint8_t remainingPercent;
+    int32_t mAhDrawn;
+    int32_t mWhDrawn;
+} telemetryBattery_t;
+
+typedef struct telemetryGps_s {
+    uint8_t fixType;
+    uint8_t numSat;
+    uint16_t hdop;
+    int32_t lat;                // deg * 1e7
+    int32_t lon;                // deg * 1e7
+    int32_t alt;                // cm, above MSL
+    uint16_t groundSpeed;       // cm/s
+    uint16_t groundCourse;      // decidegrees
+    uint32_t distanceToHome;    // m
+    int16_t directionToHome;    // degrees, 0..359
+} telemetryGps_t;
+
+typedef struct telemetryAltitude_s {
+    int32_t altitude;           // cm, estimated, above home
+    int16_t vario;              // cm/s
+} telemetryAltitude_t;
+
+void telemetryDataInvalidate(void);
+
+const telemetryAttitude_t *telemetryGetAttitude(void);
+const telemetryBattery_t *telemetryGetBattery(void);
+const telemetryGps_t *telemetryGetGps(void);
+const telemetryAltitude_t *telemetryGetAltitude(void);
+
+/*
+ * Frame scheduler shared by the protocols that pick what to send next themselves.
+ * Frames get a share of the slots proportional to their rate class and are spread
+ * out evenly (smooth weighted round robin), so a FAST frame goes out 4 times as
+ * often as a SLOW one and never in a burst.
+ */
+
+typedef enum {
+    TELEMETRY_RATE_SLOW = 1,
+    TELEMETRY_RATE_NORMAL = 2,
+    TELEMETRY_RATE_FAST = 4,
+} telemetryRateClass_e;
+
+typedef struct telemetryScheduleEntry_s {
+    uint16_t id;                // Protocol defined frame or sensor id
+    uint8_t weight;
+    int16_t credit;
+} telemetryScheduleEntry_t;
+
+typedef struct telemetrySchedule_s {
+    telemetryScheduleEntry_t *entries;
+    uint8_t count;
+    uint8_t maxCount;
+    uint16_t totalWeight;
+} telemetrySchedule_t;
+
+void telemetryScheduleInit(telemetrySchedule_t *schedule, telemetryScheduleEntry_t *entries, uint8_t maxCount);
+void telemetryScheduleAdd(telemetrySchedule_t *schedule, uint16_t id, telemetryRateClass_e rateClass);
+uint16_t telemetryScheduleNext(telemetrySchedule_t *schedule);
+
+static inline uint8_t telemetryScheduleCount(const telemetrySchedule_t *schedule) { return schedule->count; }
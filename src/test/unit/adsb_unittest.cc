@@ -0,0 +1,244 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+
+extern "C" {
+    #include "platform.h"
+    #include "common/maths.h"
+    #include "common/vector.h"
+    #include "fc/runtime_config.h"
+    #include "io/gps.h"
+    #include "navigation/navigation.h"
+    #include "io/adsb.h"
+
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wunused-function"
+    #include "common/mavlink.h"
+    #pragma GCC diagnostic pop
+
+    void adsbCalculateConflict(const fpVector3_t *relPos, const fpVector3_t *relVel, adsbVehicleCalculatedValues_t *calc);
+    adsbVehicle_t *findVehicleByIcao(uint32_t avicao);
+
+    uint32_t stateFlags;
+    gpsSolutionData_t gpsSol;
+    gpsLocation_t GPS_home;
+    fpVector3_t testOwnVelocity;
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define TEST_LAT    500000000
+#define TEST_LON    150000000
+#define TEST_CM_PER_LAT_UNIT    1.113195f   // Same as DISTANCE_BETWEEN_TWO_LONGITUDE_POINTS_AT_EQUATOR
+
+extern "C" {
+    float getEstimatedActualPosition(int axis) { UNUSED(axis); return 0.0f; }
+    float getEstimatedActualVelocity(int axis) { return testOwnVelocity.v[axis]; }
+}
+
+static void setOwnState(float velNorth, float velEast)
+{
+    ENABLE_STATE(GPS_FIX);
+    gpsSol.numSat = 12;
+    gpsSol.llh.lat = TEST_LAT;
+    gpsSol.llh.lon = TEST_LON;
+    GPS_home.alt = 0;
+    testOwnVelocity.x = velNorth;
+    testOwnVelocity.y = velEast;
+    testOwnVelocity.z = 0.0f;
+}
+
+// Plane at given offset from FC in meters, flying course (degrees) with speed (m/s)
+static void feedVehicle(uint32_t icao, float north, float east, float up, float course, float speed)
+{
+    const float scaleLonDown = cos_approx(DEGREES_TO_RADIANS(TEST_LAT / 10000000.0f));
+    adsbVehicleValues_t *v = getVehicleForFill();
+
+    v->icao = icao;
+    v->lat = TEST_LAT + lrintf(METERS_TO_CENTIMETERS(north) / TEST_CM_PER_LAT_UNIT);
+    v->lon = TEST_LON + lrintf(METERS_TO_CENTIMETERS(east) / TEST_CM_PER_LAT_UNIT / scaleLonDown);
+    v->alt = METERS_TO_CENTIMETERS(up);
+    v->heading = course * 100;
+    v->horVelocity = METERS_TO_CENTIMETERS(speed);
+    v->verVelocity = 0;
+    v->flags = ADSB_FLAGS_VALID_COORDS | ADSB_FLAGS_VALID_ALTITUDE | ADSB_FLAGS_VALID_HEADING | ADSB_FLAGS_VALID_VELOCITY;
+    v->tslc = 0;
+
+    adsbNewVehicle(v);
+}
+
+static void clearVehicles(void)
+{
+    for (int i = 0; i < MAX_ADSB_VEHICLES; i++) {
+        findVehicle(i)->ttl = 0;
+    }
+}
+
+TEST(AdsbTest, ConflictHeadOn)
+{
+    adsbVehicleCalculatedValues_t calc;
+
+    // 3km north, coming straight at us with 50 m/s
+    fpVector3_t relPos = { .v = { 300000.0f, 0.0f, 0.0f } };
+    fpVector3_t relVel = { .v = { -5000.0f, 0.0f, 0.0f } };
+    adsbCalculateConflict(&relPos, &relVel, &calc);
+
+    EXPECT_EQ(calc.closingRate, 5000);
+    EXPECT_EQ(calc.cpaTime, 600);
+    EXPECT_NEAR(calc.cpaDist, 0, 2);
+    EXPECT_NEAR(calc.conflictTime, (300000 - ADSB_CONFLICT_RADIUS_CM) / 500, 1);
+    EXPECT_EQ(calc.threatLevel, ADSB_THREAT_LOW);
+
+    // Same plane 5km away enters protected radius after the horizon
+    relPos.x = 500000.0f;
+    adsbCalculateConflict(&relPos, &relVel, &calc);
+    EXPECT_EQ(calc.conflictTime, ADSB_NO_CONFLICT);
+    EXPECT_EQ(calc.threatLevel, ADSB_THREAT_NONE);
+
+    // Already inside protected radius
+    relPos.x = 20000.0f;
+    adsbCalculateConflict(&relPos, &relVel, &calc);
+    EXPECT_EQ(calc.conflictTime, 0);
+    EXPECT_EQ(calc.threatLevel, ADSB_THREAT_HIGH);
+}
+
+TEST(AdsbTest, ConflictMissAndSeparation)
+{
+    adsbVehicleCalculatedValues_t calc;
+
+    // Crossing 1km to the east, never closer than 1km
+    fpVector3_t relPos = { .v = { 100000.0f, 100000.0f, 0.0f } };
+    fpVector3_t relVel = { .v = { -5000.0f, 0.0f, 0.0f } };
+    adsbCalculateConflict(&relPos, &relVel, &calc);
+
+    EXPECT_EQ(calc.cpaTime, 200);
+    EXPECT_NEAR(calc.cpaDist, 100000, 100);
+    EXPECT_EQ(calc.threatLevel, ADSB_THREAT_NONE);
+
+    // Diverging
+    relVel.x = 5000.0f;
+    adsbCalculateConflict(&relPos, &relVel, &calc);
+    EXPECT_EQ(calc.cpaTime, 0);
+    EXPECT_LT(calc.closingRate, 0);
+    EXPECT_EQ(calc.threatLevel, ADSB_THREAT_NONE);
+
+    // Head on but 300m above
+    relPos.y = 0.0f;
+    relPos.z = 30000.0f;
+    relVel.x = -5000.0f;
+    adsbCalculateConflict(&relPos, &relVel, &calc);
+    EXPECT_EQ(calc.cpaVerticalDistance, 30000);
+    EXPECT_EQ(calc.threatLevel, ADSB_THREAT_NONE);
+
+    // Descending into our altitude band by closest approach
+    relVel.z = -1000.0f;
+    adsbCalculateConflict(&relPos, &relVel, &calc);
+    EXPECT_EQ(calc.cpaVerticalDistance, 10000);
+    EXPECT_EQ(calc.threatLevel, ADSB_THREAT_HIGH);
+}
+
+TEST(AdsbTest, IcaoIndexSurvivesChurn)
+{
+    setOwnState(0.0f, 0.0f);
+    clearVehicles();
+    srand(1234);
+
+    for (int n = 0; n < 2000; n++) {
+        // Small ICAO range forces both updates of known planes and slot reuse
+        const uint32_t icao = 0x400000 + (rand() % 64) * 0x40;
+        const float dist = 1000.0f + (rand() % 50000);
+        feedVehicle(icao, dist, 0.0f, 1000.0f, 0.0f, 0.0f);
+
+        if ((rand() % 8) == 0) {
+            findVehicle(rand() % MAX_ADSB_VEHICLES)->ttl = 0;
+        }
+
+        // Every plane in the list must be found by its ICAO, and nothing else
+        for (int i = 0; i < MAX_ADSB_VEHICLES; i++) {
+            adsbVehicle_t *vehicle = findVehicle(i);
+            if (vehicle->vehicleValues.icao != 0) {
+                ASSERT_EQ(findVehicleByIcao(vehicle->vehicleValues.icao), vehicle);
+            }
+        }
+
+        ASSERT_EQ(findVehicleByIcao(icao)->vehicleValues.icao, icao);
+        ASSERT_EQ(findVehicleByIcao(0x400001), (adsbVehicle_t *)NULL);
+    }
+}
+
+TEST(AdsbTest, ThreatsRankedByTimeToConflict)
+{
+    setOwnState(0.0f, 0.0f);
+    clearVehicles();
+
+    // Far plane, but fast and coming at us from the east
+    feedVehicle(0xA00001, 0.0f, 4000.0f, 0.0f, 270.0f, 100.0f);
+    // Closest plane, flying away
+    feedVehicle(0xA00002, -800.0f, 0.0f, 0.0f, 180.0f, 30.0f);
+    // Slow plane converging from the north
+    feedVehicle(0xA00003, 2000.0f, 0.0f, 0.0f, 180.0f, 30.0f);
+    // Well above us
+    feedVehicle(0xA00004, 0.0f, 1500.0f, 1000.0f, 270.0f, 30.0f);
+
+    adsbUpdateVehicles();
+
+    EXPECT_EQ(findVehicleClosest()->vehicleValues.icao, 0xA00002u);
+    ASSERT_EQ(getThreatVehiclesCount(), 2);
+    EXPECT_EQ(findVehicleMostThreatening()->vehicleValues.icao, 0xA00001u);
+    EXPECT_EQ(findVehicleByThreatRank(1)->vehicleValues.icao, 0xA00003u);
+    EXPECT_EQ(findVehicleByThreatRank(2), (adsbVehicle_t *)NULL);
+
+    // Expired plane drops out of the ranking
+    findVehicleByIcao(0xA00001)->ttl = 0;
+    EXPECT_EQ(findVehicleMostThreatening()->vehicleValues.icao, 0xA00003u);
+}
+
+TEST(AdsbTest, PositionAcrossAntimeridian)
+{
+    setOwnState(0.0f, 0.0f);
+    clearVehicles();
+    gpsSol.llh.lat = 0;
+    gpsSol.llh.lon = 1799900000;
+
+    // 0.02 degrees east of us, on the other side of the antimeridian
+    adsbVehicleValues_t *v = getVehicleForFill();
+    v->icao = 0xA00005;
+    v->lat = 0;
+    v->lon = -1799900000;
+    v->alt = 0;
+    v->flags = ADSB_FLAGS_VALID_COORDS | ADSB_FLAGS_VALID_ALTITUDE;
+    v->tslc = 0;
+    adsbNewVehicle(v);
+    adsbUpdateVehicles();
+
+    const adsbVehicle_t *vehicle = findVehicleByIcao(0xA00005);
+    ASSERT_NE(vehicle, (adsbVehicle_t *)NULL);
+    EXPECT_NEAR(vehicle->calculatedVehicleValues.dist, 200000 * TEST_CM_PER_LAT_UNIT, 100);
+    EXPECT_NEAR(vehicle->calculatedVehicleValues.dir, 9000, 10);
+}
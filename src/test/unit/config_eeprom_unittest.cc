@@ -0,0 +1,343 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+
+#include <stdint.h>
+#include <string.h>
+
+#include <vector>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/crc.h"
+
+    #include "config/config_eeprom.h"
+    #include "config/config_streamer.h"
+    #include "config/parameter_group.h"
+
+    #include "drivers/system.h"
+    #include "drivers/time.h"
+
+    #include "fc/config.h"
+
+    typedef struct {
+        uint32_t a;
+        uint16_t b;
+    } __attribute__((packed)) testSystemConfig_t;
+
+    typedef struct {
+        uint8_t rate;
+        uint8_t expo;
+    } testProfileConfig_t;
+
+    static testSystemConfig_t testSystemConfig;
+    static testSystemConfig_t testSystemConfigCopy;
+    static testProfileConfig_t testProfileConfig[MAX_PROFILE_COUNT];
+    static testProfileConfig_t testProfileConfigCopy[MAX_PROFILE_COUNT];
+    static uint8_t *testProfileConfigCurrent;
+
+    static void pgResetFn_testSystemConfig(void *base)
+    {
+        testSystemConfig_t *config = (testSystemConfig_t *)base;
+        config->a = 1;
+        config->b = 2;
+    }
+
+    static void pgResetFn_testProfileConfig(void *base)
+    {
+        testProfileConfig_t *config = (testProfileConfig_t *)base;
+        config->rate = 70;
+        config->expo = 30;
+    }
+
+    // PG_FOREACH walks the registry between __pg_registry_start and
+    // __pg_registry_end, which the firmware linker scripts provide
+    const pgRegistry_t __pg_registry_start[] = {
+        {
+            .pgn = 10 | (1 << 12),
+            .size = sizeof(testSystemConfig_t) | PGR_SIZE_SYSTEM_FLAG,
+            .address = (uint8_t *)&testSystemConfig,
+            .copy = (uint8_t *)&testSystemConfigCopy,
+            .ptr = NULL,
+            .reset = { .fn = pgResetFn_testSystemConfig },
+        },
+        {
+            .pgn = 11 | (2 << 12),
+            .size = sizeof(testProfileConfig_t) | PGR_SIZE_PROFILE_FLAG,
+            .address = (uint8_t *)&testProfileConfig,
+            .copy = (uint8_t *)&testProfileConfigCopy,
+            .ptr = &testProfileConfigCurrent,
+            .reset = { .fn = pgResetFn_testProfileConfig },
+        },
+    };
+
+    uint8_t __config_start;
+    uint8_t __config_end;
+
+    static timeMs_t testMillis;
+}
+
+#define TEST_PG_COUNT 2
+static_assert(sizeof(pgRegistry_t) == 40, "registry end offset below assumes LP64 layout");
+asm(".globl __pg_registry_end\n\t.set __pg_registry_end, __pg_registry_start + 2 * 40");
+static_assert(sizeof(__pg_registry_start) == TEST_PG_COUNT * sizeof(pgRegistry_t), "update registry end offset");
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define TEST_PGN_SYSTEM     10
+#define TEST_PGN_PROFILE    11
+#define TEST_PGN_UNKNOWN    99
+
+typedef std::vector<uint8_t> snapshotStream_t;
+
+static void streamAppend(snapshotStream_t &stream, const void *data, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    stream.insert(stream.end(), p, p + len);
+}
+
+static void streamAppendRecord(snapshotStream_t &stream, uint16_t pgn, uint8_t version, uint8_t flags, const void *data, uint16_t len)
+{
+    const uint16_t size = 6 + len;
+    const uint8_t header[6] = { (uint8_t)size, (uint8_t)(size >> 8), (uint8_t)pgn, (uint8_t)(pgn >> 8), version, flags };
+    streamAppend(stream, header, sizeof(header));
+    streamAppend(stream, data, len);
+}
+
+static void streamFinish(snapshotStream_t &stream)
+{
+    const uint8_t footer[2] = { 0, 0 };
+    streamAppend(stream, footer, sizeof(footer));
+    const uint16_t crc = crc16_ccitt_update(0, stream.data(), stream.size());
+    const uint8_t checksum[2] = { (uint8_t)crc, (uint8_t)(crc >> 8) };
+    streamAppend(stream, checksum, sizeof(checksum));
+}
+
+// Same layout writeConfigToEEPROM() produces, with one PG this build does not know about
+static snapshotStream_t buildSnapshot(void)
+{
+    snapshotStream_t stream;
+    const uint8_t format = EEPROM_CONF_VERSION;
+    streamAppend(stream, &format, 1);
+
+    const testSystemConfig_t system = { 0x12345678, 0xabcd };
+    streamAppendRecord(stream, TEST_PGN_SYSTEM, 1, 0, &system, sizeof(system));
+
+    const uint8_t unknown[5] = { 1, 2, 3, 4, 5 };
+    streamAppendRecord(stream, TEST_PGN_UNKNOWN, 0, 0, unknown, sizeof(unknown));
+
+    for (uint8_t profile = 0; profile < MAX_PROFILE_COUNT; profile++) {
+        const testProfileConfig_t config = { (uint8_t)(10 + profile), (uint8_t)(20 + profile) };
+        streamAppendRecord(stream, TEST_PGN_PROFILE, 2, profile + 1, &config, sizeof(config));
+    }
+
+    streamFinish(stream);
+    return stream;
+}
+
+static configSnapshotStatus_e importInChunks(const snapshotStream_t &stream, size_t chunkSize)
+{
+    configSnapshotImportStart();
+    configSnapshotStatus_e status = CONFIG_SNAPSHOT_IN_PROGRESS;
+    for (size_t offset = 0; offset < stream.size() && status == CONFIG_SNAPSHOT_IN_PROGRESS; offset += chunkSize) {
+        const size_t len = std::min(chunkSize, stream.size() - offset);
+        status = configSnapshotImportWrite(offset, &stream[offset], len);
+    }
+    return status;
+}
+
+static void resetLiveConfig(void)
+{
+    pgResetFn_testSystemConfig(&testSystemConfig);
+    for (int i = 0; i < MAX_PROFILE_COUNT; i++) {
+        pgResetFn_testProfileConfig(&testProfileConfig[i]);
+    }
+    testMillis = 0;
+}
+
+TEST(ConfigSnapshotTest, ImportsStreamInAnyChunkSize)
+{
+    const snapshotStream_t stream = buildSnapshot();
+
+    for (size_t chunkSize : { (size_t)1, (size_t)7, stream.size() }) {
+        resetLiveConfig();
+
+        EXPECT_EQ(CONFIG_SNAPSHOT_COMPLETE, importInChunks(stream, chunkSize));
+        EXPECT_EQ(stream.size(), configSnapshotImportOffset());
+        EXPECT_FALSE(configSnapshotImportActive());
+
+        EXPECT_EQ(0x12345678u, testSystemConfig.a);
+        EXPECT_EQ(0xabcd, testSystemConfig.b);
+        for (int i = 0; i < MAX_PROFILE_COUNT; i++) {
+            EXPECT_EQ(10 + i, testProfileConfig[i].rate);
+            EXPECT_EQ(20 + i, testProfileConfig[i].expo);
+        }
+    }
+}
+
+TEST(ConfigSnapshotTest, MissingProfilesFallBackToDefaults)
+{
+    snapshotStream_t stream;
+    const uint8_t format = EEPROM_CONF_VERSION;
+    streamAppend(stream, &format, 1);
+    const testProfileConfig_t config = { 5, 6 };
+    streamAppendRecord(stream, TEST_PGN_PROFILE, 2, 2, &config, sizeof(config));
+    streamFinish(stream);
+
+    resetLiveConfig();
+    testSystemConfig.a = 77;
+    testProfileConfig[0].rate = 99;
+
+    EXPECT_EQ(CONFIG_SNAPSHOT_COMPLETE, importInChunks(stream, 4));
+    EXPECT_EQ(1u, testSystemConfig.a);
+    EXPECT_EQ(70, testProfileConfig[0].rate);
+    EXPECT_EQ(5, testProfileConfig[1].rate);
+    EXPECT_EQ(70, testProfileConfig[2].rate);
+}
+
+TEST(ConfigSnapshotTest, ResumesFromReportedOffset)
+{
+    const snapshotStream_t stream = buildSnapshot();
+    resetLiveConfig();
+
+    configSnapshotImportStart();
+    EXPECT_EQ(CONFIG_SNAPSHOT_IN_PROGRESS, configSnapshotImportWrite(0, &stream[0], 10));
+
+    // Chunk 10..19 lost, the next one is rejected and the expected offset reported
+    EXPECT_EQ(CONFIG_SNAPSHOT_ERROR_OFFSET, configSnapshotImportWrite(20, &stream[20], 10));
+    EXPECT_EQ(10u, configSnapshotImportOffset());
+
+    // A retransmitted chunk that was already accepted is rejected as well
+    EXPECT_EQ(CONFIG_SNAPSHOT_ERROR_OFFSET, configSnapshotImportWrite(0, &stream[0], 10));
+    EXPECT_TRUE(configSnapshotImportActive());
+
+    const uint32_t resume = configSnapshotImportOffset();
+    EXPECT_EQ(CONFIG_SNAPSHOT_COMPLETE, configSnapshotImportWrite(resume, &stream[resume], stream.size() - resume));
+    EXPECT_EQ(0x12345678u, testSystemConfig.a);
+    EXPECT_EQ(12, testProfileConfig[2].rate);
+}
+
+TEST(ConfigSnapshotTest, ChecksumMismatchLeavesConfigIntact)
+{
+    snapshotStream_t stream = buildSnapshot();
+    stream[8] ^= 0x01;
+    resetLiveConfig();
+
+    EXPECT_EQ(CONFIG_SNAPSHOT_ERROR_CRC, importInChunks(stream, 16));
+    EXPECT_FALSE(configSnapshotImportActive());
+    EXPECT_EQ(1u, testSystemConfig.a);
+    EXPECT_EQ(70, testProfileConfig[0].rate);
+
+    // Failure is sticky until the import is restarted
+    EXPECT_EQ(CONFIG_SNAPSHOT_ERROR_CRC, configSnapshotImportWrite(configSnapshotImportOffset(), &stream[0], 1));
+}
+
+TEST(ConfigSnapshotTest, RejectsVersionMismatchAndBadFormat)
+{
+    resetLiveConfig();
+
+    snapshotStream_t stream;
+    const uint8_t format = EEPROM_CONF_VERSION;
+    streamAppend(stream, &format, 1);
+    const testSystemConfig_t system = { 3, 4 };
+    streamAppendRecord(stream, TEST_PGN_SYSTEM, 2, 0, &system, sizeof(system));
+    streamFinish(stream);
+
+    EXPECT_EQ(CONFIG_SNAPSHOT_ERROR_PG_VERSION, importInChunks(stream, stream.size()));
+    EXPECT_EQ(TEST_PGN_SYSTEM, configSnapshotImportFailedPgn());
+
+    // Profile PG stored as a system record
+    stream.clear();
+    streamAppend(stream, &format, 1);
+    const testProfileConfig_t config = { 5, 6 };
+    streamAppendRecord(stream, TEST_PGN_PROFILE, 2, 0, &config, sizeof(config));
+    streamFinish(stream);
+
+    EXPECT_EQ(CONFIG_SNAPSHOT_ERROR_FORMAT, importInChunks(stream, stream.size()));
+    EXPECT_EQ(TEST_PGN_PROFILE, configSnapshotImportFailedPgn());
+
+    const uint8_t badFormat = EEPROM_CONF_VERSION + 1;
+    configSnapshotImportStart();
+    EXPECT_EQ(CONFIG_SNAPSHOT_ERROR_FORMAT, configSnapshotImportWrite(0, &badFormat, 1));
+
+    EXPECT_EQ(1u, testSystemConfig.a);
+}
+
+TEST(ConfigSnapshotTest, AbandonedImportReleasesCopyArea)
+{
+    const snapshotStream_t stream = buildSnapshot();
+    resetLiveConfig();
+
+    configSnapshotImportStart();
+    EXPECT_EQ(CONFIG_SNAPSHOT_IN_PROGRESS, configSnapshotImportWrite(0, &stream[0], 10));
+    testMillis += 4000;
+    EXPECT_TRUE(configSnapshotImportActive());
+    EXPECT_EQ(CONFIG_SNAPSHOT_IN_PROGRESS, configSnapshotImportWrite(10, &stream[10], 10));
+
+    testMillis += 6000;
+    EXPECT_FALSE(configSnapshotImportActive());
+    EXPECT_EQ(CONFIG_SNAPSHOT_ERROR_TIMEOUT, configSnapshotImportWrite(20, &stream[20], 10));
+    EXPECT_EQ(1u, testSystemConfig.a);
+}
+
+// STUBS
+extern "C" {
+    const pgRegistry_t* pgFind(pgn_t pgn)
+    {
+        for (int i = 0; i < TEST_PG_COUNT; i++) {
+            if (pgN(&__pg_registry_start[i]) == pgn) {
+                return &__pg_registry_start[i];
+            }
+        }
+        return NULL;
+    }
+
+    bool pgResetCopy(void *copy, pgn_t pgn)
+    {
+        const pgRegistry_t *reg = pgFind(pgn);
+        if (reg) {
+            reg->reset.fn(copy);
+            return true;
+        }
+        return false;
+    }
+
+    void pgReset(const pgRegistry_t* reg, int profileIndex) { UNUSED(reg); UNUSED(profileIndex); }
+    void pgLoad(const pgRegistry_t* reg, int profileIndex, const void *from, int size, int version)
+    {
+        UNUSED(reg); UNUSED(profileIndex); UNUSED(from); UNUSED(size); UNUSED(version);
+    }
+
+    void config_streamer_init(config_streamer_t *c) { UNUSED(c); }
+    void config_streamer_start(config_streamer_t *c, uintptr_t base, int size) { UNUSED(c); UNUSED(base); UNUSED(size); }
+    int config_streamer_write(config_streamer_t *c, const uint8_t *p, uint32_t size) { UNUSED(c); UNUSED(p); UNUSED(size); return 0; }
+    int config_streamer_flush(config_streamer_t *c) { UNUSED(c); return 0; }
+    int config_streamer_finish(config_streamer_t *c) { UNUSED(c); return 0; }
+
+    void failureMode(failureMode_e mode) { UNUSED(mode); }
+
+    timeMs_t millis(void) { return testMillis; }
+}
@@ -0,0 +1,185 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <chrono>
+
+extern "C" {
+    #include "platform.h"
+    #include "common/crc.h"
+    #include "common/streambuf.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define TEST_BUFFER_SIZE    1024
+
+// Bitwise implementations the tables were generated from
+static uint16_t refCrc16Ccitt(uint16_t crc, const uint8_t *data, uint32_t length)
+{
+    while (length--) {
+        crc ^= (uint16_t)*data++ << 8;
+        for (int ii = 0; ii < 8; ++ii) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+static uint8_t refCrc8(uint8_t crc, const uint8_t *data, uint32_t length, uint8_t poly)
+{
+    while (length--) {
+        crc ^= *data++;
+        for (int ii = 0; ii < 8; ++ii) {
+            crc = (crc & 0x80) ? (crc << 1) ^ poly : crc << 1;
+        }
+    }
+    return crc;
+}
+
+static uint8_t refXor(uint8_t crc, const uint8_t *data, uint32_t length)
+{
+    while (length--) {
+        crc ^= *data++;
+    }
+    return crc;
+}
+
+static uint8_t testBuffer[TEST_BUFFER_SIZE + 4];
+
+static void fillTestBuffer(unsigned seed)
+{
+    srand(seed);
+    for (unsigned i = 0; i < sizeof(testBuffer); i++) {
+        testBuffer[i] = rand();
+    }
+}
+
+TEST(CrcTest, CheckValues)
+{
+    const char *check = "123456789";
+
+    EXPECT_EQ(crc16_ccitt_update(0, check, 9), 0x31C3);
+    EXPECT_EQ(crc8_dvb_s2_update(0, check, 9), 0xBC);
+    EXPECT_EQ(crc8_update(0, check, 9), 0xF4);
+    EXPECT_EQ(crc8_xor_update(0, check, 9), 0x31);
+}
+
+TEST(CrcTest, BulkMatchesBitwise)
+{
+    fillTestBuffer(42);
+
+    // All lengths around the 4 byte stride, at every alignment, with non-zero seeds
+    for (uint32_t offset = 0; offset < 4; offset++) {
+        for (uint32_t length = 0; length <= 300; length++) {
+            const uint8_t *data = testBuffer + offset;
+            const uint8_t seed = length * 7 + offset;
+
+            ASSERT_EQ(crc16_ccitt_update(seed << 8 | seed, data, length), refCrc16Ccitt(seed << 8 | seed, data, length)) << "length " << length;
+            ASSERT_EQ(crc8_dvb_s2_update(seed, data, length), refCrc8(seed, data, length, 0xD5)) << "length " << length;
+            ASSERT_EQ(crc8_update(seed, data, length), refCrc8(seed, data, length, 0x07)) << "length " << length;
+            ASSERT_EQ(crc8_xor_update(seed, data, length), refXor(seed, data, length)) << "length " << length;
+        }
+    }
+}
+
+TEST(CrcTest, BytewiseMatchesBulk)
+{
+    fillTestBuffer(7);
+
+    uint16_t crc16 = 0xFFFF;
+    uint8_t crcDvb = 0;
+    uint8_t crc8Value = 0;
+    for (int i = 0; i < TEST_BUFFER_SIZE; i++) {
+        crc16 = crc16_ccitt(crc16, testBuffer[i]);
+        crcDvb = crc8_dvb_s2(crcDvb, testBuffer[i]);
+        crc8Value = crc8(crc8Value, testBuffer[i]);
+    }
+
+    EXPECT_EQ(crc16, crc16_ccitt_update(0xFFFF, testBuffer, TEST_BUFFER_SIZE));
+    EXPECT_EQ(crcDvb, crc8_dvb_s2_update(0, testBuffer, TEST_BUFFER_SIZE));
+    EXPECT_EQ(crc8Value, crc8_update(0, testBuffer, TEST_BUFFER_SIZE));
+}
+
+TEST(CrcTest, SbufAppend)
+{
+    uint8_t buf[64];
+    sbuf_t sbuf = { .ptr = buf, .end = buf + sizeof(buf) };
+
+    fillTestBuffer(3);
+    sbufWriteData(&sbuf, testBuffer, 21);
+    crc8_dvb_s2_sbuf_append(&sbuf, buf);
+    EXPECT_EQ(sbufPtr(&sbuf) - buf, 22);
+    EXPECT_EQ(buf[21], refCrc8(0, testBuffer, 21, 0xD5));
+
+    sbuf.ptr = buf;
+    sbufWriteData(&sbuf, testBuffer, 21);
+    crc16_ccitt_sbuf_append(&sbuf, buf);
+    EXPECT_EQ(buf[21] | (buf[22] << 8), refCrc16Ccitt(0, testBuffer, 21));
+
+    sbuf.ptr = buf;
+    sbufWriteData(&sbuf, testBuffer, 21);
+    crc8_xor_sbuf_append(&sbuf, buf);
+    EXPECT_EQ(buf[21], refXor(0, testBuffer, 21));
+}
+
+/*
+ * Throughput of the table implementations against the bitwise references.
+ * Disabled so "make check" stays fast, run with
+ * crc_unittest --gtest_filter=*Benchmark --gtest_also_run_disabled_tests --gtest_output=json
+ * to get the MB/s figures in the test properties.
+ */
+TEST(CrcTest, DISABLED_Benchmark)
+{
+    const int rounds = 2000;
+    volatile uint32_t sink = 0;
+
+    fillTestBuffer(1);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < rounds; i++) {
+        sink += refCrc16Ccitt(i, testBuffer, TEST_BUFFER_SIZE);
+        sink += refCrc8(i, testBuffer, TEST_BUFFER_SIZE, 0xD5);
+    }
+    auto bitwise = std::chrono::high_resolution_clock::now() - start;
+
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < rounds; i++) {
+        sink += crc16_ccitt_update(i, testBuffer, TEST_BUFFER_SIZE);
+        sink += crc8_dvb_s2_update(i, testBuffer, TEST_BUFFER_SIZE);
+    }
+    auto table = std::chrono::high_resolution_clock::now() - start;
+
+    const double bitwiseUs = std::chrono::duration<double, std::micro>(bitwise).count();
+    const double tableUs = std::chrono::duration<double, std::micro>(table).count();
+    const double megabytes = 2.0 * rounds * TEST_BUFFER_SIZE / 1e6;
+
+    RecordProperty("bitwise_MBps", (int)(megabytes / (bitwiseUs / 1e6)));
+    RecordProperty("table_MBps", (int)(megabytes / (tableUs / 1e6)));
+    EXPECT_LT(tableUs, bitwiseUs);
+    UNUSED(sink);
+}
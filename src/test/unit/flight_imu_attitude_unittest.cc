@@ -0,0 +1,139 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+
+#include <stdint.h>
+
+extern "C" {
+    #include "platform.h"
+    #include "common/axis.h"
+    #include "common/maths.h"
+    #include "common/vector.h"
+    #include "fc/runtime_config.h"
+    #include "flight/imu.h"
+    #include "flight/pid.h"
+    #include "io/gps.h"
+    #include "sensors/acceleration.h"
+    #include "sensors/compass.h"
+    #include "sensors/gyro.h"
+    #include "sensors/sensors.h"
+
+    void imuComputeQuaternionFromRPY(int16_t initialRoll, int16_t initialPitch, int16_t initialYaw);
+    void imuUpdateTailSitter(void);
+
+    uint32_t armingFlags;
+    uint32_t stateFlags;
+    gpsSolutionData_t gpsSol;
+    acc_t acc;
+    mag_t mag;
+    compassConfig_t compassConfig_System;
+    pidProfile_t *pidProfile_ProfileCurrent;
+    bool isMixerTransitionMixing;
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static fpVector3_t testRotationRate;
+
+/*
+ * Euler angles are cached until the orientation changes. Each test reads the
+ * angles once to fill the cache, changes the orientation through one writer
+ * and expects the next read to see the change.
+ */
+static void resetAttitude(void)
+{
+    imuConfigure();
+    imuInit();
+    stateFlags = 0;
+    vectorZero(&testRotationRate);
+}
+
+TEST(FlightImuAttitudeTest, InitInvalidatesAttitude)
+{
+    resetAttitude();
+    imuComputeQuaternionFromRPY(300, 200, 900);
+    EXPECT_NEAR(300, imuGetAttitude()->values.roll, 2);
+
+    imuInit();
+    EXPECT_NEAR(0, imuGetAttitude()->values.roll, 2);
+    EXPECT_NEAR(0, imuGetAttitude()->values.pitch, 2);
+    EXPECT_NEAR(0, imuGetAttitude()->values.yaw, 2);
+}
+
+TEST(FlightImuAttitudeTest, QuaternionFromRPYInvalidatesAttitude)
+{
+    resetAttitude();
+    EXPECT_NEAR(0, imuGetAttitude()->values.roll, 2);
+
+    imuComputeQuaternionFromRPY(300, -200, 900);
+    EXPECT_NEAR(300, imuGetAttitude()->values.roll, 2);
+    EXPECT_NEAR(-200, imuGetAttitude()->values.pitch, 2);
+    EXPECT_NEAR(900, imuGetAttitude()->values.yaw, 2);
+}
+
+TEST(FlightImuAttitudeTest, AhrsUpdateInvalidatesAttitude)
+{
+    resetAttitude();
+    imuUpdateAccelerometer();
+    imuUpdateAttitude(100000);
+    EXPECT_NEAR(0, imuGetAttitude()->values.roll, 2);
+
+    // 1 rad/s roll for 100ms, no accelerometer correction
+    testRotationRate.x = 1.0f;
+    imuUpdateAttitude(200000);
+    EXPECT_NEAR(RADIANS_TO_DECIDEGREES(0.1f), imuGetAttitude()->values.roll, 2);
+}
+
+TEST(FlightImuAttitudeTest, TailsitterInvalidatesAttitude)
+{
+    resetAttitude();
+    EXPECT_NEAR(0, imuGetAttitude()->values.pitch, 2);
+
+    ENABLE_STATE(TAILSITTER);
+    imuUpdateTailSitter();
+    EXPECT_NEAR(900, ABS(imuGetAttitude()->values.pitch), 2);
+
+    DISABLE_STATE(TAILSITTER);
+    imuUpdateTailSitter();
+    EXPECT_NEAR(0, imuGetAttitude()->values.pitch, 2);
+}
+
+// STUBS
+extern "C" {
+    timeMs_t millis(void) { return 0; }
+    bool sensors(uint32_t mask) { return mask == SENSOR_ACC; }
+    bool feature(uint32_t mask) { UNUSED(mask); return false; }
+
+    void accUpdate(void) {}
+    void accGetMeasuredAcceleration(fpVector3_t *measuredAcc) { vectorZero(measuredAcc); }
+    void accGetVibrationLevels(fpVector3_t *accVibeLevels) { vectorZero(accVibeLevels); }
+    uint32_t accGetClipCount(void) { return 0; }
+    void gyroGetMeasuredRotationRate(fpVector3_t *imuMeasuredRotationBF) { *imuMeasuredRotationBF = testRotationRate; }
+    bool gyroIsCalibrationComplete(void) { return true; }
+    bool compassIsHealthy(void) { return false; }
+
+    bool isGPSHeadingValid(void) { return false; }
+    void resetHeadingHoldTarget(int16_t heading) { UNUSED(heading); }
+}
@@ -0,0 +1,253 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+extern "C" {
+    #include "platform.h"
+    #include "common/maths.h"
+    #include "navigation/navigation_geozone_index.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define TEST_ZONES          63
+#define TEST_MAX_VERTICES   126
+#define TEST_AREA_CM        500000.0f
+
+typedef struct {
+    bool circle;
+    uint8_t vertexCount;
+    float radius;
+    fpVector2_t vertices[TEST_MAX_VERTICES];
+} testZone_t;
+
+static testZone_t zones[TEST_ZONES];
+static geozoneBounds_t zoneBounds[TEST_ZONES];
+static geozoneIndex_t zoneIndex;
+
+static float randomFloat(float min, float max)
+{
+    return min + (max - min) * (float)rand() / (float)RAND_MAX;
+}
+
+// Star shaped polygons with many vertices and circles spread over the area,
+// worst case for the linear scan the index replaces
+static void buildWorstCaseZones(unsigned seed)
+{
+    srand(seed);
+    for (int i = 0; i < TEST_ZONES; i++) {
+        testZone_t *zone = &zones[i];
+        const fpVector2_t center = { .x = randomFloat(-TEST_AREA_CM, TEST_AREA_CM), .y = randomFloat(-TEST_AREA_CM, TEST_AREA_CM) };
+
+        zone->circle = (i % 4) == 3;
+        if (zone->circle) {
+            zone->vertexCount = 1;
+            zone->radius = randomFloat(5000.0f, 50000.0f);
+            zone->vertices[0] = center;
+            geozoneBoundsFromCircle(&zoneBounds[i], &zone->vertices[0], zone->radius);
+        } else {
+            zone->vertexCount = 2 + TEST_MAX_VERTICES / 2 + rand() % (TEST_MAX_VERTICES / 2 - 1);
+            for (int j = 0; j < zone->vertexCount; j++) {
+                const float angle = 2.0f * M_PIf * j / zone->vertexCount;
+                const float radius = randomFloat(10000.0f, 60000.0f);
+                zone->vertices[j].x = center.x + radius * cos_approx(angle);
+                zone->vertices[j].y = center.y + radius * sin_approx(angle);
+            }
+            geozoneBoundsFromPolygon(&zoneBounds[i], zone->vertices, zone->vertexCount);
+        }
+    }
+    geozoneIndexBuild(&zoneIndex, zoneBounds, TEST_ZONES);
+}
+
+static bool isPointInZone(const testZone_t *zone, const fpVector2_t *point)
+{
+    if (zone->circle) {
+        return calc_length_pythagorean_2D(point->x - zone->vertices[0].x, point->y - zone->vertices[0].y) <= zone->radius;
+    }
+
+    bool inside = false;
+    const fpVector2_t *prev = &zone->vertices[zone->vertexCount - 1];
+    for (int i = 0; i < zone->vertexCount; i++) {
+        const fpVector2_t *current = &zone->vertices[i];
+        if ((current->y > point->y) != (prev->y > point->y) &&
+            point->x < (prev->x - current->x) * (point->y - current->y) / (prev->y - current->y) + current->x) {
+            inside = !inside;
+        }
+        prev = current;
+    }
+    return inside;
+}
+
+static bool segmentsIntersect(const fpVector2_t *a, const fpVector2_t *b, const fpVector2_t *c, const fpVector2_t *d)
+{
+    const float denom = (b->x - a->x) * (d->y - c->y) - (b->y - a->y) * (d->x - c->x);
+    if (denom == 0.0f) {
+        return false;
+    }
+    const float t = ((c->x - a->x) * (d->y - c->y) - (c->y - a->y) * (d->x - c->x)) / denom;
+    const float u = ((c->x - a->x) * (b->y - a->y) - (c->y - a->y) * (b->x - a->x)) / denom;
+    return t >= 0.0f && t <= 1.0f && u >= 0.0f && u <= 1.0f;
+}
+
+static bool isSegmentTouchingZone(const testZone_t *zone, const fpVector2_t *start, const fpVector2_t *end)
+{
+    if (isPointInZone(zone, start) || isPointInZone(zone, end)) {
+        return true;
+    }
+
+    if (zone->circle) {
+        const fpVector2_t dir = { .x = end->x - start->x, .y = end->y - start->y };
+        const float lengthSq = dir.x * dir.x + dir.y * dir.y;
+        float t = lengthSq > 0.0f ? ((zone->vertices[0].x - start->x) * dir.x + (zone->vertices[0].y - start->y) * dir.y) / lengthSq : 0.0f;
+        t = constrainf(t, 0.0f, 1.0f);
+        const fpVector2_t closest = { .x = start->x + t * dir.x, .y = start->y + t * dir.y };
+        return isPointInZone(zone, &closest);
+    }
+
+    const fpVector2_t *prev = &zone->vertices[zone->vertexCount - 1];
+    for (int i = 0; i < zone->vertexCount; i++) {
+        if (segmentsIntersect(start, end, prev, &zone->vertices[i])) {
+            return true;
+        }
+        prev = &zone->vertices[i];
+    }
+    return false;
+}
+
+static geozoneMask_t bruteForcePoint(const fpVector2_t *point)
+{
+    geozoneMask_t mask = 0;
+    for (int i = 0; i < TEST_ZONES; i++) {
+        if (isPointInZone(&zones[i], point)) {
+            mask |= (geozoneMask_t)1 << i;
+        }
+    }
+    return mask;
+}
+
+static geozoneMask_t bruteForceSegment(const fpVector2_t *start, const fpVector2_t *end)
+{
+    geozoneMask_t mask = 0;
+    for (int i = 0; i < TEST_ZONES; i++) {
+        if (isSegmentTouchingZone(&zones[i], start, end)) {
+            mask |= (geozoneMask_t)1 << i;
+        }
+    }
+    return mask;
+}
+
+static geozoneMask_t indexedPoint(const fpVector2_t *point)
+{
+    geozoneMask_t mask = 0;
+    for (geozoneMask_t candidates = geozoneIndexQueryPoint(&zoneIndex, point); candidates; candidates &= candidates - 1) {
+        const int i = __builtin_ctzll(candidates);
+        if (isPointInZone(&zones[i], point)) {
+            mask |= (geozoneMask_t)1 << i;
+        }
+    }
+    return mask;
+}
+
+static fpVector2_t randomPoint(void)
+{
+    const fpVector2_t point = { .x = randomFloat(-1.2f * TEST_AREA_CM, 1.2f * TEST_AREA_CM), .y = randomFloat(-1.2f * TEST_AREA_CM, 1.2f * TEST_AREA_CM) };
+    return point;
+}
+
+TEST(GeozoneIndexUnittest, PointCandidatesContainAllHits)
+{
+    for (unsigned seed = 1; seed <= 10; seed++) {
+        buildWorstCaseZones(seed);
+        for (int i = 0; i < 2000; i++) {
+            const fpVector2_t point = randomPoint();
+            const geozoneMask_t hits = bruteForcePoint(&point);
+            EXPECT_EQ(hits, geozoneIndexQueryPoint(&zoneIndex, &point) & hits);
+        }
+    }
+}
+
+TEST(GeozoneIndexUnittest, SegmentCandidatesContainAllHits)
+{
+    for (unsigned seed = 1; seed <= 10; seed++) {
+        buildWorstCaseZones(seed);
+        for (int i = 0; i < 500; i++) {
+            const fpVector2_t start = randomPoint();
+            const fpVector2_t end = { .x = start.x + randomFloat(-100000.0f, 100000.0f), .y = start.y + randomFloat(-100000.0f, 100000.0f) };
+            geozoneBounds_t segmentBounds;
+            geozoneBoundsFromSegment(&segmentBounds, &start, &end);
+
+            const geozoneMask_t hits = bruteForceSegment(&start, &end);
+            EXPECT_EQ(hits, geozoneIndexQuerySegment(&zoneIndex, &segmentBounds) & hits);
+        }
+    }
+}
+
+TEST(GeozoneIndexUnittest, UnboundedZoneIsAlwaysCandidate)
+{
+    geozoneBounds_t bounds[2];
+    const fpVector2_t center = { .x = 0, .y = 0 };
+    geozoneBoundsFromCircle(&bounds[0], &center, 1000.0f);
+    geozoneBoundsSetUnbounded(&bounds[1]);
+    geozoneIndexBuild(&zoneIndex, bounds, 2);
+
+    const fpVector2_t inside = { .x = 10.0f, .y = -10.0f };
+    const fpVector2_t outside = { .x = 1e7f, .y = 1e7f };
+    EXPECT_EQ((geozoneMask_t)3, geozoneIndexQueryPoint(&zoneIndex, &inside));
+    EXPECT_EQ((geozoneMask_t)2, geozoneIndexQueryPoint(&zoneIndex, &outside));
+
+    geozoneBounds_t segmentBounds;
+    geozoneBoundsFromSegment(&segmentBounds, &outside, &outside);
+    EXPECT_EQ((geozoneMask_t)2, geozoneIndexQuerySegment(&zoneIndex, &segmentBounds));
+}
+
+TEST(GeozoneIndexUnittest, EmptyIndex)
+{
+    geozoneIndexBuild(&zoneIndex, NULL, 0);
+    const fpVector2_t point = { .x = 0, .y = 0 };
+    EXPECT_EQ((geozoneMask_t)0, geozoneIndexQueryPoint(&zoneIndex, &point));
+}
+
+// The index has to pay for itself: on the worst case layout only a small part
+// of the zones may be left for the exact test
+TEST(GeozoneIndexUnittest, CandidatesPruneLinearScan)
+{
+    const int queries = 20000;
+    long candidates = 0;
+
+    buildWorstCaseZones(42);
+    for (int i = 0; i < queries; i++) {
+        const fpVector2_t point = randomPoint();
+        const geozoneMask_t mask = geozoneIndexQueryPoint(&zoneIndex, &point);
+        EXPECT_EQ(bruteForcePoint(&point), indexedPoint(&point));
+        candidates += __builtin_popcountll(mask);
+    }
+
+    EXPECT_LT(candidates, (long)queries * TEST_ZONES / 8);
+}
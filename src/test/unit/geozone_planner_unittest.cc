@@ -0,0 +1,314 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <float.h>
+#include <math.h>
+#include <chrono>
+
+extern "C" {
+    #include "platform.h"
+    #include "common/maths.h"
+    #include "common/time.h"
+    #include "navigation/navigation_geozone_planner.h"
+
+    timeUs_t micros(void);
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define TEST_OBSTACLES      40
+#define TEST_HEX_SIDES      6
+#define TEST_AREA_CM        200000.0f
+#define TEST_MAX_WAYPOINTS  63
+
+typedef struct {
+    fpVector2_t center;
+    float radius;
+} testObstacle_t;
+
+static testObstacle_t obstacles[TEST_OBSTACLES];
+static int obstacleCount;
+static unsigned long reachableCalls;
+static geozonePlanner_t planner;
+
+timeUs_t micros(void)
+{
+    static const auto start = std::chrono::steady_clock::now();
+    return (timeUs_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+static float randomFloat(float min, float max)
+{
+    return min + (max - min) * (float)rand() / (float)RAND_MAX;
+}
+
+static float distanceToSegment(const fpVector2_t *point, const fpVector3_t *start, const fpVector3_t *end)
+{
+    const float dx = end->x - start->x;
+    const float dy = end->y - start->y;
+    const float lengthSq = dx * dx + dy * dy;
+    float t = lengthSq > 0 ? ((point->x - start->x) * dx + (point->y - start->y) * dy) / lengthSq : 0;
+    t = constrainf(t, 0.0f, 1.0f);
+    return calc_length_pythagorean_2D(start->x + t * dx - point->x, start->y + t * dy - point->y);
+}
+
+static bool isReachable(const fpVector3_t *from, const fpVector3_t *to)
+{
+    reachableCalls++;
+    for (int i = 0; i < obstacleCount; i++) {
+        if (distanceToSegment(&obstacles[i].center, from, to) <= obstacles[i].radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static float legCost(const fpVector3_t *from, const fpVector3_t *to)
+{
+    return calc_length_pythagorean_2D(to->x - from->x, to->y - from->y) + 2 * fabsf(to->z - from->z);
+}
+
+// Circular no fly zones between start and target, nodes on enlarged hexagons around them like the safe zones
+static void buildRandomLayout(unsigned seed, const fpVector3_t *start, const fpVector3_t *target)
+{
+    srand(seed);
+    obstacleCount = 0;
+    geozonePlannerInit(&planner, start, isReachable);
+
+    while (obstacleCount < TEST_OBSTACLES) {
+        testObstacle_t *obstacle = &obstacles[obstacleCount];
+        obstacle->center.x = randomFloat(-TEST_AREA_CM, TEST_AREA_CM);
+        obstacle->center.y = randomFloat(-TEST_AREA_CM, TEST_AREA_CM);
+        obstacle->radius = randomFloat(5000.0f, 20000.0f);
+
+        const fpVector2_t startPos = { .x = start->x, .y = start->y };
+        const fpVector2_t targetPos = { .x = target->x, .y = target->y };
+        if (calc_length_pythagorean_2D(startPos.x - obstacle->center.x, startPos.y - obstacle->center.y) <= obstacle->radius * 1.5f ||
+            calc_length_pythagorean_2D(targetPos.x - obstacle->center.x, targetPos.y - obstacle->center.y) <= obstacle->radius * 1.5f) {
+            continue;
+        }
+        obstacleCount++;
+    }
+
+    for (int i = 0; i < obstacleCount; i++) {
+        const float radius = obstacles[i].radius * 1.2f / cos_approx(M_PIf / TEST_HEX_SIDES);
+        for (int j = 0; j < TEST_HEX_SIDES; j++) {
+            const fpVector3_t node = {
+                .x = obstacles[i].center.x + radius * cos_approx(2 * M_PIf * j / TEST_HEX_SIDES),
+                .y = obstacles[i].center.y + radius * sin_approx(2 * M_PIf * j / TEST_HEX_SIDES),
+                .z = start->z
+            };
+            if (isReachable(&node, &node)) {
+                geozonePlannerAddNode(&planner, &node);
+            }
+        }
+    }
+}
+
+// Dijkstra over the complete visibility graph, reference for the planner
+static float dijkstra(const fpVector3_t *points, int count)
+{
+    static float cost[GEOZONE_PLANNER_MAX_NODES];
+    static bool visited[GEOZONE_PLANNER_MAX_NODES];
+
+    for (int i = 0; i < count; i++) {
+        cost[i] = FLT_MAX;
+        visited[i] = false;
+    }
+    cost[0] = 0;
+
+    while (true) {
+        int current = -1;
+        for (int i = 0; i < count; i++) {
+            if (!visited[i] && cost[i] < FLT_MAX && (current < 0 || cost[i] < cost[current])) {
+                current = i;
+            }
+        }
+        if (current < 0) {
+            return -1;
+        }
+        if (current == count - 1) {
+            return cost[current];
+        }
+        visited[current] = true;
+        for (int i = 0; i < count; i++) {
+            if (!visited[i] && isReachable(&points[current], &points[i])) {
+                cost[i] = MIN(cost[i], cost[current] + legCost(&points[current], &points[i]));
+            }
+        }
+    }
+}
+
+static float routeCost(const fpVector3_t *start, const fpVector3_t *waypoints, int count, const fpVector3_t *target)
+{
+    float cost = 0;
+    const fpVector3_t *prev = start;
+    for (int i = 0; i < count; i++) {
+        EXPECT_TRUE(isReachable(prev, &waypoints[i]));
+        cost += legCost(prev, &waypoints[i]);
+        prev = &waypoints[i];
+    }
+    EXPECT_TRUE(isReachable(prev, target));
+    return cost + legCost(prev, target);
+}
+
+static const fpVector3_t testStart = { .x = -1.2f * TEST_AREA_CM, .y = -1.2f * TEST_AREA_CM, .z = 5000 };
+static const fpVector3_t testTarget = { .x = 1.2f * TEST_AREA_CM, .y = 1.2f * TEST_AREA_CM, .z = 5000 };
+
+TEST(GeozonePlannerUnittest, RouteIsValidAndOptimal)
+{
+    static fpVector3_t points[GEOZONE_PLANNER_MAX_NODES];
+    fpVector3_t waypoints[TEST_MAX_WAYPOINTS];
+
+    for (unsigned seed = 1; seed <= 20; seed++) {
+        buildRandomLayout(seed, &testStart, &testTarget);
+        ASSERT_TRUE(geozonePlannerSetTarget(&planner, &testTarget));
+
+        for (int i = 0; i < planner.nodeCount; i++) {
+            points[i] = planner.nodes[i].point;
+        }
+        const float expectedCost = dijkstra(points, planner.nodeCount);
+
+        while (geozonePlannerStep(&planner, 1000000) == GEOZONE_PLANNER_RUNNING);
+
+        if (expectedCost < 0) {
+            EXPECT_EQ(GEOZONE_PLANNER_NO_PATH, planner.state);
+            continue;
+        }
+
+        ASSERT_EQ(GEOZONE_PLANNER_FOUND, planner.state);
+        const int8_t count = geozonePlannerGetRoute(&planner, waypoints, TEST_MAX_WAYPOINTS);
+        ASSERT_GE(count, 0);
+        EXPECT_NEAR(expectedCost, routeCost(&testStart, waypoints, count, &testTarget), expectedCost * 1e-4f);
+    }
+}
+
+TEST(GeozonePlannerUnittest, SlicedSearchMatchesSingleStep)
+{
+    fpVector3_t waypoints[TEST_MAX_WAYPOINTS];
+    fpVector3_t waypointsSliced[TEST_MAX_WAYPOINTS];
+
+    for (unsigned seed = 1; seed <= 5; seed++) {
+        buildRandomLayout(seed, &testStart, &testTarget);
+        geozonePlannerSetTarget(&planner, &testTarget);
+        while (geozonePlannerStep(&planner, 1000000) == GEOZONE_PLANNER_RUNNING);
+        const int8_t count = geozonePlannerGetRoute(&planner, waypoints, TEST_MAX_WAYPOINTS);
+
+        // Zero budget still makes progress, one unit of work per call
+        buildRandomLayout(seed, &testStart, &testTarget);
+        geozonePlannerSetTarget(&planner, &testTarget);
+        int calls = 0;
+        while (geozonePlannerStep(&planner, 0) == GEOZONE_PLANNER_RUNNING) {
+            calls++;
+        }
+        EXPECT_GT(calls, 1);
+
+        ASSERT_EQ(count, geozonePlannerGetRoute(&planner, waypointsSliced, TEST_MAX_WAYPOINTS));
+        for (int i = 0; i < count; i++) {
+            EXPECT_EQ(waypoints[i].x, waypointsSliced[i].x);
+            EXPECT_EQ(waypoints[i].y, waypointsSliced[i].y);
+        }
+    }
+}
+
+TEST(GeozonePlannerUnittest, EnclosedTargetHasNoPath)
+{
+    const fpVector3_t start = { .x = 0, .y = 0, .z = 0 };
+    const fpVector3_t target = { .x = 100000, .y = 0, .z = 0 };
+
+    obstacleCount = 1;
+    obstacles[0].center.x = 100000;
+    obstacles[0].center.y = 50000;
+    obstacles[0].radius = 50000;
+
+    geozonePlannerInit(&planner, &start, isReachable);
+    const fpVector3_t node = { .x = 0, .y = 100000, .z = 0 };
+    geozonePlannerAddNode(&planner, &node);
+    geozonePlannerSetTarget(&planner, &target);
+
+    EXPECT_EQ(GEOZONE_PLANNER_NO_PATH, geozonePlannerStep(&planner, 1000000));
+    EXPECT_EQ(-1, geozonePlannerGetRoute(&planner, NULL, 0));
+}
+
+TEST(GeozonePlannerUnittest, RouteLongerThanBufferIsRejected)
+{
+    const fpVector3_t start = { .x = 0, .y = 0, .z = 0 };
+    const fpVector3_t target = { .x = 400000, .y = 0, .z = 0 };
+    fpVector3_t waypoints[2];
+
+    // Zig zag around a row of obstacles on the direct line
+    obstacleCount = 3;
+    for (int i = 0; i < 3; i++) {
+        obstacles[i].center.x = 100000 * (i + 1);
+        obstacles[i].center.y = 0;
+        obstacles[i].radius = 10000;
+    }
+
+    geozonePlannerInit(&planner, &start, isReachable);
+    for (int i = 0; i < 3; i++) {
+        const fpVector3_t node = { .x = 100000.0f * (i + 1), .y = 20000, .z = 0 };
+        geozonePlannerAddNode(&planner, &node);
+    }
+    const fpVector3_t far = { .x = 200000, .y = 21000, .z = 0 };
+    geozonePlannerAddNode(&planner, &far);
+    geozonePlannerSetTarget(&planner, &target);
+
+    while (geozonePlannerStep(&planner, 1000000) == GEOZONE_PLANNER_RUNNING);
+    ASSERT_EQ(GEOZONE_PLANNER_FOUND, planner.state);
+    EXPECT_EQ(-1, geozonePlannerGetRoute(&planner, waypoints, 0));
+    EXPECT_GE(geozonePlannerGetRoute(&planner, waypoints, 2), 1);
+}
+
+// Reachability checks are the expensive part on the FC, the lazy A* has to
+// do far less of them than a Dijkstra over the full visibility graph
+TEST(GeozonePlannerUnittest, FewerReachabilityChecksThanFullGraph)
+{
+    static fpVector3_t points[GEOZONE_PLANNER_MAX_NODES];
+    unsigned long plannerChecks = 0, referenceChecks = 0;
+
+    for (unsigned seed = 100; seed < 120; seed++) {
+        buildRandomLayout(seed, &testStart, &testTarget);
+        geozonePlannerSetTarget(&planner, &testTarget);
+        for (int i = 0; i < planner.nodeCount; i++) {
+            points[i] = planner.nodes[i].point;
+        }
+
+        reachableCalls = 0;
+        const float expectedCost = dijkstra(points, planner.nodeCount);
+        referenceChecks += reachableCalls;
+
+        reachableCalls = 0;
+        while (geozonePlannerStep(&planner, 200) == GEOZONE_PLANNER_RUNNING);
+        EXPECT_EQ(expectedCost < 0 ? GEOZONE_PLANNER_NO_PATH : GEOZONE_PLANNER_FOUND, planner.state);
+        EXPECT_EQ(planner.reachableChecks, reachableCalls);
+        plannerChecks += planner.reachableChecks;
+    }
+
+    EXPECT_LT(plannerChecks, referenceChecks / 4);
+}
@@ -0,0 +1,537 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+extern "C" {
+    #include "platform.h"
+    #include "common/utils.h"
+    #include "io/gps_ublox_parser.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define TEST_MAX_PAYLOAD    (64 * 16 + 8)
+
+#define TEST_CLASS_NAV      0x01
+#define TEST_MSG_PVT        0x07
+#define TEST_MSG_SIG        0x43
+#define TEST_MSG_TIMEGPS    0x20
+
+#define TEST_PVT_LENGTH     92
+#define TEST_SIG_COUNT      40
+#define TEST_SIG_LENGTH     (8 + 16 * TEST_SIG_COUNT)
+
+static uint32_t parserBuffer[(TEST_MAX_PAYLOAD + 3) / 4];
+
+static int pvtCount;
+static int sigCount;
+static int misaligned;
+static uint32_t lastPvtItow;
+static const void *lastPvtPayload;
+static uint32_t payloadSum;
+
+static uint32_t sumPayload(const void *payload, uint16_t length)
+{
+    const uint8_t *p = (const uint8_t *)payload;
+    uint32_t sum = 0;
+    for (int i = 0; i < length; i++) {
+        sum += p[i];
+    }
+    return sum;
+}
+
+static bool handlePvt(const void *payload, uint16_t length)
+{
+    misaligned += ((uintptr_t)payload & 3) != 0;
+    lastPvtItow = *(const uint32_t *)payload;
+    lastPvtPayload = payload;
+    payloadSum += sumPayload(payload, length);
+    pvtCount++;
+    return true;
+}
+
+static bool handleSig(const void *payload, uint16_t length)
+{
+    misaligned += ((uintptr_t)payload & 3) != 0;
+    payloadSum += sumPayload(payload, length);
+    sigCount++;
+    return false;
+}
+
+static const ubxMessageHandler_t handlers[] = {
+    { TEST_CLASS_NAV, TEST_MSG_PVT, TEST_PVT_LENGTH, handlePvt },
+    { TEST_CLASS_NAV, TEST_MSG_SIG, 8, handleSig },
+};
+
+static void resetCounters(void)
+{
+    pvtCount = sigCount = misaligned = 0;
+    lastPvtItow = 0;
+    lastPvtPayload = NULL;
+    payloadSum = 0;
+}
+
+static void appendMessage(std::vector<uint8_t> &stream, uint8_t msgClass, uint8_t msgId, const uint8_t *payload, uint16_t length)
+{
+    const size_t start = stream.size();
+
+    stream.push_back(0xB5);
+    stream.push_back(0x62);
+    stream.push_back(msgClass);
+    stream.push_back(msgId);
+    stream.push_back(length & 0xFF);
+    stream.push_back(length >> 8);
+    stream.insert(stream.end(), payload, payload + length);
+
+    uint8_t ckA = 0, ckB = 0;
+    for (size_t i = start + 2; i < stream.size(); i++) {
+        ckA += stream[i];
+        ckB += ckA;
+    }
+    stream.push_back(ckA);
+    stream.push_back(ckB);
+}
+
+// M10 style output: PVT + NAV-SIG per epoch, an unhandled message and some NMEA noise in between
+static std::vector<uint8_t> buildStream(int epochs, uint32_t *expectedSum)
+{
+    std::vector<uint8_t> stream;
+    uint8_t payload[TEST_MAX_PAYLOAD];
+    uint32_t sum = 0;
+
+    srand(1);
+    for (int epoch = 0; epoch < epochs; epoch++) {
+        const uint32_t itow = 1000 + epoch * 40;    // 25Hz
+
+        for (int i = 0; i < TEST_SIG_LENGTH; i++) {
+            payload[i] = rand();
+        }
+        payload[4] = 0;     // version
+        payload[5] = TEST_SIG_COUNT;
+        appendMessage(stream, TEST_CLASS_NAV, TEST_MSG_SIG, payload, TEST_SIG_LENGTH);
+        sum += sumPayload(payload, TEST_SIG_LENGTH);
+
+        for (int i = 0; i < 16; i++) {
+            payload[i] = rand();
+        }
+        appendMessage(stream, TEST_CLASS_NAV, TEST_MSG_TIMEGPS, payload, 16);
+
+        const char *nmea = "$GNTXT,01,01,02,u-blox\xb5*5C\r\n";
+        stream.insert(stream.end(), nmea, nmea + strlen(nmea));
+
+        for (int i = 0; i < TEST_PVT_LENGTH; i++) {
+            payload[i] = rand();
+        }
+        memcpy(payload, &itow, sizeof(itow));
+        appendMessage(stream, TEST_CLASS_NAV, TEST_MSG_PVT, payload, TEST_PVT_LENGTH);
+        sum += sumPayload(payload, TEST_PVT_LENGTH);
+    }
+
+    if (expectedSum) {
+        *expectedSum = sum;
+    }
+
+    return stream;
+}
+
+// Feed in chunks, resuming after every new solution like the receiver thread does
+static void feedStream(ubxParser_t *parser, const std::vector<uint8_t> &stream, size_t chunkSize)
+{
+    size_t offset = 0;
+
+    while (offset < stream.size()) {
+        const size_t chunkLength = std::min(chunkSize, stream.size() - offset);
+        size_t position = 0;
+
+        while (position < chunkLength) {
+            bool newSolution;
+            position += ubxParserFeed(parser, &stream[offset + position], chunkLength - position, &newSolution);
+        }
+
+        offset += chunkLength;
+    }
+}
+
+TEST(GpsUbloxParserTest, SingleChunk)
+{
+    ubxParser_t parser;
+    uint32_t expectedSum;
+    const std::vector<uint8_t> stream = buildStream(25, &expectedSum);
+
+    resetCounters();
+    ubxParserInit(&parser, handlers, ARRAYLEN(handlers), parserBuffer, TEST_MAX_PAYLOAD);
+    feedStream(&parser, stream, stream.size());
+
+    EXPECT_EQ(25, pvtCount);
+    EXPECT_EQ(25, sigCount);
+    EXPECT_EQ(0, misaligned);
+    EXPECT_EQ(1000u + 24 * 40, lastPvtItow);
+    EXPECT_EQ(expectedSum, payloadSum);
+    EXPECT_EQ(75u, parser.packetCount);
+    EXPECT_EQ(0u, parser.errorCount);
+}
+
+TEST(GpsUbloxParserTest, ArbitraryChunks)
+{
+    uint32_t expectedSum;
+    const std::vector<uint8_t> stream = buildStream(10, &expectedSum);
+
+    for (size_t chunkSize = 1; chunkSize <= 97; chunkSize++) {
+        ubxParser_t parser;
+
+        resetCounters();
+        ubxParserInit(&parser, handlers, ARRAYLEN(handlers), parserBuffer, TEST_MAX_PAYLOAD);
+        feedStream(&parser, stream, chunkSize);
+
+        EXPECT_EQ(10, pvtCount) << "chunk " << chunkSize;
+        EXPECT_EQ(10, sigCount) << "chunk " << chunkSize;
+        EXPECT_EQ(0, misaligned) << "chunk " << chunkSize;
+        EXPECT_EQ(expectedSum, payloadSum) << "chunk " << chunkSize;
+        EXPECT_EQ(0u, parser.errorCount) << "chunk " << chunkSize;
+    }
+}
+
+TEST(GpsUbloxParserTest, MisalignedChunk)
+{
+    ubxParser_t parser;
+    uint32_t expectedSum;
+    const std::vector<uint8_t> stream = buildStream(5, &expectedSum);
+
+    // Shift the whole stream so every zero copy view would be unaligned
+    std::vector<uint8_t> shifted(stream.size() + 1);
+    memcpy(&shifted[1], stream.data(), stream.size());
+
+    resetCounters();
+    ubxParserInit(&parser, handlers, ARRAYLEN(handlers), parserBuffer, TEST_MAX_PAYLOAD);
+    feedStream(&parser, shifted, shifted.size());
+
+    EXPECT_EQ(5, pvtCount);
+    EXPECT_EQ(0, misaligned);
+    EXPECT_EQ(expectedSum, payloadSum);
+}
+
+TEST(GpsUbloxParserTest, StopsAfterSolution)
+{
+    ubxParser_t parser;
+    const std::vector<uint8_t> stream = buildStream(3, NULL);
+    bool newSolution;
+
+    resetCounters();
+    ubxParserInit(&parser, handlers, ARRAYLEN(handlers), parserBuffer, TEST_MAX_PAYLOAD);
+
+    const uint32_t consumed = ubxParserFeed(&parser, stream.data(), stream.size(), &newSolution);
+
+    EXPECT_TRUE(newSolution);
+    EXPECT_EQ(1, pvtCount);
+    EXPECT_EQ(stream.size() / 3, consumed);
+}
+
+TEST(GpsUbloxParserTest, BadChecksum)
+{
+    ubxParser_t parser;
+    std::vector<uint8_t> stream = buildStream(3, NULL);
+
+    // Corrupt a byte of the second epoch's PVT payload
+    const size_t epochLength = stream.size() / 3;
+    stream[2 * epochLength - 20] ^= 0x55;
+
+    for (size_t chunkSize : { (size_t)1, (size_t)7, stream.size() }) {
+        resetCounters();
+        ubxParserInit(&parser, handlers, ARRAYLEN(handlers), parserBuffer, TEST_MAX_PAYLOAD);
+        feedStream(&parser, stream, chunkSize);
+
+        EXPECT_EQ(2, pvtCount);
+        EXPECT_EQ(3, sigCount);
+        EXPECT_EQ(1u, parser.errorCount);
+    }
+}
+
+TEST(GpsUbloxParserTest, OversizeResync)
+{
+    ubxParser_t parser;
+    const std::vector<uint8_t> messages = buildStream(2, NULL);
+
+    // Garbage header announcing a payload larger than we accept, followed by valid traffic
+    std::vector<uint8_t> stream = { 0xB5, 0x62, 0x01, 0x07, 0xFF, 0xFF };
+    stream.insert(stream.end(), messages.begin(), messages.end());
+
+    resetCounters();
+    ubxParserInit(&parser, handlers, ARRAYLEN(handlers), parserBuffer, TEST_MAX_PAYLOAD);
+    feedStream(&parser, stream, 13);
+
+    EXPECT_EQ(2, pvtCount);
+    EXPECT_EQ(2, sigCount);
+    EXPECT_EQ(1u, parser.errorCount);
+}
+
+TEST(GpsUbloxParserTest, RescanAfterFalseSync)
+{
+    ubxParser_t parser;
+    const std::vector<uint8_t> messages = buildStream(3, NULL);
+
+    // Sync bytes in noise whose header swallows the start of a real frame: class 0x01, id 0xB5, length 0x0162
+    std::vector<uint8_t> stream = { 0xB5, 0x62, 0x01 };
+    stream.insert(stream.end(), messages.begin(), messages.end());
+
+    resetCounters();
+    ubxParserInit(&parser, handlers, ARRAYLEN(handlers), parserBuffer, TEST_MAX_PAYLOAD);
+    feedStream(&parser, stream, stream.size());
+
+    EXPECT_EQ(3, pvtCount);
+    EXPECT_EQ(3, sigCount);
+    EXPECT_EQ(1u, parser.errorCount);
+}
+
+TEST(GpsUbloxParserTest, AlignedFrameDispatchedInPlace)
+{
+    ubxParser_t parser;
+    std::vector<uint8_t> frame;
+    uint8_t payload[TEST_PVT_LENGTH] = { 0 };
+    uint32_t chunk[(TEST_PVT_LENGTH + 8 + 2 + 3) / 4];
+    bool newSolution;
+
+    appendMessage(frame, TEST_CLASS_NAV, TEST_MSG_PVT, payload, TEST_PVT_LENGTH);
+
+    // Same layout as the driver's receive chunk, frame read 2 bytes in so the payload lands aligned
+    uint8_t *data = (uint8_t *)chunk + 2;
+    memcpy(data, frame.data(), frame.size());
+
+    resetCounters();
+    ubxParserInit(&parser, handlers, ARRAYLEN(handlers), parserBuffer, TEST_MAX_PAYLOAD);
+    ubxParserFeed(&parser, data, frame.size(), &newSolution);
+
+    EXPECT_TRUE(newSolution);
+    EXPECT_EQ(data + 6, lastPvtPayload);
+}
+
+TEST(GpsUbloxParserTest, ShortPayloadDropped)
+{
+    ubxParser_t parser;
+    std::vector<uint8_t> stream;
+    uint8_t payload[TEST_PVT_LENGTH] = { 0 };
+    bool newSolution;
+
+    appendMessage(stream, TEST_CLASS_NAV, TEST_MSG_PVT, payload, 84);
+
+    resetCounters();
+    ubxParserInit(&parser, handlers, ARRAYLEN(handlers), parserBuffer, TEST_MAX_PAYLOAD);
+    ubxParserFeed(&parser, stream.data(), stream.size(), &newSolution);
+
+    EXPECT_FALSE(newSolution);
+    EXPECT_EQ(0, pvtCount);
+    EXPECT_EQ(1u, parser.packetCount);
+}
+
+TEST(GpsUbloxParserTest, BytesToCompletion)
+{
+    ubxParser_t parser;
+    std::vector<uint8_t> stream;
+    uint8_t payload[TEST_PVT_LENGTH] = { 0 };
+    bool newSolution;
+
+    appendMessage(stream, TEST_CLASS_NAV, TEST_MSG_PVT, payload, TEST_PVT_LENGTH);
+
+    resetCounters();
+    ubxParserInit(&parser, handlers, ARRAYLEN(handlers), parserBuffer, TEST_MAX_PAYLOAD);
+    EXPECT_EQ(8u, ubxParserBytesToCompletion(&parser));
+
+    // Lower bound until the length is known, the exact remainder of the frame afterwards
+    for (size_t fed = 1; fed < stream.size(); fed++) {
+        ubxParserFeed(&parser, &stream[fed - 1], 1, &newSolution);
+        const size_t expected = (fed < 6) ? 8 - fed : stream.size() - fed;
+        EXPECT_EQ(expected, ubxParserBytesToCompletion(&parser)) << "fed " << fed;
+    }
+
+    ubxParserFeed(&parser, &stream.back(), 1, &newSolution);
+    EXPECT_TRUE(newSolution);
+    EXPECT_EQ(8u, ubxParserBytesToCompletion(&parser));
+}
+
+// Byte at a time parser the driver used before, kept as a reference
+static struct {
+    uint8_t step;
+    uint8_t msgClass;
+    uint8_t msgId;
+    uint8_t ckA;
+    uint8_t ckB;
+    uint16_t length;
+    uint16_t counter;
+    uint8_t buffer[TEST_MAX_PAYLOAD];
+} ref;
+
+static bool refNewFrame(uint8_t data)
+{
+    switch (ref.step) {
+        case 0:
+            if (data == 0xB5) {
+                ref.step++;
+            }
+            break;
+        case 1:
+            ref.step = (data == 0x62) ? 2 : 0;
+            break;
+        case 2:
+            ref.step++;
+            ref.msgClass = data;
+            ref.ckB = ref.ckA = data;
+            break;
+        case 3:
+            ref.step++;
+            ref.ckB += (ref.ckA += data);
+            ref.msgId = data;
+            break;
+        case 4:
+            ref.step++;
+            ref.ckB += (ref.ckA += data);
+            ref.length = data;
+            break;
+        case 5:
+            ref.step++;
+            ref.ckB += (ref.ckA += data);
+            ref.length |= (uint16_t)(data << 8);
+            if (ref.length > TEST_MAX_PAYLOAD) {
+                ref.step = 0;
+                break;
+            }
+            ref.counter = 0;
+            if (ref.length == 0) {
+                ref.step = 7;
+            }
+            break;
+        case 6:
+            ref.ckB += (ref.ckA += data);
+            ref.buffer[ref.counter] = data;
+            if (ref.counter == ref.length - 1) {
+                ref.step++;
+            }
+            ref.counter++;
+            break;
+        case 7:
+            ref.step = (ref.ckA == data) ? 8 : 0;
+            break;
+        case 8:
+            ref.step = 0;
+            if (ref.ckB != data) {
+                break;
+            }
+            for (unsigned i = 0; i < ARRAYLEN(handlers); i++) {
+                if (handlers[i].msgClass == ref.msgClass && handlers[i].msgId == ref.msgId) {
+                    return handlers[i].fn(ref.buffer, ref.length);
+                }
+            }
+            break;
+    }
+
+    return false;
+}
+
+TEST(GpsUbloxParserTest, MatchesBytewiseReference)
+{
+    uint32_t expectedSum;
+    const std::vector<uint8_t> stream = buildStream(25, &expectedSum);
+    ubxParser_t parser;
+
+    resetCounters();
+    for (size_t n = 0; n < stream.size(); n++) {
+        refNewFrame(stream[n]);
+    }
+    const int refPvtCount = pvtCount;
+    const int refSigCount = sigCount;
+    EXPECT_EQ(expectedSum, payloadSum);
+
+    for (size_t chunkSize : { (size_t)1, (size_t)64, (size_t)110, stream.size() }) {
+        resetCounters();
+        ubxParserInit(&parser, handlers, ARRAYLEN(handlers), parserBuffer, TEST_MAX_PAYLOAD);
+        feedStream(&parser, stream, chunkSize);
+
+        EXPECT_EQ(refPvtCount, pvtCount) << "chunk " << chunkSize;
+        EXPECT_EQ(refSigCount, sigCount) << "chunk " << chunkSize;
+        EXPECT_EQ(expectedSum, payloadSum) << "chunk " << chunkSize;
+        EXPECT_EQ(0u, parser.errorCount) << "chunk " << chunkSize;
+    }
+}
+
+/*
+ * Throughput of the streaming parser against the bytewise reference. Runs over
+ * a raw receiver capture (e.g. a u-blox M10 log recorded with u-center) named
+ * by UBX_CAPTURE, or one second of the synthetic 25Hz stream without it.
+ * Disabled so "make check" stays fast, run with
+ * gps_ublox_parser_unittest --gtest_filter=*Benchmark --gtest_also_run_disabled_tests --gtest_output=json
+ * to get the MB/s figures in the test properties.
+ */
+TEST(GpsUbloxParserTest, DISABLED_Benchmark)
+{
+    const int rounds = 200;
+    const char *capturePath = getenv("UBX_CAPTURE");
+    std::vector<uint8_t> stream;
+    ubxParser_t parser;
+
+    if (capturePath) {
+        std::ifstream capture(capturePath, std::ios::binary);
+        ASSERT_TRUE(capture.good()) << capturePath;
+        stream.assign(std::istreambuf_iterator<char>(capture), std::istreambuf_iterator<char>());
+    } else {
+        stream = buildStream(25, NULL);
+    }
+    RecordProperty("stream_bytes", (int)stream.size());
+
+    resetCounters();
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < rounds; i++) {
+        for (size_t n = 0; n < stream.size(); n++) {
+            refNewFrame(stream[n]);
+        }
+    }
+    auto bytewise = std::chrono::high_resolution_clock::now() - start;
+    const int refPvtCount = pvtCount;
+    const int refSigCount = sigCount;
+
+    resetCounters();
+    ubxParserInit(&parser, handlers, ARRAYLEN(handlers), parserBuffer, TEST_MAX_PAYLOAD);
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < rounds; i++) {
+        feedStream(&parser, stream, 64);
+    }
+    auto streaming = std::chrono::high_resolution_clock::now() - start;
+
+    EXPECT_GT(refPvtCount, 0);
+    EXPECT_EQ(refPvtCount, pvtCount);
+    EXPECT_EQ(refSigCount, sigCount);
+
+    const double bytewiseUs = std::chrono::duration<double, std::micro>(bytewise).count();
+    const double streamingUs = std::chrono::duration<double, std::micro>(streaming).count();
+    const double megabytes = (double)rounds * stream.size() / 1e6;
+
+    RecordProperty("bytewise_MBps", (int)(megabytes / (bytewiseUs / 1e6)));
+    RecordProperty("streaming_MBps", (int)(megabytes / (streamingUs / 1e6)));
+}
@@ -0,0 +1,399 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "drivers/light_ws2811strip.h"
+    #include "drivers/time.h"
+
+    #include "fc/cli.h"
+    #include "fc/config.h"
+    #include "fc/fc_core.h"
+    #include "fc/rc_controls.h"
+    #include "fc/rc_modes.h"
+    #include "fc/runtime_config.h"
+
+    #include "flight/failsafe.h"
+    #include "flight/imu.h"
+    #include "flight/mixer_profile.h"
+    #include "flight/pid.h"
+
+    #include "io/gps.h"
+    #include "io/osd_common.h"
+
+    #include "navigation/navigation.h"
+    // navigation_private.h uses the C11 spelling
+    #define _Static_assert static_assert
+    #include "navigation/navigation_private.h"
+    #undef _Static_assert
+
+    #include "programming/global_variables.h"
+    #include "programming/logic_condition.h"
+    #include "programming/pid.h"
+
+    #include "rx/rx.h"
+
+    #include "sensors/battery.h"
+    #include "sensors/diagnostics.h"
+    #include "sensors/rangefinder.h"
+
+    extern logicConditionState_t logicConditionStates[MAX_LOGIC_CONDITIONS];
+    void pgResetFn_logicConditions(logicCondition_t *instance);
+    void pgResetFn_globalVariableConfigs(globalVariableConfig_t *instance);
+
+    static int16_t testRcChannels[MAX_SUPPORTED_RC_CHANNEL_COUNT];
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define RC_CHANNEL_1    1
+
+static void setCondition(uint8_t index, logicOperation_e operation, int8_t activatorId,
+                         logicOperandType_e typeA, int32_t valueA, logicOperandType_e typeB, int32_t valueB)
+{
+    logicCondition_t *condition = logicConditionsMutable(index);
+    condition->enabled = 1;
+    condition->activatorId = activatorId;
+    condition->operation = operation;
+    condition->operandA.type = typeA;
+    condition->operandA.value = valueA;
+    condition->operandB.type = typeB;
+    condition->operandB.value = valueB;
+    condition->flags = 0;
+}
+
+static void resetProgram(void)
+{
+    pgResetFn_logicConditions(logicConditionsMutable(0));
+    pgResetFn_globalVariableConfigs(globalVariableConfigsMutable(0));
+    gvInit();
+    logicConditionReset();
+    memset(testRcChannels, 0, sizeof(testRcChannels));
+}
+
+static void setRcChannel(uint8_t channel, int16_t value)
+{
+    testRcChannels[channel - 1] = value;
+    logicConditionNotifyRxFrame();
+}
+
+// LC1 = RC1 > 1500, LC0 = LC1 == 1: LC0 references a later LC
+TEST(LogicConditionTest, ReferenceChainSettlesInOnePass)
+{
+    resetProgram();
+    setCondition(0, LOGIC_CONDITION_EQUAL, -1, LOGIC_CONDITION_OPERAND_TYPE_LC, 1, LOGIC_CONDITION_OPERAND_TYPE_VALUE, 1);
+    setCondition(1, LOGIC_CONDITION_GREATER_THAN, -1, LOGIC_CONDITION_OPERAND_TYPE_RC_CHANNEL, RC_CHANNEL_1, LOGIC_CONDITION_OPERAND_TYPE_VALUE, 1500);
+
+    setRcChannel(RC_CHANNEL_1, 2000);
+    logicConditionUpdateTask(0);
+
+    EXPECT_EQ(1, logicConditionGetValue(1));
+    EXPECT_EQ(1, logicConditionGetValue(0));
+}
+
+// GVAR_SET activated by a later LC still runs before LCs after it that read the gvar,
+// and after LCs before it, which see the value of the previous run
+TEST(LogicConditionTest, GvarWriterKeepsIndexOrderWithReaders)
+{
+    resetProgram();
+    setCondition(0, LOGIC_CONDITION_EQUAL, -1, LOGIC_CONDITION_OPERAND_TYPE_GVAR, 0, LOGIC_CONDITION_OPERAND_TYPE_VALUE, 5);
+    setCondition(1, LOGIC_CONDITION_GVAR_SET, 10, LOGIC_CONDITION_OPERAND_TYPE_VALUE, 0, LOGIC_CONDITION_OPERAND_TYPE_VALUE, 5);
+    setCondition(2, LOGIC_CONDITION_EQUAL, -1, LOGIC_CONDITION_OPERAND_TYPE_GVAR, 0, LOGIC_CONDITION_OPERAND_TYPE_VALUE, 5);
+    setCondition(10, LOGIC_CONDITION_GREATER_THAN, -1, LOGIC_CONDITION_OPERAND_TYPE_RC_CHANNEL, RC_CHANNEL_1, LOGIC_CONDITION_OPERAND_TYPE_VALUE, 1500);
+
+    setRcChannel(RC_CHANNEL_1, 2000);
+    logicConditionUpdateTask(0);
+
+    EXPECT_EQ(5, gvGet(0));
+    EXPECT_EQ(1, logicConditionGetValue(2));
+    EXPECT_EQ(0, logicConditionGetValue(0));
+
+    logicConditionUpdateTask(0);
+    EXPECT_EQ(1, logicConditionGetValue(0));
+}
+
+// Several writers of one gvar: the last one in index order wins, whatever their activators
+TEST(LogicConditionTest, GvarWritersKeepIndexOrder)
+{
+    resetProgram();
+    setCondition(1, LOGIC_CONDITION_GVAR_SET, 5, LOGIC_CONDITION_OPERAND_TYPE_VALUE, 0, LOGIC_CONDITION_OPERAND_TYPE_VALUE, 1);
+    setCondition(3, LOGIC_CONDITION_GVAR_SET, -1, LOGIC_CONDITION_OPERAND_TYPE_VALUE, 0, LOGIC_CONDITION_OPERAND_TYPE_VALUE, 2);
+    setCondition(5, LOGIC_CONDITION_GREATER_THAN, -1, LOGIC_CONDITION_OPERAND_TYPE_RC_CHANNEL, RC_CHANNEL_1, LOGIC_CONDITION_OPERAND_TYPE_VALUE, 1500);
+
+    setRcChannel(RC_CHANNEL_1, 2000);
+    logicConditionUpdateTask(0);
+    EXPECT_EQ(2, gvGet(0));
+
+    logicConditionUpdateTask(0);
+    EXPECT_EQ(2, gvGet(0));
+}
+
+// gv0 = gv0 + 1 through two LCs forms a loop, which keeps index order and advances once per run
+TEST(LogicConditionTest, GvarCounterLoopAdvancesOncePerRun)
+{
+    resetProgram();
+    setCondition(0, LOGIC_CONDITION_ADD, -1, LOGIC_CONDITION_OPERAND_TYPE_GVAR, 0, LOGIC_CONDITION_OPERAND_TYPE_VALUE, 1);
+    setCondition(1, LOGIC_CONDITION_GVAR_SET, -1, LOGIC_CONDITION_OPERAND_TYPE_VALUE, 0, LOGIC_CONDITION_OPERAND_TYPE_LC, 0);
+
+    for (int run = 1; run <= 5; run++) {
+        logicConditionUpdateTask(0);
+        EXPECT_EQ(run, gvGet(0));
+    }
+}
+
+TEST(LogicConditionTest, ConstantConditionsAreFolded)
+{
+    resetProgram();
+    setCondition(0, LOGIC_CONDITION_ADD, -1, LOGIC_CONDITION_OPERAND_TYPE_VALUE, 2, LOGIC_CONDITION_OPERAND_TYPE_VALUE, 3);
+    setCondition(1, LOGIC_CONDITION_GREATER_THAN, -1, LOGIC_CONDITION_OPERAND_TYPE_LC, 0, LOGIC_CONDITION_OPERAND_TYPE_VALUE, 4);
+    // Activated by disabled LC 7
+    setCondition(2, LOGIC_CONDITION_GVAR_INC, 7, LOGIC_CONDITION_OPERAND_TYPE_VALUE, 1, LOGIC_CONDITION_OPERAND_TYPE_VALUE, 1);
+    // Activated by constant true LC 1, so it stays in the program
+    setCondition(3, LOGIC_CONDITION_GVAR_INC, 1, LOGIC_CONDITION_OPERAND_TYPE_VALUE, 2, LOGIC_CONDITION_OPERAND_TYPE_VALUE, 1);
+    setCondition(4, LOGIC_CONDITION_ADD, -1, LOGIC_CONDITION_OPERAND_TYPE_RC_CHANNEL, RC_CHANNEL_1, LOGIC_CONDITION_OPERAND_TYPE_VALUE, 1);
+
+    setRcChannel(RC_CHANNEL_1, 1000);
+    logicConditionUpdateTask(0);
+
+    EXPECT_EQ(5, logicConditionGetValue(0));
+    EXPECT_EQ(1, logicConditionGetValue(1));
+    EXPECT_EQ(0, logicConditionGetValue(2));
+    EXPECT_EQ(1001, logicConditionGetValue(4));
+
+    // Folded LCs are not evaluated again, live ones are
+    logicConditionStates[0].value = 99;
+    logicConditionStates[1].value = 99;
+    logicConditionStates[4].value = 99;
+    setRcChannel(RC_CHANNEL_1, 1100);
+    logicConditionUpdateTask(0);
+
+    EXPECT_EQ(99, logicConditionGetValue(0));
+    EXPECT_EQ(99, logicConditionGetValue(1));
+    EXPECT_EQ(1101, logicConditionGetValue(4));
+    EXPECT_EQ(0, gvGet(1));
+    EXPECT_EQ(2, gvGet(2));
+
+    // Reset recomputes folded constants
+    logicConditionReset();
+    logicConditionUpdateTask(0);
+    EXPECT_EQ(5, logicConditionGetValue(0));
+    EXPECT_EQ(1, logicConditionGetValue(1));
+}
+
+/*
+ * Reference: every enabled LC evaluated in index order once per run, as before the program
+ * was compiled. Covers the operations used by the chain below
+ */
+static int32_t referenceStates[MAX_LOGIC_CONDITIONS];
+static int32_t referenceGvars[MAX_GLOBAL_VARIABLES];
+
+static int32_t referenceOperand(const logicOperand_t *operand)
+{
+    switch (operand->type) {
+        case LOGIC_CONDITION_OPERAND_TYPE_RC_CHANNEL:
+            return testRcChannels[operand->value - 1];
+        case LOGIC_CONDITION_OPERAND_TYPE_LC:
+            return referenceStates[operand->value];
+        case LOGIC_CONDITION_OPERAND_TYPE_GVAR:
+            return referenceGvars[operand->value];
+        default:
+            return operand->value;
+    }
+}
+
+static void referencePass(void)
+{
+    for (int i = 0; i < MAX_LOGIC_CONDITIONS; i++) {
+        const logicCondition_t *condition = logicConditions(i);
+        if (!condition->enabled) {
+            continue;
+        }
+        if (condition->activatorId >= 0 && !referenceStates[condition->activatorId]) {
+            referenceStates[i] = 0;
+            continue;
+        }
+        const int32_t a = referenceOperand(&condition->operandA);
+        const int32_t b = referenceOperand(&condition->operandB);
+        switch (condition->operation) {
+            case LOGIC_CONDITION_GREATER_THAN:
+                referenceStates[i] = a > b;
+                break;
+            case LOGIC_CONDITION_EQUAL:
+                referenceStates[i] = a == b;
+                break;
+            case LOGIC_CONDITION_ADD:
+                referenceStates[i] = a + b;
+                break;
+            case LOGIC_CONDITION_GVAR_SET:
+                referenceGvars[a] = b;
+                referenceStates[i] = b;
+                break;
+            default:
+                FAIL() << "operation not covered by reference";
+        }
+    }
+}
+
+/*
+ * gvar chain with readers before and after each writer. LC references only point
+ * backwards, so index order and dependency order agree on them:
+ *   LC0 = gv1 == 11            reads gv1 before it is written
+ *   LC1 = RC1 > 1000
+ *   LC2 = RC1 > 1500
+ *   LC3 = gv0 := LC2           activated by LC1
+ *   LC4 = gv0 + 10
+ *   LC5 = gv1 := LC4
+ *   LC6 = LC0 + gv0
+ */
+static void setupGvarChain(void)
+{
+    resetProgram();
+    setCondition(0, LOGIC_CONDITION_EQUAL, -1, LOGIC_CONDITION_OPERAND_TYPE_GVAR, 1, LOGIC_CONDITION_OPERAND_TYPE_VALUE, 11);
+    setCondition(1, LOGIC_CONDITION_GREATER_THAN, -1, LOGIC_CONDITION_OPERAND_TYPE_RC_CHANNEL, RC_CHANNEL_1, LOGIC_CONDITION_OPERAND_TYPE_VALUE, 1000);
+    setCondition(2, LOGIC_CONDITION_GREATER_THAN, -1, LOGIC_CONDITION_OPERAND_TYPE_RC_CHANNEL, RC_CHANNEL_1, LOGIC_CONDITION_OPERAND_TYPE_VALUE, 1500);
+    setCondition(3, LOGIC_CONDITION_GVAR_SET, 1, LOGIC_CONDITION_OPERAND_TYPE_VALUE, 0, LOGIC_CONDITION_OPERAND_TYPE_LC, 2);
+    setCondition(4, LOGIC_CONDITION_ADD, -1, LOGIC_CONDITION_OPERAND_TYPE_GVAR, 0, LOGIC_CONDITION_OPERAND_TYPE_VALUE, 10);
+    setCondition(5, LOGIC_CONDITION_GVAR_SET, -1, LOGIC_CONDITION_OPERAND_TYPE_VALUE, 1, LOGIC_CONDITION_OPERAND_TYPE_LC, 4);
+    setCondition(6, LOGIC_CONDITION_ADD, -1, LOGIC_CONDITION_OPERAND_TYPE_LC, 0, LOGIC_CONDITION_OPERAND_TYPE_GVAR, 0);
+
+    memset(referenceStates, 0, sizeof(referenceStates));
+    memset(referenceGvars, 0, sizeof(referenceGvars));
+}
+
+static void expectSameAsReference(int step)
+{
+    for (int i = 0; i < MAX_LOGIC_CONDITIONS; i++) {
+        EXPECT_EQ(referenceStates[i], logicConditionGetValue(i)) << "LC" << i << " step " << step;
+    }
+    for (int i = 0; i < MAX_GLOBAL_VARIABLES; i++) {
+        EXPECT_EQ(referenceGvars[i], gvGet(i)) << "gv" << i << " step " << step;
+    }
+}
+
+static const int16_t gvarChainRc[] = { 900, 1200, 1200, 1800, 1800, 1800, 1200, 900, 900, 1800 };
+
+TEST(LogicConditionTest, EventDrivenGvarChainMatchesFullPass)
+{
+    setupGvarChain();
+
+    // First run evaluates everything once
+    logicConditionProcessPending();
+    referencePass();
+    expectSameAsReference(-1);
+
+    for (unsigned step = 0; step < ARRAYLEN(gvarChainRc); step++) {
+        if (testRcChannels[0] != gvarChainRc[step]) {
+            setRcChannel(RC_CHANNEL_1, gvarChainRc[step]);
+        }
+        logicConditionProcessPending();
+        referencePass();
+        expectSameAsReference(step);
+    }
+}
+
+TEST(LogicConditionTest, TaskGvarChainMatchesFullPass)
+{
+    setupGvarChain();
+
+    for (unsigned step = 0; step < ARRAYLEN(gvarChainRc); step++) {
+        if (testRcChannels[0] != gvarChainRc[step]) {
+            setRcChannel(RC_CHANNEL_1, gvarChainRc[step]);
+        }
+        logicConditionUpdateTask(0);
+        referencePass();
+        expectSameAsReference(step);
+    }
+}
+
+// STUBS
+extern "C" {
+    bool cliMode = false;
+    uint32_t armingFlags;
+    uint32_t flightModeFlags;
+    uint32_t stateFlags;
+    int16_t rcCommand[4];
+    int16_t axisPID[XYZ_AXIS_COUNT];
+    uint32_t GPS_distanceToHome;
+    gpsSolutionData_t gpsSol;
+    navSystemStatus_t NAV_Status;
+    navigationPosControl_t posControl;
+    navConfig_t navConfig_System;
+    pidProfile_t *pidProfile_ProfileCurrent;
+    int currentMixerProfileIndex;
+    bool isMixerTransitionMixing;
+
+    int16_t rxGetChannelValue(unsigned channelNumber) { return testRcChannels[channelNumber]; }
+    uint16_t getRSSI(void) { return 0; }
+    bool IS_RC_MODE_ACTIVE(boxId_e boxId) { UNUSED(boxId); return false; }
+
+    timeMs_t millis(void) { return 0; }
+    float getFlightTime(void) { return 0; }
+
+    uint8_t getConfigProfile(void) { return 0; }
+    bool setConfigProfile(uint8_t profileIndex) { UNUSED(profileIndex); return false; }
+    uint8_t getConfigBatteryProfile(void) { return 0; }
+
+    uint16_t getBatteryVoltage(void) { return 0; }
+    uint8_t getBatteryCellCount(void) { return 0; }
+    uint16_t getBatteryAverageCellVoltage(void) { return 0; }
+    int16_t getAmperage(void) { return 0; }
+    int32_t getMAhDrawn(void) { return 0; }
+
+    failsafePhase_e failsafePhase(void) { return FAILSAFE_IDLE; }
+    hardwareSensorStatus_e getHwGPSStatus(void) { return HW_SENSOR_NONE; }
+    int32_t rangefinderGetLatestRawAltitude(void) { return 0; }
+    const attitudeEulerAngles_t *imuGetAttitude(void) { static attitudeEulerAngles_t attitude; return &attitude; }
+    int16_t osdGet3DSpeed(void) { return 0; }
+
+    float getEstimatedActualVelocity(int axis) { UNUSED(axis); return 0; }
+    float getEstimatedActualPosition(int axis) { UNUSED(axis); return 0; }
+    float getEstimatedAglPosition(void) { return 0; }
+    bool isEstimatedAglTrusted(void) { return false; }
+    uint32_t getTotalTravelDistance(void) { return 0; }
+    uint16_t getFlownLoiterRadius(void) { return 0; }
+    bool navigationIsExecutingAnEmergencyLanding(void) { return false; }
+    navigationFSMStateFlags_t navGetCurrentStateFlags(void) { return (navigationFSMStateFlags_t)0; }
+    uint32_t calculateDistanceToDestination(const fpVector3_t *destinationPos) { UNUSED(destinationPos); return 0; }
+    bool geoConvertGeodeticToLocal(fpVector3_t *pos, const gpsOrigin_t *origin, const gpsLocation_t *llh, geoAltitudeConversionMode_e altConv)
+    {
+        UNUSED(pos); UNUSED(origin); UNUSED(llh); UNUSED(altConv);
+        return false;
+    }
+    void navigationUsePIDs(void) {}
+
+    void pidInit(void) {}
+    bool pidInitFilters(void) { return true; }
+    void schedulePidGainsUpdate(void) {}
+    void updateHeadingHoldTarget(int16_t heading) { UNUSED(heading); }
+    int32_t programmingPidGetOutput(uint8_t i) { UNUSED(i); return 0; }
+
+    void ledPinStartPWM(uint16_t value) { UNUSED(value); }
+    void ledPinStopPWM(void) {}
+}
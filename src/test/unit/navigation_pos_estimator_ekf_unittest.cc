@@ -0,0 +1,161 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+#include <stdint.h>
+#include <math.h>
+#include <random>
+
+extern "C" {
+    #include "platform.h"
+    #include "common/maths.h"
+    #include "navigation/navigation_pos_estimator_ekf.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define TEST_IMU_RATE_HZ        500
+#define TEST_GPS_RATE_HZ        10
+#define TEST_DURATION_S         120
+#define TEST_SETTLE_S           20
+
+#define TEST_ACC_BIAS           50.0f   // cm/s/s
+#define TEST_ACC_NOISE          30.0f   // cm/s/s
+#define TEST_GPS_POS_NOISE      100.0f  // cm
+#define TEST_GPS_VEL_NOISE      30.0f   // cm/s
+
+#define TEST_EKF_ACC_NOISE      50.0f
+#define TEST_EKF_BIAS_NOISE     1.0f
+#define TEST_EKF_GATE           5.0f
+
+static float covDeterminant(const navEkfAxis_t *ekf)
+{
+    const float *P = ekf->P;    // 00 01 02 11 12 22
+    return P[0] * (P[3] * P[5] - P[4] * P[4])
+         - P[1] * (P[1] * P[5] - P[4] * P[2])
+         + P[2] * (P[1] * P[4] - P[3] * P[2]);
+}
+
+TEST(NavEkfTest, PredictFollowsKinematics)
+{
+    navEkfAxis_t ekf;
+    navEkfAxisReset(&ekf, 100.0f, 20.0f, 1.0f, 1.0f, 1.0f);
+
+    // 1s at 50Hz, 10cm/s/s measured of which 4 is bias
+    ekf.x[NAV_EKF_ACC_BIAS] = 4.0f;
+    for (int i = 0; i < 50; i++) {
+        navEkfAxisPredict(&ekf, 10.0f, 0.02f, 0.0f, 0.0f);
+    }
+
+    EXPECT_NEAR(ekf.x[NAV_EKF_POS], 100.0f + 20.0f + 0.5f * 6.0f, 1e-3f);
+    EXPECT_NEAR(ekf.x[NAV_EKF_VEL], 20.0f + 6.0f, 1e-3f);
+    EXPECT_FLOAT_EQ(ekf.x[NAV_EKF_ACC_BIAS], 4.0f);
+
+    // Position uncertainty must grow with velocity and bias uncertainty
+    EXPECT_GT(navEkfAxisGetVariance(&ekf, NAV_EKF_POS), 1.0f + 1.0f);
+}
+
+TEST(NavEkfTest, UpdateConvergesAndGates)
+{
+    navEkfAxis_t ekf;
+    navEkfAxisReset(&ekf, 0.0f, 0.0f, sq(1000.0f), sq(100.0f), sq(20.0f));
+
+    EXPECT_TRUE(navEkfAxisUpdate(&ekf, NAV_EKF_POS, 500.0f, sq(10.0f), TEST_EKF_GATE));
+    EXPECT_NEAR(ekf.x[NAV_EKF_POS], 500.0f, 1.0f);
+    EXPECT_LT(navEkfAxisGetVariance(&ekf, NAV_EKF_POS), sq(10.0f));
+
+    // 50 sigma away - rejected, state untouched
+    const float pos = ekf.x[NAV_EKF_POS];
+    EXPECT_FALSE(navEkfAxisUpdate(&ekf, NAV_EKF_POS, pos + 700.0f, sq(10.0f), TEST_EKF_GATE));
+    EXPECT_FLOAT_EQ(ekf.x[NAV_EKF_POS], pos);
+
+    // Same measurement passes with gating disabled
+    EXPECT_TRUE(navEkfAxisUpdate(&ekf, NAV_EKF_POS, pos + 700.0f, sq(10.0f), 0.0f));
+}
+
+TEST(NavEkfTest, SetStateDecorrelates)
+{
+    navEkfAxis_t ekf;
+    navEkfAxisReset(&ekf, 0.0f, 0.0f, 100.0f, 100.0f, 100.0f);
+
+    for (int i = 0; i < 100; i++) {
+        navEkfAxisPredict(&ekf, 0.0f, 0.01f, 100.0f, 1.0f);
+        navEkfAxisUpdate(&ekf, NAV_EKF_POS, 0.0f, 100.0f, 0.0f);
+    }
+    EXPECT_NE(ekf.P[1], 0.0f);
+
+    navEkfAxisSetState(&ekf, NAV_EKF_POS, 1234.0f, 25.0f);
+    EXPECT_FLOAT_EQ(ekf.x[NAV_EKF_POS], 1234.0f);
+    EXPECT_FLOAT_EQ(ekf.P[0], 25.0f);
+    EXPECT_FLOAT_EQ(ekf.P[1], 0.0f);
+    EXPECT_FLOAT_EQ(ekf.P[2], 0.0f);
+}
+
+/*
+ * Replay a simulated flight with a biased, noisy accelerometer and noisy GPS:
+ * the estimate has to stay well inside the GPS noise and find the bias
+ */
+TEST(NavEkfTest, ReplayTracksSimulatedFlight)
+{
+    std::mt19937 rng(1234);
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+
+    const float dt = 1.0f / TEST_IMU_RATE_HZ;
+    const int gpsDivider = TEST_IMU_RATE_HZ / TEST_GPS_RATE_HZ;
+
+    navEkfAxis_t ekf;
+    navEkfAxisReset(&ekf, 0.0f, 0.0f, sq(TEST_GPS_POS_NOISE), sq(100.0f), sq(20.0f));
+
+    float truePos = 0.0f, trueVel = 0.0f;
+    double posErrSq = 0, velErrSq = 0, posErrSum = 0;
+    int samples = 0;
+
+    for (int i = 0; i < TEST_DURATION_S * TEST_IMU_RATE_HZ; i++) {
+        const float t = i * dt;
+        const float trueAcc = 200.0f * sinf(0.5f * t) + 100.0f * sinf(1.3f * t);
+        truePos += trueVel * dt + trueAcc * sq(dt) / 2.0f;
+        trueVel += trueAcc * dt;
+
+        // Prediction every IMU sample, fusion once per GPS sample
+        navEkfAxisPredict(&ekf, trueAcc + TEST_ACC_BIAS + TEST_ACC_NOISE * noise(rng), dt, sq(TEST_EKF_ACC_NOISE), sq(TEST_EKF_BIAS_NOISE));
+        if ((i % gpsDivider) == 0) {
+            navEkfAxisUpdate(&ekf, NAV_EKF_POS, truePos + TEST_GPS_POS_NOISE * noise(rng), sq(TEST_GPS_POS_NOISE), TEST_EKF_GATE);
+            navEkfAxisUpdate(&ekf, NAV_EKF_VEL, trueVel + TEST_GPS_VEL_NOISE * noise(rng), sq(TEST_GPS_VEL_NOISE), TEST_EKF_GATE);
+        }
+
+        if (t >= TEST_SETTLE_S) {
+            posErrSq += sq(ekf.x[NAV_EKF_POS] - truePos);
+            velErrSq += sq(ekf.x[NAV_EKF_VEL] - trueVel);
+            posErrSum += ekf.x[NAV_EKF_POS] - truePos;
+            samples++;
+        }
+
+        ASSERT_GT(covDeterminant(&ekf), 0.0f);
+    }
+
+    EXPECT_LT(sqrtf(posErrSq / samples), 0.3f * TEST_GPS_POS_NOISE);
+    EXPECT_LT(sqrtf(velErrSq / samples), 0.3f * TEST_GPS_VEL_NOISE);
+    EXPECT_LT(fabsf(posErrSum / samples), 15.0f);
+    EXPECT_NEAR(ekf.x[NAV_EKF_ACC_BIAS], TEST_ACC_BIAS, 5.0f);
+}
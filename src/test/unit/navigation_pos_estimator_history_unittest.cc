@@ -0,0 +1,207 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+#include <stdint.h>
+#include <math.h>
+
+extern "C" {
+    #include "platform.h"
+    #include "common/maths.h"
+    #include "common/time.h"
+    #include "common/vector.h"
+    #include "navigation/navigation_pos_estimator_history.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define TEST_LOOP_RATE_HZ       500
+#define TEST_GPS_RATE_HZ        10
+#define TEST_GPS_LATENCY_US     150000
+#define TEST_DURATION_S         60
+
+static navPosHistory_t history;
+
+static fpVector3_t vec(float x, float y, float z)
+{
+    fpVector3_t v = { .v = { x, y, z } };
+    return v;
+}
+
+TEST(NavPosHistoryTest, InterpolatesAndClamps)
+{
+    navPosHistoryReset(&history);
+
+    fpVector3_t pos, vel;
+    EXPECT_FALSE(navPosHistoryGetState(&history, 0, &pos, &vel));
+
+    // Position ramps 1cm per ms, pushed every 1ms but stored every 10ms
+    for (timeUs_t t = 1000; t <= 100000; t += 1000) {
+        const fpVector3_t p = vec(t / 1000.0f, 0, 0);
+        const fpVector3_t v = vec(1000.0f, 0, 0);
+        navPosHistoryPush(&history, t, &p, &v);
+    }
+    EXPECT_EQ(10, navPosHistoryGetDepth(&history));
+
+    EXPECT_TRUE(navPosHistoryGetState(&history, 45000, &pos, &vel));
+    EXPECT_NEAR(45.0f, pos.x, 1e-3f);
+
+    // Outside of the recorded window
+    navPosHistoryGetState(&history, 200000, &pos, &vel);
+    EXPECT_NEAR(91.0f, pos.x, 1e-3f);
+    navPosHistoryGetState(&history, 0, &pos, &vel);
+    EXPECT_NEAR(1.0f, pos.x, 1e-3f);
+}
+
+TEST(NavPosHistoryTest, CorrectionsApplyToPastStates)
+{
+    navPosHistoryReset(&history);
+
+    for (timeUs_t t = 10000; t <= 100000; t += 10000) {
+        const fpVector3_t p = vec(0, 0, 0);
+        navPosHistoryPush(&history, t, &p, &p);
+    }
+
+    fpVector3_t pos, vel;
+    const fpVector3_t posCorr = vec(5.0f, -3.0f, 1.0f);
+    const fpVector3_t velCorr = vec(2.0f, 0.0f, 0.0f);
+    navPosHistoryAddCorrection(&history, &posCorr, &velCorr);
+
+    navPosHistoryGetState(&history, 50000, &pos, &vel);
+    EXPECT_FLOAT_EQ(5.0f, pos.x);
+    EXPECT_FLOAT_EQ(-3.0f, pos.y);
+    EXPECT_FLOAT_EQ(2.0f, vel.x);
+
+    // Large corrections are folded into the entries without changing the result
+    const fpVector3_t bigCorr = vec(20000.0f, 0.0f, 0.0f);
+    navPosHistoryAddCorrection(&history, &bigCorr, &velCorr);
+    EXPECT_FLOAT_EQ(0.0f, history.posCorr.x);
+
+    navPosHistoryGetState(&history, 50000, &pos, &vel);
+    EXPECT_FLOAT_EQ(20005.0f, pos.x);
+    EXPECT_FLOAT_EQ(4.0f, vel.x);
+
+    // New entries are stored relative to the corrections
+    const fpVector3_t p = vec(100.0f, 0, 0);
+    navPosHistoryAddCorrection(&history, &posCorr, &velCorr);
+    navPosHistoryPush(&history, 110000, &p, &p);
+    navPosHistoryGetState(&history, 110000, &pos, &vel);
+    EXPECT_FLOAT_EQ(100.0f, pos.x);
+}
+
+static float trueAccel(float t)
+{
+    return 300.0f * sinf(0.8f * t) + 150.0f * sinf(2.1f * t);
+}
+
+// Deterministic GPS velocity noise, uniform in +-amplitude
+static float gpsNoise(uint32_t *seed, float amplitude)
+{
+    *seed = *seed * 1664525u + 1013904223u;
+    return amplitude * ((float)(*seed >> 8) / (1 << 23) - 1.0f);
+}
+
+/*
+ * Noisy GPS velocity delayed by TEST_GPS_LATENCY_US. Lags that only just got
+ * covered by the history must not be picked before they have settled.
+ */
+TEST(NavPosHistoryTest, MeasuresLatency)
+{
+    navPosHistoryReset(&history);
+
+    const float dt = 1.0f / TEST_LOOP_RATE_HZ;
+    const int lagSamples = TEST_GPS_LATENCY_US / (1000000 / TEST_LOOP_RATE_HZ);
+    float pos = 0, vel = 0;
+    float delayedVel[TEST_LOOP_RATE_HZ];    // 1s of true velocity
+    uint32_t seed = 1;
+
+    for (int i = 0; i < TEST_DURATION_S * TEST_LOOP_RATE_HZ; i++) {
+        const timeUs_t now = (timeUs_t)i * (1000000 / TEST_LOOP_RATE_HZ);
+        vel += trueAccel(i * dt) * dt;
+        pos += vel * dt;
+        delayedVel[i % TEST_LOOP_RATE_HZ] = vel;
+
+        const fpVector3_t p = vec(pos, 0, 0);
+        const fpVector3_t v = vec(vel, 0, 0);
+        navPosHistoryPush(&history, now, &p, &v);
+
+        if (i > lagSamples && (i % (TEST_LOOP_RATE_HZ / TEST_GPS_RATE_HZ)) == 0) {
+            const fpVector3_t gpsVel = vec(delayedVel[(i - lagSamples) % TEST_LOOP_RATE_HZ] + gpsNoise(&seed, 5.0f), gpsNoise(&seed, 5.0f), 0);
+            navPosHistoryUpdateLatency(&history, now, &gpsVel);
+
+            if (i * dt < 1.0f) {
+                EXPECT_EQ(0, navPosHistoryGetMeasuredLatencyMs(&history));
+            } else if (i * dt >= 5.0f) {
+                EXPECT_NEAR(TEST_GPS_LATENCY_US / 1000, navPosHistoryGetMeasuredLatencyMs(&history), NAV_POS_HISTORY_PERIOD_US / 1000);
+            }
+        }
+    }
+}
+
+/*
+ * Perfect estimate and GPS delayed by TEST_GPS_LATENCY_US: residuals against
+ * the history at the sample time only carry interpolation error, residuals
+ * against the current estimate carry the full lag
+ */
+TEST(NavPosHistoryTest, DelayedResidualsMatchSampleTime)
+{
+    const float dt = 1.0f / TEST_LOOP_RATE_HZ;
+    const int lagSamples = TEST_GPS_LATENCY_US / (1000000 / TEST_LOOP_RATE_HZ);
+
+    float truePos[TEST_LOOP_RATE_HZ], trueVel[TEST_LOOP_RATE_HZ];
+    float pos = 0, vel = 0;
+    double historyErrSq = 0, historyErrSum = 0, currentErrSq = 0;
+    int samples = 0;
+
+    navPosHistoryReset(&history);
+
+    for (int i = 0; i < TEST_DURATION_S * TEST_LOOP_RATE_HZ; i++) {
+        const timeUs_t now = (timeUs_t)i * (1000000 / TEST_LOOP_RATE_HZ);
+        const float acc = trueAccel(i * dt);
+        pos += vel * dt + acc * sq(dt) / 2.0f;
+        vel += acc * dt;
+        truePos[i % TEST_LOOP_RATE_HZ] = pos;
+        trueVel[i % TEST_LOOP_RATE_HZ] = vel;
+
+        const fpVector3_t p = vec(pos, 0, 0);
+        const fpVector3_t v = vec(vel, 0, 0);
+        navPosHistoryPush(&history, now, &p, &v);
+
+        if (i > TEST_LOOP_RATE_HZ && (i % (TEST_LOOP_RATE_HZ / TEST_GPS_RATE_HZ)) == 0) {
+            const float gpsPos = truePos[(i - lagSamples) % TEST_LOOP_RATE_HZ];
+            fpVector3_t hPos, hVel;
+            ASSERT_TRUE(navPosHistoryGetState(&history, now - TEST_GPS_LATENCY_US, &hPos, &hVel));
+            EXPECT_NEAR(trueVel[(i - lagSamples) % TEST_LOOP_RATE_HZ], hVel.x, 5.0f);
+
+            historyErrSq += sq(gpsPos - hPos.x);
+            historyErrSum += gpsPos - hPos.x;
+            currentErrSq += sq(gpsPos - pos);
+            samples++;
+        }
+    }
+
+    EXPECT_LT(sqrt(historyErrSq / samples), 1.0);
+    EXPECT_LT(fabs(historyErrSum / samples), 0.1);
+    EXPECT_GT(sqrt(currentErrSq / samples), 50.0);
+}
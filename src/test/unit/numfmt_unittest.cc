@@ -0,0 +1,109 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+
+extern "C" {
+    #include "common/numfmt.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+TEST(NumfmtUnittest, SignedMatchesPrintf)
+{
+    const int32_t values[] = { 0, 1, -1, 9, 10, -10, 123, -123, 99999, INT32_MAX, INT32_MIN };
+    char buf[24];
+    char expected[24];
+
+    for (int32_t value : values) {
+        for (int width = 0; width <= 12; width++) {
+            int len = numfmtSigned(buf, value, width, ' ');
+            snprintf(expected, sizeof(expected), "%*d", width, (int)value);
+            EXPECT_STREQ(expected, buf);
+            EXPECT_EQ((int)strlen(expected), len);
+
+            len = numfmtSigned(buf, value, width, '0');
+            snprintf(expected, sizeof(expected), "%0*d", width, (int)value);
+            EXPECT_STREQ(expected, buf);
+            EXPECT_EQ((int)strlen(expected), len);
+        }
+    }
+}
+
+TEST(NumfmtUnittest, UnsignedMatchesPrintf)
+{
+    const uint32_t values[] = { 0, 7, 42, 1000000, UINT32_MAX };
+    char buf[24];
+    char expected[24];
+
+    for (uint32_t value : values) {
+        for (int width = 0; width <= 12; width++) {
+            int len = numfmtUnsigned(buf, value, width, '0');
+            snprintf(expected, sizeof(expected), "%0*u", width, (unsigned)value);
+            EXPECT_STREQ(expected, buf);
+            EXPECT_EQ((int)strlen(expected), len);
+        }
+    }
+}
+
+TEST(NumfmtUnittest, Fixed)
+{
+    char buf[24];
+
+    EXPECT_EQ(5, numfmtFixed(buf, 1234, 2, 0));
+    EXPECT_STREQ("12.34", buf);
+
+    numfmtFixed(buf, 5, 2, 0);
+    EXPECT_STREQ("0.05", buf);
+
+    numfmtFixed(buf, -5, 2, 6);
+    EXPECT_STREQ(" -0.05", buf);
+
+    numfmtFixed(buf, -1234, 1, 0);
+    EXPECT_STREQ("-123.4", buf);
+
+    numfmtFixed(buf, 1234, 0, 5);
+    EXPECT_STREQ(" 1234", buf);
+
+    numfmtFixed(buf, INT32_MIN, 3, 0);
+    EXPECT_STREQ("-2147483.648", buf);
+}
+
+TEST(NumfmtUnittest, Centered)
+{
+    char buf[24];
+
+    EXPECT_EQ(7, numfmtCentered(buf, "ABC", 7));
+    EXPECT_STREQ("  ABC  ", buf);
+
+    numfmtCentered(buf, "AB", 5);
+    EXPECT_STREQ(" AB  ", buf);
+
+    EXPECT_EQ(7, numfmtCentered(buf, "TOOLONG", 3));
+    EXPECT_STREQ("TOOLONG", buf);
+}
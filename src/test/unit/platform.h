@@ -44,6 +44,10 @@ typedef struct {
     void * test;
 } TIM_TypeDef;
 
+typedef struct {
+    void * test;
+} USART_TypeDef;
+
 typedef enum {
   EXTI_Trigger_Rising = 0x08,
   EXTI_Trigger_Falling = 0x0C,
@@ -84,3 +88,8 @@ extern SysTick_Type *SysTick;
 #define FAST_CODE 
 #define NOINLINE
 #define EXTENDED_FASTRAM
+
+// Same as firmware platform.h, packed structure member access is safe
+#if (__GNUC__ >= 9)
+#pragma GCC diagnostic ignored "-Waddress-of-packed-member"
+#endif
@@ -0,0 +1,231 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+
+#include <stdint.h>
+
+extern "C" {
+    #include "platform.h"
+    #include "common/maths.h"
+    #include "common/utils.h"
+    #include "common/vector.h"
+    #include "fc/multifunction.h"
+    #include "fc/runtime_config.h"
+    #include "io/gps.h"
+    #include "navigation/navigation.h"
+    // navigation_private.h uses the C11 spelling
+    #define _Static_assert static_assert
+    #include "navigation/navigation_private.h"
+    #undef _Static_assert
+    #include "navigation/rth_trackback.h"
+
+    uint32_t armingFlags;
+    uint32_t flightModeFlags;
+    uint32_t stateFlags;
+    gpsSolutionData_t gpsSol;
+    navSystemStatus_t NAV_Status;
+    navigationPosControl_t posControl;
+    navConfig_t navConfig_System;
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define MAX_TEST_POINTS 400
+
+// Rounding every offset to whole meters may move a point by half a meter per axis
+#define ROUNDING_TOLERANCE_CM 87.0f
+
+static fpVector3_t recorded[MAX_TEST_POINTS];
+static int recordedCount;
+
+static void startTrack(void)
+{
+    navConfig_System.general.flags.rth_trackback_mode = RTH_TRACKBACK_ON;
+    navConfig_System.general.rth_trackback_distance = 50000;
+    armingFlags = ARMED;
+    flightModeFlags = 0;
+    stateFlags = 0;
+    posControl.flags.estPosStatus = EST_TRUSTED;
+    posControl.flags.estAltStatus = EST_TRUSTED;
+    posControl.homeDistance = METERS_TO_CENTIMETERS(NAV_RTH_TRACKBACK_MIN_DIST_TO_START) + 1;
+    recordedCount = 0;
+    resetRthTrackBack();
+}
+
+static void recordPoint(float x, float y, float z)
+{
+    posControl.actualState.abs.pos.x = x;
+    posControl.actualState.abs.pos.y = y;
+    posControl.actualState.abs.pos.z = z;
+    rthTrackBackUpdate(true);
+    recorded[recordedCount++] = posControl.actualState.abs.pos;
+}
+
+// Decodes the store newest to oldest the way RTH walks it, returns points oldest first
+static int walkTrack(fpVector3_t *points)
+{
+    posControl.actualState.abs.pos = rth_trackback.lastPoint;
+
+    const int count = rth_trackback.pointCount;
+    int index = count - 1;
+
+    points[index--] = rth_trackback.activePoint;
+    while (rthTrackBackSetNewPosition()) {
+        points[index--] = rth_trackback.activePoint;
+    }
+
+    EXPECT_EQ(-1, index);
+    return count;
+}
+
+static float distanceToPolyline(const fpVector3_t *point, const fpVector3_t *line, int count)
+{
+    float best = INFINITY;
+
+    for (int i = 0; i + 1 < count; i++) {
+        const float sx = line[i + 1].x - line[i].x, sy = line[i + 1].y - line[i].y, sz = line[i + 1].z - line[i].z;
+        const float px = point->x - line[i].x, py = point->y - line[i].y, pz = point->z - line[i].z;
+        const float lengthSq = sx * sx + sy * sy + sz * sz;
+        const float t = lengthSq > 0 ? constrainf((px * sx + py * sy + pz * sz) / lengthSq, 0.0f, 1.0f) : 0;
+        best = MIN(best, sqrtf(sq(px - t * sx) + sq(py - t * sy) + sq(pz - t * sz)));
+    }
+
+    return best;
+}
+
+static void expectNear(const fpVector3_t *expected, const fpVector3_t *actual, float tolerance)
+{
+    EXPECT_NEAR(expected->x, actual->x, tolerance);
+    EXPECT_NEAR(expected->y, actual->y, tolerance);
+    EXPECT_NEAR(expected->z, actual->z, tolerance);
+}
+
+TEST(RthTrackbackTest, DeltaEncodingRoundTrip)
+{
+    startTrack();
+
+    // Wandering climb with sub-meter positions, short enough to keep every point
+    for (int i = 0; i < NAV_RTH_TRACKBACK_POINTS; i++) {
+        recordPoint(i * 4037.3f + 811.9f * sinf(i * 0.7f), 1500.0f * cosf(i * 0.3f) - i * 733.1f, 3000.0f + 431.7f * sinf(i * 1.3f));
+    }
+
+    ASSERT_EQ(NAV_RTH_TRACKBACK_POINTS, rth_trackback.pointCount);
+    expectNear(&recorded[0], &rth_trackback.firstPoint, ROUNDING_TOLERANCE_CM);
+
+    fpVector3_t decoded[NAV_RTH_TRACKBACK_POINTS];
+    ASSERT_EQ(recordedCount, walkTrack(decoded));
+
+    // Offsets are taken from the stored last point, so the error stays bounded along the whole track
+    for (int i = 0; i < recordedCount; i++) {
+        expectNear(&recorded[i], &decoded[i], 50.0f + 1.0f);
+    }
+}
+
+TEST(RthTrackbackTest, SimplificationKeepsTrackWithinTolerance)
+{
+    startTrack();
+
+    // Five straight legs with sharp turns, three times as many points as the store holds
+    static const float corners[][3] = {
+        { 0, 0, 5000 }, { 400000, 0, 5000 }, { 400000, 320000, 9000 }, { 80000, 320000, 9000 }, { 80000, 600000, 4000 }, { 480000, 600000, 4000 },
+    };
+    const int legs = ARRAYLEN(corners) - 1;
+    const int pointsPerLeg = 3 * NAV_RTH_TRACKBACK_POINTS / legs;
+
+    for (int leg = 0; leg < legs; leg++) {
+        for (int i = 0; i < pointsPerLeg; i++) {
+            const float t = (float)i / pointsPerLeg;
+            recordPoint(corners[leg][0] + t * (corners[leg + 1][0] - corners[leg][0]),
+                        corners[leg][1] + t * (corners[leg + 1][1] - corners[leg][1]),
+                        corners[leg][2] + t * (corners[leg + 1][2] - corners[leg][2]));
+        }
+    }
+    recordPoint(corners[legs][0], corners[legs][1], corners[legs][2]);
+
+    ASSERT_EQ(NAV_RTH_TRACKBACK_POINTS, rth_trackback.pointCount);
+
+    fpVector3_t decoded[NAV_RTH_TRACKBACK_POINTS];
+    const int count = walkTrack(decoded);
+
+    // The start of the track is kept rather than dropped
+    expectNear(&recorded[0], &decoded[0], ROUNDING_TOLERANCE_CM);
+    expectNear(&recorded[recordedCount - 1], &decoded[count - 1], ROUNDING_TOLERANCE_CM);
+
+    // Every corner survives simplification
+    for (int leg = 0; leg <= legs; leg++) {
+        const fpVector3_t corner = { .x = corners[leg][0], .y = corners[leg][1], .z = corners[leg][2] };
+        float nearest = INFINITY;
+        for (int i = 0; i < count; i++) {
+            nearest = MIN(nearest, calc_length_pythagorean_3D(corner.x - decoded[i].x, corner.y - decoded[i].y, corner.z - decoded[i].z));
+        }
+        EXPECT_LT(nearest, ROUNDING_TOLERANCE_CM);
+    }
+
+    // Only collinear points were merged, so the simplified track stays on the flown one
+    for (int i = 0; i < recordedCount; i++) {
+        EXPECT_LT(distanceToPolyline(&recorded[i], decoded, count), 2 * ROUNDING_TOLERANCE_CM);
+    }
+}
+
+TEST(RthTrackbackTest, OldestPointDroppedWhenNothingCanBeMerged)
+{
+    startTrack();
+
+    // Steps so long that no two neighbouring offsets can be merged into one
+    const float step = METERS_TO_CENTIMETERS(20000);
+    const int extra = 20;
+
+    for (int i = 0; i < NAV_RTH_TRACKBACK_POINTS + extra; i++) {
+        recordPoint(i * step, 0, 5000);
+    }
+
+    ASSERT_EQ(NAV_RTH_TRACKBACK_POINTS, rth_trackback.pointCount);
+    expectNear(&recorded[extra], &rth_trackback.firstPoint, ROUNDING_TOLERANCE_CM);
+    expectNear(&recorded[recordedCount - 1], &rth_trackback.lastPoint, ROUNDING_TOLERANCE_CM);
+
+    fpVector3_t decoded[NAV_RTH_TRACKBACK_POINTS];
+    ASSERT_EQ(NAV_RTH_TRACKBACK_POINTS, walkTrack(decoded));
+
+    for (int i = 0; i < NAV_RTH_TRACKBACK_POINTS; i++) {
+        expectNear(&recorded[extra + i], &decoded[i], ROUNDING_TOLERANCE_CM);
+    }
+}
+
+// STUBS
+extern "C" {
+#ifdef USE_MULTI_FUNCTIONS
+    uint8_t multiFunctionFlags;
+#endif
+
+    bool isGPSHeadingValid(void) { return false; }
+    uint32_t calculateDistanceToDestination(const fpVector3_t *destinationPos)
+    {
+        return calc_length_pythagorean_2D(destinationPos->x - posControl.actualState.abs.pos.x, destinationPos->y - posControl.actualState.abs.pos.y);
+    }
+    bool isWaypointReached(const fpVector3_t *waypointPos, const int32_t *waypointBearing) { UNUSED(waypointPos); UNUSED(waypointBearing); return true; }
+    void calculateAndSetActiveWaypointToLocalPosition(const fpVector3_t *pos) { UNUSED(pos); }
+    void setDesiredPosition(const fpVector3_t *pos, int32_t yaw, navSetWaypointFlags_t useMask) { UNUSED(pos); UNUSED(yaw); UNUSED(useMask); }
+    bool rthAltControlStickOverrideCheck(uint8_t axis) { UNUSED(axis); return false; }
+}
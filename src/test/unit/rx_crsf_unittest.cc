@@ -0,0 +1,209 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/crc.h"
+    #include "common/utils.h"
+
+    #include "drivers/serial.h"
+
+    #include "io/serial.h"
+
+    #include "rx/rx.h"
+    #include "rx/crsf.h"
+
+    void crsfDataReceive(uint16_t c, void *rxCallbackData);
+    void crsfDataReceiveFrame(const uint8_t *data, uint16_t length, void *rxCallbackData);
+    uint8_t crsfFrameStatus(rxRuntimeConfig_t *rxRuntimeConfig);
+
+    extern bool crsfFrameDone;
+    extern crsfFrame_t crsfFrame;
+    extern uint32_t crsfChannelData[CRSF_MAX_CHANNEL];
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static timeUs_t fakeMicros;
+
+// Builds an RC channels frame with every channel set to value, returns full frame length
+static uint8_t buildRcFrame(uint8_t *buf, uint16_t value)
+{
+    buf[0] = CRSF_SYNC_BYTE;
+    buf[1] = CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE + CRSF_FRAME_LENGTH_TYPE_CRC;
+    buf[2] = CRSF_FRAMETYPE_RC_CHANNELS_PACKED;
+
+    // 16 channels of 11 bits, little endian bit packing
+    memset(&buf[3], 0, CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE);
+    for (int ch = 0; ch < 16; ch++) {
+        for (int bit = 0; bit < 11; bit++) {
+            if (value & (1 << bit)) {
+                const int pos = ch * 11 + bit;
+                buf[3 + pos / 8] |= 1 << (pos % 8);
+            }
+        }
+    }
+
+    const uint8_t len = 3 + CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE;
+    buf[len] = crc8_dvb_s2_update(0, &buf[2], len - 2);
+    return len + 1;
+}
+
+static void resetParser(void)
+{
+    // Let the byte state machine time out any partial frame
+    fakeMicros += 10000;
+    crsfFrameDone = false;
+    memset(&crsfFrame, 0, sizeof(crsfFrame));
+    memset(crsfChannelData, 0, sizeof(crsfChannelData));
+}
+
+TEST(RxCrsfTest, FrameCallbackDecodesSingleFrame)
+{
+    uint8_t buf[CRSF_FRAME_SIZE_MAX];
+    const uint8_t len = buildRcFrame(buf, 992);
+
+    resetParser();
+    crsfDataReceiveFrame(buf, len, NULL);
+
+    EXPECT_TRUE(crsfFrameDone);
+    EXPECT_EQ(RX_FRAME_COMPLETE, crsfFrameStatus(NULL));
+    for (int ch = 0; ch < 16; ch++) {
+        EXPECT_EQ(992u, crsfChannelData[ch]);
+    }
+}
+
+TEST(RxCrsfTest, FrameCallbackMatchesByteCallback)
+{
+    uint8_t buf[CRSF_FRAME_SIZE_MAX];
+    const uint8_t len = buildRcFrame(buf, 1500);
+
+    resetParser();
+    for (int i = 0; i < len; i++) {
+        crsfDataReceive(buf[i], NULL);
+    }
+    EXPECT_EQ(RX_FRAME_COMPLETE, crsfFrameStatus(NULL));
+    uint32_t byteChannels[CRSF_MAX_CHANNEL];
+    memcpy(byteChannels, crsfChannelData, sizeof(byteChannels));
+
+    resetParser();
+    crsfDataReceiveFrame(buf, len, NULL);
+    EXPECT_EQ(RX_FRAME_COMPLETE, crsfFrameStatus(NULL));
+    EXPECT_EQ(0, memcmp(byteChannels, crsfChannelData, sizeof(byteChannels)));
+}
+
+TEST(RxCrsfTest, FrameCallbackRejectsBadCrc)
+{
+    uint8_t buf[CRSF_FRAME_SIZE_MAX];
+    const uint8_t len = buildRcFrame(buf, 992);
+    buf[len - 1] ^= 0xFF;
+
+    resetParser();
+    crsfDataReceiveFrame(buf, len, NULL);
+
+    EXPECT_EQ(RX_FRAME_PENDING, crsfFrameStatus(NULL));
+    EXPECT_EQ(0u, crsfChannelData[0]);
+}
+
+TEST(RxCrsfTest, FrameCallbackHandlesSplitBursts)
+{
+    uint8_t buf[CRSF_FRAME_SIZE_MAX];
+    const uint8_t len = buildRcFrame(buf, 700);
+
+    // Host side transports may split a frame over several deliveries
+    resetParser();
+    crsfDataReceiveFrame(buf, 10, NULL);
+    EXPECT_FALSE(crsfFrameDone);
+    crsfDataReceiveFrame(buf + 10, len - 10, NULL);
+
+    EXPECT_EQ(RX_FRAME_COMPLETE, crsfFrameStatus(NULL));
+    EXPECT_EQ(700u, crsfChannelData[15]);
+}
+
+TEST(RxCrsfTest, FrameCallbackHandlesSeveralFramesPerBurst)
+{
+    uint8_t buf[2 * CRSF_FRAME_SIZE_MAX];
+    const uint8_t len1 = buildRcFrame(buf, 300);
+    const uint8_t len2 = buildRcFrame(buf + len1, 1200);
+
+    resetParser();
+    crsfDataReceiveFrame(buf, len1 + len2, NULL);
+
+    // Latest frame wins, as with per byte delivery
+    EXPECT_EQ(RX_FRAME_COMPLETE, crsfFrameStatus(NULL));
+    EXPECT_EQ(1200u, crsfChannelData[0]);
+}
+
+// STUBS
+
+extern "C" {
+
+rxLinkStatistics_t rxLinkStatistics;
+
+void rxFrameArrived(void) {}
+
+timeUs_t micros(void)
+{
+    return fakeMicros;
+}
+
+serialPortConfig_t *findSerialPortConfig(serialPortFunction_e function)
+{
+    UNUSED(function);
+    return NULL;
+}
+
+serialPort_t *openSerialPort(serialPortIdentifier_e identifier, serialPortFunction_e function, serialReceiveCallbackPtr rxCallback, void *rxCallbackData, uint32_t baudRate, portMode_t mode, portOptions_t options)
+{
+    UNUSED(identifier);
+    UNUSED(function);
+    UNUSED(rxCallback);
+    UNUSED(rxCallbackData);
+    UNUSED(baudRate);
+    UNUSED(mode);
+    UNUSED(options);
+    return NULL;
+}
+
+bool serialSetRxFrameCallback(serialPort_t *instance, serialReceiveFrameCallbackPtr callback)
+{
+    UNUSED(instance);
+    UNUSED(callback);
+    return false;
+}
+
+void serialWriteBuf(serialPort_t *instance, const uint8_t *data, int count)
+{
+    UNUSED(instance);
+    UNUSED(data);
+    UNUSED(count);
+}
+
+}
@@ -0,0 +1,159 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+#include <stdint.h>
+
+extern "C" {
+    #include "platform.h"
+    #include "scheduler/scheduler.h"
+
+    extern void queueClear(void);
+    extern bool queueAdd(cfTask_t *task);
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static timeUs_t simulatedTimeUs;
+static bool rxFrameReady;
+static cfTaskId_e lastExecutedTask;
+
+static void recordTask(cfTaskId_e taskId)
+{
+    lastExecutedTask = taskId;
+    simulatedTimeUs += 10;
+}
+
+static void taskPid(timeUs_t currentTimeUs) { UNUSED(currentTimeUs); recordTask(TASK_PID); }
+static void taskRx(timeUs_t currentTimeUs) { UNUSED(currentTimeUs); recordTask(TASK_RX); }
+static void taskBattery(timeUs_t currentTimeUs) { UNUSED(currentTimeUs); recordTask(TASK_BATTERY); }
+
+static bool taskRxCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTimeUs)
+{
+    UNUSED(currentTimeUs);
+    UNUSED(currentDeltaTimeUs);
+    return rxFrameReady;
+}
+
+#define TEST_TASK(name, check, func, period, priority) \
+    { name, check, func, period, priority, 0, 0, 0, 0, false, 0, 0, 0, 0 }
+
+extern "C" {
+    // Same order as cfTaskId_e, the tasks not listed stay out of the queue
+    cfTask_t cfTasks[TASK_COUNT] = {
+        TEST_TASK("SYSTEM", NULL, taskSystem, TASK_PERIOD_HZ(10), TASK_PRIORITY_HIGH),
+        TEST_TASK("PID", NULL, taskPid, TASK_PERIOD_US(1000), TASK_PRIORITY_REALTIME),
+        TEST_TASK("GYRO", NULL, NULL, 0, TASK_PRIORITY_IDLE),
+        TEST_TASK("RX", taskRxCheck, taskRx, TASK_PERIOD_HZ(10), TASK_PRIORITY_HIGH),
+        TEST_TASK("SERIAL", NULL, NULL, 0, TASK_PRIORITY_IDLE),
+        TEST_TASK("BATTERY", NULL, taskBattery, TASK_PERIOD_US(1000), TASK_PRIORITY_MEDIUM),
+    };
+}
+
+static void setupTasks(void)
+{
+    simulatedTimeUs = 1000000;
+    rxFrameReady = false;
+    lastExecutedTask = TASK_NONE;
+
+    for (int i = 0; i < TASK_COUNT; i++) {
+        cfTasks[i].dynamicPriority = 0;
+        cfTasks[i].taskAgeCycles = 0;
+        cfTasks[i].lastExecutedAt = simulatedTimeUs;
+        cfTasks[i].lastSignaledAt = simulatedTimeUs;
+        cfTasks[i].eventPending = false;
+    }
+
+    queueClear();
+    queueAdd(&cfTasks[TASK_SYSTEM]);
+    queueAdd(&cfTasks[TASK_PID]);
+    queueAdd(&cfTasks[TASK_RX]);
+    queueAdd(&cfTasks[TASK_BATTERY]);
+
+    // Battery is 50 periods late, PID just ran
+    cfTasks[TASK_BATTERY].lastExecutedAt = simulatedTimeUs - 50 * cfTasks[TASK_BATTERY].desiredPeriod;
+    simulatedTimeUs += 100;
+}
+
+TEST(SchedulerUnittest, OverdueTimeDrivenTaskWinsOverUnsignalledEvent)
+{
+    setupTasks();
+    rxFrameReady = true;
+
+    scheduler();
+    EXPECT_EQ(TASK_BATTERY, lastExecutedTask);
+}
+
+TEST(SchedulerUnittest, SignalledEventPreemptsTimeDrivenTask)
+{
+    setupTasks();
+    rxFrameReady = true;
+    schedulerSignalTask(TASK_RX);
+
+    scheduler();
+    EXPECT_EQ(TASK_RX, lastExecutedTask);
+    EXPECT_FALSE(cfTasks[TASK_RX].eventPending);
+
+    // Signal is consumed, the time-driven task is next
+    rxFrameReady = false;
+    scheduler();
+    EXPECT_EQ(TASK_BATTERY, lastExecutedTask);
+}
+
+TEST(SchedulerUnittest, SignalWithoutDataIsDropped)
+{
+    setupTasks();
+    schedulerSignalTask(TASK_RX);
+
+    scheduler();
+    EXPECT_EQ(TASK_BATTERY, lastExecutedTask);
+    EXPECT_FALSE(cfTasks[TASK_RX].eventPending);
+}
+
+TEST(SchedulerUnittest, OverdueRealtimeTaskRunsBeforeSignalledEvent)
+{
+    setupTasks();
+    rxFrameReady = true;
+    schedulerSignalTask(TASK_RX);
+    simulatedTimeUs += 2 * cfTasks[TASK_PID].desiredPeriod;
+
+    scheduler();
+    EXPECT_EQ(TASK_PID, lastExecutedTask);
+
+    scheduler();
+    EXPECT_EQ(TASK_RX, lastExecutedTask);
+}
+
+// STUBS
+extern "C" {
+    timeUs_t micros(void)
+    {
+        return simulatedTimeUs;
+    }
+
+    void taskRunRealtimeCallbacks(timeUs_t currentTimeUs)
+    {
+        UNUSED(currentTimeUs);
+    }
+}
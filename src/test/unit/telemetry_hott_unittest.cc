@@ -49,6 +49,7 @@ extern "C" {
 
     #include "telemetry/hott.h"
     #include "telemetry/telemetry.h"
+    #include "telemetry/telemetry_scheduler.h"
 
 
     PG_REGISTER(telemetryConfig_t, telemetryConfig, PG_TELEMETRY_CONFIG, 0);
@@ -141,6 +142,24 @@ TEST(TelemetryHottTest, UpdateGPSCoordinates3)
     EXPECT_EQ((int16_t)(hottGPSMessage->pos_EW_sec_H << 8 | hottGPSMessage->pos_EW_sec_L), 9999);
 }
 
+TEST(TelemetryHottTest, PrepareGPSMessage_HomeDirection)
+{
+    // given
+    HOTT_GPS_MSG_t *hottGPSMessage = getGPSMessageForTest();
+    stateFlags = GPS_FIX;
+
+    // when
+    GPS_directionToHome = 359;
+    hottPrepareGPSResponse(hottGPSMessage);
+
+    // then
+    EXPECT_EQ(hottGPSMessage->home_direction, 179);
+
+    GPS_directionToHome = 90;
+    hottPrepareGPSResponse(hottGPSMessage);
+    EXPECT_EQ(hottGPSMessage->home_direction, 45);
+}
+
 /*
 TEST(TelemetryHottTest, PrepareGPSMessage_Altitude1m)
 {
@@ -258,24 +277,30 @@ batteryState_e getBatteryState(void) {
     return BATTERY_OK;
 }
 
-float getEstimatedActualPosition(int) {
-    return 0.0f;
-}
-
-float getEstimatedActualVelocity(int) {
-    return 0.0f;
-}
-
-uint16_t getBatteryVoltage(void) {
-    return testBatteryVoltage;
+const telemetryBattery_t *telemetryGetBattery(void) {
+    static telemetryBattery_t battery;
+    battery.voltage = testBatteryVoltage;
+    battery.amperage = testAmperage;
+    battery.mAhDrawn = testMAhDrawn;
+    return &battery;
 }
 
-int16_t getAmperage(void) {
-    return testAmperage;
+const telemetryGps_t *telemetryGetGps(void) {
+    static telemetryGps_t gps;
+    gps.fixType = gpsSol.fixType;
+    gps.numSat = gpsSol.numSat;
+    gps.lat = gpsSol.llh.lat;
+    gps.lon = gpsSol.llh.lon;
+    gps.alt = gpsSol.llh.alt;
+    gps.groundSpeed = gpsSol.groundSpeed;
+    gps.distanceToHome = GPS_distanceToHome;
+    gps.directionToHome = GPS_directionToHome;
+    return &gps;
 }
 
-int32_t getMAhDrawn(void) {
-    return testMAhDrawn;
+const telemetryAltitude_t *telemetryGetAltitude(void) {
+    static telemetryAltitude_t altitude;
+    return &altitude;
 }
 
 }
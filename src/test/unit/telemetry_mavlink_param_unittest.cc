@@ -0,0 +1,154 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <map>
+#include <string>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "config/parameter_group.h"
+
+    #include "fc/settings.h"
+
+    #include "telemetry/mavlink_param.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static std::string paramId(const char *name)
+{
+    char id[MAVLINK_PARAM_ID_LEN];
+    mavlinkParamIdFromName(name, id);
+    return std::string(id, strnlen(id, MAVLINK_PARAM_ID_LEN));
+}
+
+TEST(MavlinkParamTest, Fnv1aHash)
+{
+    EXPECT_EQ(0x811c9dc5u, mavlinkParamHash("", 16));
+    EXPECT_EQ(0xe40c292cu, mavlinkParamHash("a", 16));
+    EXPECT_EQ(0xbf9cf968u, mavlinkParamHash("foobar", 16));
+
+    // Stops at the length limit as well as at the terminator
+    EXPECT_EQ(mavlinkParamHash("foo", 16), mavlinkParamHash("foobar", 3));
+}
+
+TEST(MavlinkParamTest, ShortNamesKept)
+{
+    char id[MAVLINK_PARAM_ID_LEN];
+
+    mavlinkParamIdFromName("looptime", id);
+    EXPECT_EQ(0, memcmp(id, "looptime\0\0\0\0\0\0\0\0", MAVLINK_PARAM_ID_LEN));
+
+    // Exactly 16 chars fills the id without a terminator
+    EXPECT_EQ("nav_rth_altitud1", paramId("nav_rth_altitud1"));
+}
+
+TEST(MavlinkParamTest, LongNamesHashed)
+{
+    // Pinned, ground stations store these ids
+    EXPECT_EQ("nav_fw_crui~6ghn", paramId("nav_fw_cruise_speed"));
+    EXPECT_EQ(paramId("nav_fw_cruise_speed"), paramId("nav_fw_cruise_speed"));
+
+    // Same prefix, different names
+    EXPECT_NE(paramId("nav_fw_cruise_speed"), paramId("nav_fw_cruise_thr"));
+    EXPECT_EQ(0, paramId("nav_fw_cruise_thr").compare(0, 12, "nav_fw_crui~"));
+}
+
+// Ids are looked up by hash, a second setting with the same id would never be found
+TEST(MavlinkParamTest, SettingIdsUnique)
+{
+    std::map<std::string, std::string> names;
+    char name[SETTING_MAX_NAME_LENGTH];
+
+    for (unsigned i = 0; i < SETTINGS_TABLE_COUNT; i++) {
+        const setting_t *setting = settingGet(i);
+        if (SETTING_TYPE(setting) == VAR_STRING) {
+            continue;
+        }
+
+        settingGetName(setting, name);
+        const auto inserted = names.emplace(paramId(name), name);
+        EXPECT_TRUE(inserted.second) << name << " and " << inserted.first->second << " share id " << inserted.first->first;
+    }
+
+    EXPECT_GT(names.size(), 600u);
+}
+
+TEST(MavlinkParamTest, EncodeCastsToFloat)
+{
+    const uint8_t u8 = 200;
+    const int8_t i8 = -100;
+    const uint16_t u16 = 60000;
+    const int16_t i16 = -30000;
+    const uint32_t u32 = 16777216;
+    const float f = 0.125f;
+
+    EXPECT_EQ(200.0f, mavlinkParamEncode(VAR_UINT8, &u8));
+    EXPECT_EQ(-100.0f, mavlinkParamEncode(VAR_INT8, &i8));
+    EXPECT_EQ(60000.0f, mavlinkParamEncode(VAR_UINT16, &u16));
+    EXPECT_EQ(-30000.0f, mavlinkParamEncode(VAR_INT16, &i16));
+    EXPECT_EQ(16777216.0f, mavlinkParamEncode(VAR_UINT32, &u32));
+    EXPECT_EQ(0.125f, mavlinkParamEncode(VAR_FLOAT, &f));
+}
+
+TEST(MavlinkParamTest, DecodeRoundsAndChecksRange)
+{
+    uint8_t u8 = 0;
+    int16_t i16 = 0;
+    uint32_t u32 = 0;
+    float f = 0;
+
+    EXPECT_TRUE(mavlinkParamDecode(VAR_UINT8, &u8, 41.6f, 0, 255));
+    EXPECT_EQ(42, u8);
+    EXPECT_TRUE(mavlinkParamDecode(VAR_INT16, &i16, -1234.4f, -2000, 2000));
+    EXPECT_EQ(-1234, i16);
+    EXPECT_TRUE(mavlinkParamDecode(VAR_FLOAT, &f, 0.3f, 0, 1));
+    EXPECT_EQ(0.3f, f);
+
+    // Rejected values leave the setting alone
+    EXPECT_FALSE(mavlinkParamDecode(VAR_UINT8, &u8, 256, 0, 255));
+    EXPECT_FALSE(mavlinkParamDecode(VAR_UINT8, &u8, -1, 0, 255));
+    EXPECT_FALSE(mavlinkParamDecode(VAR_FLOAT, &f, NAN, 0, 1));
+    EXPECT_FALSE(mavlinkParamDecode(VAR_STRING, &u8, 1, 0, 255));
+    EXPECT_EQ(42, u8);
+    EXPECT_EQ(0.3f, f);
+
+    // The float nearest UINT32_MAX is 2^32, it saturates instead of wrapping
+    EXPECT_TRUE(mavlinkParamDecode(VAR_UINT32, &u32, 4294967295.0f, 0, 4294967295.0f));
+    EXPECT_EQ(UINT32_MAX, u32);
+}
+
+// STUBS
+extern "C" {
+    uint8_t getConfigProfile(void) { return 0; }
+    uint8_t getConfigBatteryProfile(void) { return 0; }
+    uint8_t getConfigMixerProfile(void) { return 0; }
+    const pgRegistry_t *pgFind(pgn_t pgn) { UNUSED(pgn); return NULL; }
+}
@@ -0,0 +1,547 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include <deque>
+#include <vector>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/crc.h"
+    #include "common/streambuf.h"
+
+    #include "fc/fc_msp.h"
+
+    #include "msp/msp.h"
+
+    #include "telemetry/msp_shared.h"
+
+    static uint32_t testMillis;
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define TEST_CMD_ECHO       1       // Replies with the request payload reversed
+#define TEST_CMD_FAIL       0x66    // Always fails
+#define TEST_CMD_BLOB       0x1003  // Anything else replies with payload[0] bytes counting up from payload[1]
+
+#define TEST_CRSF_UPLINK_SIZE       8
+#define TEST_CRSF_DOWNLINK_SIZE     58
+#define TEST_SMARTPORT_FRAME_SIZE   6
+
+// Header versions of the windowed transport, Betaflight uses 2 for MSPv2
+#define TEST_VERSION_WINDOWED       6
+#define TEST_VERSION_WINDOWED_ACK   7
+
+#define TEST_WINDOW                 5
+#define TEST_RETRANSMIT_TICKS       250
+
+typedef std::vector<uint8_t> bytes_t;
+
+static unsigned testDownlinkSize;
+static std::vector<bytes_t> testDownlinkFrames;
+
+static void testCaptureResponse(uint8_t *payload)
+{
+    testDownlinkFrames.push_back(bytes_t(payload, payload + testDownlinkSize));
+}
+
+static bytes_t testExpectedReply(uint16_t cmd, const bytes_t &request)
+{
+    if (cmd == TEST_CMD_ECHO) {
+        return bytes_t(request.rbegin(), request.rend());
+    }
+
+    bytes_t reply;
+    for (int i = 0; i < request[0]; i++) {
+        reply.push_back(request[1] + i);
+    }
+    return reply;
+}
+
+static uint8_t testCrc(const bytes_t &data)
+{
+    return crc8_dvb_s2_update(0, data.data(), data.size());
+}
+
+// Radio side of the windowed transport, written from the protocol description
+class TestRadio {
+public:
+    struct Reply {
+        uint16_t cmd;
+        uint8_t status;
+        bytes_t payload;
+    };
+
+    explicit TestRadio(unsigned uplinkSize) : uplinkSize(uplinkSize) {}
+
+    void queueRequest(uint16_t cmd, const bytes_t &payload, bool corrupt = false)
+    {
+        bytes_t message;
+        message.push_back(payload.size());
+        message.push_back(cmd & 0xFF);
+        message.push_back(cmd >> 8);
+        message.insert(message.end(), payload.begin(), payload.end());
+        message.push_back(testCrc(message) ^ (corrupt ? 0xFF : 0));
+
+        const unsigned chunkSize = uplinkSize - 2;
+        for (unsigned pos = 0; pos < message.size(); pos += chunkSize) {
+            Chunk chunk = {};
+            chunk.start = pos == 0;
+            chunk.data.assign(message.begin() + pos, message.begin() + std::min<size_t>(pos + chunkSize, message.size()));
+            queued.push_back(chunk);
+        }
+    }
+
+    bool frameToSend(int now, bytes_t &frame)
+    {
+        frame.assign(uplinkSize, 0);
+
+        if (!sessionOpen) {
+            frame[0] = (TEST_VERSION_WINDOWED_ACK << 5) | (1 << 4);
+            return true;
+        }
+
+        Chunk *chunk = NULL;
+        for (auto &c : tx) {
+            if (c.resend || (!c.sacked && now - c.sentAt >= TEST_RETRANSMIT_TICKS)) {
+                chunk = &c;
+                break;
+            }
+        }
+        if (!chunk && tx.size() < TEST_WINDOW && !queued.empty()) {
+            Chunk c = queued.front();
+            queued.pop_front();
+            c.seq = txSeq;
+            txSeq = (txSeq + 1) & 0x0F;
+            tx.push_back(c);
+            chunk = &tx.back();
+        }
+
+        frame[1] = ackByte();
+        if (chunk) {
+            frame[0] = (TEST_VERSION_WINDOWED << 5) | (chunk->start ? (1 << 4) : 0) | chunk->seq;
+            std::copy(chunk->data.begin(), chunk->data.end(), frame.begin() + 2);
+            chunk->resend = false;
+            chunk->sentAt = now;
+            chunk->order = sendOrder++;
+        } else if (ackPending) {
+            frame[0] = (TEST_VERSION_WINDOWED_ACK << 5);
+        } else {
+            return false;
+        }
+
+        ackPending = false;
+        return true;
+    }
+
+    void receive(const bytes_t &frame)
+    {
+        const uint8_t version = frame[0] >> 5;
+        if (version == TEST_VERSION_WINDOWED_ACK && (frame[0] & (1 << 4))) {
+            sessionOpen = true;
+            return;
+        }
+        if (!sessionOpen) {
+            // Left over from before the reset
+            return;
+        }
+        ASSERT_TRUE(version == TEST_VERSION_WINDOWED || version == TEST_VERSION_WINDOWED_ACK);
+
+        processAck(frame[1]);
+
+        if (version == TEST_VERSION_WINDOWED) {
+            const uint8_t offset = (frame[0] - rxSeq) & 0x0F;
+            // The flight controller must never run ahead of its window
+            ASSERT_TRUE(offset < TEST_WINDOW || offset > 0x0F - TEST_WINDOW);
+            if (offset < TEST_WINDOW) {
+                if (rx[offset].valid) {
+                    duplicates++;
+                } else {
+                    rx[offset].valid = true;
+                    rx[offset].start = frame[0] & (1 << 4);
+                    rx[offset].data.assign(frame.begin() + 2, frame.end());
+                }
+            } else {
+                duplicates++;
+            }
+            ackPending = true;
+            deliver();
+        }
+    }
+
+    bool idle(void) const
+    {
+        return queued.empty() && tx.empty();
+    }
+
+    std::vector<Reply> replies;
+    unsigned duplicates = 0;
+
+private:
+    struct Chunk {
+        uint8_t seq;
+        bool start;
+        bytes_t data;
+        bool sacked;
+        bool resend;
+        int sentAt;
+        int order;
+    };
+
+    struct RxChunk {
+        bool valid = false;
+        bool start = false;
+        bytes_t data;
+    };
+
+    uint8_t ackByte(void) const
+    {
+        uint8_t ack = rxSeq << 4;
+        for (int i = 1; i < TEST_WINDOW; i++) {
+            if (rx[i].valid) {
+                ack |= 1 << (i - 1);
+            }
+        }
+        return ack;
+    }
+
+    void processAck(uint8_t ack)
+    {
+        if (tx.empty()) {
+            return;
+        }
+
+        const unsigned acked = ((ack >> 4) - tx.front().seq) & 0x0F;
+        if (acked > tx.size()) {
+            return;
+        }
+        tx.erase(tx.begin(), tx.begin() + acked);
+
+        for (unsigned i = 1; i < tx.size(); i++) {
+            if (tx[i].sacked || !(ack & (1 << (i - 1)))) {
+                continue;
+            }
+            tx[i].sacked = true;
+            for (unsigned j = 0; j < i; j++) {
+                if (!tx[j].sacked && tx[j].order < tx[i].order) {
+                    tx[j].resend = true;
+                }
+            }
+        }
+    }
+
+    void deliver(void)
+    {
+        while (rx[0].valid) {
+            consume(rx[0]);
+            for (int i = 0; i < TEST_WINDOW - 1; i++) {
+                rx[i] = rx[i + 1];
+            }
+            rx[TEST_WINDOW - 1] = RxChunk();
+            rxSeq = (rxSeq + 1) & 0x0F;
+        }
+    }
+
+    void consume(const RxChunk &chunk)
+    {
+        if (chunk.start) {
+            message.clear();
+            expected = chunk.data[0] + 5;
+        }
+
+        for (uint8_t c : chunk.data) {
+            if (message.size() < expected) {
+                message.push_back(c);
+            }
+        }
+
+        if (expected && message.size() == expected) {
+            EXPECT_EQ(0, testCrc(message));
+            Reply reply;
+            reply.cmd = message[1] | (message[2] << 8);
+            reply.status = message[3];
+            reply.payload.assign(message.begin() + 4, message.end() - 1);
+            replies.push_back(reply);
+            expected = 0;
+        }
+    }
+
+    unsigned uplinkSize;
+    bool sessionOpen = false;
+    bool ackPending = false;
+
+    std::deque<Chunk> queued;
+    std::deque<Chunk> tx;
+    uint8_t txSeq = 0;
+    int sendOrder = 0;
+
+    RxChunk rx[TEST_WINDOW];
+    uint8_t rxSeq = 0;
+    bytes_t message;
+    size_t expected = 0;
+};
+
+// Radio and flight controller connected by a link that drops and delays frames, one tick is 1 ms
+class TestLink {
+public:
+    TestLink(unsigned uplinkSize, unsigned downlinkSize, unsigned lossPercent, int latency)
+        : radio(uplinkSize), uplinkSize(uplinkSize), lossPercent(lossPercent), latency(latency)
+    {
+        testDownlinkSize = downlinkSize;
+        testDownlinkFrames.clear();
+    }
+
+    // Returns the number of ticks it took, or -1 if the replies did not all arrive
+    int run(unsigned expectedReplies, int maxTicks, int uplinkPeriod = 4, int downlinkPeriod = 2)
+    {
+        for (int tick = 0; tick < maxTicks; tick++) {
+            testMillis = tick;
+
+            bytes_t frame;
+            if (tick % uplinkPeriod == 0 && radio.frameToSend(tick, frame) && !lose()) {
+                uplink.push_back(std::make_pair(tick + latency, frame));
+            }
+            while (!uplink.empty() && uplink.front().first <= tick) {
+                handleMspFrame(uplink.front().second.data(), uplinkSize);
+                uplink.pop_front();
+            }
+
+            if (tick % downlinkPeriod == 0 && isMspReplyPending()) {
+                testDownlinkFrames.clear();
+                sendMspReply(testDownlinkSize, &testCaptureResponse);
+                downlinkFrames++;
+                if (testDownlinkFrames.size() == 1 && !lose()) {
+                    downlink.push_back(std::make_pair(tick + latency, testDownlinkFrames[0]));
+                }
+            }
+            while (!downlink.empty() && downlink.front().first <= tick) {
+                radio.receive(downlink.front().second);
+                downlink.pop_front();
+            }
+
+            if (radio.replies.size() == expectedReplies && radio.idle()) {
+                return tick;
+            }
+        }
+
+        return -1;
+    }
+
+    TestRadio radio;
+    unsigned downlinkFrames = 0;
+
+private:
+    bool lose(void)
+    {
+        random = random * 1103515245 + 12345;
+        return ((random >> 16) % 100) < lossPercent;
+    }
+
+    unsigned uplinkSize;
+    unsigned lossPercent;
+    int latency;
+    uint32_t random = 1;
+    std::deque<std::pair<int, bytes_t>> uplink;
+    std::deque<std::pair<int, bytes_t>> downlink;
+};
+
+static void queueTestRequests(TestRadio &radio, int count)
+{
+    for (int i = 0; i < count; i++) {
+        if (i % 3 == 0) {
+            radio.queueRequest(TEST_CMD_ECHO, { (uint8_t)i, 2, 3, 4, 5, 6, 7 });
+        } else {
+            // Replies from empty to a few hundred bytes
+            radio.queueRequest(TEST_CMD_BLOB, { (uint8_t)((i * 37) % 251), (uint8_t)i });
+        }
+    }
+}
+
+static void checkTestReplies(const TestRadio &radio, int count)
+{
+    ASSERT_EQ((size_t)count, radio.replies.size());
+
+    for (int i = 0; i < count; i++) {
+        const TestRadio::Reply &reply = radio.replies[i];
+        if (i % 3 == 0) {
+            EXPECT_EQ(TEST_CMD_ECHO, reply.cmd);
+            EXPECT_EQ(testExpectedReply(TEST_CMD_ECHO, { (uint8_t)i, 2, 3, 4, 5, 6, 7 }), reply.payload);
+        } else {
+            EXPECT_EQ(TEST_CMD_BLOB, reply.cmd);
+            EXPECT_EQ(testExpectedReply(TEST_CMD_BLOB, { (uint8_t)((i * 37) % 251), (uint8_t)i }), reply.payload);
+        }
+        EXPECT_EQ(0, reply.status);
+    }
+}
+
+TEST(TelemetryMspSharedTest, LegacyRequestReply)
+{
+    initSharedMsp();
+    testDownlinkSize = TEST_SMARTPORT_FRAME_SIZE;
+    testDownlinkFrames.clear();
+
+    // Version 1, start flag, seq 0: size 2, cmd 3, 4 bytes counting up from 10
+    uint8_t request[TEST_SMARTPORT_FRAME_SIZE] = { (1 << 5) | (1 << 4), 2, 3, 4, 10, 0 };
+    request[5] = 2 ^ 3 ^ 4 ^ 10;
+
+    EXPECT_TRUE(handleMspFrame(request, sizeof(request)));
+
+    while (isMspReplyPending()) {
+        sendMspReply(TEST_SMARTPORT_FRAME_SIZE, &testCaptureResponse);
+    }
+
+    // 4 bytes plus size and checksum take two frames
+    ASSERT_EQ(2U, testDownlinkFrames.size());
+    EXPECT_TRUE(testDownlinkFrames[0][0] & (1 << 4));
+    EXPECT_EQ(4, testDownlinkFrames[0][1]);
+
+    bytes_t payload(testDownlinkFrames[0].begin() + 2, testDownlinkFrames[0].end());
+    payload.insert(payload.end(), testDownlinkFrames[1].begin() + 1, testDownlinkFrames[1].end());
+    EXPECT_EQ(bytes_t({ 10, 11, 12, 13 }), bytes_t(payload.begin(), payload.begin() + 4));
+    EXPECT_EQ(4 ^ 3 ^ 10 ^ 11 ^ 12 ^ 13, payload[4]);
+}
+
+TEST(TelemetryMspSharedTest, Mspv2HeaderNotWindowed)
+{
+    initSharedMsp();
+    testDownlinkSize = TEST_SMARTPORT_FRAME_SIZE;
+    testDownlinkFrames.clear();
+
+    // Betaflight MSPv2 start frame, version 2: left to the legacy handler, which reports a version mismatch
+    uint8_t request[TEST_SMARTPORT_FRAME_SIZE] = { (2 << 5) | (1 << 4), 0, 3, 0, 0, 0 };
+
+    EXPECT_TRUE(handleMspFrame(request, sizeof(request)));
+
+    while (isMspReplyPending()) {
+        sendMspReply(TEST_SMARTPORT_FRAME_SIZE, &testCaptureResponse);
+    }
+
+    ASSERT_EQ(1U, testDownlinkFrames.size());
+    EXPECT_EQ((1 << 5) | (1 << 4), testDownlinkFrames[0][0] & 0xF0);
+    EXPECT_EQ(1, testDownlinkFrames[0][1]);
+    EXPECT_EQ(0, testDownlinkFrames[0][2]);
+}
+
+TEST(TelemetryMspSharedTest, WindowedLossless)
+{
+    TestLink link(TEST_CRSF_UPLINK_SIZE, TEST_CRSF_DOWNLINK_SIZE, 0, 10);
+    queueTestRequests(link.radio, 30);
+
+    EXPECT_GE(link.run(30, 20000), 0);
+    checkTestReplies(link.radio, 30);
+    EXPECT_EQ(0U, link.radio.duplicates);
+}
+
+TEST(TelemetryMspSharedTest, WindowedPipelinesRequests)
+{
+    // With 20 ms each way a request per round trip would take 30 * 40 ms at least
+    TestLink link(TEST_CRSF_UPLINK_SIZE, TEST_CRSF_DOWNLINK_SIZE, 0, 20);
+    for (int i = 0; i < 30; i++) {
+        link.radio.queueRequest(TEST_CMD_ECHO, { (uint8_t)i });
+    }
+
+    const int ticks = link.run(30, 20000);
+    EXPECT_GE(ticks, 0);
+    EXPECT_LT(ticks, 30 * 40 / 2);
+    EXPECT_EQ(0U, link.radio.duplicates);
+}
+
+TEST(TelemetryMspSharedTest, WindowedLossyCrsf)
+{
+    TestLink link(TEST_CRSF_UPLINK_SIZE, TEST_CRSF_DOWNLINK_SIZE, 30, 20);
+    queueTestRequests(link.radio, 30);
+
+    EXPECT_GE(link.run(30, 200000), 0);
+    checkTestReplies(link.radio, 30);
+}
+
+TEST(TelemetryMspSharedTest, WindowedLossySmartPort)
+{
+    TestLink link(TEST_SMARTPORT_FRAME_SIZE, TEST_SMARTPORT_FRAME_SIZE, 20, 10);
+    queueTestRequests(link.radio, 30);
+
+    EXPECT_GE(link.run(30, 1000000), 0);
+    checkTestReplies(link.radio, 30);
+}
+
+TEST(TelemetryMspSharedTest, WindowedErrorReplies)
+{
+    TestLink link(TEST_CRSF_UPLINK_SIZE, TEST_CRSF_DOWNLINK_SIZE, 0, 5);
+    link.radio.queueRequest(TEST_CMD_FAIL, { 1 });
+    link.radio.queueRequest(TEST_CMD_ECHO, { 1, 2 }, true);
+    link.radio.queueRequest(TEST_CMD_ECHO, { 1, 2 });
+
+    EXPECT_GE(link.run(3, 20000), 0);
+    ASSERT_EQ(3U, link.radio.replies.size());
+
+    EXPECT_EQ(TEST_CMD_FAIL, link.radio.replies[0].cmd);
+    EXPECT_EQ(1, link.radio.replies[0].status);
+
+    // CRC error
+    EXPECT_EQ(TEST_CMD_ECHO, link.radio.replies[1].cmd);
+    EXPECT_EQ(1, link.radio.replies[1].status);
+    EXPECT_EQ(bytes_t({ 1 }), link.radio.replies[1].payload);
+
+    EXPECT_EQ(0, link.radio.replies[2].status);
+    EXPECT_EQ(bytes_t({ 2, 1 }), link.radio.replies[2].payload);
+}
+
+// STUBS
+
+extern "C" {
+
+timeMs_t millis(void)
+{
+    return testMillis;
+}
+
+mspResult_e mspFcProcessCommand(mspPacket_t *cmd, mspPacket_t *reply, mspPostProcessFnPtr *mspPostProcessFn)
+{
+    UNUSED(mspPostProcessFn);
+
+    bytes_t request;
+    while (sbufBytesRemaining(&cmd->buf)) {
+        request.push_back(sbufReadU8(&cmd->buf));
+    }
+
+    reply->cmd = cmd->cmd;
+    if (cmd->cmd == TEST_CMD_FAIL) {
+        reply->result = MSP_RESULT_ERROR;
+        return MSP_RESULT_ERROR;
+    }
+
+    for (uint8_t c : testExpectedReply(cmd->cmd, request)) {
+        sbufWriteU8(&reply->buf, c);
+    }
+
+    reply->result = MSP_RESULT_ACK;
+    return MSP_RESULT_ACK;
+}
+
+}
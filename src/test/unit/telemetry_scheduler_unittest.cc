@@ -0,0 +1,213 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/axis.h"
+
+    #include "flight/imu.h"
+
+    #include "io/gps.h"
+
+    #include "navigation/navigation.h"
+
+    #include "sensors/battery.h"
+
+    #include "telemetry/telemetry_scheduler.h"
+
+    gpsSolutionData_t gpsSol;
+    uint32_t GPS_distanceToHome;
+    int16_t GPS_directionToHome;
+
+    static attitudeEulerAngles_t testAttitude;
+    static int attitudeReads;
+    static int batteryReads;
+    static int altitudeReads;
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+enum {
+    FRAME_SLOW = 1,
+    FRAME_NORMAL,
+    FRAME_FAST,
+    FRAME_FAST_2,
+};
+
+TEST(TelemetrySchedulerTest, EmptySchedule)
+{
+    telemetryScheduleEntry_t entries[1];
+    telemetrySchedule_t schedule;
+
+    telemetryScheduleInit(&schedule, entries, 1);
+
+    EXPECT_EQ(0, telemetryScheduleCount(&schedule));
+    EXPECT_EQ(0, telemetryScheduleNext(&schedule));
+}
+
+TEST(TelemetrySchedulerTest, ScheduleIsBounded)
+{
+    telemetryScheduleEntry_t entries[2];
+    telemetrySchedule_t schedule;
+
+    telemetryScheduleInit(&schedule, entries, 2);
+    telemetryScheduleAdd(&schedule, FRAME_SLOW, TELEMETRY_RATE_SLOW);
+    telemetryScheduleAdd(&schedule, FRAME_NORMAL, TELEMETRY_RATE_NORMAL);
+    telemetryScheduleAdd(&schedule, FRAME_FAST, TELEMETRY_RATE_FAST);
+
+    EXPECT_EQ(2, telemetryScheduleCount(&schedule));
+    for (int i = 0; i < 30; i++) {
+        EXPECT_NE(FRAME_FAST, telemetryScheduleNext(&schedule));
+    }
+}
+
+TEST(TelemetrySchedulerTest, SlotsFollowRateClass)
+{
+    telemetryScheduleEntry_t entries[4];
+    telemetrySchedule_t schedule;
+
+    telemetryScheduleInit(&schedule, entries, 4);
+    telemetryScheduleAdd(&schedule, FRAME_SLOW, TELEMETRY_RATE_SLOW);
+    telemetryScheduleAdd(&schedule, FRAME_NORMAL, TELEMETRY_RATE_NORMAL);
+    telemetryScheduleAdd(&schedule, FRAME_FAST, TELEMETRY_RATE_FAST);
+    telemetryScheduleAdd(&schedule, FRAME_FAST_2, TELEMETRY_RATE_FAST);
+
+    // One full cycle is as many slots as the total weight
+    int count[FRAME_FAST_2 + 1] = { 0 };
+    for (int i = 0; i < 11 * 10; i++) {
+        count[telemetryScheduleNext(&schedule)]++;
+    }
+
+    EXPECT_EQ(10, count[FRAME_SLOW]);
+    EXPECT_EQ(20, count[FRAME_NORMAL]);
+    EXPECT_EQ(40, count[FRAME_FAST]);
+    EXPECT_EQ(40, count[FRAME_FAST_2]);
+}
+
+TEST(TelemetrySchedulerTest, SlotsAreSpreadOut)
+{
+    telemetryScheduleEntry_t entries[3];
+    telemetrySchedule_t schedule;
+
+    telemetryScheduleInit(&schedule, entries, 3);
+    telemetryScheduleAdd(&schedule, FRAME_SLOW, TELEMETRY_RATE_SLOW);
+    telemetryScheduleAdd(&schedule, FRAME_NORMAL, TELEMETRY_RATE_NORMAL);
+    telemetryScheduleAdd(&schedule, FRAME_FAST, TELEMETRY_RATE_FAST);
+
+    // FAST gets 4 of every 7 slots, so it must never wait more than 2 slots,
+    // and the other frames must never wait longer than one cycle
+    int lastSlot[FRAME_FAST + 1] = { -1, -1, -1, -1 };
+    int maxGap[FRAME_FAST + 1] = { 0 };
+    for (int i = 0; i < 7 * 20; i++) {
+        const uint16_t id = telemetryScheduleNext(&schedule);
+        if (lastSlot[id] >= 0 && i - lastSlot[id] > maxGap[id]) {
+            maxGap[id] = i - lastSlot[id];
+        }
+        lastSlot[id] = i;
+    }
+
+    EXPECT_LE(maxGap[FRAME_FAST], 2);
+    EXPECT_LE(maxGap[FRAME_NORMAL], 4);
+    EXPECT_LE(maxGap[FRAME_SLOW], 7);
+}
+
+TEST(TelemetrySchedulerTest, DataReadOncePerTick)
+{
+    attitudeReads = 0;
+    batteryReads = 0;
+    altitudeReads = 0;
+    testAttitude.values.roll = 100;
+
+    telemetryDataInvalidate();
+    for (int i = 0; i < 5; i++) {
+        EXPECT_EQ(100, telemetryGetAttitude()->roll);
+        telemetryGetBattery();
+        telemetryGetAltitude();
+    }
+
+    EXPECT_EQ(1, attitudeReads);
+    EXPECT_EQ(1, batteryReads);
+    EXPECT_EQ(1, altitudeReads);
+
+    // Values change only when the next tick starts
+    testAttitude.values.roll = 200;
+    EXPECT_EQ(100, telemetryGetAttitude()->roll);
+
+    telemetryDataInvalidate();
+    EXPECT_EQ(200, telemetryGetAttitude()->roll);
+    EXPECT_EQ(2, attitudeReads);
+}
+
+TEST(TelemetrySchedulerTest, DirectionToHomeIsPositive)
+{
+    GPS_directionToHome = -90;
+
+    telemetryDataInvalidate();
+
+    EXPECT_EQ(270, telemetryGetGps()->directionToHome);
+}
+
+// STUBS
+
+extern "C" {
+
+const attitudeEulerAngles_t *imuGetAttitude(void)
+{
+    attitudeReads++;
+    return &testAttitude;
+}
+
+bool isBatteryVoltageConfigured(void)
+{
+    batteryReads++;
+    return true;
+}
+
+bool isAmperageConfigured(void) { return true; }
+uint16_t getBatteryVoltage(void) { return 1680; }
+uint16_t getBatteryAverageCellVoltage(void) { return 420; }
+int16_t getAmperage(void) { return 1000; }
+int32_t getMAhDrawn(void) { return 100; }
+int32_t getMWhDrawn(void) { return 1680; }
+uint8_t calculateBatteryPercentage(void) { return 100; }
+
+float getEstimatedActualPosition(int axis)
+{
+    UNUSED(axis);
+    altitudeReads++;
+    return 1000.0f;
+}
+
+float getEstimatedActualVelocity(int axis)
+{
+    UNUSED(axis);
+    return 0.0f;
+}
+
+}
@@ -0,0 +1,366 @@
+#!/usr/bin/env python3
+'''
+Exercise the MAVLink mission protocol of a running INAV, usually SITL, the
+way a ground station on a bad radio link would.
+
+The script talks MAVLink 2 over TCP and puts a simulated link in between:
+packets in both directions are dropped with a given probability and delivered
+after a latency plus a random jitter, so they also arrive out of order.
+
+Checks:
+  upload    upload a mission over the lossy link, download it again on a clean
+            link and compare every item
+  fallback  a GCS that ignores MISSION_REQUEST_INT, the upload has to fall
+            back to MISSION_REQUEST / MISSION_ITEM
+  partial   MISSION_WRITE_PARTIAL_LIST replaces exactly the requested range,
+            out of bounds ranges are rejected with MAV_MISSION_INVALID_SEQUENCE
+
+Start SITL with MAVLink telemetry on one of its UARTs, e.g. for UART3:
+
+    serial 2 256 115200 115200 0 115200
+    feature TELEMETRY
+    save
+
+and run:
+
+    python3 src/utils/mavlink_mission_test.py --port 5762
+
+The exit code is the number of failed checks. Only the standard library is
+needed.
+'''
+
+import argparse
+import heapq
+import random
+import socket
+import struct
+import sys
+import time
+
+# Message ids and CRC extras, common.xml
+MISSION_ITEM = 39
+MISSION_REQUEST = 40
+MISSION_REQUEST_LIST = 43
+MISSION_COUNT = 44
+MISSION_ACK = 47
+MISSION_REQUEST_INT = 51
+MISSION_ITEM_INT = 73
+MISSION_WRITE_PARTIAL_LIST = 38
+
+CRC_EXTRA = {
+    MISSION_WRITE_PARTIAL_LIST: 9,
+    MISSION_ITEM: 254,
+    MISSION_REQUEST: 230,
+    MISSION_REQUEST_LIST: 132,
+    MISSION_COUNT: 221,
+    MISSION_ACK: 153,
+    MISSION_REQUEST_INT: 196,
+    MISSION_ITEM_INT: 38,
+}
+
+MAV_MISSION_ACCEPTED = 0
+MAV_MISSION_INVALID_SEQUENCE = 13
+
+MAV_CMD_NAV_WAYPOINT = 16
+MAV_CMD_NAV_RETURN_TO_LAUNCH = 20
+MAV_FRAME_MISSION = 2
+MAV_FRAME_GLOBAL_RELATIVE_ALT = 3
+MAV_FRAME_GLOBAL_RELATIVE_ALT_INT = 6
+
+GCS_SYSTEM_ID = 255
+GCS_COMPONENT_ID = 190
+
+
+def x25crc(data, extra):
+    crc = 0xFFFF
+    for b in bytes(data) + bytes([extra]):
+        t = (b ^ crc) & 0xFF
+        t = (t ^ (t << 4)) & 0xFF
+        crc = ((crc >> 8) ^ (t << 8) ^ (t << 3) ^ (t >> 4)) & 0xFFFF
+    return crc
+
+
+class Link:
+    '''MAVLink 2 over TCP through a simulated lossy, laggy and reordering link'''
+
+    def __init__(self, host, port, target_system, loss=0.0, latency=0.0, jitter=0.0, seed=1):
+        self.sock = socket.create_connection((host, port))
+        self.sock.settimeout(0.002)
+        self.target = (target_system, 1)
+        self.loss = loss
+        self.latency = latency
+        self.jitter = jitter
+        self.random = random.Random(seed)
+        self.seq = 0
+        self.rx = b''
+        self.outgoing = []
+        self.incoming = []
+
+    def configure(self, loss=0.0, latency=0.0, jitter=0.0):
+        self.loss = loss
+        self.latency = latency
+        self.jitter = jitter
+
+    def drain(self, seconds):
+        '''Drops whatever the link still delivers, late acks of the previous transfer'''
+        deadline = time.time() + self.latency + self.jitter + seconds
+        while time.time() < deadline or self.outgoing:
+            self.poll()
+
+    def _delay(self):
+        return time.time() + self.latency + self.random.uniform(0, self.jitter)
+
+    def send(self, msgid, payload):
+        header = bytes([len(payload), 0, 0, self.seq & 0xFF, GCS_SYSTEM_ID, GCS_COMPONENT_ID]) + struct.pack('<I', msgid)[:3]
+        packet = b'\xfd' + header + payload + struct.pack('<H', x25crc(header + payload, CRC_EXTRA[msgid]))
+        self.seq += 1
+        if self.random.random() >= self.loss:
+            heapq.heappush(self.outgoing, (self._delay(), self.seq, packet))
+
+    def poll(self):
+        '''Returns the (msgid, payload) pairs the simulated link delivers now'''
+        now = time.time()
+        while self.outgoing and self.outgoing[0][0] <= now:
+            self.sock.sendall(heapq.heappop(self.outgoing)[2])
+
+        try:
+            self.rx += self.sock.recv(65536)
+        except socket.timeout:
+            pass
+
+        while True:
+            start = self.rx.find(b'\xfd')
+            if start < 0 or len(self.rx) < start + 12:
+                break
+            length = self.rx[start + 1]
+            if len(self.rx) < start + 12 + length:
+                break
+            msgid = int.from_bytes(self.rx[start + 7:start + 10], 'little')
+            payload = self.rx[start + 10:start + 10 + length]
+            self.rx = self.rx[start + 12 + length:]
+            if msgid in CRC_EXTRA and self.random.random() >= self.loss:
+                heapq.heappush(self.incoming, (self._delay(), self.random.random(), msgid, payload))
+
+        delivered = []
+        while self.incoming and self.incoming[0][0] <= now:
+            _, _, msgid, payload = heapq.heappop(self.incoming)
+            delivered.append((msgid, payload))
+        return delivered
+
+    # Messages, MAVLink 2 trims trailing zero bytes so payloads are padded before decoding
+
+    def mission_count(self, count):
+        self.send(MISSION_COUNT, struct.pack('<HBBB', count, *self.target, 0))
+
+    def mission_write_partial_list(self, start, end):
+        self.send(MISSION_WRITE_PARTIAL_LIST, struct.pack('<hhBBB', start, end, *self.target, 0))
+
+    def mission_request_list(self):
+        self.send(MISSION_REQUEST_LIST, struct.pack('<BBB', *self.target, 0))
+
+    def mission_request_int(self, seq):
+        self.send(MISSION_REQUEST_INT, struct.pack('<HBBB', seq, *self.target, 0))
+
+    def mission_item_int(self, seq, item):
+        lat, lon, alt, command = item
+        frame = MAV_FRAME_MISSION if command == MAV_CMD_NAV_RETURN_TO_LAUNCH else MAV_FRAME_GLOBAL_RELATIVE_ALT_INT
+        self.send(MISSION_ITEM_INT, struct.pack('<4fiifHHBBBBBB', 0, 0, 0, 0, lat, lon, alt, seq, command, *self.target, frame, 0, 1, 0))
+
+    def mission_item(self, seq, item):
+        lat, lon, alt, command = item
+        frame = MAV_FRAME_MISSION if command == MAV_CMD_NAV_RETURN_TO_LAUNCH else MAV_FRAME_GLOBAL_RELATIVE_ALT
+        self.send(MISSION_ITEM, struct.pack('<7fHHBBBBBB', 0, 0, 0, 0, lat / 1e7, lon / 1e7, alt, seq, command, *self.target, frame, 0, 1, 0))
+
+
+def make_mission(count, altitude=50.0):
+    '''Waypoints with distinct coordinates, the last item is RTH'''
+    mission = []
+    for seq in range(count):
+        lat = int((41.0 + seq * 1e-4) * 1e7) + 3
+        lon = int((29.0 + seq * 1e-4) * 1e7) + 7
+        command = MAV_CMD_NAV_RETURN_TO_LAUNCH if seq == count - 1 else MAV_CMD_NAV_WAYPOINT
+        mission.append((lat, lon, altitude + seq, command))
+    return mission
+
+
+def upload(link, mission, first=0, last=None, legacy=False, timeout=60):
+    '''
+    Answers item requests until the vehicle sends MISSION_ACK. Returns the ack
+    result, None on timeout, and the item requests seen by type.
+    '''
+    requests = {MISSION_REQUEST_INT: 0, MISSION_REQUEST: 0}
+    link.drain(0.5)
+
+    def start():
+        if last is None:
+            link.mission_count(len(mission))
+        else:
+            link.mission_write_partial_list(first, last)
+
+    def reply(msgid, seq):
+        if msgid == MISSION_REQUEST_INT:
+            link.mission_item_int(seq, mission[seq])
+        else:
+            link.mission_item(seq, mission[seq])
+
+    deadline = time.time() + timeout
+    start()
+    restart = time.time() + 1
+    last_reply = None
+
+    while time.time() < deadline:
+        if time.time() > restart:
+            if not any(requests.values()):
+                # The opening message itself may have been lost
+                start()
+            elif last_reply:
+                # Like a GCS that got no MISSION_ACK, send the last item again
+                reply(*last_reply)
+            restart = time.time() + 1
+
+        for msgid, payload in link.poll():
+            if msgid == MISSION_ACK:
+                return payload.ljust(4, b'\0')[2], requests
+            if msgid not in requests:
+                continue
+            requests[msgid] += 1
+            restart = time.time() + 1
+            if legacy and msgid == MISSION_REQUEST_INT:
+                continue
+            seq = struct.unpack('<H', payload.ljust(2, b'\0')[:2])[0]
+            if seq < len(mission):
+                last_reply = (msgid, seq)
+                reply(msgid, seq)
+
+    return None, requests
+
+
+def download(link, timeout=30):
+    '''Returns the vehicle's mission as (lat, lon, alt, command) tuples, None on timeout'''
+    deadline = time.time() + timeout
+    count = None
+    items = {}
+    sent = {}
+
+    while time.time() < deadline:
+        now = time.time()
+        if count is None:
+            if now - sent.get('list', 0) > 0.5:
+                link.mission_request_list()
+                sent['list'] = now
+        else:
+            missing = [seq for seq in range(count) if seq not in items]
+            if not missing:
+                return [items[seq] for seq in range(count)]
+            for seq in missing[:8]:
+                if now - sent.get(seq, 0) > 0.5:
+                    link.mission_request_int(seq)
+                    sent[seq] = now
+
+        for msgid, payload in link.poll():
+            if msgid == MISSION_COUNT and count is None:
+                count = struct.unpack('<H', payload.ljust(2, b'\0')[:2])[0]
+            elif msgid == MISSION_ITEM_INT:
+                _, _, _, _, lat, lon, alt, seq, command = struct.unpack('<4fiifHH', payload.ljust(32, b'\0')[:32])
+                items[seq] = (lat, lon, round(alt, 2), command)
+
+    return None
+
+
+def same_mission(expected, actual, tolerance=0):
+    if actual is None or len(expected) != len(actual):
+        return False
+    for want, got in zip(expected, actual):
+        if abs(want[0] - got[0]) > tolerance or abs(want[1] - got[1]) > tolerance:
+            return False
+        if abs(want[2] - got[2]) > 0.01 or want[3] != got[3]:
+            return False
+    return True
+
+
+def check(results, name, ok, detail=''):
+    results.append(ok)
+    print('%-48s %s %s' % (name, 'ok' if ok else 'FAILED', detail))
+
+
+def test_upload(link, args, results):
+    mission = make_mission(args.count)
+
+    link.configure(args.loss, args.latency, args.jitter)
+    started = time.time()
+    result, requests = upload(link, mission)
+    elapsed = time.time() - started
+    check(results, 'upload %d items, %.0f%% loss' % (args.count, args.loss * 100), result == MAV_MISSION_ACCEPTED,
+          '%.1f s, %d requests' % (elapsed, sum(requests.values())))
+
+    link.configure()
+    check(results, 'download matches upload', same_mission(mission, download(link)))
+
+
+def test_fallback(link, args, results):
+    mission = make_mission(args.count, altitude=80.0)
+
+    link.configure()
+    result, requests = upload(link, mission, legacy=True)
+    check(results, 'fallback to MISSION_REQUEST', result == MAV_MISSION_ACCEPTED and requests[MISSION_REQUEST] >= args.count,
+          '%d REQUEST_INT, %d REQUEST' % (requests[MISSION_REQUEST_INT], requests[MISSION_REQUEST]))
+
+    # MISSION_ITEM carries float degrees, a few 1e-7 degree units of rounding
+    check(results, 'download matches legacy upload', same_mission(mission, download(link), tolerance=50))
+
+
+def test_partial(link, args, results):
+    count = args.count
+    mission = make_mission(count)
+
+    link.configure()
+    result, _ = upload(link, mission)
+    check(results, 'upload %d items for partial writes' % count, result == MAV_MISSION_ACCEPTED)
+
+    # Replace a range in the middle
+    replacement = make_mission(count, altitude=200.0)
+    result, requests = upload(link, replacement, 2, 4)
+    for seq in range(2, 5):
+        mission[seq] = replacement[seq]
+    check(results, 'partial write 2..4', result == MAV_MISSION_ACCEPTED and requests[MISSION_REQUEST_INT] == 3)
+
+    # -1 is up to the last item
+    result, requests = upload(link, replacement, count - 2, -1)
+    mission[count - 2:] = replacement[count - 2:]
+    check(results, 'partial write %d..end' % (count - 2), result == MAV_MISSION_ACCEPTED and requests[MISSION_REQUEST_INT] == 2)
+
+    check(results, 'download matches partial writes', same_mission(mission, download(link)))
+
+    for first, last in ((4, 2), (-1, 2), (count - 1, count), (count, -1)):
+        result, requests = upload(link, replacement, first, last, timeout=5)
+        check(results, 'partial write %d..%d rejected' % (first, last),
+              result == MAV_MISSION_INVALID_SEQUENCE and not any(requests.values()))
+
+    check(results, 'rejected writes left the mission alone', same_mission(mission, download(link)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='MAVLink mission protocol checks against a running INAV')
+    parser.add_argument('--host', default='127.0.0.1')
+    parser.add_argument('--port', type=int, default=5762, help='TCP port of the MAVLink UART, SITL uses 5760 + UART number - 1')
+    parser.add_argument('--system', type=int, default=1, help='mavlink_sysid of the vehicle')
+    parser.add_argument('--count', type=int, default=60, help='mission length')
+    parser.add_argument('--loss', type=float, default=0.2, help='packet loss for the upload check, 0..1')
+    parser.add_argument('--latency', type=float, default=0.05, help='one way latency in s')
+    parser.add_argument('--jitter', type=float, default=0.05, help='extra random delay in s, reorders packets')
+    parser.add_argument('--seed', type=int, default=1)
+    parser.add_argument('checks', nargs='*', default=['upload', 'fallback', 'partial'])
+    args = parser.parse_args()
+
+    link = Link(args.host, args.port, args.system, seed=args.seed)
+    tests = {'upload': test_upload, 'fallback': test_fallback, 'partial': test_partial}
+    results = []
+
+    for name in args.checks:
+        tests[name](link, args, results)
+
+    return results.count(False)
+
+
+if __name__ == '__main__':
+    sys.exit(main())